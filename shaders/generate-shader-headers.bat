@@ -1,7 +1,13 @@
 %VULKAN_SDK%\Bin\glslc.exe shader.vert -o vert.spv
 %VULKAN_SDK%\Bin\glslc.exe shader.frag -o frag.spv
+%VULKAN_SDK%\Bin\glslc.exe shader-indirect.vert -o vert-indirect.spv
+%VULKAN_SDK%\Bin\glslc.exe shader-instanced.vert -o vert-instanced.spv
+%VULKAN_SDK%\Bin\glslc.exe cull.comp -o cull.spv
 
 "..\bin\debug\bin2cpp.exe" gShaderVertex vert.spv ..\src\poc-engine\rendering\vulkan\shaders\vulkan-shader-vertex.hpp
 "..\bin\debug\bin2cpp.exe" gShaderFragment frag.spv ..\src\poc-engine\rendering\vulkan\shaders\vulkan-shader-fragment.hpp
+"..\bin\debug\bin2cpp.exe" gShaderVertexIndirect vert-indirect.spv ..\src\poc-engine\rendering\vulkan\shaders\vulkan-shader-vertex-indirect.hpp
+"..\bin\debug\bin2cpp.exe" gShaderVertexInstanced vert-instanced.spv ..\src\poc-engine\rendering\vulkan\shaders\vulkan-shader-vertex-instanced.hpp
+"..\bin\debug\bin2cpp.exe" gShaderCull cull.spv ..\src\poc-engine\rendering\vulkan\shaders\vulkan-shader-cull.hpp
 
 pause
@@ -0,0 +1,56 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// GPU driven draws: the instance index is the object whose transform & mesh dequantization are used
+
+struct Lod {
+    uint firstIndex;
+    uint indexCount;
+    float error;
+    uint padding;
+};
+
+// GpuMesh
+struct Mesh {
+    vec4 sphere;
+    vec4 scale;
+    vec4 offset;
+    int vertexOffset;
+    uint format;
+    uint lodCount;
+    uint padding;
+    Lod lods[8];
+};
+
+// GpuObject
+struct Object {
+    mat4 transform;
+    uint mesh;
+    float maxScale;
+    uint padding0;
+    uint padding1;
+};
+
+layout(push_constant) uniform Frame {
+    mat4 viewProjection;
+} frame;
+
+layout(std430, set = 0, binding = 0) readonly buffer Objects {
+    Object objects[];
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer Meshes {
+    Mesh meshes[];
+};
+
+layout(location = 0) in vec3 positions;
+layout(location = 1) in vec3 color;
+
+layout(location = 0) out vec3 outColor;
+
+void main() {
+    const mat4 transform = objects[gl_InstanceIndex].transform;
+    const Mesh mesh = meshes[objects[gl_InstanceIndex].mesh];
+    gl_Position = frame.viewProjection * transform * vec4(positions * mesh.scale.xyz + mesh.offset.xyz, 1.0);
+    outColor = color;
+}
@@ -0,0 +1,26 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// instanced draws: the per draw transform is the view projection, the instance gives the world
+// transform rows & a color multiplying the vertex colors
+layout(push_constant) uniform Draw {
+    mat4 transform;
+    vec4 scale;
+    vec4 offset;
+} draw;
+
+layout(location = 0) in vec3 positions;
+layout(location = 1) in vec3 color;
+layout(location = 2) in vec4 instanceRow0;
+layout(location = 3) in vec4 instanceRow1;
+layout(location = 4) in vec4 instanceRow2;
+layout(location = 5) in vec4 instanceColor;
+
+layout(location = 0) out vec3 outColor;
+
+void main() {
+    const vec4 local = vec4(positions * draw.scale.xyz + draw.offset.xyz, 1.0);
+    const vec4 world = vec4(dot(instanceRow0, local), dot(instanceRow1, local), dot(instanceRow2, local), 1.0);
+    gl_Position = draw.transform * world;
+    outColor = color * instanceColor.rgb;
+}
@@ -1,12 +1,20 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
+// per draw constants: world transform of the entity & dequantization of the mesh positions
+// (identity dequantization for FLOAT32 & HALF_POSITION meshes)
+layout(push_constant) uniform Draw {
+    mat4 transform;
+    vec4 scale;
+    vec4 offset;
+} draw;
+
 layout(location = 0) in vec3 positions;
 layout(location = 1) in vec3 color;
 
 layout(location = 0) out vec3 outColor;
 
 void main() {
-    gl_Position = vec4(positions, 1.0);
+    gl_Position = draw.transform * vec4(positions * draw.scale.xyz + draw.offset.xyz, 1.0);
     outColor = color;
 }
@@ -0,0 +1,55 @@
+#include "benchmark.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+#include "assets/asset-cooker.hpp"
+
+using namespace poc;
+
+POC_BENCHMARK(assetCookerNoChange) {
+	// 10k small meshes in 100 directories, cooked once before the measures
+	namespace fs = std::filesystem;
+	const fs::path root = fs::temp_directory_path() / "poc-benchmark-cook";
+	fs::remove_all(root);
+	for (int directory = 0; directory < 100; ++directory) {
+		const fs::path path = root / "source" / ("props-" + std::to_string(directory));
+		fs::create_directories(path);
+		for (int asset = 0; asset < 100; ++asset) {
+			std::ofstream file(path / ("prop-" + std::to_string(asset) + ".obj"), std::ios::trunc);
+			const std::string size = std::to_string(1 + directory * 100 + asset);
+			file << "v 0 0 0\nv " << size << " 0 0\nv " << size << " " << size << " 0\nv 0 " << size << " 0\nf 1 2 3 4\n";
+		}
+	}
+
+	CookSettings settings;
+	settings.shaderCompiler.clear();
+	AssetCooker cooker((root / "source").string(), (root / "cooked").string(), settings);
+	JobSystem jobs;
+	cooker.cook(jobs);
+
+	double milliseconds = Benchmark::measure(5, [&]() {
+		cooker.cook(jobs);
+	});
+	Benchmark::report("10k assets, no change, " + std::to_string(jobs.getThreadCount()) + " threads", milliseconds);
+
+	// a new process: the cache is read from the disk first
+	milliseconds = Benchmark::measure(5, [&]() {
+		AssetCooker((root / "source").string(), (root / "cooked").string(), settings).cook(jobs);
+	});
+	Benchmark::report("10k assets, no change, cache loaded", milliseconds);
+
+	// every file touched: all the contents are hashed
+	milliseconds = Benchmark::measure(3, [&]() {
+		for (const fs::directory_entry& entry : fs::recursive_directory_iterator(root / "source")) {
+			if (entry.is_regular_file()) {
+				fs::last_write_time(entry.path(), fs::last_write_time(entry.path()) + std::chrono::seconds(1));
+			}
+		}
+	}, [&]() {
+		cooker.cook(jobs);
+	});
+	Benchmark::report("10k assets touched, same contents", milliseconds);
+
+	fs::remove_all(root);
+}
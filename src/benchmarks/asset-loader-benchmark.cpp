@@ -0,0 +1,81 @@
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "assets/asset-loader.hpp"
+#include "assets/obj-importer.hpp"
+
+using namespace poc;
+
+// grid of n x n vertices, one quad per cell
+static void writeGrid(const std::string& path, uint32_t n, float offset) {
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	char line[96];
+	for (uint32_t z = 0; z < n; ++z) {
+		for (uint32_t x = 0; x < n; ++x) {
+			file.write(line, std::snprintf(line, sizeof(line), "v %.4f 0 %.4f\n", offset + float(x) * 0.1f, float(z) * 0.1f));
+		}
+	}
+	for (uint32_t z = 0; z + 1 < n; ++z) {
+		for (uint32_t x = 0; x + 1 < n; ++x) {
+			const uint32_t i = z * n + x + 1;
+			file.write(line, std::snprintf(line, sizeof(line), "f %u %u %u %u\n", i, i + n, i + n + 1, i + 1));
+		}
+	}
+}
+
+POC_BENCHMARK(assetLoaderStreaming) {
+	// a level of 32 meshes of 64k vertices
+	std::vector<std::string> paths;
+	for (int i = 0; i < 32; ++i) {
+		paths.push_back((std::filesystem::temp_directory_path() / ("poc-benchmark-stream-" + std::to_string(i) + ".obj")).string());
+		writeGrid(paths.back(), 256, float(i) * 30.0f);
+	}
+
+	// the frame blocks until everything is loaded
+	JobSystem jobs;
+	double milliseconds = Benchmark::measure(3, [&]() {
+		Scene scene;
+		for (const std::string& path : paths) {
+			scene.addMesh(ObjImporter::import(path, jobs));
+		}
+	});
+	Benchmark::report("synchronous load, one blocked frame", milliseconds);
+
+	// frames of the render loop while the level streams in: only the update runs on the frame thread
+	for (const uint64_t budget : { 1ull << 20, 4ull << 20, 32ull << 20 }) {
+		double longestUpdate = 0.0;
+		double totalUpdates = 0.0;
+		uint32_t frameCount = 0;
+		const auto start = std::chrono::steady_clock::now();
+		{
+			AssetLoaderSettings settings;
+			settings.maxBytesPerUpdate = budget;
+			AssetLoader loader(settings);
+			Scene scene;
+			for (size_t i = 0; i < paths.size(); ++i) {
+				loader.load(paths[i], static_cast<int32_t>(paths.size() - i));
+			}
+			while (loader.getLoadingCount() > 0 || loader.getPendingCount() > 0) {
+				const auto frameStart = std::chrono::steady_clock::now();
+				loader.update(scene, scene.getGeneration());
+				const std::chrono::duration<double, std::milli> update = std::chrono::steady_clock::now() - frameStart;
+				longestUpdate = std::max(longestUpdate, update.count());
+				totalUpdates += update.count();
+				++frameCount;
+				std::this_thread::sleep_for(std::chrono::milliseconds(2));
+			}
+		}
+		const std::chrono::duration<double, std::milli> total = std::chrono::steady_clock::now() - start;
+		Benchmark::report("streamed, " + std::to_string(budget >> 20) + " MB per update, longest update", longestUpdate,
+			std::to_string(frameCount) + " frames, mean update " + std::to_string(totalUpdates / frameCount) + " ms, level in " + std::to_string(total.count()) + " ms");
+	}
+
+	for (const std::string& path : paths) {
+		std::filesystem::remove(path);
+	}
+}
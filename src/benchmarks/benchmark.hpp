@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+ * Minimal benchmark registry: POC_BENCHMARK(name) { ... } declares a benchmark run by poc-benchmarks,
+ * the command line arguments select the benchmarks to run by name (all when empty).
+ */
+namespace poc {
+
+	namespace Benchmark {
+
+		struct Entry {
+			const char* name;
+			void (*run)();
+		};
+
+		inline std::vector<Entry>& getEntries() {
+			static std::vector<Entry> entries;
+			return entries;
+		}
+
+		struct Registration {
+			Registration(const char* name, void (*run)()) {
+				getEntries().push_back(Entry{ name, run });
+			}
+		};
+
+		// mean duration of run in milliseconds over the iterations, setup is not measured
+		template<class Setup, class Run>
+		double measure(uint32_t iterations, Setup&& setup, Run&& run) {
+			// warm up
+			setup();
+			run();
+
+			std::chrono::duration<double, std::milli> total{ 0.0 };
+			for (uint32_t i = 0; i < iterations; ++i) {
+				setup();
+				const auto start = std::chrono::steady_clock::now();
+				run();
+				total += std::chrono::steady_clock::now() - start;
+			}
+			return total.count() / iterations;
+		}
+
+		template<class Run>
+		double measure(uint32_t iterations, Run&& run) {
+			return measure(iterations, []() {}, std::forward<Run>(run));
+		}
+
+		inline void report(const std::string& label, double milliseconds, const std::string& details = "") {
+			std::cout << "  " << std::left << std::setw(56) << label
+				<< std::right << std::setw(10) << std::fixed << std::setprecision(3) << milliseconds << " ms"
+				<< (details.empty() ? "" : "   " + details) << std::endl;
+		}
+
+	}
+
+}
+
+#define POC_BENCHMARK(name) \
+	static void name(); \
+	static const poc::Benchmark::Registration name##Registration(#name, &name); \
+	static void name()
@@ -0,0 +1,77 @@
+#include "benchmark.hpp"
+
+#include <random>
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "core/bvh.hpp"
+#include "core/frustum-culling.hpp"
+
+using namespace poc;
+
+// 100k small boxes spread in a 1 km cube, the camera sees a small part of it
+static std::vector<Aabb> createBoxes(size_t count) {
+	std::mt19937 generator(42);
+	std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+	std::uniform_real_distribution<float> size(0.5f, 2.0f);
+	std::vector<Aabb> boxes(count);
+	for (Aabb& box : boxes) {
+		const glm::vec3 center(position(generator), position(generator), position(generator));
+		box = Aabb{ center - glm::vec3(size(generator)), center + glm::vec3(size(generator)) };
+	}
+	return boxes;
+}
+
+POC_BENCHMARK(bvhQueries) {
+	std::vector<Aabb> boxes = createBoxes(100000);
+	const Frustum frustum = Frustum::fromViewProjection(
+		glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 300.0f) *
+		glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+
+	Bvh bvh;
+	double milliseconds = Benchmark::measure(10, [&]() {
+		bvh.build(boxes);
+	});
+	Benchmark::report("build, 100000 objects", milliseconds, std::to_string(bvh.getNodes().size()) + " nodes, SAH cost " + std::to_string(bvh.getCost()));
+
+	milliseconds = Benchmark::measure(50, [&]() {
+		bvh.refit(boxes);
+	});
+	Benchmark::report("refit, 100000 objects", milliseconds);
+
+	std::vector<uint32_t> visible;
+	milliseconds = Benchmark::measure(200, [&]() { visible.clear(); }, [&]() {
+		bvh.cull(frustum, visible);
+	});
+	Benchmark::report("hierarchical frustum culling", milliseconds, std::to_string(visible.size()) + " visible");
+
+	// the same boxes as spheres, culled one by one
+	std::vector<float> centersX, centersY, centersZ, radiuses;
+	for (const Aabb& box : boxes) {
+		centersX.push_back(box.getCenter().x);
+		centersY.push_back(box.getCenter().y);
+		centersZ.push_back(box.getCenter().z);
+		radiuses.push_back(glm::length(box.getExtent()));
+	}
+	std::vector<uint8_t> visibility(boxes.size());
+	JobSystem singleThread(1);
+	size_t visibleCount = 0;
+	milliseconds = Benchmark::measure(200, [&]() {
+		visibleCount = FrustumCulling::cull(frustum, SphereArrays{ centersX, centersY, centersZ, radiuses }, visibility, singleThread);
+	});
+	Benchmark::report("flat frustum culling, 1 thread", milliseconds, std::to_string(visibleCount) + " visible");
+
+	std::mt19937 generator(7);
+	std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+	std::vector<Ray> rays(1000);
+	for (Ray& ray : rays) {
+		ray = Ray{ glm::vec3(0.0f), glm::normalize(glm::vec3(direction(generator), direction(generator), direction(generator))) };
+	}
+	size_t hitCount = 0;
+	milliseconds = Benchmark::measure(20, [&]() { hitCount = 0; }, [&]() {
+		for (const Ray& ray : rays) {
+			hitCount += bvh.raycast(ray).isHit() ? 1 : 0;
+		}
+	});
+	Benchmark::report("1000 ray casts", milliseconds, std::to_string(hitCount) + " hits");
+}
@@ -0,0 +1,52 @@
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <random>
+
+#include "rendering/draw-packets.hpp"
+
+using namespace poc;
+
+// packets of a busy frame: few pipelines, some hundreds of meshes, depths up to 1 km
+static std::vector<DrawPacket> createPackets(size_t count) {
+	std::mt19937 generator(42);
+	std::uniform_int_distribution<uint32_t> pipeline(0, 5);
+	std::uniform_int_distribution<uint32_t> material(0, 500);
+	std::uniform_real_distribution<float> depth(0.1f, 1000.0f);
+	std::vector<DrawPacket> packets(count);
+	for (uint32_t i = 0; i < count; ++i) {
+		packets[i] = DrawPacket{ SortKey::make(DrawPass::OPAQUE, pipeline(generator), material(generator), depth(generator)), i };
+	}
+	return packets;
+}
+
+POC_BENCHMARK(drawPacketSort) {
+	const std::vector<DrawPacket> unsorted = createPackets(100000);
+	std::vector<DrawPacket> packets;
+	std::vector<DrawPacket> scratch;
+
+	double milliseconds = Benchmark::measure(100, [&]() { packets = unsorted; }, [&]() {
+		DrawPackets::sort(packets, scratch);
+	});
+	Benchmark::report("radix sort, 100000 packets", milliseconds);
+
+	milliseconds = Benchmark::measure(100, [&]() { packets = unsorted; }, [&]() {
+		std::stable_sort(packets.begin(), packets.end(), [](const DrawPacket& a, const DrawPacket& b) {
+			return a.key < b.key;
+		});
+	});
+	Benchmark::report("std::stable_sort, 100000 packets", milliseconds);
+
+	milliseconds = Benchmark::measure(100, [&]() { packets = unsorted; }, [&]() {
+		std::sort(packets.begin(), packets.end(), [](const DrawPacket& a, const DrawPacket& b) {
+			return a.key < b.key;
+		});
+	});
+	Benchmark::report("std::sort, 100000 packets", milliseconds);
+
+	// the order of the previous frame is mostly kept
+	milliseconds = Benchmark::measure(100, [&]() {}, [&]() {
+		DrawPackets::sort(packets, scratch);
+	});
+	Benchmark::report("radix sort, 100000 packets already sorted", milliseconds);
+}
@@ -0,0 +1,26 @@
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <exception>
+
+int main(int argc, char** argv) {
+
+	try {
+		const std::vector<std::string> filters(argv + 1, argv + argc);
+
+		for (const poc::Benchmark::Entry& entry : poc::Benchmark::getEntries()) {
+			if (!filters.empty() && std::find(filters.begin(), filters.end(), entry.name) == filters.end()) {
+				continue;
+			}
+
+			std::cout << entry.name << std::endl;
+			entry.run();
+		}
+	}
+	catch (std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,98 @@
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <random>
+
+#include "rendering/memory-sub-allocators.hpp"
+#include "rendering/vulkan/vulkan-instance.hpp"
+#include "rendering/vulkan/vulkan-memory-allocator.hpp"
+
+using namespace poc;
+
+// 100k allocations & frees of 256 B to 64 KB in random order, as the resources of a streamed scene
+POC_BENCHMARK(tlsfAllocator) {
+	std::mt19937 random(1);
+	std::uniform_int_distribution<uint64_t> sizes(256, 64 << 10);
+	std::vector<uint64_t> allocationSizes(100000);
+	for (uint64_t& size : allocationSizes) {
+		size = sizes(random);
+	}
+	std::vector<size_t> freeOrder(allocationSizes.size());
+	for (size_t i = 0; i < freeOrder.size(); ++i) {
+		freeOrder[i] = i;
+	}
+	std::shuffle(freeOrder.begin(), freeOrder.end(), random);
+
+	std::vector<TlsfAllocation> allocations(allocationSizes.size());
+	const double milliseconds = Benchmark::measure(5, [&]() {
+		TlsfAllocator allocator(uint64_t(8) << 30);
+		for (size_t i = 0; i < allocationSizes.size(); ++i) {
+			allocations[i] = allocator.allocate(allocationSizes[i], 256);
+		}
+		for (const size_t i : freeOrder) {
+			allocator.free(allocations[i]);
+		}
+	});
+	Benchmark::report("100k allocations & frees", milliseconds,
+		std::to_string(milliseconds * 1e6 / double(2 * allocationSizes.size())) + " ns per operation");
+}
+
+// 2000 buffers of 64 KB: a device memory per buffer against the sub-allocation of shared blocks
+POC_BENCHMARK(vulkanMemoryAllocator) {
+	try {
+		VulkanInstance instance;
+		const std::vector<vk::PhysicalDevice> physicalDevices = instance.getInstance().enumeratePhysicalDevices();
+		if (physicalDevices.empty()) {
+			std::cout << "  no Vulkan device" << std::endl;
+			return;
+		}
+		const vk::PhysicalDevice physicalDevice = physicalDevices.front();
+		const float priority = 1.0f;
+		const auto queueInfo = vk::DeviceQueueCreateInfo().setQueueFamilyIndex(0).setQueueCount(1).setPQueuePriorities(&priority);
+		const vk::UniqueDevice device = physicalDevice.createDeviceUnique(vk::DeviceCreateInfo().setQueueCreateInfoCount(1).setPQueueCreateInfos(&queueInfo));
+
+		const auto bufferInfo = vk::BufferCreateInfo()
+			.setSize(64 << 10)
+			.setUsage(vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eTransferDst)
+			.setSharingMode(vk::SharingMode::eExclusive);
+		std::vector<vk::UniqueBuffer> buffers;
+		const auto createBuffers = [&]() {
+			buffers.clear();
+			for (uint32_t i = 0; i < 2000; ++i) {
+				buffers.push_back(device->createBufferUnique(bufferInfo));
+			}
+		};
+		const vk::MemoryPropertyFlags properties = vk::MemoryPropertyFlagBits::eDeviceLocal;
+
+		double milliseconds = Benchmark::measure(5, createBuffers, [&]() {
+			std::vector<vk::UniqueDeviceMemory> memories;
+			for (const vk::UniqueBuffer& buffer : buffers) {
+				const vk::MemoryRequirements requirements = device->getBufferMemoryRequirements(*buffer);
+				const vk::PhysicalDeviceMemoryProperties memoryProperties = physicalDevice.getMemoryProperties();
+				uint32_t memoryTypeIndex = 0;
+				while (!(requirements.memoryTypeBits & (1u << memoryTypeIndex)) || (memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & properties) != properties) {
+					++memoryTypeIndex;
+				}
+				memories.push_back(device->allocateMemoryUnique(vk::MemoryAllocateInfo().setAllocationSize(requirements.size).setMemoryTypeIndex(memoryTypeIndex)));
+				device->bindBufferMemory(*buffer, *memories.back(), 0);
+			}
+			buffers.clear();
+		});
+		Benchmark::report("2000 buffers, a device memory each", milliseconds, "2000 device memories");
+
+		VulkanMemoryAllocator allocator(physicalDevice, *device);
+		uint32_t blockCount = 0;
+		milliseconds = Benchmark::measure(5, createBuffers, [&]() {
+			std::vector<VulkanAllocation> allocations;
+			for (const vk::UniqueBuffer& buffer : buffers) {
+				allocations.push_back(allocator.allocateBuffer(*buffer, properties));
+			}
+			blockCount = allocator.getStats().blockCount;
+			buffers.clear();
+		});
+		Benchmark::report("2000 buffers, sub-allocated", milliseconds, std::to_string(blockCount) + " device memories");
+	}
+	catch (const std::exception& error) {
+		std::cout << "  no Vulkan device: " << error.what() << std::endl;
+	}
+}
@@ -0,0 +1,67 @@
+#include "benchmark.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "rendering/mesh-file.hpp"
+
+using namespace poc;
+
+// grid of n x n vertices in the plane y = 0, two triangles per cell
+static Mesh createGrid(uint32_t n) {
+	std::vector<Vertex> vertices;
+	vertices.reserve(size_t(n) * n);
+	for (uint32_t z = 0; z < n; ++z) {
+		for (uint32_t x = 0; x < n; ++x) {
+			vertices.push_back(Vertex{ glm::vec3(float(x), 0.0f, float(z)), glm::vec3(1.0f) });
+		}
+	}
+	std::vector<uint32_t> indices;
+	indices.reserve(size_t(n - 1) * (n - 1) * 6);
+	for (uint32_t z = 0; z + 1 < n; ++z) {
+		for (uint32_t x = 0; x + 1 < n; ++x) {
+			const uint32_t i = z * n + x;
+			indices.insert(indices.end(), { i, i + n, i + n + 1, i, i + n + 1, i + 1 });
+		}
+	}
+	return Mesh(std::move(vertices), std::move(indices));
+}
+
+POC_BENCHMARK(meshFileLoad) {
+	// 16 meshes of 1M vertices: about 600 MB of vertices & indices
+	Scene source;
+	const Mesh grid = createGrid(1024);
+	for (int i = 0; i < 16; ++i) {
+		source.addMesh(Mesh(grid));
+	}
+	const std::string path = (std::filesystem::temp_directory_path() / "poc-benchmark.pocmesh").string();
+	MeshFile::write(path, source);
+	const double gigabytes = double(std::filesystem::file_size(path)) / double(1 << 30);
+
+	// the upload copies the arenas to the staging memory, the file is in the system cache after the first run
+	std::vector<std::byte> staging(source.getVertices().size_bytes() + source.getIndices().size_bytes());
+	double milliseconds = Benchmark::measure(5, [&]() {
+		Scene scene;
+		MeshFile::load(path, scene);
+		std::memcpy(staging.data(), scene.getVertices().data(), scene.getVertices().size_bytes());
+		std::memcpy(staging.data() + scene.getVertices().size_bytes(), scene.getIndices().data(), scene.getIndices().size_bytes());
+	});
+	Benchmark::report("map & copy to staging", milliseconds, std::to_string(gigabytes * 1000.0 / milliseconds) + " GB/s");
+
+	milliseconds = Benchmark::measure(5, [&]() {
+		std::ifstream file(path, std::ios::binary);
+		file.read(reinterpret_cast<char*>(staging.data()), static_cast<std::streamsize>(staging.size()));
+	});
+	Benchmark::report("read to staging, same size", milliseconds, std::to_string(gigabytes * 1000.0 / milliseconds) + " GB/s");
+
+	milliseconds = Benchmark::measure(5, [&]() {
+		Scene scene;
+		for (int i = 0; i < 16; ++i) {
+			scene.addMesh(Mesh(grid));
+		}
+	});
+	Benchmark::report("build the scene from meshes", milliseconds);
+
+	std::filesystem::remove(path);
+}
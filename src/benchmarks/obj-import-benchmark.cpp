@@ -0,0 +1,69 @@
+#include "benchmark.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#include "assets/obj-importer.hpp"
+
+using namespace poc;
+
+// grid of n x n colored vertices with 6 decimals, one quad per cell as exported by the usual tools
+static void writeGrid(const std::string& path, uint32_t n) {
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	char line[128];
+	for (uint32_t z = 0; z < n; ++z) {
+		for (uint32_t x = 0; x < n; ++x) {
+			const int length = std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f %.6f %.6f %.6f\n",
+				float(x) * 0.01f, float((x * 7 + z * 13) % 100) * 0.001f, float(z) * 0.01f, float(x) / float(n), 0.5f, float(z) / float(n));
+			file.write(line, length);
+		}
+	}
+	for (uint32_t z = 0; z + 1 < n; ++z) {
+		for (uint32_t x = 0; x + 1 < n; ++x) {
+			const uint32_t i = z * n + x + 1;
+			const int length = std::snprintf(line, sizeof(line), "f %u %u %u %u\n", i, i + n, i + n + 1, i + 1);
+			file.write(line, length);
+		}
+	}
+}
+
+POC_BENCHMARK(objImport) {
+	// 4M vertices & faces: about 330 MB of text
+	const std::string path = (std::filesystem::temp_directory_path() / "poc-benchmark.obj").string();
+	writeGrid(path, 2048);
+	const double megabytes = double(std::filesystem::file_size(path)) / double(1 << 20);
+
+	JobSystem serial(1);
+	double milliseconds = Benchmark::measure(3, [&]() {
+		ObjImporter::import(path, serial, ImportSettings{ false });
+	});
+	Benchmark::report("1 thread", milliseconds, std::to_string(megabytes * 1000.0 / milliseconds) + " MB/s");
+
+	JobSystem jobs;
+	milliseconds = Benchmark::measure(3, [&]() {
+		ObjImporter::import(path, jobs, ImportSettings{ false });
+	});
+	Benchmark::report(std::to_string(jobs.getThreadCount()) + " threads", milliseconds, std::to_string(megabytes * 1000.0 / milliseconds) + " MB/s");
+
+	milliseconds = Benchmark::measure(3, [&]() {
+		ObjImporter::import(path, jobs);
+	});
+	Benchmark::report(std::to_string(jobs.getThreadCount()) + " threads, welded", milliseconds, std::to_string(megabytes * 1000.0 / milliseconds) + " MB/s");
+
+	// reference: the standard parsing of the same numbers, without the OBJ structure
+	milliseconds = Benchmark::measure(1, [&]() {
+		std::FILE* file = std::fopen(path.c_str(), "rb");
+		char line[128];
+		float values[6];
+		while (std::fgets(line, sizeof(line), file)) {
+			if (line[0] == 'v') {
+				std::sscanf(line + 2, "%f %f %f %f %f %f", &values[0], &values[1], &values[2], &values[3], &values[4], &values[5]);
+			}
+		}
+		std::fclose(file);
+	});
+	Benchmark::report("sscanf of the vertices, 1 thread", milliseconds, std::to_string(megabytes * 1000.0 / milliseconds) + " MB/s");
+
+	std::filesystem::remove(path);
+}
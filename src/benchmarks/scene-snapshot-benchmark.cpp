@@ -0,0 +1,85 @@
+#include "benchmark.hpp"
+
+#include <filesystem>
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "rendering/scene-snapshot.hpp"
+
+using namespace poc;
+
+// grid of n x n vertices in the plane y = 0, two triangles per cell
+static Mesh createGrid(uint32_t n) {
+	std::vector<Vertex> vertices;
+	vertices.reserve(size_t(n) * n);
+	for (uint32_t z = 0; z < n; ++z) {
+		for (uint32_t x = 0; x < n; ++x) {
+			vertices.push_back(Vertex{ glm::vec3(float(x), 0.0f, float(z)), glm::vec3(1.0f) });
+		}
+	}
+	std::vector<uint32_t> indices;
+	indices.reserve(size_t(n - 1) * (n - 1) * 6);
+	for (uint32_t z = 0; z + 1 < n; ++z) {
+		for (uint32_t x = 0; x + 1 < n; ++x) {
+			const uint32_t i = z * n + x;
+			indices.insert(indices.end(), { i, i + n, i + n + 1, i, i + n + 1, i + 1 });
+		}
+	}
+	return Mesh(std::move(vertices), std::move(indices));
+}
+
+// 64 meshes, 10k instances and 100k entities on 1000 roots with 100 children each
+static void buildScene(Scene& scene, const std::vector<Mesh>& meshes, const std::vector<glm::mat4>& transforms) {
+	for (const Mesh& mesh : meshes) {
+		scene.addMesh(Mesh(mesh));
+	}
+	scene.addInstances(0, transforms);
+
+	TransformHierarchy& hierarchy = scene.getTransforms();
+	for (uint32_t i = 0; i < 1000; ++i) {
+		const TransformNode root = hierarchy.create();
+		hierarchy.setLocalPosition(root, glm::vec3(float(i), 0.0f, 0.0f));
+		for (uint32_t j = 0; j < 100; ++j) {
+			const TransformNode child = hierarchy.create(root);
+			hierarchy.setLocalPosition(child, glm::vec3(0.0f, float(j), 0.0f));
+			scene.createEntity((i + j) % 64, child);
+		}
+	}
+}
+
+POC_BENCHMARK(sceneSnapshotLoad) {
+	std::vector<Mesh> meshes;
+	for (uint32_t i = 0; i < 64; ++i) {
+		meshes.push_back(createGrid(128 + i));
+	}
+	std::vector<glm::mat4> transforms;
+	for (uint32_t i = 0; i < 10000; ++i) {
+		transforms.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(float(i % 100), 0.0f, float(i / 100))));
+	}
+
+	Scene source;
+	buildScene(source, meshes, transforms);
+	const std::string path = (std::filesystem::temp_directory_path() / "poc-benchmark.pocscene").string();
+	SceneSnapshot::write(path, source);
+	const double megabytes = double(std::filesystem::file_size(path)) / double(1 << 20);
+
+	// the file is in the system cache after the first run
+	double milliseconds = Benchmark::measure(5, [&]() {
+		Scene scene;
+		SceneSnapshot::load(path, scene);
+	});
+	Benchmark::report("load the snapshot", milliseconds, std::to_string(megabytes) + " MB");
+
+	milliseconds = Benchmark::measure(5, [&]() {
+		Scene scene;
+		buildScene(scene, meshes, transforms);
+	});
+	Benchmark::report("build the scene from meshes", milliseconds);
+
+	milliseconds = Benchmark::measure(5, [&]() {
+		SceneSnapshot::write(path, source);
+	});
+	Benchmark::report("write the snapshot", milliseconds);
+
+	std::filesystem::remove(path);
+}
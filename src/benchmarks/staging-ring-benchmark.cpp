@@ -0,0 +1,70 @@
+#include "benchmark.hpp"
+
+#include <vector>
+
+#include "plateform/window.hpp"
+#include "rendering/vulkan/vulkan-buffer.hpp"
+#include "rendering/vulkan/vulkan-command-pool.hpp"
+#include "rendering/vulkan/vulkan-instance.hpp"
+#include "rendering/vulkan/vulkan-staging-ring.hpp"
+#include "rendering/vulkan/vulkan-surface.hpp"
+
+using namespace poc;
+
+static std::string toGigabytesPerSecond(double bytes, double milliseconds) {
+	return std::to_string(bytes / (milliseconds * 1e6)) + " GB/s";
+}
+
+// 256 uploads of 1 MB: a staging buffer & a submission waited for each against the staging ring,
+// 16 uploads per batch as the meshes streamed in a frame
+POC_BENCHMARK(stagingRing) {
+	try {
+		const auto window = Window::openWindow(64, 64, "poc-benchmarks");
+		const VulkanInstance instance;
+		const VulkanSurface surface(instance, *window);
+		const VulkanPhysicalDevice physicalDevice(instance, surface);
+		const VulkanDevice device(physicalDevice, surface);
+		const VulkanCommandPool commandPool(device);
+		VulkanStagingRing stagingRing(device);
+
+		constexpr vk::DeviceSize uploadSize = 1 << 20;
+		constexpr uint32_t uploadCount = 256;
+		const std::vector<std::byte> data(uploadSize, std::byte{ 42 });
+		std::vector<VulkanBuffer> buffers;
+		for (uint32_t i = 0; i < uploadCount; ++i) {
+			buffers.emplace_back(device, uploadSize, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer, vk::MemoryPropertyFlagBits::eDeviceLocal, nullptr);
+		}
+		const double totalBytes = double(uploadSize) * uploadCount;
+
+		double milliseconds = Benchmark::measure(5, [&]() {
+			for (const VulkanBuffer& buffer : buffers) {
+				const VulkanBuffer stagingBuffer(device, uploadSize, vk::BufferUsageFlagBits::eTransferSrc,
+					vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, data.data());
+				const vk::UniqueCommandBuffer commandBuffer = commandPool.beginCommandBuffer(device);
+				const auto copy = vk::BufferCopy().setSize(uploadSize);
+				commandBuffer->copyBuffer(stagingBuffer.getBuffer(), buffer.getBuffer(), 1, &copy);
+				commandPool.endCommandBuffer(device, *commandBuffer);
+			}
+		});
+		Benchmark::report("a staging buffer & a wait per upload", milliseconds, toGigabytesPerSecond(totalBytes, milliseconds));
+
+		const UploadStats before = stagingRing.getStats();
+		milliseconds = Benchmark::measure(5, [&]() {
+			uint64_t batch = 0;
+			for (uint32_t i = 0; i < uploadCount; ++i) {
+				stagingRing.upload(buffers[i].getBuffer(), 0, data.data(), uploadSize);
+				if (i % 16 == 15) {
+					batch = stagingRing.submit();
+				}
+			}
+			stagingRing.wait(batch);
+		});
+		const UploadStats after = stagingRing.getStats();
+		const double runs = double(after.uploadCount - before.uploadCount) / uploadCount;
+		Benchmark::report(std::string("staging ring, 16 uploads per batch, ") + (device.hasTransferQueue() ? "transfer queue" : "graphics queue"), milliseconds, toGigabytesPerSecond(totalBytes, milliseconds)
+			+ ", " + std::to_string((after.stallMilliseconds - before.stallMilliseconds) / runs) + " ms waiting, last batch included");
+	}
+	catch (const std::exception& error) {
+		std::cout << "  no Vulkan device: " << error.what() << std::endl;
+	}
+}
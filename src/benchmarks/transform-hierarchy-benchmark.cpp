@@ -0,0 +1,61 @@
+#include "benchmark.hpp"
+
+#include <random>
+
+#include "core/transform-hierarchy.hpp"
+
+using namespace poc;
+
+// 100k nodes on 4 levels: 100 roots, 900, 9 000 & 90 000 children
+static TransformHierarchy createHierarchy(std::vector<TransformNode>& nodes) {
+	TransformHierarchy hierarchy;
+	const std::vector<uint32_t> levelSizes{ 100, 900, 9000, 90000 };
+
+	size_t previousBegin = 0;
+	size_t previousSize = 0;
+	for (const uint32_t levelSize : levelSizes) {
+		const size_t levelBegin = nodes.size();
+		for (uint32_t i = 0; i < levelSize; ++i) {
+			const TransformNode parent = previousSize == 0 ? TransformNode{} : nodes[previousBegin + i % previousSize];
+			nodes.push_back(hierarchy.create(parent));
+			hierarchy.setLocalPosition(nodes.back(), glm::vec3(float(i % 7), 1.0f, 0.0f));
+			hierarchy.setLocalRotation(nodes.back(), glm::angleAxis(0.01f * float(i), glm::vec3(0.0f, 1.0f, 0.0f)));
+		}
+		previousBegin = levelBegin;
+		previousSize = levelSize;
+	}
+	return hierarchy;
+}
+
+POC_BENCHMARK(transformHierarchyUpdate) {
+	std::vector<TransformNode> nodes;
+	TransformHierarchy hierarchy = createHierarchy(nodes);
+
+	JobSystem singleThread(1);
+	JobSystem allThreads;
+
+	for (JobSystem* jobs : { &singleThread, &allThreads }) {
+		for (const float dirtyRatio : { 0.01f, 0.1f, 1.0f }) {
+			std::mt19937 generator(42);
+			std::uniform_int_distribution<size_t> pick(0, nodes.size() - 1);
+			const size_t dirtyCount = static_cast<size_t>(float(nodes.size()) * dirtyRatio);
+
+			// dirty subtrees also update their descendants
+			const double milliseconds = Benchmark::measure(50,
+				[&]() {
+					for (size_t i = 0; i < dirtyCount; ++i) {
+						const TransformNode node = nodes[dirtyRatio < 1.0f ? pick(generator) : i];
+						hierarchy.setLocalScale(node, hierarchy.getLocalScale(node));
+					}
+				},
+				[&]() {
+					hierarchy.update(*jobs);
+				});
+
+			Benchmark::report(
+				std::to_string(nodes.size()) + " nodes, " + std::to_string(int(dirtyRatio * 100.0f)) + "% dirty, " + std::to_string(jobs->getThreadCount()) + " threads",
+				milliseconds,
+				std::to_string(hierarchy.getLastUpdateCount()) + " matrices updated");
+		}
+	}
+}
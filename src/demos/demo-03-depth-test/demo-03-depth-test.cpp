@@ -26,7 +26,7 @@ int main() {
 		};
 
 		auto scene = poc::Scene();
-		scene.addMesh(poc::Mesh(std::move(vertices)));
+		scene.createEntity(scene.addMesh(poc::Mesh(std::move(vertices))));
 
 		auto engine = poc::PocEngine::make();
 		engine->loadScene(std::move(scene));
@@ -0,0 +1,361 @@
+#include "asset-cooker.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "../core/logger.hpp"
+#include "../plateform/mapped-file.hpp"
+#include "../rendering/mesh-file.hpp"
+#include "../rendering/mesh-optimizer.hpp"
+#include "../rendering/mesh-simplifier.hpp"
+#include "../rendering/meshlet-builder.hpp"
+#include "content-hash.hpp"
+#include "gltf-importer.hpp"
+#include "obj-importer.hpp"
+
+using namespace poc;
+
+namespace poc {
+
+	static constexpr char logTag[]{ "POC::AssetCooker" };
+
+	// first line of the cache, a cache of another version is ignored: everything is cooked again
+	static constexpr char cacheHeader[]{ "# poc-cook cache 1" };
+
+	enum class AssetKind {
+		MESH,
+		SHADER
+	};
+
+	enum class CookStatus {
+		UNCHANGED,
+		SAME_CONTENT,
+		COOKED,
+		FAILED
+	};
+
+	struct AssetType {
+		const char* extension;
+		AssetKind kind;
+		const char* outputExtension;
+	};
+
+	static constexpr AssetType assetTypes[]{
+		{ ".obj", AssetKind::MESH, ".pocmesh" },
+		{ ".gltf", AssetKind::MESH, ".pocmesh" },
+		{ ".glb", AssetKind::MESH, ".pocmesh" },
+		{ ".vert", AssetKind::SHADER, ".spv" },
+		{ ".frag", AssetKind::SHADER, ".spv" },
+		{ ".comp", AssetKind::SHADER, ".spv" } };
+
+	static const AssetType* findAssetType(const std::filesystem::path& path) {
+		const std::string extension = path.extension().string();
+		for (const AssetType& type : assetTypes) {
+			if (extension == type.extension) {
+				return &type;
+			}
+		}
+		return nullptr;
+	}
+
+	[[noreturn]] static void fail(const std::string& message) {
+		Logger::error(logTag, message);
+		throw std::runtime_error(message);
+	}
+
+	// hash of everything changing the output of a cooker but its inputs
+	static uint64_t getSettingsHash(AssetKind kind, const CookSettings& settings) {
+		std::ostringstream os;
+		if (kind == AssetKind::MESH) {
+			os << "mesh " << MeshFile::version
+				<< " optimize " << settings.optimizeMeshes
+				<< " lods " << settings.generateLods
+				<< " meshlets " << settings.buildMeshlets
+				<< " format " << static_cast<uint32_t>(settings.vertexFormat);
+		}
+		else {
+			os << "shader " << settings.shaderCompiler;
+		}
+		return ContentHash::hash(os.str());
+	}
+
+	static bool getFileStatus(const std::filesystem::path& path, uint64_t& size, int64_t& writeTime) {
+		std::error_code error;
+		size = static_cast<uint64_t>(std::filesystem::file_size(path, error));
+		if (error) {
+			return false;
+		}
+		writeTime = static_cast<int64_t>(std::filesystem::last_write_time(path, error).time_since_epoch().count());
+		return !error;
+	}
+
+	static void cookMesh(const std::filesystem::path& source, const std::filesystem::path& output, const CookSettings& settings) {
+		// one asset per job: the importers run on the calling thread
+		JobSystem jobs(1);
+		std::vector<Mesh> meshes;
+		if (source.extension() == ".obj") {
+			meshes.push_back(ObjImporter::import(source.string(), jobs));
+		}
+		else {
+			meshes = GltfImporter::importMeshes(source.string(), jobs);
+		}
+
+		Scene scene;
+		for (Mesh& mesh : meshes) {
+			if (settings.optimizeMeshes) {
+				mesh = MeshOptimizer::optimize(mesh);
+			}
+			if (settings.generateLods) {
+				mesh = MeshSimplifier::generateLods(mesh);
+			}
+			if (settings.buildMeshlets) {
+				mesh = MeshletBuilder::build(mesh);
+			}
+			mesh.setVertexFormat(settings.vertexFormat);
+			scene.addMesh(std::move(mesh));
+		}
+		MeshFile::write(output.string(), scene);
+	}
+
+	// the paths are pasted between double quotes in the command: no character may end the quotes or be
+	// expanded by the shell (sh or cmd) inside them
+	static bool isQuotable(const std::string& path) {
+		return path.find_first_of("\"$`%!\r\n") == std::string::npos;
+	}
+
+	static void cookShader(const std::filesystem::path& source, const std::filesystem::path& output, const CookSettings& settings) {
+		if (!isQuotable(source.string()) || !isQuotable(output.string())) {
+			fail("Unsupported character in the path of " + source.string());
+		}
+		const std::string command = settings.shaderCompiler + " \"" + source.string() + "\" -o \"" + output.string() + "\"";
+		if (std::system(command.c_str()) != 0) {
+			fail("Failed to compile " + source.string() + " with '" + command + "'");
+		}
+	}
+
+	AssetCooker::AssetCooker(std::string sourceDirectory, std::string outputDirectory, const CookSettings& settings) :
+		sourceDirectory(std::move(sourceDirectory)),
+		outputDirectory(std::move(outputDirectory)),
+		settings(settings) {}
+
+	CookReport AssetCooker::cook(JobSystem& jobs) {
+		namespace fs = std::filesystem;
+
+		struct Asset {
+			std::string path;
+			const AssetType* type;
+			CacheEntry entry;
+			CookStatus status;
+		};
+
+		const fs::path sourceRoot(sourceDirectory);
+		const fs::path outputRoot(outputDirectory);
+		if (!fs::is_directory(sourceRoot)) {
+			fail("No source directory " + sourceDirectory);
+		}
+		fs::create_directories(outputRoot);
+		loadCache();
+
+		// the outputs are skipped when they are in the source tree
+		const fs::path outputCanonical = fs::weakly_canonical(outputRoot);
+		std::vector<Asset> assets;
+		for (fs::recursive_directory_iterator it(sourceRoot), end; it != end; ++it) {
+			if (it->is_directory() && fs::weakly_canonical(it->path()) == outputCanonical) {
+				it.disable_recursion_pending();
+			}
+			else if (const AssetType* type = it->is_regular_file() ? findAssetType(it->path()) : nullptr) {
+				if (type->kind != AssetKind::SHADER || !settings.shaderCompiler.empty()) {
+					assets.push_back(Asset{ it->path().lexically_relative(sourceRoot).generic_string(), type, {}, CookStatus::FAILED });
+				}
+			}
+		}
+		std::sort(assets.begin(), assets.end(), [](const Asset& a, const Asset& b) { return a.path < b.path; });
+
+		const uint64_t settingsHashes[]{ getSettingsHash(AssetKind::MESH, settings), getSettingsHash(AssetKind::SHADER, settings) };
+
+		// the cache is only read by the jobs, each asset gets its own entry
+		jobs.parallelFor(assets.size(), 1, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				Asset& asset = assets[i];
+				const fs::path source = sourceRoot / asset.path;
+				const fs::path output = outputRoot / (asset.path + asset.type->outputExtension);
+				const uint64_t settingsHash = settingsHashes[static_cast<size_t>(asset.type->kind)];
+				const auto cached = cache.find(asset.path);
+				// the job bodies must not throw: an output that cannot be checked is cooked again
+				std::error_code error;
+				const bool cacheValid = cached != cache.end() && cached->second.settingsHash == settingsHash && fs::exists(output, error);
+
+				try {
+					// fast path: the inputs have their cached size & time
+					if (cacheValid) {
+						const bool unchanged = std::all_of(cached->second.inputs.begin(), cached->second.inputs.end(), [&](const CookInput& input) {
+							uint64_t size;
+							int64_t writeTime;
+							return getFileStatus(sourceRoot / input.path, size, writeTime) && size == input.size && writeTime == input.writeTime;
+						});
+						if (unchanged) {
+							asset.entry = cached->second;
+							asset.status = CookStatus::UNCHANGED;
+							continue;
+						}
+					}
+
+					std::vector<std::string> inputPaths{ asset.path };
+					if (asset.type->kind == AssetKind::MESH && source.extension() == ".gltf") {
+						for (const std::string& buffer : GltfImporter::getBufferFiles(source.string())) {
+							inputPaths.push_back(fs::path(buffer).lexically_relative(sourceRoot).generic_string());
+						}
+					}
+
+					// status before the hash: a file written meanwhile is hashed again on the next run
+					CacheEntry entry{ settingsHash, 0, {} };
+					for (const std::string& inputPath : inputPaths) {
+						CookInput input{ inputPath, 0, 0 };
+						if (!getFileStatus(sourceRoot / inputPath, input.size, input.writeTime)) {
+							fail("Failed to read the status of " + (sourceRoot / inputPath).string());
+						}
+						const MappedFile file((sourceRoot / inputPath).string());
+						entry.contentHash = ContentHash::hash(file.getContent(), entry.contentHash);
+						entry.inputs.push_back(std::move(input));
+					}
+
+					if (cacheValid && cached->second.contentHash == entry.contentHash) {
+						asset.entry = std::move(entry);
+						asset.status = CookStatus::SAME_CONTENT;
+						continue;
+					}
+
+					// written aside then renamed: an interrupted cook never leaves a partial output
+					fs::create_directories(output.parent_path());
+					const fs::path temporary = output.string() + ".tmp";
+					if (asset.type->kind == AssetKind::MESH) {
+						cookMesh(source, temporary, settings);
+					}
+					else {
+						cookShader(source, temporary, settings);
+					}
+					fs::rename(temporary, output);
+
+					asset.entry = std::move(entry);
+					asset.status = CookStatus::COOKED;
+				}
+				catch (const std::exception& e) {
+					Logger::error(logTag, "Failed to cook " + asset.path + ": " + e.what());
+					asset.status = CookStatus::FAILED;
+				}
+			}
+		});
+
+		CookReport report{ static_cast<uint32_t>(assets.size()), 0, 0, 0, 0 };
+		std::unordered_map<std::string, CacheEntry> updatedCache;
+		for (Asset& asset : assets) {
+			switch (asset.status) {
+			case CookStatus::UNCHANGED: ++report.unchangedCount; break;
+			case CookStatus::SAME_CONTENT: ++report.sameContentCount; break;
+			case CookStatus::COOKED: ++report.cookedCount; break;
+			case CookStatus::FAILED: ++report.failedCount; break;
+			}
+			if (asset.status != CookStatus::FAILED) {
+				updatedCache.emplace(asset.path, std::move(asset.entry));
+			}
+		}
+
+		// the outputs of the removed sources are removed too
+		uint32_t removedCount = 0;
+		for (const auto& [path, entry] : cache) {
+			if (updatedCache.find(path) == updatedCache.end()) {
+				const AssetType* type = findAssetType(path);
+				if (type && !fs::exists(sourceRoot / path)) {
+					std::error_code error;
+					fs::remove(outputRoot / (path + type->outputExtension), error);
+					++removedCount;
+				}
+			}
+		}
+
+		// nothing to save when nothing changed
+		if (report.unchangedCount != report.assetCount || removedCount > 0 || updatedCache.size() != cache.size()) {
+			cache = std::move(updatedCache);
+			saveCache();
+		}
+
+		std::ostringstream os;
+		os << "Assets " << report.assetCount << ": " << report.cookedCount << " cooked, " << report.unchangedCount << " unchanged, "
+			<< report.sameContentCount << " touched with the same content, " << report.failedCount << " failed, " << removedCount << " removed";
+		Logger::info(logTag, os.str());
+		return report;
+	}
+
+	void AssetCooker::loadCache() {
+		cache.clear();
+		std::ifstream file(std::filesystem::path(outputDirectory) / cacheFileName);
+		std::string line;
+		if (!file.is_open() || !std::getline(file, line) || line != cacheHeader) {
+			return;
+		}
+
+		// asset <settings hash> <content hash> <input count> <path>, then an input <size> <time> <path> line per input
+		while (std::getline(file, line)) {
+			std::istringstream is(line);
+			std::string tag;
+			CacheEntry entry{ 0, 0, {} };
+			size_t inputCount = 0;
+			is >> tag >> std::hex >> entry.settingsHash >> entry.contentHash >> std::dec >> inputCount;
+			std::string path;
+			if (tag != "asset" || !is || !std::getline(is >> std::ws, path)) {
+				Logger::warn(logTag, "Invalid cache, the assets are cooked again");
+				cache.clear();
+				return;
+			}
+
+			for (size_t i = 0; i < inputCount && std::getline(file, line); ++i) {
+				std::istringstream inputStream(line);
+				CookInput input{ {}, 0, 0 };
+				inputStream >> tag >> input.size >> input.writeTime;
+				if (tag == "input" && inputStream && std::getline(inputStream >> std::ws, input.path)) {
+					entry.inputs.push_back(std::move(input));
+				}
+			}
+			if (entry.inputs.size() == inputCount) {
+				cache.emplace(std::move(path), std::move(entry));
+			}
+		}
+	}
+
+	void AssetCooker::saveCache() const {
+		// sorted: the cache diffs well
+		std::vector<const std::pair<const std::string, CacheEntry>*> entries;
+		entries.reserve(cache.size());
+		for (const auto& entry : cache) {
+			entries.push_back(&entry);
+		}
+		std::sort(entries.begin(), entries.end(), [](const auto* a, const auto* b) { return a->first < b->first; });
+
+		const std::filesystem::path path = std::filesystem::path(outputDirectory) / cacheFileName;
+		const std::filesystem::path temporary = path.string() + ".tmp";
+		{
+			std::ofstream file(temporary, std::ios::trunc);
+			if (!file.is_open()) {
+				fail("Failed to write " + temporary.string());
+			}
+			file << cacheHeader << '\n';
+			for (const auto* entry : entries) {
+				file << "asset " << std::hex << entry->second.settingsHash << ' ' << entry->second.contentHash << std::dec
+					<< ' ' << entry->second.inputs.size() << ' ' << entry->first << '\n';
+				for (const CookInput& input : entry->second.inputs) {
+					file << "input " << input.size << ' ' << input.writeTime << ' ' << input.path << '\n';
+				}
+			}
+			if (!file) {
+				fail("Failed to write " + temporary.string());
+			}
+		}
+		std::filesystem::rename(temporary, path);
+	}
+
+}
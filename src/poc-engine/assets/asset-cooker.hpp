@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../core/job-system.hpp"
+#include "../rendering/vertex.hpp"
+
+namespace poc {
+
+	struct CookSettings {
+		// MeshOptimizer passes: vertex cache, overdraw & vertex fetch orders
+		bool optimizeMeshes{ true };
+		// MeshSimplifier chain of levels of detail
+		bool generateLods{ true };
+		bool buildMeshlets{ true };
+		// quantization of the cooked vertices
+		VertexFormat vertexFormat{ VertexFormat::FLOAT32 };
+		// GLSL to SPIR-V compiler, the shaders are not cooked when empty
+		std::string shaderCompiler{ "glslc" };
+	};
+
+	struct CookReport {
+		uint32_t assetCount;
+		// cooked again because they, their dependencies or the settings changed
+		uint32_t cookedCount;
+		// same size & time as cached, not even read
+		uint32_t unchangedCount;
+		// touched but with the cached content hash, not cooked again
+		uint32_t sameContentCount;
+		uint32_t failedCount;
+	};
+
+	/*
+	 * Incremental conversion of the source assets to their runtime formats.
+	 *
+	 * The source directory is scanned for the known extensions: the meshes (.obj, .gltf, .glb) are
+	 * imported, optimized, simplified, split in meshlets & quantized into .pocmesh files, the shaders
+	 * (.vert, .frag, .comp) compiled to .spv files by the external compiler. The outputs mirror the source
+	 * tree in the output directory, their name is the source name followed by the runtime extension.
+	 *
+	 * The cache, a text file in the output directory, keeps for each asset the size, write time & content
+	 * hash of its inputs (the source and e.g. the external buffers of a glTF) and the hash of the settings
+	 * of its cooker. An asset whose inputs have the cached size & time is skipped after a few stat calls,
+	 * one whose inputs were touched is hashed and only cooked when the hash differs. The assets are
+	 * checked & cooked in parallel, one per job; an asset that fails to cook is logged and retried on the
+	 * next run.
+	 */
+	class AssetCooker {
+	public:
+
+		static constexpr char cacheFileName[]{ "cook-cache.txt" };
+
+		AssetCooker(std::string sourceDirectory, std::string outputDirectory, const CookSettings& settings = {});
+
+		CookReport cook(JobSystem& jobs);
+
+	private:
+
+		// an input file of an asset, the path relative to the source directory
+		struct CookInput {
+			std::string path;
+			uint64_t size;
+			int64_t writeTime;
+		};
+
+		struct CacheEntry {
+			uint64_t settingsHash;
+			uint64_t contentHash;
+			std::vector<CookInput> inputs;
+		};
+
+		std::string sourceDirectory;
+		std::string outputDirectory;
+		CookSettings settings;
+
+		// by source path relative to the source directory
+		std::unordered_map<std::string, CacheEntry> cache;
+
+		void loadCache();
+		void saveCache() const;
+	};
+
+}
@@ -0,0 +1,280 @@
+#include "asset-loader.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+#include "../core/job-system.hpp"
+#include "../core/logger.hpp"
+#include "../rendering/mesh-file.hpp"
+#include "gltf-importer.hpp"
+#include "obj-importer.hpp"
+
+using namespace poc;
+
+namespace poc {
+
+	static constexpr char logTag[]{ "POC::AssetLoader" };
+
+	struct LoadRequest {
+		std::string path;
+		int32_t priority;
+		uint64_t sequence;
+		CancellationToken token;
+		LoadCallback callback;
+		std::promise<LoadResult> promise;
+		// loaded geometry, in the scene formats
+		std::unique_ptr<Scene> geometry;
+		std::string error;
+		// generation of the scene including the meshes
+		uint64_t generation{ 0 };
+		std::vector<uint32_t> meshes;
+	};
+
+	// highest priority first, then in request order
+	static bool isBefore(const LoadRequest& a, const LoadRequest& b) {
+		return a.priority != b.priority ? a.priority > b.priority : a.sequence < b.sequence;
+	}
+
+	struct RequestOrder {
+		bool operator()(const std::shared_ptr<LoadRequest>& a, const std::shared_ptr<LoadRequest>& b) const {
+			return isBefore(*b, *a);
+		}
+	};
+
+	static uint64_t getByteSize(const Scene& geometry) {
+		return uint64_t(geometry.getVertices().size_bytes()) + geometry.getPackedVertices().size_bytes()
+			+ geometry.getIndices().size_bytes() + geometry.getMeshlets().size_bytes();
+	}
+
+	// runs on a loader thread: a geometry or an error
+	static void loadGeometry(LoadRequest& request, const ImportSettings& settings, JobSystem& jobs) {
+		try {
+			auto geometry = std::make_unique<Scene>();
+			const std::string extension = std::filesystem::path(request.path).extension().string();
+			if (extension == ".pocmesh") {
+				MeshFile::load(request.path, *geometry);
+			}
+			else {
+				std::vector<Mesh> meshes;
+				if (extension == ".obj") {
+					meshes.push_back(ObjImporter::import(request.path, jobs, settings));
+				}
+				else if (extension == ".gltf" || extension == ".glb") {
+					meshes = GltfImporter::importMeshes(request.path, jobs, settings);
+				}
+				else {
+					throw std::runtime_error("Unknown mesh file type " + request.path);
+				}
+
+				for (Mesh& mesh : meshes) {
+					if (request.token.isCancelled()) {
+						return;
+					}
+					geometry->addMesh(std::move(mesh));
+				}
+			}
+			request.geometry = std::move(geometry);
+		}
+		catch (const std::exception& e) {
+			request.error = e.what();
+		}
+	}
+
+	class AssetLoader::Impl {
+	public:
+
+		explicit Impl(const AssetLoaderSettings& s) :
+			settings(s),
+			jobs(settings.importThreadCount) {
+
+			uint32_t threadCount = settings.threadCount;
+			if (threadCount == 0) {
+				threadCount = std::max(2u, std::thread::hardware_concurrency()) - 1;
+			}
+			threads.reserve(threadCount);
+			for (uint32_t i = 0; i < threadCount; ++i) {
+				threads.emplace_back([this]() { threadLoop(); });
+			}
+		}
+
+		~Impl() {
+			{
+				const std::lock_guard<std::mutex> lock(mutex);
+				stopping = true;
+			}
+			wake.notify_all();
+			for (std::thread& thread : threads) {
+				thread.join();
+			}
+
+			// no scene to add them to anymore
+			while (!queue.empty()) {
+				complete(*queue.top(), LoadStatus::CANCELLED, nullptr);
+				queue.pop();
+			}
+			for (const auto& request : loaded) {
+				complete(*request, LoadStatus::CANCELLED, nullptr);
+			}
+			for (const auto& request : waiting) {
+				complete(*request, LoadStatus::CANCELLED, nullptr);
+			}
+			for (const auto& request : added) {
+				complete(*request, LoadStatus::CANCELLED, nullptr);
+			}
+		}
+
+		std::shared_future<LoadResult> load(const std::string& path, int32_t priority, const CancellationToken& token, LoadCallback callback) {
+			auto request = std::make_shared<LoadRequest>();
+			request->path = path;
+			request->priority = priority;
+			request->token = token;
+			request->callback = std::move(callback);
+			std::shared_future<LoadResult> future = request->promise.get_future().share();
+			{
+				const std::lock_guard<std::mutex> lock(mutex);
+				request->sequence = nextSequence++;
+				queue.push(std::move(request));
+			}
+			wake.notify_one();
+			return future;
+		}
+
+		void update(Scene& scene, uint64_t residentGeneration) {
+			// complete the loads the renderer now draws, in the order they were added
+			const auto resident = std::stable_partition(added.begin(), added.end(), [residentGeneration](const auto& request) {
+				return request->generation > residentGeneration;
+			});
+			for (auto it = resident; it != added.end(); ++it) {
+				complete(**it, LoadStatus::RESIDENT, &scene);
+			}
+			added.erase(resident, added.end());
+
+			{
+				const std::lock_guard<std::mutex> lock(mutex);
+				waiting.insert(waiting.end(), std::make_move_iterator(loaded.begin()), std::make_move_iterator(loaded.end()));
+				loaded.clear();
+			}
+			std::sort(waiting.begin(), waiting.end(), [](const auto& a, const auto& b) { return isBefore(*a, *b); });
+
+			// add the loaded geometries within the budget, the renderer uploads them with the next frame
+			uint64_t bytes = 0;
+			size_t count = 0;
+			for (; count < waiting.size(); ++count) {
+				LoadRequest& request = *waiting[count];
+				if (request.token.isCancelled()) {
+					complete(request, LoadStatus::CANCELLED, &scene);
+					continue;
+				}
+				if (!request.error.empty()) {
+					Logger::error(logTag, "Failed to load " + request.path + ": " + request.error);
+					complete(request, LoadStatus::FAILED, &scene);
+					continue;
+				}
+
+				const uint64_t size = getByteSize(*request.geometry);
+				if (bytes > 0 && bytes + size > settings.maxBytesPerUpdate) {
+					break;
+				}
+				bytes += size;
+
+				const SceneGeometry geometry = request.geometry->getGeometry();
+				const uint32_t firstMesh = scene.addGeometry(geometry);
+				for (uint32_t i = 0; i < geometry.meshes.size(); ++i) {
+					request.meshes.push_back(firstMesh + i);
+				}
+				request.generation = scene.getGeneration();
+				request.geometry.reset();
+				added.push_back(waiting[count]);
+			}
+			waiting.erase(waiting.begin(), waiting.begin() + static_cast<std::ptrdiff_t>(count));
+		}
+
+		size_t getLoadingCount() const {
+			const std::lock_guard<std::mutex> lock(mutex);
+			return queue.size() + loadingCount;
+		}
+
+		size_t getPendingCount() const {
+			const std::lock_guard<std::mutex> lock(mutex);
+			return loaded.size() + waiting.size() + added.size();
+		}
+
+	private:
+		AssetLoaderSettings settings;
+		JobSystem jobs;
+		std::vector<std::thread> threads;
+
+		mutable std::mutex mutex;
+		std::condition_variable wake;
+		bool stopping{ false };
+		uint64_t nextSequence{ 0 };
+		std::priority_queue<std::shared_ptr<LoadRequest>, std::vector<std::shared_ptr<LoadRequest>>, RequestOrder> queue;
+		size_t loadingCount{ 0 };
+		// loaded by the threads, taken by the next update
+		std::vector<std::shared_ptr<LoadRequest>> loaded;
+
+		// owned by the updating thread
+		std::vector<std::shared_ptr<LoadRequest>> waiting;
+		std::vector<std::shared_ptr<LoadRequest>> added;
+
+		void threadLoop() {
+			while (true) {
+				std::shared_ptr<LoadRequest> request;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					wake.wait(lock, [this]() { return stopping || !queue.empty(); });
+					if (stopping) {
+						return;
+					}
+					request = queue.top();
+					queue.pop();
+					++loadingCount;
+				}
+
+				// a cancelled request is not loaded, the update completes it
+				if (!request->token.isCancelled()) {
+					loadGeometry(*request, settings.importSettings, jobs);
+				}
+
+				const std::lock_guard<std::mutex> lock(mutex);
+				--loadingCount;
+				loaded.push_back(std::move(request));
+			}
+		}
+
+		static void complete(LoadRequest& request, LoadStatus status, Scene* scene) {
+			LoadResult result{ status, request.path, status == LoadStatus::RESIDENT ? request.meshes : std::vector<uint32_t>{}, request.error };
+			if (scene && request.callback) {
+				request.callback(*scene, result);
+			}
+			request.promise.set_value(std::move(result));
+		}
+	};
+
+	AssetLoader::AssetLoader(const AssetLoaderSettings& settings) :
+		pimpl(make_unique_pimpl<AssetLoader::Impl>(settings)) {}
+
+	AssetLoader::~AssetLoader() = default;
+
+	std::shared_future<LoadResult> AssetLoader::load(const std::string& path, int32_t priority, const CancellationToken& token, LoadCallback callback) {
+		return pimpl->load(path, priority, token, std::move(callback));
+	}
+
+	void AssetLoader::update(Scene& scene, uint64_t residentGeneration) {
+		pimpl->update(scene, residentGeneration);
+	}
+
+	size_t AssetLoader::getLoadingCount() const {
+		return pimpl->getLoadingCount();
+	}
+
+	size_t AssetLoader::getPendingCount() const {
+		return pimpl->getPendingCount();
+	}
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "../core/cancellation-token.hpp"
+#include "../core/pimpl_ptr.hpp"
+#include "../core/scene.hpp"
+#include "import-settings.hpp"
+
+namespace poc {
+
+	enum class LoadStatus {
+		RESIDENT,
+		CANCELLED,
+		FAILED
+	};
+
+	struct LoadResult {
+		LoadStatus status;
+		std::string path;
+		// meshes added to the scene, in the order of the file
+		std::vector<uint32_t> meshes;
+		std::string error;
+	};
+
+	// called on the thread updating the loader, the entities of the meshes can be created from it
+	using LoadCallback = std::function<void(Scene& scene, const LoadResult& result)>;
+
+	struct AssetLoaderSettings {
+		// 0: one per hardware thread but the calling one, at least one
+		uint32_t threadCount{ 2 };
+		// geometry added to the scene per update, a load larger than the budget is added alone
+		uint64_t maxBytesPerUpdate{ 32ull << 20 };
+		ImportSettings importSettings{};
+		// threads of the job system parsing the chunks of a file, shared by the loads: 0, one per hardware thread
+		uint32_t importThreadCount{ 0 };
+	};
+
+	/*
+	 * Asynchronous loading of mesh files (.pocmesh, .obj, .gltf, .glb) into a scene.
+	 *
+	 * The requests are taken by priority, the highest first, then in order by the loader threads: the
+	 * file is mapped, imported and converted to the vertex formats in a scene of its own; the importers
+	 * split the file across the job system of the loader, the imports of the loader threads take it in
+	 * turns. The loader does not use the job system of the frames: a parse never holds up a frame. The update,
+	 * called once per frame by the thread owning the scene, appends the loaded geometries by priority
+	 * within a byte budget: the renderer uploads the geometry added during a frame at once. A load is
+	 * complete when the renderer reports a resident generation of the scene including its meshes, its
+	 * callback is then called and its future set. A request cancelled before its geometry is added is
+	 * dropped at its next step and completes as cancelled; a failed one completes with its error.
+	 */
+	class AssetLoader {
+	public:
+
+		explicit AssetLoader(const AssetLoaderSettings& settings = {});
+		~AssetLoader();
+
+		// higher priorities first
+		std::shared_future<LoadResult> load(const std::string& path, int32_t priority = 0, const CancellationToken& token = {}, LoadCallback callback = {});
+
+		// residentGeneration: generation of the copy of the scene the renderer draws once uploaded, 0 when it has none
+		void update(Scene& scene, uint64_t residentGeneration);
+
+		// requests not yet loaded by the loader threads
+		size_t getLoadingCount() const;
+
+		// requests loaded, added or waiting to be resident
+		size_t getPendingCount() const;
+
+	private:
+		class Impl;
+		pimpl_ptr<Impl> pimpl;
+	};
+
+}
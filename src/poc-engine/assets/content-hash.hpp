@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "../core/span.hpp"
+
+namespace poc {
+
+	/*
+	 * 64 bits hash of file contents & settings, XXH64: 4 lanes of 8 bytes per round, several GB/s.
+	 *
+	 * Not a cryptographic hash, only a change detection: two different inputs colliding is as likely as
+	 * a random 64 bits match.
+	 */
+	namespace ContentHash {
+
+		namespace details {
+
+			inline constexpr uint64_t prime1 = 0x9E3779B185EBCA87ull;
+			inline constexpr uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+			inline constexpr uint64_t prime3 = 0x165667B19E3779F9ull;
+			inline constexpr uint64_t prime4 = 0x85EBCA77C2B2AE63ull;
+			inline constexpr uint64_t prime5 = 0x27D4EB2F165667C5ull;
+
+			inline uint64_t rotateLeft(uint64_t value, int bits) {
+				return (value << bits) | (value >> (64 - bits));
+			}
+
+			// little endian reads, the hashes are the same on all the platforms we build for
+			inline uint64_t read64(const std::byte* data) {
+				uint64_t value;
+				std::memcpy(&value, data, sizeof(value));
+				return value;
+			}
+
+			inline uint32_t read32(const std::byte* data) {
+				uint32_t value;
+				std::memcpy(&value, data, sizeof(value));
+				return value;
+			}
+
+			inline uint64_t round(uint64_t accumulator, uint64_t input) {
+				return rotateLeft(accumulator + input * prime2, 31) * prime1;
+			}
+
+			inline uint64_t mergeRound(uint64_t accumulator, uint64_t lane) {
+				return (accumulator ^ round(0, lane)) * prime1 + prime4;
+			}
+
+		}
+
+		inline uint64_t hash(span<const std::byte> data, uint64_t seed = 0) {
+			using namespace details;
+
+			const std::byte* cursor = data.data();
+			const std::byte* const end = cursor + data.size();
+			uint64_t result;
+			if (data.size() >= 32) {
+				uint64_t lanes[4]{ seed + prime1 + prime2, seed + prime2, seed, seed - prime1 };
+				for (; end - cursor >= 32; cursor += 32) {
+					for (int lane = 0; lane < 4; ++lane) {
+						lanes[lane] = round(lanes[lane], read64(cursor + lane * 8));
+					}
+				}
+				result = rotateLeft(lanes[0], 1) + rotateLeft(lanes[1], 7) + rotateLeft(lanes[2], 12) + rotateLeft(lanes[3], 18);
+				for (const uint64_t lane : lanes) {
+					result = mergeRound(result, lane);
+				}
+			}
+			else {
+				result = seed + prime5;
+			}
+			result += static_cast<uint64_t>(data.size());
+
+			for (; end - cursor >= 8; cursor += 8) {
+				result = rotateLeft(result ^ round(0, read64(cursor)), 27) * prime1 + prime4;
+			}
+			if (end - cursor >= 4) {
+				result = rotateLeft(result ^ (uint64_t(read32(cursor)) * prime1), 23) * prime2 + prime3;
+				cursor += 4;
+			}
+			for (; cursor != end; ++cursor) {
+				result = rotateLeft(result ^ (uint64_t(std::to_integer<uint8_t>(*cursor)) * prime5), 11) * prime1;
+			}
+
+			// avalanche
+			result ^= result >> 33;
+			result *= prime2;
+			result ^= result >> 29;
+			result *= prime3;
+			result ^= result >> 32;
+			return result;
+		}
+
+		inline uint64_t hash(std::string_view text, uint64_t seed = 0) {
+			return hash(span<const std::byte>(reinterpret_cast<const std::byte*>(text.data()), text.size()), seed);
+		}
+
+	}
+
+}
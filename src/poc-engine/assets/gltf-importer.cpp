@@ -0,0 +1,568 @@
+#include "gltf-importer.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+
+#include "../core/logger.hpp"
+#include "../plateform/mapped-file.hpp"
+#include "../rendering/mesh-optimizer.hpp"
+#include "json.hpp"
+
+using namespace poc;
+
+namespace poc {
+
+	static constexpr char logTag[]{ "POC::GltfImporter" };
+
+	static constexpr uint32_t glbMagic = 0x46546C67;		// "glTF"
+	static constexpr uint32_t glbJsonChunk = 0x4E4F534A;	// "JSON"
+	static constexpr uint32_t glbBinaryChunk = 0x004E4942;	// "BIN\0"
+
+	enum GltfComponentType : uint32_t {
+		BYTE = 5120,
+		UNSIGNED_BYTE = 5121,
+		SHORT = 5122,
+		UNSIGNED_SHORT = 5123,
+		UNSIGNED_INT = 5125,
+		FLOAT = 5126
+	};
+
+	static constexpr uint32_t gltfTriangles = 4;
+
+	// elements of an accessor, each one starting stride bytes after the previous one
+	struct GltfAccessor {
+		const std::byte* data;
+		size_t count;
+		size_t stride;
+		uint32_t componentType;
+		uint32_t componentCount;
+		bool normalized;
+	};
+
+	// a triangle primitive to decode
+	struct GltfPrimitive {
+		const JsonValue* description;
+		std::optional<Mesh> mesh;
+		std::string error;
+	};
+
+	[[noreturn]] static void fail(const std::string& message) {
+		Logger::error(logTag, message);
+		throw std::runtime_error(message);
+	}
+
+	// an index or a count: a non negative integer below the limit, the default when there is no value, nothing when invalid
+	static std::optional<size_t> getIndex(const JsonValue& value, size_t limit = std::numeric_limits<size_t>::max(), std::optional<size_t> defaultValue = std::nullopt) {
+		if (value.getType() == JsonValue::Type::NULL_VALUE) {
+			return defaultValue;
+		}
+		// not a number, not finite, negative, fractional or too large
+		const double number = value.getNumber(-1.0);
+		if (!(number >= 0.0 && number < static_cast<double>(limit)) || std::floor(number) != number) {
+			return std::nullopt;
+		}
+		return static_cast<size_t>(number);
+	}
+
+	template<class T>
+	static T read(const std::byte* data) {
+		T value;
+		std::memcpy(&value, data, sizeof(T));
+		return value;
+	}
+
+	static size_t getComponentSize(uint32_t componentType) {
+		switch (componentType) {
+		case BYTE: case UNSIGNED_BYTE: return 1;
+		case SHORT: case UNSIGNED_SHORT: return 2;
+		case UNSIGNED_INT: case FLOAT: return 4;
+		default: return 0;
+		}
+	}
+
+	static uint32_t getComponentCount(const std::string& type) {
+		static const std::array<std::pair<const char*, uint32_t>, 7> types{ {
+			{ "SCALAR", 1 }, { "VEC2", 2 }, { "VEC3", 3 }, { "VEC4", 4 }, { "MAT2", 4 }, { "MAT3", 9 }, { "MAT4", 16 } } };
+		for (const auto& [name, count] : types) {
+			if (type == name) {
+				return count;
+			}
+		}
+		return 0;
+	}
+
+	// component as a float, the normalized integers are mapped to [0, 1] or [-1, 1]
+	static float readComponent(const std::byte* data, uint32_t componentType, bool normalized) {
+		switch (componentType) {
+		case BYTE: return normalized ? std::max(float(read<int8_t>(data)) / 127.0f, -1.0f) : float(read<int8_t>(data));
+		case UNSIGNED_BYTE: return normalized ? float(read<uint8_t>(data)) / 255.0f : float(read<uint8_t>(data));
+		case SHORT: return normalized ? std::max(float(read<int16_t>(data)) / 32767.0f, -1.0f) : float(read<int16_t>(data));
+		case UNSIGNED_SHORT: return normalized ? float(read<uint16_t>(data)) / 65535.0f : float(read<uint16_t>(data));
+		case UNSIGNED_INT: return float(read<uint32_t>(data));
+		default: return read<float>(data);
+		}
+	}
+
+	static std::vector<std::byte> decodeBase64(std::string_view text) {
+		const auto decode = [](char c) -> int {
+			return c >= 'A' && c <= 'Z' ? c - 'A'
+				: c >= 'a' && c <= 'z' ? c - 'a' + 26
+				: c >= '0' && c <= '9' ? c - '0' + 52
+				: c == '+' ? 62
+				: c == '/' ? 63
+				: -1;
+		};
+
+		std::vector<std::byte> result;
+		result.reserve(text.size() / 4 * 3);
+		uint32_t bits = 0;
+		int bitCount = 0;
+		for (const char c : text) {
+			const int value = decode(c);
+			if (value < 0) {
+				if (c == '=') {
+					break;
+				}
+				fail("Invalid base64 buffer");
+			}
+			bits = (bits << 6) | uint32_t(value);
+			bitCount += 6;
+			if (bitCount >= 8) {
+				bitCount -= 8;
+				result.push_back(static_cast<std::byte>((bits >> bitCount) & 0xFF));
+			}
+		}
+		return result;
+	}
+
+	// the JSON description of a .gltf or .glb file, and the binary chunk of a .glb
+	static JsonValue parseDescription(const std::string& path, span<const std::byte> content, span<const std::byte>& binaryChunk) {
+		std::string_view json(reinterpret_cast<const char*>(content.data()), content.size());
+		if (content.size() >= 12 && read<uint32_t>(content.data()) == glbMagic) {
+			if (read<uint32_t>(content.data() + 4) != 2) {
+				fail(path + ": unsupported glb version");
+			}
+
+			// chunks: length, type & data padded to 4 bytes, the JSON one first
+			size_t offset = 12;
+			json = std::string_view();
+			while (offset + 8 <= content.size()) {
+				const uint32_t length = read<uint32_t>(content.data() + offset);
+				const uint32_t type = read<uint32_t>(content.data() + offset + 4);
+				if (length > content.size() - offset - 8) {
+					fail(path + ": truncated glb chunk");
+				}
+				const std::byte* data = content.data() + offset + 8;
+				if (type == glbJsonChunk && json.empty()) {
+					json = std::string_view(reinterpret_cast<const char*>(data), length);
+				}
+				else if (type == glbBinaryChunk && binaryChunk.empty()) {
+					binaryChunk = span<const std::byte>(data, length);
+				}
+				offset += 8 + (size_t(length) + 3) / 4 * 4;
+			}
+			if (json.empty()) {
+				fail(path + ": no JSON chunk");
+			}
+		}
+
+		JsonValue description = JsonValue::parse(json);
+		const std::string version = description["asset"]["version"].getString();
+		if (version.compare(0, 2, "2.") != 0) {
+			fail(path + ": unsupported glTF version '" + version + "'");
+		}
+		return description;
+	}
+
+	/*
+	 * Buffers of a glTF file: the binary chunk of a .glb, the mapped external files & the decoded
+	 * embedded buffers, kept while the primitives are decoded.
+	 */
+	class GltfDocument {
+	public:
+
+		JsonValue description;
+		std::vector<span<const std::byte>> buffers;
+
+		explicit GltfDocument(const std::string& p) :
+			path(p),
+			file(std::make_unique<MappedFile>(p)) {
+
+			span<const std::byte> binaryChunk;
+			description = parseDescription(path, file->getContent(), binaryChunk);
+			loadBuffers(binaryChunk);
+		}
+
+		[[noreturn]] void fail(const std::string& message) const {
+			poc::fail(message);
+		}
+
+		// throws an exception with the message, caught by the parallel decoding
+		GltfAccessor getAccessor(size_t index) const {
+			const JsonValue& accessor = description["accessors"][index];
+			if (!accessor.isObject()) {
+				throw std::runtime_error("unknown accessor " + std::to_string(index));
+			}
+			if (accessor.contains("sparse")) {
+				throw std::runtime_error("sparse accessors are not supported");
+			}
+
+			const std::optional<size_t> count = getIndex(accessor["count"]);
+			const std::optional<size_t> componentType = getIndex(accessor["componentType"], std::numeric_limits<uint32_t>::max());
+			if (!count || !componentType) {
+				throw std::runtime_error("invalid count or type of accessor " + std::to_string(index));
+			}
+
+			GltfAccessor result{
+				nullptr,
+				*count,
+				0,
+				static_cast<uint32_t>(*componentType),
+				getComponentCount(accessor["type"].getString()),
+				accessor["normalized"].getBool() };
+			const size_t elementSize = getComponentSize(result.componentType) * result.componentCount;
+			if (elementSize == 0) {
+				throw std::runtime_error("invalid type of accessor " + std::to_string(index));
+			}
+
+			// null view without a valid index
+			const JsonValue& views = description["bufferViews"];
+			const JsonValue& view = views[getIndex(accessor["bufferView"], views.size()).value_or(views.size())];
+			const std::optional<size_t> bufferIndex = getIndex(view["buffer"], buffers.size());
+			if (!view.isObject() || !bufferIndex) {
+				throw std::runtime_error("accessor " + std::to_string(index) + " without data");
+			}
+
+			const std::optional<size_t> viewOffset = getIndex(view["byteOffset"], std::numeric_limits<size_t>::max(), 0);
+			const std::optional<size_t> viewLength = getIndex(view["byteLength"], std::numeric_limits<size_t>::max(), 0);
+			const std::optional<size_t> accessorOffset = getIndex(accessor["byteOffset"], std::numeric_limits<size_t>::max(), 0);
+			const std::optional<size_t> stride = getIndex(view["byteStride"], std::numeric_limits<size_t>::max(), elementSize);
+			if (!viewOffset || !viewLength || !accessorOffset || !stride) {
+				throw std::runtime_error("invalid offset, length or stride of accessor " + std::to_string(index));
+			}
+			result.stride = *stride;
+			const span<const std::byte> buffer = buffers[*bufferIndex];
+			if (result.stride < elementSize
+				|| *viewOffset > buffer.size() || *viewLength > buffer.size() - *viewOffset
+				|| (result.count > 0 && (*accessorOffset > *viewLength || elementSize > *viewLength - *accessorOffset
+					|| (result.count - 1) > (*viewLength - *accessorOffset - elementSize) / result.stride))) {
+				throw std::runtime_error("accessor " + std::to_string(index) + " out of its buffer");
+			}
+			result.data = buffer.data() + *viewOffset + *accessorOffset;
+			return result;
+		}
+
+	private:
+		std::string path;
+		std::unique_ptr<MappedFile> file;
+		std::vector<std::unique_ptr<MappedFile>> externalFiles;
+		std::vector<std::vector<std::byte>> embeddedBuffers;
+
+		void loadBuffers(span<const std::byte> binaryChunk) {
+			const std::filesystem::path directory = std::filesystem::path(path).parent_path();
+			for (const JsonValue& buffer : description["buffers"].getElements()) {
+				const std::optional<size_t> length = getIndex(buffer["byteLength"]);
+				if (!length) {
+					fail(path + ": invalid length of buffer " + std::to_string(buffers.size()));
+				}
+				const std::string& uri = buffer["uri"].getString();
+
+				span<const std::byte> data;
+				if (uri.empty()) {
+					data = binaryChunk;
+				}
+				else if (uri.compare(0, 5, "data:") == 0) {
+					const size_t base64 = uri.find(";base64,");
+					if (base64 == std::string::npos) {
+						fail(path + ": embedded buffers must be base64");
+					}
+					embeddedBuffers.push_back(decodeBase64(std::string_view(uri).substr(base64 + 8)));
+					data = embeddedBuffers.back();
+				}
+				else {
+					externalFiles.push_back(std::make_unique<MappedFile>((directory / uri).string()));
+					data = externalFiles.back()->getContent();
+				}
+
+				if (data.size() < *length) {
+					fail(path + ": buffer " + std::to_string(buffers.size()) + " is shorter than its length");
+				}
+				buffers.push_back(data.subspan(0, *length));
+			}
+		}
+	};
+
+	static Mesh decodePrimitive(const GltfDocument& document, const JsonValue& primitive, const ImportSettings& settings) {
+		const JsonValue& attributes = primitive["attributes"];
+		const std::optional<size_t> positionAccessor = getIndex(attributes["POSITION"]);
+		if (!positionAccessor) {
+			throw std::runtime_error("primitive without positions");
+		}
+
+		const GltfAccessor positions = document.getAccessor(*positionAccessor);
+		if (positions.componentType != FLOAT || positions.componentCount != 3) {
+			throw std::runtime_error("positions must be float VEC3");
+		}
+
+		std::vector<Vertex> vertices(positions.count, Vertex{ glm::vec3(0.0f), glm::vec3(1.0f) });
+		for (size_t i = 0; i < positions.count; ++i) {
+			const std::byte* data = positions.data + i * positions.stride;
+			vertices[i].position = glm::vec3(read<float>(data), read<float>(data + 4), read<float>(data + 8));
+		}
+
+		if (attributes.contains("COLOR_0")) {
+			const std::optional<size_t> colorAccessor = getIndex(attributes["COLOR_0"]);
+			if (!colorAccessor) {
+				throw std::runtime_error("invalid accessor of the colors");
+			}
+			const GltfAccessor colors = document.getAccessor(*colorAccessor);
+			if (colors.count != positions.count || colors.componentCount < 3 || colors.componentCount > 4) {
+				throw std::runtime_error("colors must be VEC3 or VEC4, one per position");
+			}
+			const size_t componentSize = getComponentSize(colors.componentType);
+			for (size_t i = 0; i < colors.count; ++i) {
+				const std::byte* data = colors.data + i * colors.stride;
+				for (glm::length_t c = 0; c < 3; ++c) {
+					vertices[i].color[c] = readComponent(data + c * componentSize, colors.componentType, colors.normalized);
+				}
+			}
+		}
+
+		std::vector<uint32_t> indices;
+		if (primitive.contains("indices")) {
+			const std::optional<size_t> indexAccessor = getIndex(primitive["indices"]);
+			if (!indexAccessor) {
+				throw std::runtime_error("invalid accessor of the indices");
+			}
+			const GltfAccessor accessor = document.getAccessor(*indexAccessor);
+			if (accessor.componentCount != 1 || (accessor.componentType != UNSIGNED_BYTE && accessor.componentType != UNSIGNED_SHORT && accessor.componentType != UNSIGNED_INT)) {
+				throw std::runtime_error("indices must be unsigned SCALAR");
+			}
+			indices.resize(accessor.count);
+			for (size_t i = 0; i < accessor.count; ++i) {
+				const std::byte* data = accessor.data + i * accessor.stride;
+				indices[i] = accessor.componentType == UNSIGNED_INT ? read<uint32_t>(data)
+					: accessor.componentType == UNSIGNED_SHORT ? read<uint16_t>(data)
+					: read<uint8_t>(data);
+				if (indices[i] >= vertices.size()) {
+					throw std::runtime_error("index out of the vertices");
+				}
+			}
+		}
+		else {
+			indices.resize(vertices.size());
+			for (uint32_t i = 0; i < indices.size(); ++i) {
+				indices[i] = i;
+			}
+		}
+		if (indices.size() % 3 != 0) {
+			throw std::runtime_error("incomplete triangle");
+		}
+
+		if (settings.weldVertices) {
+			MeshOptimizer::weldVertices(vertices, indices);
+		}
+		return Mesh(std::move(vertices), std::move(indices));
+	}
+
+	// translation, rotation & scale of a node, from its matrix when it has one
+	static void setNodeTransform(TransformHierarchy& transforms, TransformNode node, const JsonValue& description) {
+		glm::vec3 position(0.0f);
+		glm::quat rotation(1.0f, 0.0f, 0.0f, 0.0f);
+		glm::vec3 scale(1.0f);
+
+		const JsonValue& matrix = description["matrix"];
+		if (matrix.size() == 16) {
+			// column major, the shear is dropped
+			glm::mat4 transform;
+			for (glm::length_t i = 0; i < 16; ++i) {
+				transform[i / 4][i % 4] = static_cast<float>(matrix[static_cast<size_t>(i)].getNumber());
+			}
+			position = glm::vec3(transform[3]);
+			scale = glm::vec3(glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2])));
+			if (glm::determinant(glm::mat3(transform)) < 0.0f) {
+				scale.x = -scale.x;
+			}
+			const glm::mat3 axes{ glm::vec3(transform[0]) / scale.x, glm::vec3(transform[1]) / scale.y, glm::vec3(transform[2]) / scale.z };
+			rotation = glm::normalize(glm::quat_cast(axes));
+		}
+		else {
+			const JsonValue& translation = description["translation"];
+			const JsonValue& quaternion = description["rotation"];
+			const JsonValue& scaling = description["scale"];
+			if (translation.size() == 3) {
+				position = glm::vec3(translation[0].getNumber(), translation[1].getNumber(), translation[2].getNumber());
+			}
+			if (quaternion.size() == 4) {
+				// stored x, y, z, w
+				rotation = glm::quat(float(quaternion[3].getNumber()), float(quaternion[0].getNumber()), float(quaternion[1].getNumber()), float(quaternion[2].getNumber()));
+			}
+			if (scaling.size() == 3) {
+				scale = glm::vec3(scaling[0].getNumber(), scaling[1].getNumber(), scaling[2].getNumber());
+			}
+		}
+
+		transforms.setLocalPosition(node, position);
+		transforms.setLocalRotation(node, rotation);
+		transforms.setLocalScale(node, scale);
+	}
+
+	std::vector<std::string> GltfImporter::getBufferFiles(const std::string& path) {
+		const MappedFile file(path);
+		span<const std::byte> binaryChunk;
+		const JsonValue description = parseDescription(path, file.getContent(), binaryChunk);
+
+		const std::filesystem::path directory = std::filesystem::path(path).parent_path();
+		std::vector<std::string> files;
+		for (const JsonValue& buffer : description["buffers"].getElements()) {
+			const std::string& uri = buffer["uri"].getString();
+			if (!uri.empty() && uri.compare(0, 5, "data:") != 0) {
+				files.push_back((directory / uri).string());
+			}
+		}
+		return files;
+	}
+
+	// the triangle primitives of each mesh, decoded in parallel; the primitives of mesh m are in [firstPrimitives[m], firstPrimitives[m + 1])
+	static std::vector<Mesh> decodeMeshes(const GltfDocument& document, const std::string& path, JobSystem& jobs, const ImportSettings& settings, std::vector<size_t>& firstPrimitives) {
+		std::vector<GltfPrimitive> primitives;
+		firstPrimitives.clear();
+		for (const JsonValue& mesh : document.description["meshes"].getElements()) {
+			firstPrimitives.push_back(primitives.size());
+			for (const JsonValue& primitive : mesh["primitives"].getElements()) {
+				if (getIndex(primitive["mode"], std::numeric_limits<size_t>::max(), gltfTriangles) == gltfTriangles) {
+					primitives.push_back(GltfPrimitive{ &primitive, std::nullopt, {} });
+				}
+				else {
+					Logger::warn(logTag, path + ": primitive of mode " + std::to_string(primitive["mode"].getNumber()) + " ignored");
+				}
+			}
+		}
+		firstPrimitives.push_back(primitives.size());
+
+		jobs.parallelFor(primitives.size(), 1, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				try {
+					primitives[i].mesh = decodePrimitive(document, *primitives[i].description, settings);
+				}
+				catch (const std::exception& e) {
+					primitives[i].error = e.what();
+				}
+			}
+		});
+
+		std::vector<Mesh> meshes;
+		meshes.reserve(primitives.size());
+		for (size_t i = 0; i < primitives.size(); ++i) {
+			if (!primitives[i].error.empty()) {
+				fail(path + ": primitive " + std::to_string(i) + ": " + primitives[i].error);
+			}
+			meshes.push_back(std::move(*primitives[i].mesh));
+		}
+		return meshes;
+	}
+
+	std::vector<Mesh> GltfImporter::importMeshes(const std::string& path, JobSystem& jobs, const ImportSettings& settings) {
+		const GltfDocument document(path);
+		std::vector<size_t> firstPrimitives;
+		return decodeMeshes(document, path, jobs, settings, firstPrimitives);
+	}
+
+	std::vector<Entity> GltfImporter::import(const std::string& path, Scene& scene, JobSystem& jobs, const ImportSettings& settings) {
+		const GltfDocument document(path);
+		const JsonValue& description = document.description;
+		const std::vector<JsonValue>& meshDescriptions = description["meshes"].getElements();
+		std::vector<size_t> firstPrimitives;
+		std::vector<Mesh> meshes = decodeMeshes(document, path, jobs, settings, firstPrimitives);
+
+		std::vector<uint32_t> sceneMeshes;
+		sceneMeshes.reserve(meshes.size());
+		for (Mesh& mesh : meshes) {
+			sceneMeshes.push_back(scene.addMesh(std::move(mesh)));
+		}
+
+		// roots of the default scene, or the nodes nobody references without scene
+		const std::vector<JsonValue>& nodes = description["nodes"].getElements();
+		std::vector<size_t> roots;
+		const std::optional<size_t> sceneIndex = getIndex(description["scene"], std::numeric_limits<size_t>::max(), 0);
+		if (!sceneIndex) {
+			fail(path + ": invalid default scene");
+		}
+		const JsonValue& defaultScene = description["scenes"][*sceneIndex];
+		if (defaultScene.isObject()) {
+			for (const JsonValue& root : defaultScene["nodes"].getElements()) {
+				const std::optional<size_t> index = getIndex(root, nodes.size());
+				if (!index) {
+					fail(path + ": invalid root node of the default scene");
+				}
+				roots.push_back(*index);
+			}
+		}
+		else {
+			std::vector<bool> isChild(nodes.size(), false);
+			for (const JsonValue& node : nodes) {
+				for (const JsonValue& child : node["children"].getElements()) {
+					// the invalid children fail when their parent is visited
+					const std::optional<size_t> index = getIndex(child, nodes.size());
+					if (index) {
+						isChild[*index] = true;
+					}
+				}
+			}
+			for (size_t i = 0; i < nodes.size(); ++i) {
+				if (!isChild[i]) {
+					roots.push_back(i);
+				}
+			}
+		}
+
+		// depth first, a node is visited once: the hierarchy must be a forest
+		std::vector<Entity> entities;
+		std::vector<bool> visited(nodes.size(), false);
+		std::vector<std::pair<size_t, TransformNode>> pending;
+		for (auto root = roots.rbegin(); root != roots.rend(); ++root) {
+			pending.emplace_back(*root, TransformNode{});
+		}
+		while (!pending.empty()) {
+			const auto [index, parent] = pending.back();
+			pending.pop_back();
+			if (index >= nodes.size() || visited[index]) {
+				fail(path + ": invalid node " + std::to_string(index));
+			}
+			visited[index] = true;
+
+			const JsonValue& node = nodes[index];
+			const TransformNode transformNode = scene.getTransforms().create(parent);
+			setNodeTransform(scene.getTransforms(), transformNode, node);
+
+			if (node.contains("mesh")) {
+				const std::optional<size_t> mesh = getIndex(node["mesh"], meshDescriptions.size());
+				if (!mesh) {
+					fail(path + ": unknown mesh of node " + std::to_string(index));
+				}
+				for (size_t primitive = firstPrimitives[*mesh]; primitive < firstPrimitives[*mesh + 1]; ++primitive) {
+					entities.push_back(scene.createEntity(sceneMeshes[primitive], transformNode));
+				}
+			}
+
+			const std::vector<JsonValue>& children = node["children"].getElements();
+			for (auto child = children.rbegin(); child != children.rend(); ++child) {
+				const std::optional<size_t> childIndex = getIndex(*child, nodes.size());
+				if (!childIndex) {
+					fail(path + ": invalid child of node " + std::to_string(index));
+				}
+				pending.emplace_back(*childIndex, transformNode);
+			}
+		}
+
+		Logger::info(logTag, "Imported " + path + ", " + std::to_string(sceneMeshes.size()) + " meshes, " + std::to_string(entities.size()) + " entities");
+		return entities;
+	}
+
+}
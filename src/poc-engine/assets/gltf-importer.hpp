@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "../core/job-system.hpp"
+#include "../core/scene.hpp"
+#include "import-settings.hpp"
+
+namespace poc {
+
+	/*
+	 * glTF 2.0 importer, .gltf with external or embedded (base64) buffers and binary .glb files.
+	 *
+	 * The JSON description is parsed, the buffers are mapped or decoded, then the triangle primitives are
+	 * decoded in parallel: the positions, the colors (COLOR_0, float or normalized integers) and the
+	 * indices of any component type. Each primitive becomes a mesh of the scene. The nodes of the default
+	 * scene become transform nodes of the scene hierarchy, with an entity per primitive of their mesh.
+	 * Materials, textures, skins, morph targets & animations are ignored.
+	 */
+	namespace GltfImporter {
+
+		// throws when a file cannot be read or the description is invalid, returns the created entities
+		std::vector<Entity> import(const std::string& path, Scene& scene, JobSystem& jobs, const ImportSettings& settings = {});
+
+		// the meshes only, one per triangle primitive in the order of the description
+		std::vector<Mesh> importMeshes(const std::string& path, JobSystem& jobs, const ImportSettings& settings = {});
+
+		// external buffer files read by import(), e.g. to track the changes of the whole asset
+		std::vector<std::string> getBufferFiles(const std::string& path);
+
+	}
+
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+namespace poc {
+
+	struct ImportSettings {
+		// merge the bitwise identical vertices, e.g. the ones only split by the dropped normals or texture coordinates
+		bool weldVertices{ true };
+	};
+
+}
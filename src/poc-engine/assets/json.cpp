@@ -0,0 +1,277 @@
+#include "json.hpp"
+
+#include <stdexcept>
+
+#include "../core/logger.hpp"
+#include "text-parsing.hpp"
+
+using namespace poc;
+
+namespace poc {
+
+	static constexpr char logTag[]{ "POC::Json" };
+
+	// recursive descent, the depth is bounded to keep the stack of malformed documents small
+	class JsonParser {
+	public:
+
+		static constexpr size_t maxDepth = 256;
+
+		explicit JsonParser(std::string_view t) :
+			text(t) {}
+
+		JsonValue parseDocument() {
+			JsonValue value = parseValue(0);
+			skipSpaces();
+			if (position != text.size()) {
+				fail("unexpected character after the document");
+			}
+			return value;
+		}
+
+	private:
+		std::string_view text;
+		size_t position{ 0 };
+
+		[[noreturn]] void fail(const std::string& message) const {
+			const std::string error = "JSON " + message + " at offset " + std::to_string(position);
+			Logger::error(logTag, error);
+			throw std::runtime_error(error);
+		}
+
+		void skipSpaces() {
+			while (position < text.size() && (text[position] == ' ' || text[position] == '\t' || text[position] == '\n' || text[position] == '\r')) {
+				++position;
+			}
+		}
+
+		bool consume(char c) {
+			skipSpaces();
+			if (position < text.size() && text[position] == c) {
+				++position;
+				return true;
+			}
+			return false;
+		}
+
+		void expect(char c) {
+			if (!consume(c)) {
+				fail(std::string("expected '") + c + "'");
+			}
+		}
+
+		bool consumeWord(std::string_view word) {
+			if (text.substr(position, word.size()) == word) {
+				position += word.size();
+				return true;
+			}
+			return false;
+		}
+
+		JsonValue parseValue(size_t depth) {
+			if (depth > maxDepth) {
+				fail("too deeply nested");
+			}
+
+			skipSpaces();
+			if (position == text.size()) {
+				fail("unexpected end");
+			}
+
+			JsonValue value;
+			const char c = text[position];
+			if (c == '{') {
+				++position;
+				value.type = JsonValue::Type::OBJECT;
+				if (!consume('}')) {
+					do {
+						skipSpaces();
+						value.keys.push_back(parseString());
+						expect(':');
+						value.elements.push_back(parseValue(depth + 1));
+					} while (consume(','));
+					expect('}');
+				}
+			}
+			else if (c == '[') {
+				++position;
+				value.type = JsonValue::Type::ARRAY;
+				if (!consume(']')) {
+					do {
+						value.elements.push_back(parseValue(depth + 1));
+					} while (consume(','));
+					expect(']');
+				}
+			}
+			else if (c == '"') {
+				value.type = JsonValue::Type::STRING;
+				value.string = parseString();
+			}
+			else if (consumeWord("true") || consumeWord("false")) {
+				value.type = JsonValue::Type::BOOLEAN;
+				value.boolean = c == 't';
+			}
+			else if (consumeWord("null")) {
+				value.type = JsonValue::Type::NULL_VALUE;
+			}
+			else {
+				const char* first = text.data() + position;
+				const char* last = TextParsing::parseDouble(first, text.data() + text.size(), value.number);
+				if (!last || !isNumber(first, last)) {
+					fail("unexpected character");
+				}
+				value.type = JsonValue::Type::NUMBER;
+				position += static_cast<size_t>(last - first);
+			}
+			return value;
+		}
+
+		// stricter than the number parser: no sign +, no leading zero, digits on both sides of the point
+		static bool isNumber(const char* first, const char* last) {
+			const auto skipDigits = [last](const char* cursor) {
+				while (cursor != last && TextParsing::isDigit(*cursor)) {
+					++cursor;
+				}
+				return cursor;
+			};
+
+			const char* cursor = first != last && *first == '-' ? first + 1 : first;
+			if (cursor == last || !TextParsing::isDigit(*cursor) || (*cursor == '0' && cursor + 1 != last && TextParsing::isDigit(cursor[1]))) {
+				return false;
+			}
+			cursor = skipDigits(cursor);
+			if (cursor != last && *cursor == '.') {
+				if (cursor + 1 == last || !TextParsing::isDigit(cursor[1])) {
+					return false;
+				}
+				cursor = skipDigits(cursor + 1);
+			}
+			if (cursor != last && (*cursor == 'e' || *cursor == 'E')) {
+				++cursor;
+				cursor = cursor != last && (*cursor == '+' || *cursor == '-') ? cursor + 1 : cursor;
+				if (cursor == last || !TextParsing::isDigit(*cursor)) {
+					return false;
+				}
+				cursor = skipDigits(cursor);
+			}
+			return cursor == last;
+		}
+
+		uint32_t parseHex4() {
+			if (position + 4 > text.size()) {
+				fail("truncated escape");
+			}
+			uint32_t code = 0;
+			for (size_t i = 0; i < 4; ++i) {
+				const char c = text[position++];
+				const uint32_t digit = c >= '0' && c <= '9' ? uint32_t(c - '0')
+					: c >= 'a' && c <= 'f' ? uint32_t(c - 'a' + 10)
+					: c >= 'A' && c <= 'F' ? uint32_t(c - 'A' + 10)
+					: 16;
+				if (digit == 16) {
+					fail("invalid escape");
+				}
+				code = code * 16 + digit;
+			}
+			return code;
+		}
+
+		static void appendUtf8(std::string& output, uint32_t code) {
+			if (code < 0x80) {
+				output += static_cast<char>(code);
+			}
+			else if (code < 0x800) {
+				output += static_cast<char>(0xC0 | (code >> 6));
+				output += static_cast<char>(0x80 | (code & 0x3F));
+			}
+			else if (code < 0x10000) {
+				output += static_cast<char>(0xE0 | (code >> 12));
+				output += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+				output += static_cast<char>(0x80 | (code & 0x3F));
+			}
+			else {
+				output += static_cast<char>(0xF0 | (code >> 18));
+				output += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+				output += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+				output += static_cast<char>(0x80 | (code & 0x3F));
+			}
+		}
+
+		std::string parseString() {
+			if (position == text.size() || text[position] != '"') {
+				fail("expected a string");
+			}
+			++position;
+
+			std::string result;
+			while (true) {
+				if (position == text.size()) {
+					fail("unterminated string");
+				}
+				const char c = text[position++];
+				if (c == '"') {
+					return result;
+				}
+				if (c != '\\') {
+					result += c;
+					continue;
+				}
+
+				if (position == text.size()) {
+					fail("unterminated string");
+				}
+				const char escape = text[position++];
+				switch (escape) {
+				case '"': result += '"'; break;
+				case '\\': result += '\\'; break;
+				case '/': result += '/'; break;
+				case 'b': result += '\b'; break;
+				case 'f': result += '\f'; break;
+				case 'n': result += '\n'; break;
+				case 'r': result += '\r'; break;
+				case 't': result += '\t'; break;
+				case 'u': {
+					uint32_t code = parseHex4();
+					// surrogate pair
+					if (code >= 0xD800 && code < 0xDC00 && consumeWord("\\u")) {
+						const uint32_t low = parseHex4();
+						code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+					}
+					appendUtf8(result, code);
+					break;
+				}
+				default:
+					fail("invalid escape");
+				}
+			}
+		}
+	};
+
+	JsonValue JsonValue::parse(std::string_view text) {
+		return JsonParser(text).parseDocument();
+	}
+
+	const JsonValue& JsonValue::operator[](std::string_view key) const {
+		for (size_t i = 0; i < keys.size(); ++i) {
+			if (keys[i] == key) {
+				return elements[i];
+			}
+		}
+		return getNull();
+	}
+
+	bool JsonValue::contains(std::string_view key) const {
+		for (const std::string& member : keys) {
+			if (member == key) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	const JsonValue& JsonValue::getNull() {
+		static const JsonValue null;
+		return null;
+	}
+
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace poc {
+
+	/*
+	 * Minimal JSON document, enough for the asset descriptions such as glTF.
+	 *
+	 * The whole text is parsed into a tree of values, the object members keep their order. The numbers are
+	 * doubles, the strings are unescaped to UTF-8. The accessors of the wrong type return a default value:
+	 * the callers check the types they require.
+	 */
+	class JsonValue {
+	public:
+
+		enum class Type {
+			NULL_VALUE,
+			BOOLEAN,
+			NUMBER,
+			STRING,
+			ARRAY,
+			OBJECT
+		};
+
+		// throws on a syntax error, with its offset in the text
+		static JsonValue parse(std::string_view text);
+
+		Type getType() const {
+			return type;
+		}
+
+		bool isNumber() const {
+			return type == Type::NUMBER;
+		}
+
+		bool isString() const {
+			return type == Type::STRING;
+		}
+
+		bool isArray() const {
+			return type == Type::ARRAY;
+		}
+
+		bool isObject() const {
+			return type == Type::OBJECT;
+		}
+
+		bool getBool(bool defaultValue = false) const {
+			return type == Type::BOOLEAN ? boolean : defaultValue;
+		}
+
+		double getNumber(double defaultValue = 0.0) const {
+			return type == Type::NUMBER ? number : defaultValue;
+		}
+
+		const std::string& getString() const {
+			return string;
+		}
+
+		// elements of an array, values of an object
+		const std::vector<JsonValue>& getElements() const {
+			return elements;
+		}
+
+		size_t size() const {
+			return elements.size();
+		}
+
+		const JsonValue& operator[](size_t index) const {
+			return index < elements.size() ? elements[index] : getNull();
+		}
+
+		// member of an object, null when there is none
+		const JsonValue& operator[](std::string_view key) const;
+
+		bool contains(std::string_view key) const;
+
+	private:
+		Type type{ Type::NULL_VALUE };
+		bool boolean{ false };
+		double number{ 0.0 };
+		std::string string;
+		std::vector<JsonValue> elements;
+		// keys of the object members, in the order of the elements
+		std::vector<std::string> keys;
+
+		static const JsonValue& getNull();
+
+		friend class JsonParser;
+	};
+
+}
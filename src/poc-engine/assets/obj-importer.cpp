@@ -0,0 +1,211 @@
+#include "obj-importer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "../core/logger.hpp"
+#include "../plateform/mapped-file.hpp"
+#include "../rendering/mesh-optimizer.hpp"
+#include "text-parsing.hpp"
+
+using namespace poc;
+
+namespace poc {
+
+	static constexpr char logTag[]{ "POC::ObjImporter" };
+
+	// vertex index of a triangle corner, relative ones count from the vertices of the chunk
+	struct ObjCorner {
+		int64_t index;
+		bool relative;
+	};
+
+	struct ObjChunk {
+		const char* begin;
+		const char* end;
+		std::vector<Vertex> vertices;
+		std::vector<ObjCorner> corners;
+		size_t lineCount{ 0 };
+		// first error, its line in the chunk
+		std::string error;
+		size_t errorLine{ 0 };
+	};
+
+	static bool isStatement(const char* cursor, const char* lineEnd, char statement) {
+		return cursor[0] == statement && cursor + 1 != lineEnd && (cursor[1] == ' ' || cursor[1] == '\t');
+	}
+
+	// v x y z [w] [r g b]
+	static bool parseVertex(const char* cursor, const char* lineEnd, ObjChunk& chunk) {
+		std::array<float, 7> values{};
+		size_t count = 0;
+		for (cursor = TextParsing::skipSpaces(cursor + 1, lineEnd); cursor != lineEnd; cursor = TextParsing::skipSpaces(cursor, lineEnd)) {
+			if (count == values.size()) {
+				return false;
+			}
+			cursor = TextParsing::parseFloat(cursor, lineEnd, values[count++]);
+			if (!cursor) {
+				return false;
+			}
+		}
+
+		if (count < 3 || count == 5) {
+			return false;
+		}
+		const glm::vec3 position(values[0], values[1], values[2]);
+		const size_t colorIndex = count == 7 ? 4 : 3;
+		const glm::vec3 color = count >= 6 ? glm::vec3(values[colorIndex], values[colorIndex + 1], values[colorIndex + 2]) : glm::vec3(1.0f);
+		chunk.vertices.push_back(Vertex{ position, color });
+		return true;
+	}
+
+	// f v[/vt][/vn] ... with at least 3 corners
+	static bool parseFace(const char* cursor, const char* lineEnd, ObjChunk& chunk) {
+		size_t cornerCount = 0;
+		ObjCorner first{};
+		ObjCorner previous{};
+		for (cursor = TextParsing::skipSpaces(cursor + 1, lineEnd); cursor != lineEnd; cursor = TextParsing::skipSpaces(cursor, lineEnd)) {
+			int64_t index = 0;
+			cursor = TextParsing::parseInt(cursor, lineEnd, index);
+			if (!cursor || index == 0) {
+				return false;
+			}
+			// the texture coordinate & normal indices are skipped
+			while (cursor != lineEnd && *cursor != ' ' && *cursor != '\t' && *cursor != '\r') {
+				++cursor;
+			}
+
+			const ObjCorner corner = index > 0
+				? ObjCorner{ index - 1, false }
+				: ObjCorner{ static_cast<int64_t>(chunk.vertices.size()) + index, true };
+			if (cornerCount == 0) {
+				first = corner;
+			}
+			else if (cornerCount >= 2) {
+				chunk.corners.insert(chunk.corners.end(), { first, previous, corner });
+			}
+			previous = corner;
+			++cornerCount;
+		}
+		return cornerCount >= 3;
+	}
+
+	static void parseChunk(ObjChunk& chunk) {
+		const char* cursor = chunk.begin;
+		while (cursor < chunk.end) {
+			const char* lineEnd = static_cast<const char*>(std::memchr(cursor, '\n', static_cast<size_t>(chunk.end - cursor)));
+			lineEnd = lineEnd ? lineEnd : chunk.end;
+			++chunk.lineCount;
+
+			// the other statements are ignored
+			const char* statement = TextParsing::skipSpaces(cursor, lineEnd);
+			bool valid = true;
+			if (statement != lineEnd) {
+				if (isStatement(statement, lineEnd, 'v')) {
+					valid = parseVertex(statement, lineEnd, chunk);
+				}
+				else if (isStatement(statement, lineEnd, 'f')) {
+					valid = parseFace(statement, lineEnd, chunk);
+				}
+			}
+
+			if (!valid) {
+				chunk.error = "Malformed statement: " + std::string(statement, lineEnd);
+				chunk.errorLine = chunk.lineCount;
+				return;
+			}
+			cursor = lineEnd + 1;
+		}
+	}
+
+	// chunks ending at line ends, at least minChunkSize long except the last one
+	static std::vector<ObjChunk> splitChunks(span<const char> text, uint32_t threadCount) {
+		const size_t chunkSize = std::max(ObjImporter::minChunkSize, text.size() / (size_t(threadCount) * 4) + 1);
+		std::vector<ObjChunk> chunks;
+		const char* begin = text.data();
+		const char* last = text.data() + text.size();
+		while (begin != last) {
+			const char* end = last;
+			if (static_cast<size_t>(last - begin) > chunkSize) {
+				const char* lineEnd = static_cast<const char*>(std::memchr(begin + chunkSize, '\n', static_cast<size_t>(last - begin - chunkSize)));
+				end = lineEnd ? lineEnd + 1 : last;
+			}
+			chunks.push_back(ObjChunk{ begin, end, {}, {}, 0, {}, 0 });
+			begin = end;
+		}
+		return chunks;
+	}
+
+	[[noreturn]] static void fail(const std::string& message) {
+		Logger::error(logTag, message);
+		throw std::runtime_error(message);
+	}
+
+	// the source names the text in the errors
+	static Mesh parseText(span<const char> text, JobSystem& jobs, const ImportSettings& settings, const std::string& source) {
+		std::vector<ObjChunk> chunks = splitChunks(text, jobs.getThreadCount());
+		jobs.parallelFor(chunks.size(), 1, [&chunks](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				parseChunk(chunks[i]);
+			}
+		});
+
+		// offsets of the chunks in the mesh
+		std::vector<size_t> vertexOffsets(chunks.size() + 1, 0);
+		std::vector<size_t> cornerOffsets(chunks.size() + 1, 0);
+		size_t lineOffset = 0;
+		for (size_t i = 0; i < chunks.size(); ++i) {
+			if (!chunks[i].error.empty()) {
+				fail(source + ", line " + std::to_string(lineOffset + chunks[i].errorLine) + ": " + chunks[i].error);
+			}
+			vertexOffsets[i + 1] = vertexOffsets[i] + chunks[i].vertices.size();
+			cornerOffsets[i + 1] = cornerOffsets[i] + chunks[i].corners.size();
+			lineOffset += chunks[i].lineCount;
+		}
+
+		const size_t vertexCount = vertexOffsets.back();
+		std::vector<Vertex> vertices(vertexCount);
+		std::vector<uint32_t> indices(cornerOffsets.back());
+		std::vector<uint8_t> invalidChunks(chunks.size(), 0);
+		jobs.parallelFor(chunks.size(), 1, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				const ObjChunk& chunk = chunks[i];
+				std::copy(chunk.vertices.begin(), chunk.vertices.end(), vertices.begin() + static_cast<std::ptrdiff_t>(vertexOffsets[i]));
+
+				uint32_t* chunkIndices = indices.data() + cornerOffsets[i];
+				const int64_t chunkOffset = static_cast<int64_t>(vertexOffsets[i]);
+				for (size_t c = 0; c < chunk.corners.size(); ++c) {
+					const ObjCorner& corner = chunk.corners[c];
+					const int64_t index = corner.relative ? chunkOffset + corner.index : corner.index;
+					invalidChunks[i] |= index < 0 || index >= static_cast<int64_t>(vertexCount) ? 1 : 0;
+					chunkIndices[c] = static_cast<uint32_t>(index);
+				}
+			}
+		});
+		if (std::find(invalidChunks.begin(), invalidChunks.end(), 1) != invalidChunks.end()) {
+			fail(source + ": face index out of the " + std::to_string(vertexCount) + " vertices");
+		}
+
+		if (settings.weldVertices) {
+			MeshOptimizer::weldVertices(vertices, indices);
+		}
+
+		Logger::info(logTag, "Parsed " + source + ", " + std::to_string(text.size() / 1024) + " KB in " + std::to_string(chunks.size()) + " chunks, "
+			+ std::to_string(vertices.size()) + " vertices (" + std::to_string(vertexCount) + " read), " + std::to_string(indices.size() / 3) + " triangles");
+		return Mesh(std::move(vertices), std::move(indices));
+	}
+
+	Mesh ObjImporter::import(const std::string& path, JobSystem& jobs, const ImportSettings& settings) {
+		const MappedFile file(path);
+		const span<const std::byte> content = file.getContent();
+		return parseText(span<const char>(reinterpret_cast<const char*>(content.data()), content.size()), jobs, settings, path);
+	}
+
+	Mesh ObjImporter::parse(span<const char> text, JobSystem& jobs, const ImportSettings& settings) {
+		return parseText(text, jobs, settings, "OBJ text");
+	}
+
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "../core/job-system.hpp"
+#include "../core/span.hpp"
+#include "../rendering/mesh.hpp"
+#include "import-settings.hpp"
+
+namespace poc {
+
+	/*
+	 * Wavefront OBJ importer.
+	 *
+	 * The file is mapped and split in chunks at line boundaries, parsed in parallel into the positions &
+	 * the triangle corners of each chunk. The chunks are then concatenated in parallel at their offsets,
+	 * the relative (negative) indices resolved with the vertices of the previous chunks. The positions,
+	 * their optional colors (x y z [w] r g b) and the faces are read, the polygons are triangulated as fans.
+	 * Texture coordinates, normals, groups & materials are ignored: the objects are merged in one mesh.
+	 */
+	namespace ObjImporter {
+
+		// text parsed by a job at least, the large files get a few chunks per thread
+		inline constexpr size_t minChunkSize = 256 * 1024;
+
+		// throws when the file cannot be read or a statement is malformed
+		Mesh import(const std::string& path, JobSystem& jobs, const ImportSettings& settings = {});
+
+		Mesh parse(span<const char> text, JobSystem& jobs, const ImportSettings& settings = {});
+
+	}
+
+}
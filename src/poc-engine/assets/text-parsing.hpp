@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace poc {
+
+	/*
+	 * Parsing of numbers in text assets, without locale nor allocation.
+	 *
+	 * The functions read a number at the start of [first, last) and return the character following it,
+	 * nullptr when there is no number. The decimal numbers whose significant digits make a mantissa of at
+	 * most 2^53 (15 digits always fit) with an exponent within [-22, 22], i.e. the usual ones, are correctly
+	 * rounded: the mantissa & the power of 10 are both exact doubles and their product or quotient is
+	 * correctly rounded. The others are scaled by std::pow, within a few ulps of the nearest double.
+	 */
+	namespace TextParsing {
+
+		inline bool isDigit(char c) {
+			return static_cast<unsigned char>(c - '0') < 10;
+		}
+
+		inline const char* skipSpaces(const char* first, const char* last) {
+			while (first != last && (*first == ' ' || *first == '\t' || *first == '\r')) {
+				++first;
+			}
+			return first;
+		}
+
+		// [+-]digits[.digits][(e|E)[+-]digits], a side of the point may be empty
+		inline const char* parseDouble(const char* first, const char* last, double& value) {
+			static constexpr std::array<double, 23> powersOf10{
+				1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+				1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+			const char* cursor = first;
+			const bool negative = cursor != last && *cursor == '-';
+			if (cursor != last && (*cursor == '-' || *cursor == '+')) {
+				++cursor;
+			}
+
+			// significant digits in the mantissa, the dropped ones only scale it
+			uint64_t mantissa = 0;
+			uint32_t significantDigits = 0;
+			int32_t exponent = 0;
+			bool hasDigits = false;
+			for (; cursor != last && isDigit(*cursor); ++cursor) {
+				hasDigits = true;
+				if (significantDigits < 19) {
+					mantissa = mantissa * 10 + static_cast<uint64_t>(*cursor - '0');
+					significantDigits += mantissa != 0 ? 1 : 0;
+				}
+				else {
+					++exponent;
+				}
+			}
+			if (cursor != last && *cursor == '.') {
+				++cursor;
+				for (; cursor != last && isDigit(*cursor); ++cursor) {
+					hasDigits = true;
+					if (significantDigits < 19) {
+						mantissa = mantissa * 10 + static_cast<uint64_t>(*cursor - '0');
+						significantDigits += mantissa != 0 ? 1 : 0;
+						--exponent;
+					}
+				}
+			}
+			if (!hasDigits) {
+				return nullptr;
+			}
+
+			if (cursor != last && (*cursor == 'e' || *cursor == 'E')) {
+				const char* exponentCursor = cursor + 1;
+				const bool negativeExponent = exponentCursor != last && *exponentCursor == '-';
+				if (exponentCursor != last && (*exponentCursor == '-' || *exponentCursor == '+')) {
+					++exponentCursor;
+				}
+				if (exponentCursor != last && isDigit(*exponentCursor)) {
+					int32_t explicitExponent = 0;
+					for (; exponentCursor != last && isDigit(*exponentCursor); ++exponentCursor) {
+						// saturated, far out of the range of a double anyway
+						explicitExponent = explicitExponent < 100000 ? explicitExponent * 10 + (*exponentCursor - '0') : explicitExponent;
+					}
+					exponent += negativeExponent ? -explicitExponent : explicitExponent;
+					cursor = exponentCursor;
+				}
+			}
+
+			double result = static_cast<double>(mantissa);
+			if (mantissa == 0) {
+				result = 0.0;
+			}
+			else if (mantissa <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22) {
+				result = exponent < 0 ? result / powersOf10[-exponent] : result * powersOf10[exponent];
+			}
+			else {
+				result *= std::pow(10.0, static_cast<double>(exponent));
+			}
+			value = negative ? -result : result;
+			return cursor;
+		}
+
+		inline const char* parseFloat(const char* first, const char* last, float& value) {
+			double result = 0.0;
+			const char* cursor = parseDouble(first, last, result);
+			value = static_cast<float>(result);
+			return cursor;
+		}
+
+		// [+-]digits
+		inline const char* parseInt(const char* first, const char* last, int64_t& value) {
+			const char* cursor = first;
+			const bool negative = cursor != last && *cursor == '-';
+			if (cursor != last && (*cursor == '-' || *cursor == '+')) {
+				++cursor;
+			}
+			if (cursor == last || !isDigit(*cursor)) {
+				return nullptr;
+			}
+
+			int64_t result = 0;
+			for (; cursor != last && isDigit(*cursor); ++cursor) {
+				// saturated, far out of the range of the indices anyway
+				result = result < (int64_t(1) << 56) ? result * 10 + (*cursor - '0') : result;
+			}
+			value = negative ? -result : result;
+			return cursor;
+		}
+
+	}
+
+}
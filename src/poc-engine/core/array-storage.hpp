@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "span.hpp"
+
+namespace poc {
+
+	/*
+	 * Elements owned in a vector or viewed in external storage, e.g. a mapped file.
+	 *
+	 * The external elements are never copied implicitly: the storage must outlive the array and its
+	 * copies. Getting the vector of an external array copies its elements once, to modify them.
+	 */
+	template<class T>
+	class ArrayStorage {
+	public:
+
+		ArrayStorage() = default;
+
+		ArrayStorage(std::vector<T>&& elements) :
+			owned(std::move(elements)) {}
+
+		explicit ArrayStorage(span<const T> elements) :
+			view(elements),
+			external(true) {}
+
+		const T* data() const {
+			return external ? view.data() : owned.data();
+		}
+
+		size_t size() const {
+			return external ? view.size() : owned.size();
+		}
+
+		bool empty() const {
+			return size() == 0;
+		}
+
+		const T* begin() const {
+			return data();
+		}
+
+		const T* end() const {
+			return data() + size();
+		}
+
+		const T& operator[](size_t index) const {
+			assert(index < size() && "array index out of range");
+			return data()[index];
+		}
+
+		bool isExternal() const {
+			return external;
+		}
+
+		// the owned elements, the external ones are copied first
+		std::vector<T>& getVector() {
+			if (external) {
+				owned.assign(view.begin(), view.end());
+				view = span<const T>();
+				external = false;
+			}
+			return owned;
+		}
+
+	private:
+		std::vector<T> owned;
+		span<const T> view;
+		bool external{ false };
+	};
+
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "../plateform/platform.hpp"
+
+namespace poc {
+
+	// axis aligned bounding box, empty until a point is added
+	struct Aabb {
+		glm::vec3 min{ std::numeric_limits<float>::max() };
+		glm::vec3 max{ std::numeric_limits<float>::lowest() };
+
+		bool isEmpty() const {
+			return min.x > max.x;
+		}
+
+		glm::vec3 getCenter() const {
+			return (min + max) * 0.5f;
+		}
+
+		glm::vec3 getExtent() const {
+			return (max - min) * 0.5f;
+		}
+
+		void expand(const glm::vec3& point) {
+			min = glm::min(min, point);
+			max = glm::max(max, point);
+		}
+
+		void expand(const Aabb& other) {
+			min = glm::min(min, other.min);
+			max = glm::max(max, other.max);
+		}
+
+		// 0 when empty, used by the surface area heuristic
+		float getSurfaceArea() const {
+			if (isEmpty()) {
+				return 0.0f;
+			}
+			const glm::vec3 size = max - min;
+			return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+		}
+
+		bool overlaps(const Aabb& other) const {
+			return glm::all(glm::lessThanEqual(min, other.max)) && glm::all(glm::lessThanEqual(other.min, max));
+		}
+	};
+
+	struct BoundingSphere {
+		glm::vec3 center{ 0.0f };
+		float radius{ 0.0f };
+	};
+
+	// largest scale of the axes of an affine matrix
+	inline float getMaxScale(const glm::mat4& matrix) {
+		return std::sqrt(std::max({
+			glm::dot(glm::vec3(matrix[0]), glm::vec3(matrix[0])),
+			glm::dot(glm::vec3(matrix[1]), glm::vec3(matrix[1])),
+			glm::dot(glm::vec3(matrix[2]), glm::vec3(matrix[2])) }));
+	}
+
+	// sphere enclosing the transformed sphere, non uniform scales use the largest axis
+	inline BoundingSphere transformSphere(const BoundingSphere& sphere, const glm::mat4& matrix) {
+		return BoundingSphere{ glm::vec3(matrix * glm::vec4(sphere.center, 1.0f)), sphere.radius * getMaxScale(matrix) };
+	}
+
+	// box enclosing the transformed box
+	inline Aabb transformAabb(const Aabb& aabb, const glm::mat4& matrix) {
+		if (aabb.isEmpty()) {
+			return aabb;
+		}
+		const glm::vec3 center = glm::vec3(matrix * glm::vec4(aabb.getCenter(), 1.0f));
+		const glm::vec3 extent = aabb.getExtent();
+		const glm::vec3 worldExtent =
+			glm::abs(glm::vec3(matrix[0])) * extent.x +
+			glm::abs(glm::vec3(matrix[1])) * extent.y +
+			glm::abs(glm::vec3(matrix[2])) * extent.z;
+		return Aabb{ center - worldExtent, center + worldExtent };
+	}
+
+	struct Ray {
+		glm::vec3 origin{ 0.0f };
+		glm::vec3 direction{ 0.0f, 0.0f, -1.0f };
+	};
+
+}
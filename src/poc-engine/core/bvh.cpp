@@ -0,0 +1,580 @@
+#include "bvh.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+#include "simd.hpp"
+
+using namespace poc;
+
+namespace poc {
+
+	// candidate split planes per axis of the binned SAH
+	static constexpr uint32_t binCount = 16;
+
+	static Aabb getBounds(const BvhNode& node, uint32_t slot) {
+		return Aabb{
+			glm::vec3(node.minX[slot], node.minY[slot], node.minZ[slot]),
+			glm::vec3(node.maxX[slot], node.maxY[slot], node.maxZ[slot])
+		};
+	}
+
+	static void setBounds(BvhNode& node, uint32_t slot, const Aabb& aabb) {
+		node.minX[slot] = aabb.min.x;
+		node.minY[slot] = aabb.min.y;
+		node.minZ[slot] = aabb.min.z;
+		node.maxX[slot] = aabb.max.x;
+		node.maxY[slot] = aabb.max.y;
+		node.maxZ[slot] = aabb.max.z;
+	}
+
+	static bool intersectRay(const glm::vec3& origin, const glm::vec3& inverseDirection, const Aabb& aabb, float maxDistance, float& distance) {
+		const glm::vec3 t1 = (aabb.min - origin) * inverseDirection;
+		const glm::vec3 t2 = (aabb.max - origin) * inverseDirection;
+		const glm::vec3 entries = glm::min(t1, t2);
+		const glm::vec3 exits = glm::max(t1, t2);
+		distance = std::max({ entries.x, entries.y, entries.z, 0.0f });
+		return distance <= std::min({ exits.x, exits.y, exits.z, maxDistance });
+	}
+
+	// tests the 4 boxes of a node against the frustum, bit i of the masks is slot i
+	class FrustumQuery {
+	public:
+
+		explicit FrustumQuery(const Frustum& f) :
+			frustum(f) {
+#if defined(POC_SIMD_SSE)
+			for (size_t p = 0; p < 6; ++p) {
+				for (glm::length_t c = 0; c < 4; ++c) {
+					planes[p][c] = _mm_set1_ps(frustum.planes[p][c]);
+				}
+				for (glm::length_t c = 0; c < 3; ++c) {
+					absNormals[p][c] = _mm_set1_ps(std::abs(frustum.planes[p][c]));
+				}
+			}
+#endif
+		}
+
+		// returns the boxes intersecting the frustum, insideMask the boxes fully inside
+		uint32_t test(const BvhNode& node, uint32_t& insideMask) const {
+#if defined(POC_SIMD_SSE)
+			const __m128 half = _mm_set1_ps(0.5f);
+			const __m128 minX = _mm_load_ps(node.minX);
+			const __m128 minY = _mm_load_ps(node.minY);
+			const __m128 minZ = _mm_load_ps(node.minZ);
+			const __m128 maxX = _mm_load_ps(node.maxX);
+			const __m128 maxY = _mm_load_ps(node.maxY);
+			const __m128 maxZ = _mm_load_ps(node.maxZ);
+			const __m128 centerX = _mm_mul_ps(_mm_add_ps(minX, maxX), half);
+			const __m128 centerY = _mm_mul_ps(_mm_add_ps(minY, maxY), half);
+			const __m128 centerZ = _mm_mul_ps(_mm_add_ps(minZ, maxZ), half);
+			const __m128 extentX = _mm_mul_ps(_mm_sub_ps(maxX, minX), half);
+			const __m128 extentY = _mm_mul_ps(_mm_sub_ps(maxY, minY), half);
+			const __m128 extentZ = _mm_mul_ps(_mm_sub_ps(maxZ, minZ), half);
+
+			const __m128 zero = _mm_setzero_ps();
+			__m128 visible = _mm_cmpeq_ps(zero, zero);
+			__m128 inside = visible;
+			for (size_t p = 0; p < 6; ++p) {
+				const __m128 distance = _mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(planes[p][0], centerX), _mm_mul_ps(planes[p][1], centerY)),
+					_mm_add_ps(_mm_mul_ps(planes[p][2], centerZ), planes[p][3]));
+				const __m128 radius = _mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(absNormals[p][0], extentX), _mm_mul_ps(absNormals[p][1], extentY)),
+					_mm_mul_ps(absNormals[p][2], extentZ));
+				visible = _mm_and_ps(visible, _mm_cmpge_ps(distance, _mm_sub_ps(zero, radius)));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, radius));
+			}
+			insideMask = static_cast<uint32_t>(_mm_movemask_ps(inside));
+			return static_cast<uint32_t>(_mm_movemask_ps(visible));
+#else
+			uint32_t visibleMask = 0;
+			insideMask = 0;
+			for (uint32_t slot = 0; slot < 4; ++slot) {
+				const Aabb aabb = getBounds(node, slot);
+				const glm::vec3 center = aabb.getCenter();
+				const glm::vec3 extent = aabb.getExtent();
+				bool visible = true;
+				bool inside = true;
+				for (const glm::vec4& plane : frustum.planes) {
+					const float distance = glm::dot(glm::vec3(plane), center) + plane.w;
+					const float radius = glm::dot(glm::abs(glm::vec3(plane)), extent);
+					visible = visible && distance >= -radius;
+					inside = inside && distance >= radius;
+				}
+				visibleMask |= (visible ? 1u : 0u) << slot;
+				insideMask |= (inside ? 1u : 0u) << slot;
+			}
+			return visibleMask;
+#endif
+		}
+
+		const Frustum& frustum;
+
+	private:
+#if defined(POC_SIMD_SSE)
+		__m128 planes[6][4];
+		__m128 absNormals[6][3];
+#endif
+	};
+
+	// slab test of the 4 boxes of a node
+	class RayQuery {
+	public:
+
+		explicit RayQuery(const Ray& ray) :
+			origin(ray.origin),
+			inverseDirection(1.0f / ray.direction) {
+#if defined(POC_SIMD_SSE)
+			for (glm::length_t c = 0; c < 3; ++c) {
+				origins[c] = _mm_set1_ps(origin[c]);
+				inverseDirections[c] = _mm_set1_ps(inverseDirection[c]);
+			}
+#endif
+		}
+
+		// returns the boxes hit before maxDistance, with their entry distance
+		uint32_t test(const BvhNode& node, float maxDistance, float (&distances)[4]) const {
+#if defined(POC_SIMD_SSE)
+			const __m128 t1X = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.minX), origins[0]), inverseDirections[0]);
+			const __m128 t1Y = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.minY), origins[1]), inverseDirections[1]);
+			const __m128 t1Z = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.minZ), origins[2]), inverseDirections[2]);
+			const __m128 t2X = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.maxX), origins[0]), inverseDirections[0]);
+			const __m128 t2Y = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.maxY), origins[1]), inverseDirections[1]);
+			const __m128 t2Z = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.maxZ), origins[2]), inverseDirections[2]);
+
+			const __m128 entry = _mm_max_ps(
+				_mm_max_ps(_mm_min_ps(t1X, t2X), _mm_min_ps(t1Y, t2Y)),
+				_mm_max_ps(_mm_min_ps(t1Z, t2Z), _mm_setzero_ps()));
+			const __m128 exit = _mm_min_ps(
+				_mm_min_ps(_mm_max_ps(t1X, t2X), _mm_max_ps(t1Y, t2Y)),
+				_mm_min_ps(_mm_max_ps(t1Z, t2Z), _mm_set1_ps(maxDistance)));
+
+			_mm_storeu_ps(distances, entry);
+			return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(entry, exit)));
+#else
+			uint32_t mask = 0;
+			for (uint32_t slot = 0; slot < 4; ++slot) {
+				mask |= (intersectRay(origin, inverseDirection, getBounds(node, slot), maxDistance, distances[slot]) ? 1u : 0u) << slot;
+			}
+			return mask;
+#endif
+		}
+
+		const glm::vec3 origin;
+		const glm::vec3 inverseDirection;
+
+	private:
+#if defined(POC_SIMD_SSE)
+		__m128 origins[3];
+		__m128 inverseDirections[3];
+#endif
+	};
+
+	static uint32_t overlapMask(const BvhNode& node, const Aabb& aabb) {
+#if defined(POC_SIMD_SSE)
+		const __m128 minX = _mm_cmple_ps(_mm_load_ps(node.minX), _mm_set1_ps(aabb.max.x));
+		const __m128 minY = _mm_cmple_ps(_mm_load_ps(node.minY), _mm_set1_ps(aabb.max.y));
+		const __m128 minZ = _mm_cmple_ps(_mm_load_ps(node.minZ), _mm_set1_ps(aabb.max.z));
+		const __m128 maxX = _mm_cmpge_ps(_mm_load_ps(node.maxX), _mm_set1_ps(aabb.min.x));
+		const __m128 maxY = _mm_cmpge_ps(_mm_load_ps(node.maxY), _mm_set1_ps(aabb.min.y));
+		const __m128 maxZ = _mm_cmpge_ps(_mm_load_ps(node.maxZ), _mm_set1_ps(aabb.min.z));
+		return static_cast<uint32_t>(_mm_movemask_ps(_mm_and_ps(
+			_mm_and_ps(_mm_and_ps(minX, minY), minZ),
+			_mm_and_ps(_mm_and_ps(maxX, maxY), maxZ))));
+#else
+		uint32_t mask = 0;
+		for (uint32_t slot = 0; slot < 4; ++slot) {
+			mask |= (getBounds(node, slot).overlaps(aabb) ? 1u : 0u) << slot;
+		}
+		return mask;
+#endif
+	}
+
+	void Bvh::build(span<const Aabb> bounds) {
+		objectBounds.assign(bounds.begin(), bounds.end());
+		objects.resize(objectBounds.size());
+		std::iota(objects.begin(), objects.end(), 0u);
+		nodes.clear();
+		infos.clear();
+
+		if (!objects.empty()) {
+			buildNode(Range{ 0, static_cast<uint32_t>(objects.size()) }, 0, nodes, infos);
+			refitNodes(0, nodes.size());
+			for (NodeInfo& info : infos) {
+				info.buildCost = info.cost;
+			}
+		}
+	}
+
+	void Bvh::refit(span<const Aabb> bounds) {
+		assert(bounds.size() == objectBounds.size() && "refit with a different object count");
+		objectBounds.assign(bounds.begin(), bounds.end());
+		refitNodes(0, nodes.size());
+	}
+
+	void Bvh::update(span<const Aabb> bounds) {
+		refit(bounds);
+		lastRebuildCount = 0;
+		if (nodes.empty()) {
+			return;
+		}
+
+		std::vector<uint32_t> degraded;
+		selectDegraded(0, degraded);
+		if (degraded.empty()) {
+			return;
+		}
+		if (degraded.front() == 0) {
+			build(bounds);
+			lastRebuildCount = 1;
+			return;
+		}
+
+		// the last subtrees first: a rebuild moves the nodes after the rebuilt subtree
+		std::sort(degraded.begin(), degraded.end());
+		for (auto node = degraded.rbegin(); node != degraded.rend(); ++node) {
+			rebuildSubtree(*node);
+		}
+		// the ancestors of the rebuilt subtrees
+		refitNodes(0, nodes.size());
+		lastRebuildCount = degraded.size();
+	}
+
+	void Bvh::cull(const Frustum& frustum, std::vector<uint32_t>& visibleObjects) const {
+		if (nodes.empty()) {
+			return;
+		}
+
+		const FrustumQuery query(frustum);
+		std::vector<uint32_t> stack{ 0 };
+		while (!stack.empty()) {
+			const BvhNode& node = nodes[stack.back()];
+			stack.pop_back();
+
+			uint32_t insideMask = 0;
+			const uint32_t visibleMask = query.test(node, insideMask);
+			for (uint32_t slot = 0; slot < 4; ++slot) {
+				const uint32_t child = node.children[slot];
+				if (((visibleMask >> slot) & 1) == 0 || child == invalidIndex) {
+					continue;
+				}
+
+				const bool leaf = node.counts[slot] > 0;
+				if ((insideMask >> slot) & 1) {
+					// the whole subtree is visible, its objects are contiguous
+					const uint32_t first = leaf ? child : infos[child].firstObject;
+					const uint32_t count = leaf ? node.counts[slot] : infos[child].objectCount;
+					visibleObjects.insert(visibleObjects.end(), objects.begin() + first, objects.begin() + first + count);
+				}
+				else if (leaf) {
+					for (uint32_t i = child; i < child + node.counts[slot]; ++i) {
+						if (frustum.intersects(objectBounds[objects[i]])) {
+							visibleObjects.push_back(objects[i]);
+						}
+					}
+				}
+				else {
+					stack.push_back(child);
+				}
+			}
+		}
+	}
+
+	RayHit Bvh::raycast(const Ray& ray, float maxDistance) const {
+		RayHit hit;
+		if (nodes.empty()) {
+			return hit;
+		}
+
+		const RayQuery query(ray);
+		float nearest = maxDistance;
+		std::vector<uint32_t> stack{ 0 };
+		while (!stack.empty()) {
+			const BvhNode& node = nodes[stack.back()];
+			stack.pop_back();
+
+			float distances[4];
+			const uint32_t hitMask = query.test(node, nearest, distances);
+
+			uint32_t slots[4];
+			uint32_t slotCount = 0;
+			for (uint32_t slot = 0; slot < 4; ++slot) {
+				if (((hitMask >> slot) & 1) && node.children[slot] != invalidIndex) {
+					slots[slotCount++] = slot;
+				}
+			}
+			// farthest first on the stack: the nearest child is visited next and shortens the ray early
+			for (uint32_t i = 1; i < slotCount; ++i) {
+				for (uint32_t j = i; j > 0 && distances[slots[j - 1]] < distances[slots[j]]; --j) {
+					std::swap(slots[j - 1], slots[j]);
+				}
+			}
+
+			for (uint32_t i = 0; i < slotCount; ++i) {
+				const uint32_t slot = slots[i];
+				const uint32_t child = node.children[slot];
+				if (node.counts[slot] == 0) {
+					stack.push_back(child);
+					continue;
+				}
+				for (uint32_t o = child; o < child + node.counts[slot]; ++o) {
+					float distance = 0.0f;
+					if (intersectRay(query.origin, query.inverseDirection, objectBounds[objects[o]], nearest, distance) && distance < hit.distance) {
+						hit = RayHit{ objects[o], distance };
+						nearest = distance;
+					}
+				}
+			}
+		}
+		return hit;
+	}
+
+	void Bvh::overlap(const Aabb& aabb, std::vector<uint32_t>& overlappingObjects) const {
+		if (nodes.empty()) {
+			return;
+		}
+
+		std::vector<uint32_t> stack{ 0 };
+		while (!stack.empty()) {
+			const BvhNode& node = nodes[stack.back()];
+			stack.pop_back();
+
+			const uint32_t mask = overlapMask(node, aabb);
+			for (uint32_t slot = 0; slot < 4; ++slot) {
+				const uint32_t child = node.children[slot];
+				if (((mask >> slot) & 1) == 0 || child == invalidIndex) {
+					continue;
+				}
+				if (node.counts[slot] == 0) {
+					stack.push_back(child);
+					continue;
+				}
+				for (uint32_t o = child; o < child + node.counts[slot]; ++o) {
+					if (objectBounds[objects[o]].overlaps(aabb)) {
+						overlappingObjects.push_back(objects[o]);
+					}
+				}
+			}
+		}
+	}
+
+	float Bvh::getCost() const {
+		if (nodes.empty()) {
+			return 0.0f;
+		}
+		const float rootArea = getNodeBounds(0).getSurfaceArea();
+		return rootArea > 0.0f ? infos[0].cost / rootArea : 0.0f;
+	}
+
+	uint32_t Bvh::buildNode(Range range, uint32_t baseIndex, std::vector<BvhNode>& outNodes, std::vector<NodeInfo>& outInfos) {
+		const uint32_t index = static_cast<uint32_t>(outNodes.size());
+		outNodes.emplace_back();
+		outInfos.push_back(NodeInfo{ range.begin, range.end - range.begin, 1, 0.0f, 0.0f });
+
+		// split the most populated range until the node has 4 children or only leaves
+		Range ranges[4]{ range };
+		uint32_t rangeCount = 1;
+		while (rangeCount < 4) {
+			uint32_t largest = invalidIndex;
+			uint32_t largestCount = maxLeafSize;
+			for (uint32_t r = 0; r < rangeCount; ++r) {
+				if (ranges[r].end - ranges[r].begin > largestCount) {
+					largest = r;
+					largestCount = ranges[r].end - ranges[r].begin;
+				}
+			}
+			if (largest == invalidIndex) {
+				break;
+			}
+
+			const Range split = ranges[largest];
+			const uint32_t middle = splitRange(split);
+			ranges[largest] = Range{ split.begin, middle };
+			ranges[rangeCount++] = Range{ middle, split.end };
+		}
+
+		uint32_t children[4];
+		uint32_t counts[4];
+		for (uint32_t slot = 0; slot < 4; ++slot) {
+			const uint32_t count = slot < rangeCount ? ranges[slot].end - ranges[slot].begin : 0;
+			if (slot >= rangeCount) {
+				children[slot] = invalidIndex;
+				counts[slot] = 0;
+			}
+			else if (count <= maxLeafSize) {
+				children[slot] = ranges[slot].begin;
+				counts[slot] = count;
+			}
+			else {
+				// the recursion grows outNodes, the node is written afterwards
+				children[slot] = baseIndex + buildNode(ranges[slot], baseIndex, outNodes, outInfos);
+				counts[slot] = 0;
+			}
+		}
+
+		BvhNode& node = outNodes[index];
+		std::copy(children, children + 4, node.children);
+		std::copy(counts, counts + 4, node.counts);
+		outInfos[index].subtreeSize = static_cast<uint32_t>(outNodes.size()) - index;
+		return index;
+	}
+
+	uint32_t Bvh::splitRange(Range range) {
+		const uint32_t middle = range.begin + (range.end - range.begin) / 2;
+		const auto first = objects.begin() + range.begin;
+		const auto last = objects.begin() + range.end;
+
+		Aabb centroidBounds;
+		for (auto object = first; object != last; ++object) {
+			centroidBounds.expand(objectBounds[*object].getCenter());
+		}
+		const glm::vec3 size = centroidBounds.max - centroidBounds.min;
+		const glm::length_t axis = size.x >= size.y && size.x >= size.z ? 0 : (size.y >= size.z ? 1 : 2);
+		if (size[axis] <= 0.0f) {
+			// all the centroids at the same place, any split is as good
+			return middle;
+		}
+
+		const float origin = centroidBounds.min[axis];
+		const float scale = float(binCount) / size[axis];
+		const auto getBin = [&](uint32_t object) {
+			const float position = (objectBounds[object].getCenter()[axis] - origin) * scale;
+			return std::min(binCount - 1, static_cast<uint32_t>(position));
+		};
+
+		Aabb binBounds[binCount];
+		uint32_t binCounts[binCount]{};
+		for (auto object = first; object != last; ++object) {
+			const uint32_t bin = getBin(*object);
+			binBounds[bin].expand(objectBounds[*object]);
+			++binCounts[bin];
+		}
+
+		// cost of the objects right of each split plane, then sweep from the left
+		float rightCosts[binCount]{};
+		Aabb right;
+		uint32_t rightCount = 0;
+		for (uint32_t bin = binCount - 1; bin > 0; --bin) {
+			right.expand(binBounds[bin]);
+			rightCount += binCounts[bin];
+			rightCosts[bin] = right.getSurfaceArea() * float(rightCount);
+		}
+
+		Aabb left;
+		uint32_t leftCount = 0;
+		uint32_t bestBin = invalidIndex;
+		float bestCost = std::numeric_limits<float>::max();
+		for (uint32_t bin = 0; bin + 1 < binCount; ++bin) {
+			left.expand(binBounds[bin]);
+			leftCount += binCounts[bin];
+			const float cost = left.getSurfaceArea() * float(leftCount) + rightCosts[bin + 1];
+			if (leftCount > 0 && leftCount < range.end - range.begin && cost < bestCost) {
+				bestBin = bin;
+				bestCost = cost;
+			}
+		}
+
+		if (bestBin != invalidIndex) {
+			const auto split = std::partition(first, last, [&](uint32_t object) {
+				return getBin(object) <= bestBin;
+			});
+			return static_cast<uint32_t>(split - objects.begin());
+		}
+
+		std::nth_element(first, objects.begin() + middle, last, [&](uint32_t a, uint32_t b) {
+			return objectBounds[a].getCenter()[axis] < objectBounds[b].getCenter()[axis];
+		});
+		return middle;
+	}
+
+	void Bvh::rebuildSubtree(uint32_t node) {
+		const NodeInfo info = infos[node];
+		const uint32_t oldEnd = node + info.subtreeSize;
+
+		std::vector<BvhNode> subtreeNodes;
+		std::vector<NodeInfo> subtreeInfos;
+		buildNode(Range{ info.firstObject, info.firstObject + info.objectCount }, node, subtreeNodes, subtreeInfos);
+
+		// the nodes after the subtree move, their parents & the ancestors of the subtree are patched
+		const int64_t delta = int64_t(subtreeNodes.size()) - int64_t(info.subtreeSize);
+		if (delta != 0) {
+			for (size_t n = 0; n < nodes.size(); ++n) {
+				if (n >= node && n < oldEnd) {
+					continue;
+				}
+				for (uint32_t slot = 0; slot < 4; ++slot) {
+					if (nodes[n].counts[slot] == 0 && nodes[n].children[slot] != invalidIndex && nodes[n].children[slot] >= oldEnd) {
+						nodes[n].children[slot] = static_cast<uint32_t>(int64_t(nodes[n].children[slot]) + delta);
+					}
+				}
+				if (n < node && n + infos[n].subtreeSize > node) {
+					infos[n].subtreeSize = static_cast<uint32_t>(int64_t(infos[n].subtreeSize) + delta);
+				}
+			}
+		}
+
+		nodes.erase(nodes.begin() + node, nodes.begin() + oldEnd);
+		nodes.insert(nodes.begin() + node, subtreeNodes.begin(), subtreeNodes.end());
+		infos.erase(infos.begin() + node, infos.begin() + oldEnd);
+		infos.insert(infos.begin() + node, subtreeInfos.begin(), subtreeInfos.end());
+
+		const size_t newEnd = node + subtreeNodes.size();
+		refitNodes(node, newEnd);
+		for (size_t n = node; n < newEnd; ++n) {
+			infos[n].buildCost = infos[n].cost;
+		}
+	}
+
+	void Bvh::refitNodes(size_t first, size_t last) {
+		// children are after their parent: refitted first
+		for (size_t n = last; n-- > first;) {
+			BvhNode& node = nodes[n];
+			float cost = 0.0f;
+			for (uint32_t slot = 0; slot < 4; ++slot) {
+				const uint32_t child = node.children[slot];
+				Aabb aabb;
+				if (child == invalidIndex) {
+					// empty slot: never intersects
+				}
+				else if (node.counts[slot] > 0) {
+					for (uint32_t o = child; o < child + node.counts[slot]; ++o) {
+						aabb.expand(objectBounds[objects[o]]);
+					}
+					cost += aabb.getSurfaceArea() * float(node.counts[slot]);
+				}
+				else {
+					aabb = getNodeBounds(child);
+					cost += aabb.getSurfaceArea() + infos[child].cost;
+				}
+				setBounds(node, slot, aabb);
+			}
+			infos[n].cost = cost;
+		}
+	}
+
+	void Bvh::selectDegraded(uint32_t node, std::vector<uint32_t>& degraded) const {
+		// the topmost degraded subtrees: a local motion only rebuilds the region it damaged
+		if (infos[node].cost > infos[node].buildCost * rebuildRatio) {
+			degraded.push_back(node);
+			return;
+		}
+		for (uint32_t slot = 0; slot < 4; ++slot) {
+			if (nodes[node].counts[slot] == 0 && nodes[node].children[slot] != invalidIndex) {
+				selectDegraded(nodes[node].children[slot], degraded);
+			}
+		}
+	}
+
+	Aabb Bvh::getNodeBounds(uint32_t node) const {
+		Aabb aabb;
+		for (uint32_t slot = 0; slot < 4; ++slot) {
+			if (nodes[node].children[slot] != invalidIndex) {
+				aabb.expand(getBounds(nodes[node], slot));
+			}
+		}
+		return aabb;
+	}
+
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "bounds.hpp"
+#include "frustum.hpp"
+#include "span.hpp"
+
+namespace poc {
+
+	// 4 children boxes in structure of arrays, tested together with SSE
+	// children[i] is a node index when counts[i] is 0, the first entry of a leaf in the object list otherwise
+	struct alignas(64) BvhNode {
+		float minX[4];
+		float minY[4];
+		float minZ[4];
+		float maxX[4];
+		float maxY[4];
+		float maxZ[4];
+		uint32_t children[4];
+		uint32_t counts[4];
+	};
+
+	struct RayHit {
+		uint32_t object{ std::numeric_limits<uint32_t>::max() };
+		float distance{ std::numeric_limits<float>::max() };
+
+		bool isHit() const {
+			return object != std::numeric_limits<uint32_t>::max();
+		}
+	};
+
+	/*
+	 * Bounding volume hierarchy over object boxes, 4 children per node.
+	 *
+	 * build() splits the objects top-down with the binned surface area heuristic (SAH) and stores the
+	 * nodes depth-first in a flat array: a node is followed by its whole subtree, so every subtree is a
+	 * contiguous block of nodes over a contiguous range of objects. refit() updates the boxes of moved
+	 * objects bottom-up without changing the topology. update() refits then rebuilds the subtrees whose
+	 * SAH cost degraded too much since they were built.
+	 */
+	class Bvh {
+	public:
+
+		static constexpr uint32_t invalidIndex = std::numeric_limits<uint32_t>::max();
+
+		// objects per leaf at most
+		static constexpr uint32_t maxLeafSize = 4;
+
+		// a subtree is rebuilt by update() when its cost exceeds its build cost by this ratio
+		static constexpr float rebuildRatio = 1.5f;
+
+		// objects are identified by their index in objectBounds
+		void build(span<const Aabb> objectBounds);
+
+		// same objects, new boxes
+		void refit(span<const Aabb> objectBounds);
+
+		// refit, then rebuild the topmost degraded subtrees, the whole tree when the root degraded
+		void update(span<const Aabb> objectBounds);
+
+		// appends the objects whose box intersects the frustum
+		void cull(const Frustum& frustum, std::vector<uint32_t>& visibleObjects) const;
+
+		// nearest object box hit by the ray, distances are in units of the ray direction
+		RayHit raycast(const Ray& ray, float maxDistance = std::numeric_limits<float>::max()) const;
+
+		// appends the objects whose box overlaps the box
+		void overlap(const Aabb& aabb, std::vector<uint32_t>& overlappingObjects) const;
+
+		size_t getObjectCount() const {
+			return objectBounds.size();
+		}
+
+		span<const BvhNode> getNodes() const {
+			return nodes;
+		}
+
+		// SAH cost relative to the root box: expected boxes tested by a query going through the tree
+		float getCost() const;
+
+		// subtrees rebuilt by the last update(), the whole tree counts as one
+		size_t getLastRebuildCount() const {
+			return lastRebuildCount;
+		}
+
+	private:
+
+		struct NodeInfo {
+			uint32_t firstObject;
+			uint32_t objectCount;
+			// nodes of the subtree, including the node itself
+			uint32_t subtreeSize;
+			// SAH cost of the subtree, not normalized, current & after its last build
+			float cost;
+			float buildCost;
+		};
+
+		struct Range {
+			uint32_t begin;
+			uint32_t end;
+		};
+
+		std::vector<BvhNode> nodes;
+		std::vector<NodeInfo> infos;
+		// object indices, the leaves reference ranges of this list
+		std::vector<uint32_t> objects;
+		std::vector<Aabb> objectBounds;
+		size_t lastRebuildCount{ 0 };
+
+		uint32_t buildNode(Range range, uint32_t baseIndex, std::vector<BvhNode>& outNodes, std::vector<NodeInfo>& outInfos);
+		uint32_t splitRange(Range range);
+		void rebuildSubtree(uint32_t node);
+		// nodes in [first, last), their children already refitted or in the range
+		void refitNodes(size_t first, size_t last);
+		void selectDegraded(uint32_t node, std::vector<uint32_t>& degraded) const;
+		Aabb getNodeBounds(uint32_t node) const;
+
+	};
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../plateform/platform.hpp"
+#include "frustum.hpp"
+
+namespace poc {
+
+	// view & projection of the scene, identity by default: world space is the clip space
+	class Camera {
+	public:
+
+		void setView(const glm::mat4& v) {
+			view = v;
+			viewProjection = projection * view;
+		}
+
+		void setProjection(const glm::mat4& p) {
+			projection = p;
+			viewProjection = projection * view;
+		}
+
+		const glm::mat4& getView() const {
+			return view;
+		}
+
+		const glm::mat4& getProjection() const {
+			return projection;
+		}
+
+		const glm::mat4& getViewProjection() const {
+			return viewProjection;
+		}
+
+		Frustum getFrustum() const {
+			return Frustum::fromViewProjection(viewProjection);
+		}
+
+		// homogeneous point the triangles are seen from: the eye of a perspective projection, a direction (w = 0)
+		// for an orthographic one. A triangle of plane (n, -dot(n, p)), n = cross(p1 - p0, p2 - p0), is drawn
+		// by the counter clockwise front face pipelines when dot(plane, facingPoint) > 0
+		glm::vec4 getFacingPoint() const {
+			return -glm::determinant(viewProjection) * (glm::inverse(viewProjection) * glm::vec4(0.0f, 0.0f, 1.0f, 0.0f));
+		}
+
+	private:
+		glm::mat4 view{ 1.0f };
+		glm::mat4 projection{ 1.0f };
+		glm::mat4 viewProjection{ 1.0f };
+	};
+
+}
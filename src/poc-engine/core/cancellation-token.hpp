@@ -0,0 +1,30 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace poc {
+
+	/*
+	 * Flag shared by the copies of a token: the requester keeps a copy to cancel, the work checks its own
+	 * copy between its steps. A default token is never cancelled unless cancel() is called on one of its copies.
+	 */
+	class CancellationToken {
+	public:
+
+		CancellationToken() :
+			cancelled(std::make_shared<std::atomic<bool>>(false)) {}
+
+		void cancel() const {
+			cancelled->store(true, std::memory_order_relaxed);
+		}
+
+		bool isCancelled() const {
+			return cancelled->load(std::memory_order_relaxed);
+		}
+
+	private:
+		std::shared_ptr<std::atomic<bool>> cancelled;
+	};
+
+}
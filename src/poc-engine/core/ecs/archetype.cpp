@@ -0,0 +1,116 @@
+#include "archetype.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+#include "../logger.hpp"
+
+using namespace poc;
+
+namespace poc {
+
+	static constexpr char logTag[]{ "POC::Archetype" };
+
+	static uint32_t alignUp(uint32_t value, uint32_t alignment) {
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	// bytes used by a chunk of the given capacity, fills the offset of each component array
+	static size_t computeLayout(const std::vector<ComponentId>& componentIds, uint32_t capacity, std::array<uint32_t, maxComponentTypes>& offsets) {
+		uint32_t size = static_cast<uint32_t>(sizeof(Entity)) * capacity;
+		for (const ComponentId id : componentIds) {
+			const ComponentInfo& info = Components::getInfo(id);
+			size = alignUp(size, info.alignment);
+			offsets[id] = size;
+			size += info.size * capacity;
+		}
+		return size;
+	}
+
+	Archetype::Archetype(ComponentMask m) :
+		mask(m) {
+
+		uint32_t rowSize = sizeof(Entity);
+		for (ComponentId id = 0; id < maxComponentTypes; ++id) {
+			if (hasComponent(id)) {
+				componentIds.push_back(id);
+				rowSize += Components::getInfo(id).size;
+			}
+		}
+
+		// alignment padding may not fit with the ideal capacity
+		capacity = static_cast<uint32_t>(chunkSize / rowSize);
+		while (capacity > 0 && computeLayout(componentIds, capacity, offsets) > chunkSize) {
+			--capacity;
+		}
+
+		if (capacity == 0) {
+			Logger::error(logTag, "Components too large for a chunk");
+			throw std::runtime_error("Components too large for a chunk");
+		}
+	}
+
+	Archetype::Archetype(const Archetype& other) :
+		mask(other.mask),
+		componentIds(other.componentIds),
+		capacity(other.capacity),
+		offsets(other.offsets),
+		counts(other.counts),
+		entityCount(other.entityCount) {
+
+		chunks.reserve(other.chunks.size());
+		for (const std::unique_ptr<Chunk>& chunk : other.chunks) {
+			chunks.push_back(std::make_unique<Chunk>(*chunk));
+		}
+	}
+
+	EntitySlot Archetype::allocate(const Entity& entity) {
+		if (chunks.empty() || counts.back() == capacity) {
+			chunks.push_back(std::unique_ptr<Chunk>(new Chunk));
+			counts.push_back(0);
+		}
+
+		const EntitySlot slot{ static_cast<uint32_t>(chunks.size() - 1), counts.back()++ };
+		getMutableEntities(slot.chunk)[slot.row] = entity;
+		for (const ComponentId id : componentIds) {
+			std::memset(getComponent(slot, id), 0, Components::getInfo(id).size);
+		}
+
+		++entityCount;
+		return slot;
+	}
+
+	std::optional<Entity> Archetype::remove(const EntitySlot& slot) {
+		assert(slot.chunk < chunks.size() && slot.row < counts[slot.chunk] && "invalid entity slot");
+
+		const EntitySlot last{ static_cast<uint32_t>(chunks.size() - 1), counts.back() - 1 };
+
+		std::optional<Entity> moved;
+		if (slot.chunk != last.chunk || slot.row != last.row) {
+			moved = getMutableEntities(last.chunk)[last.row];
+			getMutableEntities(slot.chunk)[slot.row] = *moved;
+			for (const ComponentId id : componentIds) {
+				std::memcpy(getComponent(slot, id), getComponent(last, id), Components::getInfo(id).size);
+			}
+		}
+
+		if (--counts.back() == 0) {
+			chunks.pop_back();
+			counts.pop_back();
+		}
+
+		--entityCount;
+		return moved;
+	}
+
+	void Archetype::copyComponents(Archetype& source, const EntitySlot& sourceSlot, Archetype& destination, const EntitySlot& destinationSlot) {
+		const ComponentMask common = source.mask & destination.mask;
+		for (const ComponentId id : source.componentIds) {
+			if (common & (ComponentMask{ 1 } << id)) {
+				std::memcpy(destination.getComponent(destinationSlot, id), source.getComponent(sourceSlot, id), Components::getInfo(id).size);
+			}
+		}
+	}
+
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "component.hpp"
+#include "entity.hpp"
+
+namespace poc {
+
+	// size of the memory blocks holding the entities of an archetype
+	inline constexpr size_t chunkSize = 16 * 1024;
+
+	struct alignas(64) Chunk {
+		std::byte data[chunkSize];
+	};
+
+	// location of an entity inside its archetype
+	struct EntitySlot {
+		uint32_t chunk;
+		uint32_t row;
+	};
+
+	/*
+	 * Storage of all the entities having exactly the same set of components.
+	 *
+	 * Each chunk is laid out as structure of arrays: the entity handles, then one tightly packed array
+	 * per component type. Every chunk is full except the last one, removals move the last entity into
+	 * the hole so the arrays never contain gaps.
+	 */
+	class Archetype {
+	public:
+
+		explicit Archetype(ComponentMask mask);
+
+		Archetype(const Archetype& other);
+		Archetype& operator=(const Archetype& other) = delete;
+
+		ComponentMask getMask() const {
+			return mask;
+		}
+
+		bool hasComponent(ComponentId id) const {
+			return (mask & (ComponentMask{ 1 } << id)) != 0;
+		}
+
+		const std::vector<ComponentId>& getComponentIds() const {
+			return componentIds;
+		}
+
+		// maximum number of entities per chunk
+		uint32_t getChunkCapacity() const {
+			return capacity;
+		}
+
+		size_t getChunkCount() const {
+			return chunks.size();
+		}
+
+		size_t getEntityCount() const {
+			return entityCount;
+		}
+
+		uint32_t getEntityCount(size_t chunk) const {
+			return counts[chunk];
+		}
+
+		const Entity* getEntities(size_t chunk) const {
+			return reinterpret_cast<const Entity*>(chunks[chunk]->data);
+		}
+
+		void* getComponents(size_t chunk, ComponentId id) {
+			assert(hasComponent(id) && "component not in archetype");
+			return chunks[chunk]->data + offsets[id];
+		}
+
+		const void* getComponents(size_t chunk, ComponentId id) const {
+			assert(hasComponent(id) && "component not in archetype");
+			return chunks[chunk]->data + offsets[id];
+		}
+
+		void* getComponent(const EntitySlot& slot, ComponentId id) {
+			return static_cast<std::byte*>(getComponents(slot.chunk, id)) + size_t(slot.row) * Components::getInfo(id).size;
+		}
+
+		// new entity at the end of the last chunk, its components are zeroed
+		EntitySlot allocate(const Entity& entity);
+
+		// returns the entity moved into the slot to fill the hole, if any
+		std::optional<Entity> remove(const EntitySlot& slot);
+
+		// copies the components present in both archetypes
+		static void copyComponents(Archetype& source, const EntitySlot& sourceSlot, Archetype& destination, const EntitySlot& destinationSlot);
+
+	private:
+		ComponentMask mask;
+		std::vector<ComponentId> componentIds;
+		uint32_t capacity{ 0 };
+		std::array<uint32_t, maxComponentTypes> offsets{};
+		std::vector<std::unique_ptr<Chunk>> chunks;
+		std::vector<uint32_t> counts;
+		size_t entityCount{ 0 };
+
+		Entity* getMutableEntities(size_t chunk) {
+			return reinterpret_cast<Entity*>(chunks[chunk]->data);
+		}
+
+	};
+
+}
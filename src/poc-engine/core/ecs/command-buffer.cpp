@@ -0,0 +1,52 @@
+#include "command-buffer.hpp"
+
+#include <cstring>
+
+using namespace poc;
+
+namespace poc {
+
+	void CommandBuffer::record(Type type, bool pending, const Entity& entity, ComponentId id, const void* component) {
+		const uint32_t offset = static_cast<uint32_t>(data.size());
+		const uint32_t size = Components::getInfo(id).size;
+
+		data.resize(data.size() + size);
+		std::memcpy(data.data() + offset, component, size);
+
+		commands.push_back(Command{ type, pending, entity, 0, id, offset });
+	}
+
+	void CommandBuffer::apply(World& world) {
+		createdEntities.clear();
+		createdEntities.reserve(pendingCount);
+
+		for (const Command& command : commands) {
+			const Entity entity = command.pending && command.type != Type::CREATE
+				? createdEntities[command.entity.index]
+				: command.entity;
+
+			switch (command.type) {
+			case Type::CREATE:
+				createdEntities.push_back(world.create(command.mask));
+				break;
+			case Type::DESTROY:
+				world.destroy(entity);
+				break;
+			case Type::ADD:
+				world.addComponent(entity, command.component, data.data() + command.dataOffset);
+				break;
+			case Type::REMOVE:
+				world.removeComponent(entity, command.component);
+				break;
+			case Type::SET:
+				std::memcpy(world.getComponent(entity, command.component), data.data() + command.dataOffset, Components::getInfo(command.component).size);
+				break;
+			}
+		}
+
+		commands.clear();
+		data.clear();
+		pendingCount = 0;
+	}
+
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "component.hpp"
+#include "entity.hpp"
+#include "world.hpp"
+
+namespace poc {
+
+	/*
+	 * Structural changes recorded while iterating a World, applied in order later with apply().
+	 *
+	 * Component values are copied into a single byte stream. Entities created by the buffer are
+	 * built directly in their final archetype, they can be referenced by the following commands
+	 * through their PendingEntity and retrieved with getEntity() once applied.
+	 */
+	class CommandBuffer {
+	public:
+
+		struct PendingEntity {
+			uint32_t index;
+		};
+
+		template<class... C>
+		PendingEntity create(const C&... components) {
+			const PendingEntity pending{ pendingCount++ };
+			commands.push_back(Command{ Type::CREATE, true, Entity{ pending.index, 0 }, Components::getMask<C...>(), 0, 0 });
+			(record(Type::SET, true, Entity{ pending.index, 0 }, Components::getId<C>(), &components), ...);
+			return pending;
+		}
+
+		void destroy(const Entity& entity) {
+			commands.push_back(Command{ Type::DESTROY, false, entity, 0, 0, 0 });
+		}
+
+		template<class C>
+		void add(const Entity& entity, const C& component) {
+			record(Type::ADD, false, entity, Components::getId<C>(), &component);
+		}
+
+		template<class C>
+		void add(const PendingEntity& entity, const C& component) {
+			record(Type::ADD, true, Entity{ entity.index, 0 }, Components::getId<C>(), &component);
+		}
+
+		template<class C>
+		void remove(const Entity& entity) {
+			commands.push_back(Command{ Type::REMOVE, false, entity, 0, Components::getId<C>(), 0 });
+		}
+
+		size_t getCommandCount() const {
+			return commands.size();
+		}
+
+		bool isEmpty() const {
+			return commands.empty();
+		}
+
+		// replays the commands on the world and clears them
+		void apply(World& world);
+
+		// entity created by the last apply()
+		Entity getEntity(const PendingEntity& pending) const {
+			assert(pending.index < createdEntities.size() && "entity not created yet");
+			return createdEntities[pending.index];
+		}
+
+	private:
+
+		enum class Type : uint8_t {
+			CREATE,
+			DESTROY,
+			ADD,
+			REMOVE,
+			SET		// component of an entity created by the buffer, no structural change
+		};
+
+		struct Command {
+			Type type;
+			bool pending;
+			Entity entity;
+			ComponentMask mask;
+			ComponentId component;
+			uint32_t dataOffset;
+		};
+
+		std::vector<Command> commands;
+		std::vector<std::byte> data;
+		std::vector<Entity> createdEntities;
+		uint32_t pendingCount{ 0 };
+
+		void record(Type type, bool pending, const Entity& entity, ComponentId id, const void* component);
+
+	};
+
+}
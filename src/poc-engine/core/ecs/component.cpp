@@ -0,0 +1,38 @@
+#include "component.hpp"
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <stdexcept>
+
+#include "../logger.hpp"
+
+using namespace poc;
+
+namespace poc {
+
+	static constexpr char logTag[]{ "POC::Components" };
+
+	static std::array<ComponentInfo, maxComponentTypes> infos{};
+	static std::atomic<ComponentId> registeredCount{ 0 };
+
+	namespace Components {
+
+		ComponentId registerType(const ComponentInfo& info) {
+			const ComponentId id = registeredCount++;
+			if (id >= maxComponentTypes) {
+				Logger::error(logTag, "Too many component types");
+				throw std::runtime_error("Too many component types");
+			}
+			infos[id] = info;
+			return id;
+		}
+
+		const ComponentInfo& getInfo(ComponentId id) {
+			assert(id < registeredCount && "component type not registered");
+			return infos[id];
+		}
+
+	}
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+namespace poc {
+
+	using ComponentId = uint32_t;
+
+	// set of component types, bit i is the component of id i
+	using ComponentMask = uint64_t;
+
+	inline constexpr ComponentId maxComponentTypes = 64;
+
+	struct ComponentInfo {
+		uint32_t size;
+		uint32_t alignment;
+	};
+
+	namespace Components {
+
+		// thread safe, ids are assigned in registration order
+		ComponentId registerType(const ComponentInfo& info);
+
+		const ComponentInfo& getInfo(ComponentId id);
+
+		// components are plain data: the chunks move them with memcpy and never call their destructor
+		template<class C>
+		ComponentId getId() {
+			static_assert(std::is_trivially_copyable_v<C>, "components must be trivially copyable");
+			static_assert(std::is_trivially_destructible_v<C>, "components must be trivially destructible");
+			static const ComponentId id = registerType(ComponentInfo{ sizeof(C), alignof(C) });
+			return id;
+		}
+
+		template<class... C>
+		ComponentMask getMask() {
+			return (ComponentMask{ 0 } | ... | (ComponentMask{ 1 } << getId<std::remove_const_t<C>>()));
+		}
+
+	}
+
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+namespace poc {
+
+	// handle of an entity, the generation detects the reuse of the slot of a destroyed entity
+	// live generations start at 1: a default constructed Entity is never alive
+	struct Entity {
+		uint32_t index{ 0 };
+		uint32_t generation{ 0 };
+	};
+
+	inline bool operator==(const Entity& lhs, const Entity& rhs) {
+		return lhs.index == rhs.index && lhs.generation == rhs.generation;
+	}
+
+	inline bool operator!=(const Entity& lhs, const Entity& rhs) {
+		return !(lhs == rhs);
+	}
+
+}
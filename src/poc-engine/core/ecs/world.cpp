@@ -0,0 +1,139 @@
+#include "world.hpp"
+
+#include <cstring>
+#include <utility>
+
+using namespace poc;
+
+namespace poc {
+
+	World::World() {
+		// entities without components
+		getOrCreateArchetype(ComponentMask{ 0 });
+	}
+
+	World::World(const World& other) :
+		records(other.records),
+		freeIndices(other.freeIndices),
+		archetypeIndices(other.archetypeIndices),
+		entityCount(other.entityCount) {
+
+		assert(other.iterationDepth == 0 && "world copied while iterating");
+
+		archetypes.reserve(other.archetypes.size());
+		for (const std::unique_ptr<Archetype>& archetype : other.archetypes) {
+			archetypes.push_back(std::make_unique<Archetype>(*archetype));
+		}
+	}
+
+	World& World::operator=(const World& other) {
+		if (this != &other) {
+			World copy(other);
+			*this = std::move(copy);
+		}
+		return *this;
+	}
+
+	Entity World::create(ComponentMask mask) {
+		assert(iterationDepth == 0 && "structural change while iterating, use a CommandBuffer");
+
+		uint32_t index;
+		if (!freeIndices.empty()) {
+			index = freeIndices.back();
+			freeIndices.pop_back();
+		}
+		else {
+			index = static_cast<uint32_t>(records.size());
+			records.push_back(EntityRecord{ 0, EntitySlot{ 0, 0 }, 1 });
+		}
+
+		const uint32_t archetype = getOrCreateArchetype(mask);
+		const Entity entity{ index, records[index].generation };
+
+		EntityRecord& record = records[index];
+		record.archetype = archetype;
+		record.slot = archetypes[archetype]->allocate(entity);
+
+		++entityCount;
+		return entity;
+	}
+
+	void World::destroy(const Entity& entity) {
+		assert(iterationDepth == 0 && "structural change while iterating, use a CommandBuffer");
+		assert(isAlive(entity) && "entity not alive");
+
+		EntityRecord& record = records[entity.index];
+		removeFromArchetype(record);
+
+		// invalidates the existing handles
+		++record.generation;
+		freeIndices.push_back(entity.index);
+		--entityCount;
+	}
+
+	void World::addComponent(const Entity& entity, ComponentId id, const void* data) {
+		if (!hasComponent(entity, id)) {
+			moveToArchetype(entity, archetypes[records[entity.index].archetype]->getMask() | (ComponentMask{ 1 } << id));
+		}
+		std::memcpy(getComponent(entity, id), data, Components::getInfo(id).size);
+	}
+
+	void World::removeComponent(const Entity& entity, ComponentId id) {
+		if (hasComponent(entity, id)) {
+			moveToArchetype(entity, archetypes[records[entity.index].archetype]->getMask() & ~(ComponentMask{ 1 } << id));
+		}
+	}
+
+	bool World::hasComponent(const Entity& entity, ComponentId id) const {
+		assert(isAlive(entity) && "entity not alive");
+		return archetypes[records[entity.index].archetype]->hasComponent(id);
+	}
+
+	void* World::getComponent(const Entity& entity, ComponentId id) {
+		assert(isAlive(entity) && "entity not alive");
+		const EntityRecord& record = records[entity.index];
+		return archetypes[record.archetype]->getComponent(record.slot, id);
+	}
+
+	const void* World::getComponent(const Entity& entity, ComponentId id) const {
+		return const_cast<World&>(*this).getComponent(entity, id);
+	}
+
+	uint32_t World::getOrCreateArchetype(ComponentMask mask) {
+		const auto it = archetypeIndices.find(mask);
+		if (it != archetypeIndices.end()) {
+			return it->second;
+		}
+
+		const uint32_t index = static_cast<uint32_t>(archetypes.size());
+		archetypes.push_back(std::make_unique<Archetype>(mask));
+		archetypeIndices.emplace(mask, index);
+		return index;
+	}
+
+	void World::moveToArchetype(const Entity& entity, ComponentMask mask) {
+		assert(iterationDepth == 0 && "structural change while iterating, use a CommandBuffer");
+
+		const uint32_t target = getOrCreateArchetype(mask);
+		const EntityRecord previous = records[entity.index];
+
+		Archetype& source = *archetypes[previous.archetype];
+		Archetype& destination = *archetypes[target];
+
+		const EntitySlot slot = destination.allocate(entity);
+		Archetype::copyComponents(source, previous.slot, destination, slot);
+		removeFromArchetype(previous);
+
+		EntityRecord& record = records[entity.index];
+		record.archetype = target;
+		record.slot = slot;
+	}
+
+	void World::removeFromArchetype(const EntityRecord& record) {
+		const std::optional<Entity> moved = archetypes[record.archetype]->remove(record.slot);
+		if (moved) {
+			records[moved->index].slot = record.slot;
+		}
+	}
+
+}
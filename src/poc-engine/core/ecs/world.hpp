@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cassert>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "../span.hpp"
+#include "archetype.hpp"
+#include "component.hpp"
+#include "entity.hpp"
+
+namespace poc {
+
+	/*
+	 * Archetype based entity component system.
+	 *
+	 * Entities with the same set of components share an Archetype, iterations walk its chunks and
+	 * hand out tightly packed component arrays. Adding or removing a component moves the entity to
+	 * another archetype: structural changes are forbidden while iterating, record them in a
+	 * CommandBuffer and apply it afterwards.
+	 */
+	class World {
+	public:
+
+		World();
+
+		World(const World& other);
+		World(World&& other) noexcept = default;
+		World& operator=(const World& other);
+		World& operator=(World&& other) noexcept = default;
+
+		Entity create() {
+			return create(ComponentMask{ 0 });
+		}
+
+		// the entity is created directly in its final archetype
+		template<class... C>
+		Entity create(const C&... components) {
+			const Entity entity = create(Components::getMask<C...>());
+			((get<C>(entity) = components), ...);
+			return entity;
+		}
+
+		// components of the mask are zeroed
+		Entity create(ComponentMask mask);
+
+		void destroy(const Entity& entity);
+
+		bool isAlive(const Entity& entity) const {
+			return entity.index < records.size() && records[entity.index].generation == entity.generation;
+		}
+
+		size_t getEntityCount() const {
+			return entityCount;
+		}
+
+		size_t getArchetypeCount() const {
+			return archetypes.size();
+		}
+
+		// replaces the component value if already present
+		template<class C>
+		void add(const Entity& entity, const C& component) {
+			addComponent(entity, Components::getId<C>(), &component);
+		}
+
+		template<class C>
+		void remove(const Entity& entity) {
+			removeComponent(entity, Components::getId<C>());
+		}
+
+		template<class C>
+		bool has(const Entity& entity) const {
+			return hasComponent(entity, Components::getId<C>());
+		}
+
+		template<class C>
+		C& get(const Entity& entity) {
+			return *static_cast<C*>(getComponent(entity, Components::getId<C>()));
+		}
+
+		template<class C>
+		const C& get(const Entity& entity) const {
+			return *static_cast<const C*>(getComponent(entity, Components::getId<C>()));
+		}
+
+		// type erased access, used by the command buffers
+		void addComponent(const Entity& entity, ComponentId id, const void* data);
+		void removeComponent(const Entity& entity, ComponentId id);
+		bool hasComponent(const Entity& entity, ComponentId id) const;
+		void* getComponent(const Entity& entity, ComponentId id);
+		const void* getComponent(const Entity& entity, ComponentId id) const;
+
+		// f(span<const Entity>, span<C>...) for each chunk of the archetypes having all the components
+		template<class... C, class F>
+		void forEachChunk(F&& f) {
+			const IterationScope scope(*this);
+			const ComponentMask required = Components::getMask<C...>();
+			for (const std::unique_ptr<Archetype>& archetype : archetypes) {
+				if ((archetype->getMask() & required) != required) {
+					continue;
+				}
+				for (size_t chunk = 0; chunk < archetype->getChunkCount(); ++chunk) {
+					const size_t count = archetype->getEntityCount(chunk);
+					f(span<const Entity>(archetype->getEntities(chunk), count),
+						span<C>(static_cast<C*>(archetype->getComponents(chunk, Components::getId<std::remove_const_t<C>>())), count)...);
+				}
+			}
+		}
+
+		template<class... C, class F>
+		void forEachChunk(F&& f) const {
+			static_assert((std::is_const_v<C> && ...), "components of a const world are const");
+			const_cast<World&>(*this).forEachChunk<C...>(std::forward<F>(f));
+		}
+
+		// f(Entity, C&...) for each entity having all the components
+		template<class... C, class F>
+		void forEach(F&& f) {
+			forEachChunk<C...>([&f](span<const Entity> entities, span<C>... components) {
+				for (size_t i = 0; i < entities.size(); ++i) {
+					f(entities[i], components[i]...);
+				}
+			});
+		}
+
+		template<class... C, class F>
+		void forEach(F&& f) const {
+			static_assert((std::is_const_v<C> && ...), "components of a const world are const");
+			const_cast<World&>(*this).forEach<C...>(std::forward<F>(f));
+		}
+
+	private:
+
+		struct EntityRecord {
+			uint32_t archetype;
+			EntitySlot slot;
+			uint32_t generation;
+		};
+
+		struct IterationScope {
+			explicit IterationScope(World& w) : world(w) { ++world.iterationDepth; }
+			~IterationScope() { --world.iterationDepth; }
+			World& world;
+		};
+
+		std::vector<EntityRecord> records;
+		std::vector<uint32_t> freeIndices;
+		std::vector<std::unique_ptr<Archetype>> archetypes;
+		std::unordered_map<ComponentMask, uint32_t> archetypeIndices;
+		size_t entityCount{ 0 };
+		uint32_t iterationDepth{ 0 };
+
+		uint32_t getOrCreateArchetype(ComponentMask mask);
+		void moveToArchetype(const Entity& entity, ComponentMask mask);
+		void removeFromArchetype(const EntityRecord& record);
+
+	};
+
+}
@@ -0,0 +1,78 @@
+#include "frustum-culling.hpp"
+
+#include <atomic>
+#include <cassert>
+
+#include "simd.hpp"
+
+using namespace poc;
+
+namespace poc {
+
+	namespace FrustumCulling {
+
+		static size_t cullRange(const Frustum& frustum, const SphereArrays& spheres, uint8_t* visibility, size_t begin, size_t end) {
+			size_t visibleCount = 0;
+			size_t i = begin;
+
+#if defined(POC_SIMD_SSE)
+			__m128 planes[6][4];
+			for (size_t p = 0; p < 6; ++p) {
+				for (glm::length_t c = 0; c < 4; ++c) {
+					planes[p][c] = _mm_set1_ps(frustum.planes[p][c]);
+				}
+			}
+
+			const __m128 zero = _mm_setzero_ps();
+			for (; i + 4 <= end; i += 4) {
+				const __m128 x = _mm_loadu_ps(spheres.centersX.data() + i);
+				const __m128 y = _mm_loadu_ps(spheres.centersY.data() + i);
+				const __m128 z = _mm_loadu_ps(spheres.centersZ.data() + i);
+				const __m128 negativeRadius = _mm_sub_ps(zero, _mm_loadu_ps(spheres.radiuses.data() + i));
+
+				// inside all the planes: distance >= -radius
+				__m128 inside = _mm_cmpeq_ps(zero, zero);
+				for (const __m128(&plane)[4] : planes) {
+					const __m128 distance = _mm_add_ps(
+						_mm_add_ps(_mm_mul_ps(plane[0], x), _mm_mul_ps(plane[1], y)),
+						_mm_add_ps(_mm_mul_ps(plane[2], z), plane[3]));
+					inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+				}
+
+				const int mask = _mm_movemask_ps(inside);
+				for (size_t lane = 0; lane < 4; ++lane) {
+					const uint8_t visible = (mask >> lane) & 1;
+					visibility[i + lane] = visible;
+					visibleCount += visible;
+				}
+			}
+#endif
+
+			for (; i < end; ++i) {
+				const BoundingSphere sphere{
+					glm::vec3(spheres.centersX[i], spheres.centersY[i], spheres.centersZ[i]),
+					spheres.radiuses[i]
+				};
+				visibility[i] = frustum.intersects(sphere) ? 1 : 0;
+				visibleCount += visibility[i];
+			}
+
+			return visibleCount;
+		}
+
+		size_t cull(const Frustum& frustum, const SphereArrays& spheres, span<uint8_t> visibility, JobSystem& jobs) {
+			assert(spheres.centersY.size() == spheres.centersX.size() && "sphere arrays size mismatch");
+			assert(spheres.centersZ.size() == spheres.centersX.size() && "sphere arrays size mismatch");
+			assert(spheres.radiuses.size() == spheres.centersX.size() && "sphere arrays size mismatch");
+			assert(visibility.size() == spheres.centersX.size() && "visibility size mismatch");
+
+			std::atomic<size_t> visibleCount{ 0 };
+			jobs.parallelFor(visibility.size(), batchSize, [&](size_t begin, size_t end) {
+				visibleCount += cullRange(frustum, spheres, visibility.data(), begin, end);
+			});
+			return visibleCount;
+		}
+
+	}
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+#include "frustum.hpp"
+#include "job-system.hpp"
+#include "span.hpp"
+
+namespace poc {
+
+	// bounding spheres in structure of arrays, all the spans have the same size
+	struct SphereArrays {
+		span<const float> centersX;
+		span<const float> centersY;
+		span<const float> centersZ;
+		span<const float> radiuses;
+	};
+
+	namespace FrustumCulling {
+
+		// spheres tested per batch of the parallel culling
+		inline constexpr size_t batchSize = 4096;
+
+		// visibility[i] = 1 when sphere i intersects the frustum, 0 otherwise, returns the visible count
+		// the spheres are tested 4 at a time with SSE
+		size_t cull(const Frustum& frustum, const SphereArrays& spheres, span<uint8_t> visibility, JobSystem& jobs);
+
+	}
+
+}
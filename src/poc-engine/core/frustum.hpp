@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+
+#include "../plateform/platform.hpp"
+#include "bounds.hpp"
+
+namespace poc {
+
+	// normalized planes pointing inside: dot(plane.xyz, point) + plane.w >= 0 for the points inside
+	struct Frustum {
+		std::array<glm::vec4, 6> planes;
+
+		// Vulkan clip space: x & y in [-w, w], depth in [0, w]
+		static Frustum fromViewProjection(const glm::mat4& m) {
+			const auto row = [&m](glm::length_t i) {
+				return glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+			};
+
+			Frustum frustum{ {
+				row(3) + row(0),	// left
+				row(3) - row(0),	// right
+				row(3) + row(1),	// bottom
+				row(3) - row(1),	// top
+				row(2),				// near
+				row(3) - row(2)		// far
+			} };
+
+			for (glm::vec4& plane : frustum.planes) {
+				plane /= glm::length(glm::vec3(plane));
+			}
+			return frustum;
+		}
+
+		bool intersects(const BoundingSphere& sphere) const {
+			for (const glm::vec4& plane : planes) {
+				if (glm::dot(glm::vec3(plane), sphere.center) + plane.w < -sphere.radius) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		// conservative: boxes crossing the corners outside of the frustum may pass
+		bool intersects(const Aabb& aabb) const {
+			const glm::vec3 center = aabb.getCenter();
+			const glm::vec3 extent = aabb.getExtent();
+			for (const glm::vec4& plane : planes) {
+				const glm::vec3 normal(plane);
+				if (glm::dot(normal, center) + plane.w < -glm::dot(glm::abs(normal), extent)) {
+					return false;
+				}
+			}
+			return true;
+		}
+	};
+
+}
@@ -0,0 +1,142 @@
+#include "job-system.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace poc;
+
+namespace poc {
+
+	// shared with the workers: a late worker still holding a completed job finds no batch left
+	struct Job {
+		const std::function<void(size_t, size_t)>* function;
+		size_t count;
+		size_t batchSize;
+		size_t batchCount;
+		std::atomic<size_t> nextBatch{ 0 };
+		std::atomic<size_t> completedBatches{ 0 };
+	};
+
+	class JobSystem::Impl {
+	public:
+
+		explicit Impl(uint32_t threadCount) {
+			if (threadCount == 0) {
+				threadCount = std::max(1u, std::thread::hardware_concurrency());
+			}
+
+			workers.reserve(threadCount - 1);
+			for (uint32_t i = 1; i < threadCount; ++i) {
+				workers.emplace_back([this]() { workerLoop(); });
+			}
+		}
+
+		~Impl() {
+			{
+				const std::lock_guard<std::mutex> lock(mutex);
+				stopping = true;
+			}
+			wake.notify_all();
+			for (std::thread& worker : workers) {
+				worker.join();
+			}
+		}
+
+		uint32_t getThreadCount() const {
+			return static_cast<uint32_t>(workers.size() + 1);
+		}
+
+		void parallelFor(size_t count, size_t batchSize, const std::function<void(size_t, size_t)>& f) {
+			if (count == 0) {
+				return;
+			}
+
+			batchSize = std::max<size_t>(batchSize, 1);
+			const size_t batchCount = (count + batchSize - 1) / batchSize;
+			if (workers.empty() || batchCount == 1) {
+				f(0, count);
+				return;
+			}
+
+			const std::lock_guard<std::mutex> submitLock(submitMutex);
+
+			const auto job = std::make_shared<Job>();
+			job->function = &f;
+			job->count = count;
+			job->batchSize = batchSize;
+			job->batchCount = batchCount;
+
+			{
+				const std::lock_guard<std::mutex> lock(mutex);
+				currentJob = job;
+				++jobGeneration;
+			}
+			wake.notify_all();
+
+			runBatches(*job);
+
+			std::unique_lock<std::mutex> lock(mutex);
+			done.wait(lock, [&job]() { return job->completedBatches == job->batchCount; });
+			currentJob.reset();
+		}
+
+	private:
+		std::vector<std::thread> workers;
+		std::mutex submitMutex;
+		std::mutex mutex;
+		std::condition_variable wake;
+		std::condition_variable done;
+		std::shared_ptr<Job> currentJob;
+		uint64_t jobGeneration{ 0 };
+		bool stopping{ false };
+
+		void runBatches(Job& job) {
+			for (size_t batch = job.nextBatch++; batch < job.batchCount; batch = job.nextBatch++) {
+				const size_t begin = batch * job.batchSize;
+				const size_t end = std::min(begin + job.batchSize, job.count);
+				(*job.function)(begin, end);
+
+				if (++job.completedBatches == job.batchCount) {
+					const std::lock_guard<std::mutex> lock(mutex);
+					done.notify_all();
+				}
+			}
+		}
+
+		void workerLoop() {
+			uint64_t seenGeneration = 0;
+			while (true) {
+				std::shared_ptr<Job> job;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					wake.wait(lock, [&]() { return stopping || (currentJob && jobGeneration != seenGeneration); });
+					if (stopping) {
+						return;
+					}
+					seenGeneration = jobGeneration;
+					job = currentJob;
+				}
+				runBatches(*job);
+			}
+		}
+
+	};
+
+	JobSystem::JobSystem(uint32_t threadCount) :
+		pimpl(make_unique_pimpl<JobSystem::Impl>(threadCount)) {}
+
+	uint32_t JobSystem::getThreadCount() const {
+		return pimpl->getThreadCount();
+	}
+
+	void JobSystem::parallelFor(size_t count, size_t batchSize, const std::function<void(size_t, size_t)>& f) {
+		pimpl->parallelFor(count, batchSize, f);
+	}
+
+}
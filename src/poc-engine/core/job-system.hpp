@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "pimpl_ptr.hpp"
+
+namespace poc {
+
+	/*
+	 * Pool of worker threads running data parallel loops.
+	 *
+	 * parallelFor splits a range in batches picked by the workers and by the calling thread, it returns
+	 * once the whole range is processed. Calls are serialized and must not be nested, the function must
+	 * not throw.
+	 */
+	class JobSystem {
+	public:
+
+		// 0: one thread per hardware thread, the calling thread included
+		explicit JobSystem(uint32_t threadCount = 0);
+
+		// workers + calling thread
+		uint32_t getThreadCount() const;
+
+		// f(begin, end) on batches of at most batchSize elements
+		void parallelFor(size_t count, size_t batchSize, const std::function<void(size_t, size_t)>& f);
+
+	private:
+		class Impl;
+		pimpl_ptr<Impl> pimpl;
+	};
+
+}
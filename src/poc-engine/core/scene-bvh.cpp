@@ -0,0 +1,63 @@
+#include "scene-bvh.hpp"
+
+using namespace poc;
+
+namespace poc {
+
+	void SceneBvh::update(const Scene& scene, JobSystem& jobs) {
+		gatheredEntities.clear();
+		meshes.clear();
+		transforms.clear();
+		scene.getWorld().forEachChunk<const MeshComponent, const TransformComponent>([&](
+			span<const Entity> chunkEntities,
+			span<const MeshComponent> meshComponents,
+			span<const TransformComponent> transformComponents) {
+
+			gatheredEntities.insert(gatheredEntities.end(), chunkEntities.begin(), chunkEntities.end());
+			meshes.insert(meshes.end(), meshComponents.begin(), meshComponents.end());
+			transforms.insert(transforms.end(), transformComponents.begin(), transformComponents.end());
+		});
+
+		const span<const MeshRange> sceneMeshes = scene.getMeshes();
+		const TransformHierarchy& hierarchy = scene.getTransforms();
+		worldBounds.resize(gatheredEntities.size());
+		jobs.parallelFor(worldBounds.size(), batchSize, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				worldBounds[i] = transformAabb(sceneMeshes[meshes[i].mesh].bounds.aabb, hierarchy.getWorldMatrix(transforms[i].node));
+			}
+		});
+
+		// the chunks keep their order until a structural change
+		if (gatheredEntities == entities) {
+			bvh.update(worldBounds);
+		}
+		else {
+			entities.swap(gatheredEntities);
+			bvh.build(worldBounds);
+		}
+	}
+
+	void SceneBvh::cull(const Frustum& frustum, std::vector<Entity>& visibleEntities) const {
+		std::vector<uint32_t> objects;
+		bvh.cull(frustum, objects);
+		toEntities(objects, visibleEntities);
+	}
+
+	SceneRayHit SceneBvh::raycast(const Ray& ray, float maxDistance) const {
+		const RayHit hit = bvh.raycast(ray, maxDistance);
+		return hit.isHit() ? SceneRayHit{ entities[hit.object], hit.distance } : SceneRayHit{};
+	}
+
+	void SceneBvh::overlap(const Aabb& aabb, std::vector<Entity>& overlappingEntities) const {
+		std::vector<uint32_t> objects;
+		bvh.overlap(aabb, objects);
+		toEntities(objects, overlappingEntities);
+	}
+
+	void SceneBvh::toEntities(const std::vector<uint32_t>& objects, std::vector<Entity>& outEntities) const {
+		for (const uint32_t object : objects) {
+			outEntities.push_back(entities[object]);
+		}
+	}
+
+}
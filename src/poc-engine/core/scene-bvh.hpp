@@ -0,0 +1,78 @@
+#pragma once
+
+#include <limits>
+#include <vector>
+
+#include "bvh.hpp"
+#include "job-system.hpp"
+#include "scene.hpp"
+
+namespace poc {
+
+	struct SceneRayHit {
+		Entity entity{};
+		float distance{ std::numeric_limits<float>::max() };
+
+		bool isHit() const {
+			return distance != std::numeric_limits<float>::max();
+		}
+	};
+
+	/*
+	 * Bounding volume hierarchy over the world boxes of the entities drawing a mesh.
+	 *
+	 * update() gathers the entities from the packed ECS arrays and computes their world boxes in
+	 * parallel. While the set of entities is the same as on the previous update the tree is only refitted
+	 * (and partially rebuilt when degraded), a new tree is built when entities were created or destroyed.
+	 * The transform hierarchy must be updated first.
+	 */
+	class SceneBvh {
+	public:
+
+		// entities updated per batch of the parallel bounds computation
+		static constexpr size_t batchSize = 2048;
+
+		void update(const Scene& scene, JobSystem& jobs);
+
+		void cull(const Frustum& frustum, std::vector<Entity>& visibleEntities) const;
+
+		// hierarchical frustum culling of the bvh objects, e.g. to draw them
+		void cullObjects(const Frustum& frustum, std::vector<uint32_t>& visibleObjects) const {
+			bvh.cull(frustum, visibleObjects);
+		}
+
+		// picking: nearest entity box hit by the ray
+		SceneRayHit raycast(const Ray& ray, float maxDistance = std::numeric_limits<float>::max()) const;
+
+		void overlap(const Aabb& aabb, std::vector<Entity>& overlappingEntities) const;
+
+		const Bvh& getBvh() const {
+			return bvh;
+		}
+
+		// bvh object i is entity i, drawing mesh i with transform i as of the last update
+		span<const Entity> getEntities() const {
+			return entities;
+		}
+
+		span<const MeshComponent> getMeshComponents() const {
+			return meshes;
+		}
+
+		span<const TransformComponent> getTransformComponents() const {
+			return transforms;
+		}
+
+	private:
+		Bvh bvh;
+		std::vector<Entity> entities;
+		std::vector<Entity> gatheredEntities;
+		std::vector<MeshComponent> meshes;
+		std::vector<TransformComponent> transforms;
+		std::vector<Aabb> worldBounds;
+
+		void toEntities(const std::vector<uint32_t>& objects, std::vector<Entity>& outEntities) const;
+
+	};
+
+}
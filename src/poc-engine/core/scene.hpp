@@ -1,43 +1,419 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
 #include "../rendering/mesh.hpp"
+#include "../rendering/vertex-quantization.hpp"
+#include "array-storage.hpp"
+#include "camera.hpp"
+#include "ecs/world.hpp"
+#include "span.hpp"
+#include "transform-hierarchy.hpp"
 
 namespace poc {
 
+	// indices of a level of detail in the scene arena, error in mesh units
+	struct MeshLodRange {
+		uint32_t firstIndex;
+		uint32_t indexCount;
+		float error;
+	};
+
+	// location of a mesh inside the scene arenas, indices are relative to firstVertex
+	// firstVertex is in the arena of the mesh format: vertices for FLOAT32, packed vertices otherwise
+	// firstIndex & indexCount are the full detail level, lods[0]
+	// meshlets of the full detail level are getMeshlets()[firstMeshlet, firstMeshlet + meshletCount)
+	struct MeshRange {
+		uint32_t firstVertex;
+		uint32_t vertexCount;
+		uint32_t firstIndex;
+		uint32_t indexCount;
+		VertexFormat format;
+		Dequantization dequantization;
+		MeshBounds bounds;
+		uint32_t lodCount;
+		std::array<MeshLodRange, maxMeshLods> lods;
+		uint32_t firstMeshlet;
+		uint32_t meshletCount;
+	};
+
+	// static instances of a mesh drawn with a single instanced draw: getInstances()[firstInstance, firstInstance + instanceCount)
+	// the world sphere bounds all the instances, it is culled & its level of detail selected as a whole
+	struct InstanceBatch {
+		uint32_t mesh;
+		uint32_t firstInstance;
+		uint32_t instanceCount;
+		BoundingSphere bounds;
+		// largest scale of the instance transforms
+		float maxScale;
+	};
+
+	// arenas of the scene geometry, the layout of the binary mesh files
+	struct SceneGeometry {
+		span<const Vertex> vertices;
+		span<const PackedVertex> packedVertices;
+		span<const uint32_t> indices;
+		span<const Meshlet> meshlets;
+		span<const MeshRange> meshes;
+	};
+
+	// entity drawing a mesh of the scene
+	struct MeshComponent {
+		uint32_t mesh;
+	};
+
+	// entity placed by a node of the scene transform hierarchy
+	struct TransformComponent {
+		TransformNode node;
+	};
+
 	class Scene {
 	public:
 
 		explicit Scene() :
-			vertexCount(0),
-			meshs(0) {}
+			id(nextId()),
+			generation(nextGeneration()),
+			lineage(makeLineage()),
+			vertices(),
+			packedVertices(),
+			indices(),
+			meshlets(),
+			meshs(),
+			instances(0),
+			instanceBatches(0),
+			world(),
+			transforms(),
+			camera() {}
+
+		// pre-allocate the arena when the final size is known to ingest without reallocation
+		void reserve(uint32_t vertexCount, uint32_t indexCount = 0, uint32_t meshCount = 0, VertexFormat format = VertexFormat::FLOAT32) {
+			if (format == VertexFormat::FLOAT32) {
+				vertices.getVector().reserve(vertexCount);
+			}
+			else {
+				packedVertices.getVector().reserve(vertexCount);
+			}
+			indices.getVector().reserve(indexCount);
+			meshs.getVector().reserve(meshCount);
+		}
+
+		// the arenas view the given geometry without copying it, e.g. a mapped file kept alive by the storage
+		// adding a mesh afterwards copies the arenas once, throws when the scene already has meshes or instances
+		void setGeometry(const SceneGeometry& geometry, std::shared_ptr<const void> storage) {
+			if (!meshs.empty() || !instanceBatches.empty()) {
+				throw std::runtime_error("The scene already has a geometry");
+			}
+			vertices = ArrayStorage<Vertex>(geometry.vertices);
+			packedVertices = ArrayStorage<PackedVertex>(geometry.packedVertices);
+			indices = ArrayStorage<uint32_t>(geometry.indices);
+			meshlets = ArrayStorage<Meshlet>(geometry.meshlets);
+			meshs = ArrayStorage<MeshRange>(geometry.meshes);
+			geometryStorage = std::move(storage);
+			lineage = makeLineage();
+
+			maxMeshVertexCount = 0;
+			for (const MeshRange& mesh : geometry.meshes) {
+				maxMeshVertexCount = std::max(maxMeshVertexCount, mesh.vertexCount);
+			}
+			generation = nextGeneration();
+		}
+
+		SceneGeometry getGeometry() const {
+			return SceneGeometry{ vertices, packedVertices, indices, meshlets, meshs };
+		}
+
+		// appends the meshes of another geometry, already converted to their formats, returns the index of the first one
+		uint32_t addGeometry(const SceneGeometry& geometry) {
+			beginAppend();
+			const uint32_t firstMesh = static_cast<uint32_t>(meshs.size());
+			const uint32_t vertexOffset = static_cast<uint32_t>(vertices.size());
+			const uint32_t packedVertexOffset = static_cast<uint32_t>(packedVertices.size());
+			const uint32_t indexOffset = static_cast<uint32_t>(indices.size());
+			const uint32_t meshletOffset = static_cast<uint32_t>(meshlets.size());
+
+			vertices.getVector().insert(vertices.getVector().end(), geometry.vertices.begin(), geometry.vertices.end());
+			packedVertices.getVector().insert(packedVertices.getVector().end(), geometry.packedVertices.begin(), geometry.packedVertices.end());
+			indices.getVector().insert(indices.getVector().end(), geometry.indices.begin(), geometry.indices.end());
+			for (Meshlet meshlet : geometry.meshlets) {
+				meshlet.firstIndex += indexOffset;
+				meshlets.getVector().push_back(meshlet);
+			}
+			for (MeshRange range : geometry.meshes) {
+				range.firstVertex += range.format == VertexFormat::FLOAT32 ? vertexOffset : packedVertexOffset;
+				range.firstIndex += indexOffset;
+				for (uint32_t lod = 0; lod < range.lodCount; ++lod) {
+					range.lods[lod].firstIndex += indexOffset;
+				}
+				range.firstMeshlet += meshletOffset;
+				meshs.getVector().push_back(range);
+				maxMeshVertexCount = std::max(maxMeshVertexCount, range.vertexCount);
+			}
+
+			generation = nextGeneration();
+			return firstMesh;
+		}
+
+		// returns the index of the mesh, draw it by creating entities referencing it
+		uint32_t addMesh(Mesh&& mesh) {
+			return addMesh(span<const Vertex>(mesh.getVertices()), span<const uint32_t>(mesh.getIndices()), mesh.getVertexFormat(), mesh.getBounds(), mesh.getLods(), mesh.getMeshlets());
+		}
+
+		uint32_t addMesh(span<const Vertex> meshVertices, span<const uint32_t> meshIndices, VertexFormat format = VertexFormat::FLOAT32) {
+			return addMesh(meshVertices, meshIndices, format, computeMeshBounds(meshVertices), {}, {});
+		}
+
+		// instances of the mesh stored once per instance, without copy of the geometry, white when no colors are given
+		// returns the index of the batch, they are uploaded with the geometry
+		uint32_t addInstances(uint32_t mesh, span<const glm::mat4> transforms, span<const glm::vec3> colors = {}) {
+			assert(mesh < meshs.size() && "unknown mesh");
+			assert(!transforms.empty() && "no instances");
+			assert((colors.empty() || colors.size() == transforms.size()) && "one color per instance");
+			beginAppend();
+
+			// sphere around the box of the instance spheres
+			const BoundingSphere& sphere = meshs[mesh].bounds.sphere;
+			Aabb box;
+			float maxScale = 0.0f;
+			for (const glm::mat4& transform : transforms) {
+				const BoundingSphere instanceSphere = transformSphere(sphere, transform);
+				box.expand(instanceSphere.center - instanceSphere.radius);
+				box.expand(instanceSphere.center + instanceSphere.radius);
+				maxScale = std::max(maxScale, getMaxScale(transform));
+			}
+			BoundingSphere bounds{ box.getCenter(), 0.0f };
+
+			const uint32_t firstInstance = static_cast<uint32_t>(instances.size());
+			for (size_t i = 0; i < transforms.size(); ++i) {
+				instances.push_back(VertexQuantization::packInstance(transforms[i], colors.empty() ? glm::vec3(1.0f) : colors[i]));
+				const BoundingSphere instanceSphere = transformSphere(sphere, transforms[i]);
+				bounds.radius = std::max(bounds.radius, glm::distance(bounds.center, instanceSphere.center) + instanceSphere.radius);
+			}
+
+			instanceBatches.push_back(InstanceBatch{ mesh, firstInstance, static_cast<uint32_t>(transforms.size()), bounds, maxScale });
+			generation = nextGeneration();
+			return static_cast<uint32_t>(instanceBatches.size() - 1);
+		}
+
+		// the instances & batches as returned by getInstances() & getInstanceBatches(), e.g. restored from a file
+		// throws when the scene already has instances
+		void setInstances(span<const Instance> sceneInstances, span<const InstanceBatch> batches) {
+			if (!instanceBatches.empty()) {
+				throw std::runtime_error("The scene already has instances");
+			}
+			instances.assign(sceneInstances.begin(), sceneInstances.end());
+			instanceBatches.assign(batches.begin(), batches.end());
+			lineage = makeLineage();
+			generation = nextGeneration();
+		}
+
+		// the entity gets its own root transform node
+		Entity createEntity(uint32_t mesh) {
+			return createEntity(mesh, transforms.create());
+		}
+
+		Entity createEntity(uint32_t mesh, TransformNode node) {
+			assert(mesh < meshs.size() && "unknown mesh");
+			return world.create(MeshComponent{ mesh }, TransformComponent{ node });
+		}
+
+		// entities of the scene, read every frame by the renderer
+		World& getWorld() {
+			return world;
+		}
+
+		const World& getWorld() const {
+			return world;
+		}
+
+		TransformHierarchy& getTransforms() {
+			return transforms;
+		}
 
-		void addMesh(Mesh&& mesh) {
-			const std::vector<Vertex> vertices = mesh.getVertices();
-			vertexCount += static_cast<uint32_t>(vertices.size());
-			meshs.emplace_back(mesh);
+		const TransformHierarchy& getTransforms() const {
+			return transforms;
+		}
+
+		Camera& getCamera() {
+			return camera;
+		}
+
+		const Camera& getCamera() const {
+			return camera;
+		}
+
+		// identity of the scene, shared by its copies
+		uint64_t getId() const {
+			return id;
+		}
+
+		// stamp changed on every geometry modification, never reused across scenes
+		// entities are not part of it: they do not require a new upload
+		uint64_t getGeneration() const {
+			return generation;
+		}
+
+		// stamp of the arenas content, shared by the copies of the scene: changed when the arenas are replaced or
+		// when a copy appends to arenas shared with another one, the arenas seen by an older generation of the
+		// same lineage are a prefix of the current ones
+		uint64_t getLineage() const {
+			return *lineage;
 		}
 
 		uint32_t getVertexCount() const {
-			return vertexCount;
+			return static_cast<uint32_t>(vertices.size() + packedVertices.size());
 		};
 
+		uint32_t getIndexCount() const {
+			return static_cast<uint32_t>(indices.size());
+		};
+
+		// largest vertex count of a single mesh, i.e. the range needed by the indices
+		uint32_t getMaxMeshVertexCount() const {
+			return maxMeshVertexCount;
+		}
+
 		bool isEmpty() const {
-			return vertexCount == 0;
+			return indices.empty();
 		}
 
-		std::vector<Vertex> getVertexes() const {
-			std::vector<Vertex> vertices;
-			vertices.reserve(vertexCount);
-			for (const auto mesh : meshs) {
-				const auto v = mesh.getVertices();
-				std::copy(v.cbegin(), v.cend(), std::back_inserter(vertices));
-			}
+		// all the FLOAT32 vertices of the scene, meshes are stored contiguously
+		span<const Vertex> getVertices() const {
 			return vertices;
 		};
 
+		// all the vertices of the scene using a packed format
+		span<const PackedVertex> getPackedVertices() const {
+			return packedVertices;
+		};
+
+		// all the indices of the scene, levels of detail included, relative to the first vertex of their mesh
+		span<const uint32_t> getIndices() const {
+			return indices;
+		};
+
+		// all the meshlets of the scene, their first index is in the scene index arena
+		span<const Meshlet> getMeshlets() const {
+			return meshlets;
+		}
+
+		span<const MeshRange> getMeshes() const {
+			return meshs;
+		}
+
+		// all the instances of the scene, batches are stored contiguously
+		span<const Instance> getInstances() const {
+			return instances;
+		}
+
+		span<const InstanceBatch> getInstanceBatches() const {
+			return instanceBatches;
+		}
+
+		span<const Vertex> getMeshVertices(const MeshRange& mesh) const {
+			assert(mesh.format == VertexFormat::FLOAT32 && "mesh vertices are packed");
+			return getVertices().subspan(mesh.firstVertex, mesh.vertexCount);
+		}
+
+		span<const PackedVertex> getMeshPackedVertices(const MeshRange& mesh) const {
+			assert(mesh.format != VertexFormat::FLOAT32 && "mesh vertices are not packed");
+			return getPackedVertices().subspan(mesh.firstVertex, mesh.vertexCount);
+		}
+
+		span<const uint32_t> getMeshIndices(const MeshRange& mesh) const {
+			return getIndices().subspan(mesh.firstIndex, mesh.indexCount);
+		}
+
+		span<const Meshlet> getMeshMeshlets(const MeshRange& mesh) const {
+			return getMeshlets().subspan(mesh.firstMeshlet, mesh.meshletCount);
+		}
+
 	private:
-		uint32_t vertexCount;
-		std::vector<Mesh> meshs;
+		uint64_t id;
+		uint64_t generation;
+		std::shared_ptr<const uint64_t> lineage;
+		ArrayStorage<Vertex> vertices;
+		ArrayStorage<PackedVertex> packedVertices;
+		ArrayStorage<uint32_t> indices;
+		ArrayStorage<Meshlet> meshlets;
+		ArrayStorage<MeshRange> meshs;
+		// external storage of the arenas, if any
+		std::shared_ptr<const void> geometryStorage;
+		std::vector<Instance> instances;
+		std::vector<InstanceBatch> instanceBatches;
+		uint32_t maxMeshVertexCount{ 0 };
+		World world;
+		TransformHierarchy transforms;
+		Camera camera;
+
+		// packed formats are converted here, once, when the mesh is loaded
+		uint32_t addMesh(span<const Vertex> meshVertices, span<const uint32_t> meshIndices, VertexFormat format, const MeshBounds& bounds, span<const MeshLod> meshLods, span<const Meshlet> meshMeshlets) {
+			assert(meshLods.size() < maxMeshLods && "too many levels of detail");
+			beginAppend();
+			MeshRange range{
+				0,
+				static_cast<uint32_t>(meshVertices.size()),
+				static_cast<uint32_t>(indices.size()),
+				static_cast<uint32_t>(meshIndices.size()),
+				format,
+				Dequantization{},
+				bounds,
+				static_cast<uint32_t>(meshLods.size() + 1),
+				{},
+				static_cast<uint32_t>(meshlets.size()),
+				static_cast<uint32_t>(meshMeshlets.size())
+			};
+
+			if (format == VertexFormat::FLOAT32) {
+				range.firstVertex = static_cast<uint32_t>(vertices.size());
+				vertices.getVector().insert(vertices.getVector().end(), meshVertices.begin(), meshVertices.end());
+			}
+			else {
+				range.firstVertex = static_cast<uint32_t>(packedVertices.size());
+				range.dequantization = VertexQuantization::quantize(meshVertices, format, packedVertices.getVector());
+			}
+
+			std::vector<uint32_t>& indexArena = indices.getVector();
+			indexArena.insert(indexArena.end(), meshIndices.begin(), meshIndices.end());
+			range.lods[0] = MeshLodRange{ range.firstIndex, range.indexCount, 0.0f };
+			for (size_t lod = 0; lod < meshLods.size(); ++lod) {
+				range.lods[lod + 1] = MeshLodRange{ static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(meshLods[lod].indices.size()), meshLods[lod].error };
+				indexArena.insert(indexArena.end(), meshLods[lod].indices.begin(), meshLods[lod].indices.end());
+			}
+			for (Meshlet meshlet : meshMeshlets) {
+				meshlet.firstIndex += range.firstIndex;
+				meshlets.getVector().push_back(meshlet);
+			}
+			meshs.getVector().push_back(range);
+
+			maxMeshVertexCount = std::max(maxMeshVertexCount, range.vertexCount);
+			generation = nextGeneration();
+			return static_cast<uint32_t>(meshs.size() - 1);
+		}
+
+		// the other copies keep the lineage of the arenas as they are
+		void beginAppend() {
+			if (lineage.use_count() > 1) {
+				lineage = makeLineage();
+			}
+		}
+
+		static std::shared_ptr<const uint64_t> makeLineage() {
+			return std::make_shared<const uint64_t>(nextGeneration());
+		}
+
+		static uint64_t nextId() {
+			static std::atomic<uint64_t> counter{ 0 };
+			return ++counter;
+		}
+
+		static uint64_t nextGeneration() {
+			static std::atomic<uint64_t> counter{ 0 };
+			return ++counter;
+		}
 
 	};
 
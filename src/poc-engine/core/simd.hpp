@@ -0,0 +1,39 @@
+#pragma once
+
+#include "../plateform/platform.hpp"
+
+// SSE is part of the x86-64 baseline, other targets use the scalar glm code
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define POC_SIMD_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace poc {
+
+	namespace Simd {
+
+		// column major a * b, same result as the glm operator
+		inline glm::mat4 multiply(const glm::mat4& a, const glm::mat4& b) {
+#if defined(POC_SIMD_SSE)
+			const __m128 a0 = _mm_loadu_ps(&a[0][0]);
+			const __m128 a1 = _mm_loadu_ps(&a[1][0]);
+			const __m128 a2 = _mm_loadu_ps(&a[2][0]);
+			const __m128 a3 = _mm_loadu_ps(&a[3][0]);
+
+			glm::mat4 result;
+			for (glm::length_t column = 0; column < 4; ++column) {
+				const __m128 x = _mm_mul_ps(a0, _mm_set1_ps(b[column][0]));
+				const __m128 y = _mm_mul_ps(a1, _mm_set1_ps(b[column][1]));
+				const __m128 z = _mm_mul_ps(a2, _mm_set1_ps(b[column][2]));
+				const __m128 w = _mm_mul_ps(a3, _mm_set1_ps(b[column][3]));
+				_mm_storeu_ps(&result[column][0], _mm_add_ps(_mm_add_ps(x, y), _mm_add_ps(z, w)));
+			}
+			return result;
+#else
+			return a * b;
+#endif
+		}
+
+	}
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+/*
+ * Non-owning view over a contiguous sequence, subset of C++20 std::span.
+ *
+ * Used to expose internal arrays (scene vertex arena, mapped files...) without
+ * copying them. The viewed storage must outlive the span.
+ */
+namespace poc {
+
+	template<class T>
+	class span {
+	public:
+
+		using element_type = T;
+		using value_type = std::remove_cv_t<T>;
+		using iterator = T*;
+
+		constexpr span() noexcept = default;
+
+		constexpr span(T* data, size_t size) noexcept :
+			ptr(data),
+			count(size) {}
+
+		template<class Container,
+			class = std::enable_if_t<std::is_convertible_v<decltype(std::declval<Container&>().data()), T*>>>
+		constexpr span(Container& container) noexcept :
+			ptr(container.data()),
+			count(container.size()) {}
+
+		template<class U, class = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+		constexpr span(const span<U>& other) noexcept :
+			ptr(other.data()),
+			count(other.size()) {}
+
+		constexpr T* data() const noexcept { return ptr; }
+		constexpr size_t size() const noexcept { return count; }
+		constexpr size_t size_bytes() const noexcept { return count * sizeof(T); }
+		constexpr bool empty() const noexcept { return count == 0; }
+
+		constexpr T& operator[](size_t index) const {
+			assert(index < count && "span index out of range");
+			return ptr[index];
+		}
+
+		constexpr iterator begin() const noexcept { return ptr; }
+		constexpr iterator end() const noexcept { return ptr + count; }
+
+		constexpr span<T> subspan(size_t offset, size_t size) const {
+			assert(offset + size <= count && "subspan out of range");
+			return span<T>(ptr + offset, size);
+		}
+
+	private:
+		T* ptr{ nullptr };
+		size_t count{ 0 };
+
+	};
+
+}
@@ -0,0 +1,182 @@
+#include "transform-hierarchy.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+#include "simd.hpp"
+
+using namespace poc;
+
+namespace poc {
+
+	template<class T>
+	static void permute(std::vector<T>& values, const std::vector<uint32_t>& newIndices) {
+		std::vector<T> permuted(values.size());
+		for (size_t i = 0; i < values.size(); ++i) {
+			permuted[newIndices[i]] = values[i];
+		}
+		values.swap(permuted);
+	}
+
+	TransformNode TransformHierarchy::create(TransformNode parent) {
+		const uint32_t id = static_cast<uint32_t>(indices.size());
+		const uint32_t index = static_cast<uint32_t>(parents.size());
+		const uint32_t parentIndex = parent.isValid() ? indices[parent.id] : noParent;
+		const uint32_t depth = parent.isValid() ? depths[parentIndex] + 1 : 0;
+
+		// appending a node shallower than the last one breaks the breadth-first order, sorted on next update
+		if (!depths.empty() && depth < depths.back()) {
+			breadthFirst = false;
+		}
+
+		parents.push_back(parentIndex);
+		depths.push_back(depth);
+		localPositions.emplace_back(0.0f);
+		localRotations.emplace_back(1.0f, 0.0f, 0.0f, 0.0f);
+		localScales.emplace_back(1.0f);
+		worldMatrices.emplace_back(1.0f);
+		dirty.push_back(1);
+		ids.push_back(id);
+		indices.push_back(index);
+
+		if (breadthFirst) {
+			if (levelOffsets.empty()) {
+				levelOffsets.push_back(0);
+			}
+			if (depth == getLevelCount()) {
+				levelOffsets.push_back(index + 1);
+			}
+			else {
+				levelOffsets.back() = index + 1;
+			}
+		}
+
+		return TransformNode{ id };
+	}
+
+	void TransformHierarchy::setLocalPosition(TransformNode node, const glm::vec3& position) {
+		const uint32_t index = indices[node.id];
+		localPositions[index] = position;
+		dirty[index] = 1;
+	}
+
+	void TransformHierarchy::setLocalRotation(TransformNode node, const glm::quat& rotation) {
+		const uint32_t index = indices[node.id];
+		localRotations[index] = rotation;
+		dirty[index] = 1;
+	}
+
+	void TransformHierarchy::setLocalScale(TransformNode node, const glm::vec3& scale) {
+		const uint32_t index = indices[node.id];
+		localScales[index] = scale;
+		dirty[index] = 1;
+	}
+
+	void TransformHierarchy::setData(const TransformHierarchyData& data) {
+		const size_t count = data.parents.size();
+		assert(data.depths.size() == count && data.localPositions.size() == count && data.localRotations.size() == count
+			&& data.localScales.size() == count && data.ids.size() == count && "one value per node");
+
+		parents.assign(data.parents.begin(), data.parents.end());
+		depths.assign(data.depths.begin(), data.depths.end());
+		localPositions.assign(data.localPositions.begin(), data.localPositions.end());
+		localRotations.assign(data.localRotations.begin(), data.localRotations.end());
+		localScales.assign(data.localScales.begin(), data.localScales.end());
+		worldMatrices.assign(count, glm::mat4(1.0f));
+		dirty.assign(count, 1);
+		ids.assign(data.ids.begin(), data.ids.end());
+
+		indices.resize(count);
+		for (size_t i = 0; i < count; ++i) {
+			indices[ids[i]] = static_cast<uint32_t>(i);
+		}
+
+		// the levels of a breadth-first storage are kept, any other order is sorted on next update
+		breadthFirst = std::is_sorted(depths.begin(), depths.end());
+		levelOffsets.clear();
+		if (breadthFirst && count > 0) {
+			levelOffsets.assign(depths.back() + 2, 0);
+			for (const uint32_t depth : depths) {
+				++levelOffsets[depth + 1];
+			}
+			for (size_t level = 1; level < levelOffsets.size(); ++level) {
+				levelOffsets[level] += levelOffsets[level - 1];
+			}
+		}
+	}
+
+	void TransformHierarchy::update(JobSystem& jobs) {
+		if (!breadthFirst) {
+			sortByLevel();
+		}
+
+		// a level only depends on the previous one, its nodes are independent
+		std::atomic<size_t> updateCount{ 0 };
+		for (size_t level = 0; level < getLevelCount(); ++level) {
+			const size_t levelBegin = levelOffsets[level];
+			jobs.parallelFor(levelOffsets[level + 1] - levelBegin, batchSize, [&](size_t begin, size_t end) {
+				updateCount += updateRange(levelBegin + begin, levelBegin + end);
+			});
+		}
+
+		lastUpdateCount = updateCount;
+		std::fill(dirty.begin(), dirty.end(), uint8_t{ 0 });
+	}
+
+	size_t TransformHierarchy::updateRange(size_t begin, size_t end) {
+		size_t count = 0;
+		for (size_t i = begin; i < end; ++i) {
+			const uint32_t parent = parents[i];
+			if (parent != noParent) {
+				dirty[i] |= dirty[parent];
+			}
+			if (!dirty[i]) {
+				continue;
+			}
+
+			const glm::mat4 local = composeTransform(localPositions[i], localRotations[i], localScales[i]);
+			worldMatrices[i] = parent == noParent ? local : Simd::multiply(worldMatrices[parent], local);
+			++count;
+		}
+		return count;
+	}
+
+	void TransformHierarchy::sortByLevel() {
+		const uint32_t levelCount = *std::max_element(depths.begin(), depths.end()) + 1;
+
+		// counting sort by depth, stable to keep the siblings order
+		levelOffsets.assign(levelCount + 1, 0);
+		for (const uint32_t depth : depths) {
+			++levelOffsets[depth + 1];
+		}
+		for (uint32_t level = 0; level < levelCount; ++level) {
+			levelOffsets[level + 1] += levelOffsets[level];
+		}
+
+		std::vector<uint32_t> cursors(levelOffsets.begin(), levelOffsets.end() - 1);
+		std::vector<uint32_t> newIndices(depths.size());
+		for (size_t i = 0; i < depths.size(); ++i) {
+			newIndices[i] = cursors[depths[i]]++;
+		}
+
+		permute(parents, newIndices);
+		permute(depths, newIndices);
+		permute(localPositions, newIndices);
+		permute(localRotations, newIndices);
+		permute(localScales, newIndices);
+		permute(worldMatrices, newIndices);
+		permute(dirty, newIndices);
+		permute(ids, newIndices);
+
+		for (size_t i = 0; i < parents.size(); ++i) {
+			if (parents[i] != noParent) {
+				parents[i] = newIndices[parents[i]];
+			}
+			indices[ids[i]] = static_cast<uint32_t>(i);
+		}
+
+		breadthFirst = true;
+	}
+
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "../plateform/platform.hpp"
+#include "glm/gtc/quaternion.hpp"
+#include "job-system.hpp"
+#include "span.hpp"
+
+namespace poc {
+
+	// stable handle of a node, its storage index changes when the hierarchy is reordered
+	struct TransformNode {
+		uint32_t id{ std::numeric_limits<uint32_t>::max() };
+
+		bool isValid() const {
+			return id != std::numeric_limits<uint32_t>::max();
+		}
+	};
+
+	// translation * rotation * scale, the local matrix of a node
+	inline glm::mat4 composeTransform(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale) {
+		const glm::mat3 r = glm::mat3_cast(rotation);
+		return glm::mat4(
+			glm::vec4(r[0] * scale.x, 0.0f),
+			glm::vec4(r[1] * scale.y, 0.0f),
+			glm::vec4(r[2] * scale.z, 0.0f),
+			glm::vec4(position, 1.0f));
+	}
+
+	// storage arrays of a hierarchy, one value per node in storage order
+	// parents are storage indices, TransformHierarchy::noParent for the roots, ids are the node of each index
+	struct TransformHierarchyData {
+		span<const uint32_t> parents;
+		span<const uint32_t> depths;
+		span<const glm::vec3> localPositions;
+		span<const glm::quat> localRotations;
+		span<const glm::vec3> localScales;
+		span<const uint32_t> ids;
+	};
+
+	/*
+	 * Parent/child local transforms and their world matrices.
+	 *
+	 * Nodes are stored breadth-first in structure of arrays: all the nodes of a level are contiguous and
+	 * follow the previous level, so a parent is always updated before its children. update() recomputes
+	 * the world matrices of the dirty subtrees only, level by level, each level split across the threads.
+	 */
+	class TransformHierarchy {
+	public:
+
+		// nodes updated per batch of a parallel level update
+		static constexpr size_t batchSize = 1024;
+
+		static constexpr uint32_t noParent = std::numeric_limits<uint32_t>::max();
+
+		// root node when the parent is not valid
+		TransformNode create(TransformNode parent = TransformNode{});
+
+		size_t getNodeCount() const {
+			return parents.size();
+		}
+
+		size_t getLevelCount() const {
+			return levelOffsets.empty() ? 0 : levelOffsets.size() - 1;
+		}
+
+		void setLocalPosition(TransformNode node, const glm::vec3& position);
+		void setLocalRotation(TransformNode node, const glm::quat& rotation);
+		void setLocalScale(TransformNode node, const glm::vec3& scale);
+
+		const glm::vec3& getLocalPosition(TransformNode node) const {
+			return localPositions[indices[node.id]];
+		}
+
+		const glm::quat& getLocalRotation(TransformNode node) const {
+			return localRotations[indices[node.id]];
+		}
+
+		const glm::vec3& getLocalScale(TransformNode node) const {
+			return localScales[indices[node.id]];
+		}
+
+		// value of the last update()
+		const glm::mat4& getWorldMatrix(TransformNode node) const {
+			return worldMatrices[indices[node.id]];
+		}
+
+		// all the world matrices, in storage order
+		span<const glm::mat4> getWorldMatrices() const {
+			return worldMatrices;
+		}
+
+		void update(JobSystem& jobs);
+
+		// the arrays as stored, e.g. to save the hierarchy
+		TransformHierarchyData getData() const {
+			return TransformHierarchyData{ parents, depths, localPositions, localRotations, localScales, ids };
+		}
+
+		// replaces all the nodes by copying the arrays, the world matrices are computed by the next update()
+		// the data must be consistent: the ids a permutation of the indices, the depth of a node the one of its parent + 1
+		void setData(const TransformHierarchyData& data);
+
+		// number of world matrices recomputed by the last update()
+		size_t getLastUpdateCount() const {
+			return lastUpdateCount;
+		}
+
+	private:
+		// storage order, indexed by node index
+		std::vector<uint32_t> parents;
+		std::vector<uint32_t> depths;
+		std::vector<glm::vec3> localPositions;
+		std::vector<glm::quat> localRotations;
+		std::vector<glm::vec3> localScales;
+		std::vector<glm::mat4> worldMatrices;
+		std::vector<uint8_t> dirty;
+		std::vector<uint32_t> ids;
+
+		// node index of each id
+		std::vector<uint32_t> indices;
+
+		// nodes of level l are in [levelOffsets[l], levelOffsets[l + 1])
+		std::vector<uint32_t> levelOffsets;
+		bool breadthFirst{ true };
+		size_t lastUpdateCount{ 0 };
+
+		void sortByLevel();
+		size_t updateRange(size_t begin, size_t end);
+
+	};
+
+}
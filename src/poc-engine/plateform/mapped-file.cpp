@@ -0,0 +1,121 @@
+#include "mapped-file.hpp"
+
+#include <stdexcept>
+
+#include "../core/logger.hpp"
+
+#if defined( _WIN32 )
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace poc;
+
+namespace poc {
+
+	static constexpr char logTag[]{ "POC::MappedFile" };
+
+	[[noreturn]] static void fail(const std::string& message) {
+		Logger::error(logTag, message);
+		throw std::runtime_error(message);
+	}
+
+#if defined( _WIN32 )
+
+	MappedFile::MappedFile(const std::string& p) :
+		path(p) {
+
+		file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			file = nullptr;
+			fail("Failed to open " + path);
+		}
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize)) {
+			CloseHandle(file);
+			fail("Failed to get the size of " + path);
+		}
+		size = static_cast<size_t>(fileSize.QuadPart);
+
+		// an empty file cannot be mapped, its content is empty
+		if (size == 0) {
+			return;
+		}
+
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping) {
+			CloseHandle(file);
+			fail("Failed to map " + path);
+		}
+
+		data = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		if (!data) {
+			CloseHandle(mapping);
+			CloseHandle(file);
+			fail("Failed to map " + path);
+		}
+	}
+
+	MappedFile::~MappedFile() {
+		if (data) {
+			UnmapViewOfFile(data);
+		}
+		if (mapping) {
+			CloseHandle(mapping);
+		}
+		if (file) {
+			CloseHandle(file);
+		}
+	}
+
+#else
+
+	MappedFile::MappedFile(const std::string& p) :
+		path(p) {
+
+		const int file = open(path.c_str(), O_RDONLY);
+		if (file < 0) {
+			fail("Failed to open " + path);
+		}
+
+		struct stat status;
+		if (fstat(file, &status) != 0) {
+			close(file);
+			fail("Failed to get the size of " + path);
+		}
+		size = static_cast<size_t>(status.st_size);
+
+		// an empty file cannot be mapped, its content is empty
+		if (size == 0) {
+			close(file);
+			return;
+		}
+
+		void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+		// the mapping keeps its own reference to the file
+		close(file);
+		if (address == MAP_FAILED) {
+			fail("Failed to map " + path);
+		}
+
+		// the content is mostly read once, in order, by the upload
+		madvise(address, size, MADV_SEQUENTIAL);
+		data = static_cast<const std::byte*>(address);
+	}
+
+	MappedFile::~MappedFile() {
+		if (data) {
+			munmap(const_cast<std::byte*>(data), size);
+		}
+	}
+
+#endif
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "../core/span.hpp"
+
+namespace poc {
+
+	/*
+	 * Read only memory mapping of a whole file.
+	 *
+	 * The pages are loaded by the system when they are first read, the content is neither parsed nor
+	 * copied: views of the mapping can be handed to the upload as they are. The mapping is released
+	 * when the object is destroyed, the views must not outlive it.
+	 */
+	class MappedFile {
+	public:
+
+		// throws when the file cannot be opened or mapped
+		explicit MappedFile(const std::string& path);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		span<const std::byte> getContent() const {
+			return span<const std::byte>(data, size);
+		}
+
+		const std::string& getPath() const {
+			return path;
+		}
+
+	private:
+		std::string path;
+		const std::byte* data{ nullptr };
+		size_t size{ 0 };
+#if defined( _WIN32 )
+		void* file{ nullptr };
+		void* mapping{ nullptr };
+#endif
+	};
+
+}
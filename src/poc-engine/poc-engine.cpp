@@ -1,5 +1,6 @@
 #include "poc-engine.hpp"
 
+#include "core/job-system.hpp"
 #include "core/logger.hpp"
 #include "plateform/window.hpp"
 #include "rendering/graphic-api.hpp"
@@ -20,6 +21,10 @@ namespace poc {
 			scene = s;
 		}
 
+		std::shared_future<LoadResult> loadAsync(const std::string& path, int32_t priority, const CancellationToken& token, LoadCallback callback) override {
+			return assetLoader.load(path, priority, token, std::move(callback));
+		}
+
 		void run() override
 		{
 			Logger::info(logTag, "Starting...");
@@ -27,17 +32,23 @@ namespace poc {
 			const auto window = Window::openWindow(1280, 720, "PocEngine");
 			window->setResizeCallback(std::bind(&PocEngineImpl::onResize, this, std::placeholders::_1, std::placeholders::_2));
 
-			const auto renderingSystem = RenderingSystem::make(*window, GraphicApi::Type::VULKAN);
+			const auto renderingSystem = RenderingSystem::make(*window, GraphicApi::Type::VULKAN, jobSystem);
 
 			Logger::info(logTag, "Started");
 
 			while (!window->isClosing()) {
 				window->update();
+				assetLoader.update(scene, renderingSystem->getResidentGeneration(scene));
+				scene.getTransforms().update(jobSystem);
 				renderingSystem->render(*window.get(), scene);
 			}
 
 			Logger::info(logTag, "Stopping...");
 
+			const UploadStats uploads = renderingSystem->getUploadStats();
+			Logger::info(logTag, std::to_string(uploads.uploadedBytes >> 20) + " MB uploaded in " + std::to_string(uploads.batchCount)
+				+ " batches, " + std::to_string(uploads.stallMilliseconds) + " ms waiting for the GPU");
+
 			Logger::info(logTag, "Stopped");
 
 		}
@@ -48,6 +59,8 @@ namespace poc {
 
 	private:
 		Scene scene;
+		JobSystem jobSystem;
+		AssetLoader assetLoader;
 
 	};
 
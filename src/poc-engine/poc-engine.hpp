@@ -3,6 +3,7 @@
 #include <memory>
 #include <vector>
 
+#include "assets/asset-loader.hpp"
 #include "core/scene.hpp"
 
 namespace poc {
@@ -11,6 +12,8 @@ namespace poc {
 	public:
 
 		virtual void loadScene(const Scene scene) = 0;
+		// streamed into the scene while it runs, see AssetLoader
+		virtual std::shared_future<LoadResult> loadAsync(const std::string& path, int32_t priority = 0, const CancellationToken& token = {}, LoadCallback callback = {}) = 0;
 		virtual void run() = 0;
 		virtual ~PocEngine() {};
 
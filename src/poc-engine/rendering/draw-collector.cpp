@@ -0,0 +1,237 @@
+#include "draw-collector.hpp"
+
+#include <algorithm>
+
+#include "../core/frustum-culling.hpp"
+
+using namespace poc;
+
+namespace poc {
+
+	void DrawCollector::collect(const Scene& scene, JobSystem& jobs, uint32_t viewportHeight) {
+		candidates.clear();
+		candidateEntities.clear();
+		scene.getWorld().forEachChunk<const MeshComponent, const TransformComponent>([&](
+			span<const Entity> entities,
+			span<const MeshComponent> meshComponents,
+			span<const TransformComponent> transformComponents) {
+
+			for (size_t i = 0; i < meshComponents.size(); ++i) {
+				candidates.push_back(Draw{ meshComponents[i].mesh, transformComponents[i].node, 0, 0, 0 });
+				candidateEntities.push_back(entities[i]);
+			}
+		});
+
+		addDraws(scene, jobs, viewportHeight, candidates.size());
+	}
+
+	void DrawCollector::collect(const Scene& scene, const SceneBvh& sceneBvh, JobSystem& jobs, uint32_t viewportHeight) {
+		candidates.clear();
+		candidateEntities.clear();
+		bvhObjects.clear();
+		sceneBvh.cullObjects(scene.getCamera().getFrustum(), bvhObjects);
+
+		const span<const Entity> entities = sceneBvh.getEntities();
+		const span<const MeshComponent> meshComponents = sceneBvh.getMeshComponents();
+		const span<const TransformComponent> transformComponents = sceneBvh.getTransformComponents();
+		for (const uint32_t object : bvhObjects) {
+			candidates.push_back(Draw{ meshComponents[object].mesh, transformComponents[object].node, 0, 0, 0 });
+			candidateEntities.push_back(entities[object]);
+		}
+
+		addDraws(scene, jobs, viewportHeight, entities.size());
+	}
+
+	void DrawCollector::addDraws(const Scene& scene, JobSystem& jobs, uint32_t viewportHeight, size_t entityCount) {
+		uint32_t entityIndexEnd = 0;
+		for (const Entity entity : candidateEntities) {
+			entityIndexEnd = std::max(entityIndexEnd, entity.index + 1);
+		}
+
+		const size_t count = candidates.size();
+		centersX.resize(count);
+		centersY.resize(count);
+		centersZ.resize(count);
+		radiuses.resize(count);
+		visibility.resize(count);
+		if (lodStates.size() < entityIndexEnd) {
+			lodStates.resize(entityIndexEnd, LodState{ 0, 0 });
+		}
+
+		const span<const MeshRange> meshes = scene.getMeshes();
+		const TransformHierarchy& transforms = scene.getTransforms();
+		const Camera& camera = scene.getCamera();
+		jobs.parallelFor(count, batchSize, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				Draw& draw = candidates[i];
+				const MeshRange& mesh = meshes[draw.mesh];
+				const glm::mat4& worldMatrix = transforms.getWorldMatrix(draw.node);
+				const BoundingSphere sphere = transformSphere(mesh.bounds.sphere, worldMatrix);
+				centersX[i] = sphere.center.x;
+				centersY[i] = sphere.center.y;
+				centersZ[i] = sphere.center.z;
+				radiuses[i] = sphere.radius;
+
+				// entities are unique: each one updates its own state
+				LodState& state = lodStates[candidateEntities[i].index];
+				const uint32_t previousLod = state.generation == candidateEntities[i].generation ? state.lod : 0;
+				const float pixelsPerUnit = LodSelection::getPixelsPerUnit(camera, sphere.center, getMaxScale(worldMatrix), float(viewportHeight));
+				draw.lod = LodSelection::select(mesh, pixelsPerUnit, previousLod, lodSettings);
+				draw.firstIndex = mesh.lods[draw.lod].firstIndex;
+				draw.indexCount = mesh.lods[draw.lod].indexCount;
+				state = LodState{ candidateEntities[i].generation, draw.lod };
+			}
+		});
+
+		const SphereArrays spheres{ centersX, centersY, centersZ, radiuses };
+		const Frustum frustum = camera.getFrustum();
+		const size_t visibleCount = FrustumCulling::cull(frustum, spheres, visibility, jobs);
+
+		for (std::vector<Draw>& formatDraws : draws) {
+			formatDraws.clear();
+		}
+		stats.triangleCount = 0;
+		stats.lodTriangleCounts.fill(0);
+		stats.clusterCount = 0;
+		stats.culledClusterCount = 0;
+		for (size_t i = 0; i < count; ++i) {
+			if (visibility[i]) {
+				const Draw& draw = candidates[i];
+				const MeshRange& mesh = meshes[draw.mesh];
+				uint32_t triangleCount = draw.indexCount / 3;
+				if (draw.lod == 0 && mesh.meshletCount > 0) {
+					triangleCount = addMeshletDraws(scene, draw, frustum);
+				}
+				else {
+					draws[static_cast<size_t>(mesh.format)].push_back(draw);
+				}
+
+				stats.triangleCount += triangleCount;
+				stats.lodTriangleCounts[draw.lod] += triangleCount;
+			}
+		}
+
+		stats.objectCount = static_cast<uint32_t>(entityCount);
+		stats.visibleCount = static_cast<uint32_t>(visibleCount);
+		stats.culledCount = static_cast<uint32_t>(entityCount - visibleCount);
+
+		addInstancedDraws(scene, viewportHeight);
+		addPackets(scene);
+	}
+
+	void DrawCollector::collectInstances(const Scene& scene, uint32_t viewportHeight) {
+		stats = FrameStats{};
+		for (std::vector<Draw>& formatDraws : draws) {
+			formatDraws.clear();
+		}
+		addInstancedDraws(scene, viewportHeight);
+		addPackets(scene);
+	}
+
+	void DrawCollector::addPackets(const Scene& scene) {
+		packets.clear();
+
+		// distance in front of the camera
+		const glm::mat4& view = scene.getCamera().getView();
+		const glm::vec4 depthRow = -glm::vec4(view[0][2], view[1][2], view[2][2], view[3][2]);
+
+		const span<const MeshRange> meshes = scene.getMeshes();
+		const TransformHierarchy& transforms = scene.getTransforms();
+		const span<const InstanceBatch> batches = scene.getInstanceBatches();
+		for (const VertexFormat format : vertexFormats) {
+			// the meshlet draws of an entity share its depth, the stable sort keeps them together
+			// the mesh is the material: past the bits of the key, meshes sharing the low bits are only grouped less well
+			const uint32_t pipeline = SortKey::getPacketPipeline(format, false);
+			const std::vector<Draw>& formatDraws = draws[static_cast<size_t>(format)];
+			for (uint32_t i = 0; i < formatDraws.size(); ++i) {
+				const Draw& draw = formatDraws[i];
+				const glm::vec3 center = glm::vec3(transforms.getWorldMatrix(draw.node) * glm::vec4(meshes[draw.mesh].bounds.sphere.center, 1.0f));
+				const float depth = glm::dot(depthRow, glm::vec4(center, 1.0f));
+				packets.push_back(DrawPacket{ SortKey::make(DrawPass::OPAQUE, pipeline, draw.mesh & SortKey::materialMask, depth), i });
+			}
+
+			const uint32_t instancedPipeline = SortKey::getPacketPipeline(format, true);
+			const std::vector<InstancedDraw>& formatInstancedDraws = instancedDraws[static_cast<size_t>(format)];
+			for (uint32_t i = 0; i < formatInstancedDraws.size(); ++i) {
+				const InstanceBatch& batch = batches[formatInstancedDraws[i].batch];
+				const float depth = glm::dot(depthRow, glm::vec4(batch.bounds.center, 1.0f));
+				packets.push_back(DrawPacket{ SortKey::make(DrawPass::OPAQUE, instancedPipeline, batch.mesh & SortKey::materialMask, depth), i });
+			}
+		}
+
+		DrawPackets::sort(packets, packetScratch);
+	}
+
+	void DrawCollector::addInstancedDraws(const Scene& scene, uint32_t viewportHeight) {
+		for (std::vector<InstancedDraw>& formatDraws : instancedDraws) {
+			formatDraws.clear();
+		}
+		stats.instanceCount = 0;
+		stats.culledInstanceCount = 0;
+
+		const span<const InstanceBatch> batches = scene.getInstanceBatches();
+		// the batches appended since the last frame start from the full detail level
+		if (batchLods.size() < batches.size()) {
+			batchLods.resize(batches.size(), 0);
+		}
+
+		const Camera& camera = scene.getCamera();
+		const Frustum frustum = camera.getFrustum();
+		for (uint32_t batch = 0; batch < batches.size(); ++batch) {
+			const InstanceBatch& instances = batches[batch];
+			stats.instanceCount += instances.instanceCount;
+			if (!frustum.intersects(instances.bounds)) {
+				stats.culledInstanceCount += instances.instanceCount;
+				continue;
+			}
+
+			const MeshRange& mesh = scene.getMeshes()[instances.mesh];
+			const float pixelsPerUnit = LodSelection::getPixelsPerUnit(camera, instances.bounds, instances.maxScale, float(viewportHeight));
+			const uint32_t lod = LodSelection::select(mesh, pixelsPerUnit, batchLods[batch], lodSettings);
+			batchLods[batch] = lod;
+
+			const MeshLodRange& range = mesh.lods[lod];
+			instancedDraws[static_cast<size_t>(mesh.format)].push_back(InstancedDraw{ batch, lod, range.firstIndex, range.indexCount });
+
+			const uint32_t triangleCount = range.indexCount / 3 * instances.instanceCount;
+			stats.triangleCount += triangleCount;
+			stats.lodTriangleCounts[lod] += triangleCount;
+		}
+	}
+
+	uint32_t DrawCollector::addMeshletDraws(const Scene& scene, const Draw& draw, const Frustum& frustum) {
+		const MeshRange& mesh = scene.getMeshes()[draw.mesh];
+		const span<const Meshlet> meshlets = scene.getMeshMeshlets(mesh);
+		std::vector<Draw>& formatDraws = draws[static_cast<size_t>(mesh.format)];
+
+		// the facing point in mesh space, mirrored transforms flip the winding of the triangles
+		const glm::mat4& worldMatrix = scene.getTransforms().getWorldMatrix(draw.node);
+		const float orientation = glm::determinant(worldMatrix) < 0.0f ? -1.0f : 1.0f;
+		const glm::vec4 facingPoint = orientation * (glm::inverse(worldMatrix) * scene.getCamera().getFacingPoint());
+
+		uint32_t triangleCount = 0;
+		bool merging = false;
+		for (const Meshlet& meshlet : meshlets) {
+			const bool visible = !isBackFacing(meshlet, facingPoint) && frustum.intersects(transformSphere(meshlet.sphere, worldMatrix));
+			if (!visible) {
+				++stats.culledClusterCount;
+				merging = false;
+				continue;
+			}
+
+			// consecutive meshlets are contiguous in the index arena
+			if (merging) {
+				formatDraws.back().indexCount += meshlet.triangleCount * 3;
+			}
+			else {
+				formatDraws.push_back(Draw{ draw.mesh, draw.node, draw.lod, meshlet.firstIndex, meshlet.triangleCount * 3 });
+				merging = true;
+			}
+			triangleCount += meshlet.triangleCount;
+		}
+
+		stats.clusterCount += static_cast<uint32_t>(meshlets.size());
+		return triangleCount;
+	}
+
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "../core/job-system.hpp"
+#include "../core/scene.hpp"
+#include "../core/scene-bvh.hpp"
+#include "draw-packets.hpp"
+#include "lod-selection.hpp"
+
+namespace poc {
+
+	// range of scene indices drawn with the transform of the node, the whole level or some of its meshlets
+	struct Draw {
+		uint32_t mesh;
+		TransformNode node;
+		uint32_t lod;
+		uint32_t firstIndex;
+		uint32_t indexCount;
+	};
+
+	// static instances of a batch drawn with a single instanced draw
+	struct InstancedDraw {
+		uint32_t batch;
+		uint32_t lod;
+		uint32_t firstIndex;
+		uint32_t indexCount;
+	};
+
+	struct FrameStats {
+		uint32_t objectCount;
+		uint32_t visibleCount;
+		uint32_t culledCount;
+		uint32_t triangleCount;
+		// triangles drawn at each level of detail
+		std::array<uint32_t, maxMeshLods> lodTriangleCounts;
+		// meshlets of the visible full detail entities & those outside the frustum or facing away
+		uint32_t clusterCount;
+		uint32_t culledClusterCount;
+		// instances of the instanced batches, culled with their batch
+		uint32_t instanceCount;
+		uint32_t culledInstanceCount;
+	};
+
+	/*
+	 * Visible draws of a scene for a frame, grouped by vertex format.
+	 *
+	 * The entities are gathered from the packed ECS arrays, or from the leaves of a scene BVH not culled
+	 * against the camera frustum. Their world bounding spheres are computed into structure of arrays and
+	 * culled against the frustum in parallel. The level of detail of
+	 * each entity is selected at the same time, from its previous level for the hysteresis. The visible
+	 * entities drawn at full detail with meshlets are then culled meshlet by meshlet, against the frustum
+	 * and with their normal cone, the remaining contiguous meshlets are merged into a draw. The instance
+	 * batches are culled & their level selected as a whole, from the point of their bounds nearest to
+	 * the camera. The draws are then emitted as packets, radix sorted by pipeline, mesh & depth for the
+	 * submission. The buffers are kept between frames to reuse their capacity.
+	 */
+	class DrawCollector {
+	public:
+
+		// entities updated per batch of the parallel bounds computation
+		static constexpr size_t batchSize = 2048;
+
+		void collect(const Scene& scene, JobSystem& jobs, uint32_t viewportHeight);
+
+		// only the entities of the BVH subtrees intersecting the frustum are candidates, the BVH must be updated
+		void collect(const Scene& scene, const SceneBvh& sceneBvh, JobSystem& jobs, uint32_t viewportHeight);
+
+		// only the instanced draws, the entities are drawn by other means
+		void collectInstances(const Scene& scene, uint32_t viewportHeight);
+
+		void setLodSettings(const LodSettings& settings) {
+			lodSettings = settings;
+		}
+
+		const LodSettings& getLodSettings() const {
+			return lodSettings;
+		}
+
+		const std::vector<Draw>& getDraws(VertexFormat format) const {
+			return draws[static_cast<size_t>(format)];
+		}
+
+		const std::vector<InstancedDraw>& getInstancedDraws(VertexFormat format) const {
+			return instancedDraws[static_cast<size_t>(format)];
+		}
+
+		// all the draws sorted for the submission, the payloads index the draws of the pipeline format
+		const std::vector<DrawPacket>& getPackets() const {
+			return packets;
+		}
+
+		const FrameStats& getFrameStats() const {
+			return stats;
+		}
+
+	private:
+
+		// levels, culling & draws of the candidates, out of all the entities
+		void addDraws(const Scene& scene, JobSystem& jobs, uint32_t viewportHeight, size_t entityCount);
+
+		// draws of the meshlets of a visible entity not culled, returns the triangles drawn
+		uint32_t addMeshletDraws(const Scene& scene, const Draw& draw, const Frustum& frustum);
+
+		// instanced draws of the visible batches, their triangles are added to the statistics
+		void addInstancedDraws(const Scene& scene, uint32_t viewportHeight);
+
+		// sort keys of the collected draws
+		void addPackets(const Scene& scene);
+
+		// level drawn for the entity with this generation
+		struct LodState {
+			uint32_t generation;
+			uint32_t lod;
+		};
+
+		std::vector<Draw> candidates;
+		std::vector<Entity> candidateEntities;
+		std::vector<uint32_t> bvhObjects;
+		std::vector<float> centersX;
+		std::vector<float> centersY;
+		std::vector<float> centersZ;
+		std::vector<float> radiuses;
+		std::vector<uint8_t> visibility;
+		std::array<std::vector<Draw>, vertexFormats.size()> draws;
+		std::array<std::vector<InstancedDraw>, vertexFormats.size()> instancedDraws;
+		std::vector<DrawPacket> packets;
+		std::vector<DrawPacket> packetScratch;
+		// previous level of each batch, kept across the appends to the scene
+		std::vector<uint32_t> batchLods;
+		// indexed by entity index
+		std::vector<LodState> lodStates;
+		LodSettings lodSettings;
+		FrameStats stats{};
+	};
+
+}
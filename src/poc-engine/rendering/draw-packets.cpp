@@ -0,0 +1,52 @@
+#include "draw-packets.hpp"
+
+#include <array>
+#include <utility>
+
+using namespace poc;
+
+namespace poc {
+
+	void DrawPackets::sort(std::vector<DrawPacket>& packets, std::vector<DrawPacket>& scratch) {
+		constexpr size_t digitCount = sizeof(uint64_t);
+		const size_t count = packets.size();
+		if (count < 2) {
+			return;
+		}
+
+		std::array<std::array<uint32_t, 256>, digitCount> histograms{};
+		for (const DrawPacket& packet : packets) {
+			for (size_t digit = 0; digit < digitCount; ++digit) {
+				++histograms[digit][(packet.key >> (digit * 8)) & 0xFF];
+			}
+		}
+
+		scratch.resize(count);
+		DrawPacket* source = packets.data();
+		DrawPacket* destination = scratch.data();
+		for (size_t digit = 0; digit < digitCount; ++digit) {
+			const size_t shift = digit * 8;
+			std::array<uint32_t, 256>& histogram = histograms[digit];
+			if (histogram[(source[0].key >> shift) & 0xFF] == count) {
+				continue;
+			}
+
+			// the histogram becomes the first position of each value
+			uint32_t offset = 0;
+			for (uint32_t& bucket : histogram) {
+				const uint32_t size = bucket;
+				bucket = offset;
+				offset += size;
+			}
+			for (size_t i = 0; i < count; ++i) {
+				destination[histogram[(source[i].key >> shift) & 0xFF]++] = source[i];
+			}
+			std::swap(source, destination);
+		}
+
+		if (source != packets.data()) {
+			packets.swap(scratch);
+		}
+	}
+
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "vertex.hpp"
+
+namespace poc {
+
+	// passes in their drawing order
+	enum class DrawPass : uint32_t {
+		OPAQUE
+	};
+
+	// the key orders the draws & their state changes, the payload indexes the draw in the list of its pipeline
+	struct DrawPacket {
+		uint64_t key;
+		uint32_t payload;
+	};
+
+	/*
+	 * 64 bits sort key of a draw packet, from the most significant bits:
+	 * pass (4), pipeline (8), material (20) and depth (32).
+	 *
+	 * Sorting the packets groups the draws by pass, then by pipeline so that each one is bound once, then
+	 * by material, i.e. the mesh whose constants & vertices are bound, and draws them front to back. The
+	 * depth is the float distance in front of the camera: the bits of a positive float sort as integers.
+	 */
+	namespace SortKey {
+
+		constexpr uint32_t depthBits = 32;
+		constexpr uint32_t materialBits = 20;
+		constexpr uint32_t pipelineBits = 8;
+		constexpr uint32_t passBits = 4;
+		constexpr uint32_t materialMask = (1u << materialBits) - 1;
+
+		// the per draw pipelines of the vertex formats, then the instanced ones
+		inline uint32_t getPacketPipeline(VertexFormat format, bool instanced) {
+			return static_cast<uint32_t>(format) + (instanced ? static_cast<uint32_t>(vertexFormats.size()) : 0);
+		}
+
+		inline bool isInstanced(uint32_t pipeline) {
+			return pipeline >= vertexFormats.size();
+		}
+
+		inline VertexFormat getFormat(uint32_t pipeline) {
+			return static_cast<VertexFormat>(pipeline % vertexFormats.size());
+		}
+
+		// the depths behind the camera are drawn first
+		inline uint64_t make(DrawPass pass, uint32_t pipeline, uint32_t material, float depth) {
+			assert(static_cast<uint32_t>(pass) < (1u << passBits) && "pass out of the key");
+			assert(pipeline < (1u << pipelineBits) && "pipeline out of the key");
+			assert(material < (1u << materialBits) && "material out of the key");
+
+			const float positiveDepth = depth > 0.0f ? depth : 0.0f;
+			uint32_t depthKey;
+			std::memcpy(&depthKey, &positiveDepth, sizeof(depthKey));
+
+			return (uint64_t(pass) << (pipelineBits + materialBits + depthBits))
+				| (uint64_t(pipeline) << (materialBits + depthBits))
+				| (uint64_t(material) << depthBits)
+				| depthKey;
+		}
+
+		inline DrawPass getPass(uint64_t key) {
+			return static_cast<DrawPass>(key >> (pipelineBits + materialBits + depthBits));
+		}
+
+		inline uint32_t getPipeline(uint64_t key) {
+			return static_cast<uint32_t>(key >> (materialBits + depthBits)) & ((1u << pipelineBits) - 1);
+		}
+
+		inline uint32_t getMaterial(uint64_t key) {
+			return static_cast<uint32_t>(key >> depthBits) & materialMask;
+		}
+
+	}
+
+	namespace DrawPackets {
+
+		// stable least significant digit radix sort on the keys, 8 bits per pass: the histograms of all the
+		// digits are counted in a single read and the digits shared by all the keys are skipped
+		void sort(std::vector<DrawPacket>& packets, std::vector<DrawPacket>& scratch);
+
+	}
+
+}
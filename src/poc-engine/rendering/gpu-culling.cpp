@@ -0,0 +1,69 @@
+#include "gpu-culling.hpp"
+
+#include <cmath>
+
+using namespace poc;
+
+namespace poc {
+
+	namespace GpuCulling {
+
+		std::vector<GpuMesh> makeMeshes(const Scene& scene, uint32_t firstMesh) {
+			assert(firstMesh <= scene.getMeshes().size() && "mesh out of range");
+			std::vector<GpuMesh> meshes;
+			meshes.reserve(scene.getMeshes().size() - firstMesh);
+			for (const MeshRange& range : scene.getMeshes().subspan(firstMesh, scene.getMeshes().size() - firstMesh)) {
+				GpuMesh mesh{};
+				mesh.sphere = glm::vec4(range.bounds.sphere.center, range.bounds.sphere.radius);
+				mesh.dequantization = range.dequantization;
+				mesh.vertexOffset = static_cast<int32_t>(range.firstVertex);
+				mesh.format = static_cast<uint32_t>(range.format);
+				mesh.lodCount = range.lodCount;
+				for (uint32_t lod = 0; lod < range.lodCount; ++lod) {
+					mesh.lods[lod] = GpuLod{ range.lods[lod].firstIndex, range.lods[lod].indexCount, range.lods[lod].error, 0 };
+				}
+				meshes.push_back(mesh);
+			}
+			return meshes;
+		}
+
+		void makeObjects(const Scene& scene, std::vector<GpuObject>& objects) {
+			objects.clear();
+			const TransformHierarchy& transforms = scene.getTransforms();
+			scene.getWorld().forEachChunk<const MeshComponent, const TransformComponent>([&](
+				span<const Entity>,
+				span<const MeshComponent> meshComponents,
+				span<const TransformComponent> transformComponents) {
+
+				for (size_t i = 0; i < meshComponents.size(); ++i) {
+					const glm::mat4& worldMatrix = transforms.getWorldMatrix(transformComponents[i].node);
+					objects.push_back(GpuObject{ worldMatrix, meshComponents[i].mesh, getMaxScale(worldMatrix), { 0, 0 } });
+				}
+			});
+		}
+
+		std::array<uint32_t, vertexFormats.size()> countObjects(const Scene& scene, const std::vector<GpuObject>& objects) {
+			std::array<uint32_t, vertexFormats.size()> counts{};
+			for (const GpuObject& object : objects) {
+				++counts[static_cast<size_t>(scene.getMeshes()[object.mesh].format)];
+			}
+			return counts;
+		}
+
+		GpuCullingConstants makeConstants(const Camera& camera, float viewportHeight, const LodSettings& settings, uint32_t objectCount, uint32_t commandCapacity) {
+			const glm::mat4& viewProjection = camera.getViewProjection();
+			const Frustum frustum = camera.getFrustum();
+
+			GpuCullingConstants constants{};
+			constants.planes = frustum.planes;
+			constants.wRow = glm::vec4(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+			// same projection as LodSelection::getPixelsPerUnit
+			constants.lodScale = std::abs(camera.getProjection()[1][1]) * viewportHeight * 0.5f / settings.pixelError;
+			constants.objectCount = objectCount;
+			constants.commandCapacity = commandCapacity;
+			return constants;
+		}
+
+	}
+
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "../core/camera.hpp"
+#include "../core/scene.hpp"
+#include "lod-selection.hpp"
+
+namespace poc {
+
+	// the layouts below are std430 and must match shaders/cull.comp & shaders/shader-indirect.vert
+
+	struct GpuLod {
+		uint32_t firstIndex;
+		uint32_t indexCount;
+		float error;
+		uint32_t padding;
+	};
+
+	// mesh range of the scene, uploaded with the scene geometry
+	struct GpuMesh {
+		glm::vec4 sphere;
+		Dequantization dequantization;
+		int32_t vertexOffset;
+		uint32_t format;
+		uint32_t lodCount;
+		uint32_t padding;
+		std::array<GpuLod, maxMeshLods> lods;
+	};
+
+	// entity drawing a mesh, uploaded every frame
+	struct GpuObject {
+		glm::mat4 transform;
+		uint32_t mesh;
+		float maxScale;
+		uint32_t padding[2];
+	};
+
+	// push constants of the culling dispatch
+	struct GpuCullingConstants {
+		std::array<glm::vec4, 6> planes;
+		// row of the view projection giving the clip w of a world position
+		glm::vec4 wRow;
+		// pixels per world unit at w = 1, divided by the tolerated pixel error
+		float lodScale;
+		uint32_t objectCount;
+		// commands reserved per vertex format
+		uint32_t commandCapacity;
+		uint32_t padding;
+	};
+
+	// VkDrawIndexedIndirectCommand written by the culling shader, the instance is the object index
+	struct DrawIndexedIndirectCommand {
+		uint32_t indexCount;
+		uint32_t instanceCount;
+		uint32_t firstIndex;
+		int32_t vertexOffset;
+		uint32_t firstInstance;
+	};
+
+	static_assert(sizeof(GpuMesh) == 192, "GpuMesh must match the std430 layout");
+	static_assert(sizeof(GpuObject) == 80, "GpuObject must match the std430 layout");
+	static_assert(sizeof(GpuCullingConstants) == 128, "GpuCullingConstants must fit the minimal push constant size");
+	static_assert(sizeof(DrawIndexedIndirectCommand) == 20, "DrawIndexedIndirectCommand must match VkDrawIndexedIndirectCommand");
+
+	/*
+	 * Inputs of the GPU driven rendering.
+	 *
+	 * Each invocation of the culling shader tests the world bounding sphere of an object against the
+	 * frustum, selects its level of detail from the projected error and appends an indexed indirect
+	 * draw command to the range of its vertex format. The draws are then submitted with one indirect
+	 * call per format, whatever the object count.
+	 *
+	 * The levels are selected without hysteresis, the GPU keeps no state between frames, and the
+	 * meshlets are drawn as whole meshes.
+	 */
+	namespace GpuCulling {
+
+		// invocations per workgroup of the culling shader
+		inline constexpr uint32_t workgroupSize = 64;
+
+		// meshes from firstMesh, the ones of a scene grown by appends
+		std::vector<GpuMesh> makeMeshes(const Scene& scene, uint32_t firstMesh = 0);
+
+		// one object per entity drawing a mesh, in the order of the ECS chunks
+		void makeObjects(const Scene& scene, std::vector<GpuObject>& objects);
+
+		// objects of each vertex format: the most commands the shader appends to the range of the format
+		std::array<uint32_t, vertexFormats.size()> countObjects(const Scene& scene, const std::vector<GpuObject>& objects);
+
+		GpuCullingConstants makeConstants(const Camera& camera, float viewportHeight, const LodSettings& settings, uint32_t objectCount, uint32_t commandCapacity);
+
+	}
+
+}
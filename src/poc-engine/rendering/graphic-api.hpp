@@ -4,9 +4,21 @@
 
 #include "../core/scene.hpp"
 #include "../plateform/window.hpp"
+#include "draw-collector.hpp"
 
 namespace poc {
 
+	// uploads of data to the GPU memory since the creation of the graphic API
+	struct UploadStats {
+		uint64_t uploadCount{ 0 };
+		uint64_t uploadedBytes{ 0 };
+		// submissions of the uploads, each one carries many of them
+		uint64_t batchCount{ 0 };
+		// waits of the CPU for the GPU to complete uploads
+		uint64_t stallCount{ 0 };
+		double stallMilliseconds{ 0.0 };
+	};
+
 	class GraphicApi {
 	public:
 
@@ -16,7 +28,16 @@ namespace poc {
 			VULKAN
 		};
 
-		virtual void render(const Window& window, const Scene& scene) = 0;
+		virtual void render(const Window& window, const Scene& scene, const DrawCollector& drawCollector) = 0;
+
+		// the scene is culled on the GPU, the draws of the collector are not used
+		virtual bool isGpuDriven() const = 0;
+		// objects, visible & culled counts read back from the GPU culling, some frames late
+		virtual const FrameStats& getGpuFrameStats() const = 0;
+		// generation of the GPU copy of the scene once its upload completed, 0 when another scene is resident
+		virtual uint64_t getResidentGeneration(const Scene& scene) const = 0;
+		virtual UploadStats getUploadStats() const = 0;
+
 		virtual ~GraphicApi() {}
 
 		static std::unique_ptr<GraphicApi> make(const Window& window, Type type);
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "../core/camera.hpp"
+#include "../core/scene.hpp"
+
+namespace poc {
+
+	struct LodSettings {
+		// error tolerated on screen, in pixels
+		float pixelError{ 1.0f };
+		// switching to a coarser level needs an error under (1 - hysteresis) * pixelError:
+		// an object moving around the switch distance does not alternate between two levels every frame
+		float hysteresis{ 0.25f };
+	};
+
+	/*
+	 * Level of detail selection from the projected screen space error.
+	 *
+	 * The error of a level is a distance in mesh units: scaled by the world transform and projected at
+	 * the distance of the object, it gives the pixels the simplified surface may be away from the full
+	 * detail one. The coarsest level within the tolerance is drawn.
+	 */
+	namespace LodSelection {
+
+		// pixels covered by a mesh unit at the given world position, the largest for positions behind the camera
+		inline float getPixelsPerUnit(const Camera& camera, const glm::vec3& position, float worldScale, float viewportHeight) {
+			const float w = (camera.getViewProjection() * glm::vec4(position, 1.0f)).w;
+			if (w <= std::numeric_limits<float>::epsilon()) {
+				return std::numeric_limits<float>::max();
+			}
+			return worldScale * std::abs(camera.getProjection()[1][1]) * viewportHeight * 0.5f / w;
+		}
+
+		// pixels covered by a mesh unit at the point of the sphere nearest to the camera
+		inline float getPixelsPerUnit(const Camera& camera, const BoundingSphere& sphere, float worldScale, float viewportHeight) {
+			// the w row of an orthographic projection is constant, the sphere does not come closer
+			const glm::mat4& viewProjection = camera.getViewProjection();
+			const glm::vec3 wAxis(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3]);
+			const float w = (viewProjection * glm::vec4(sphere.center, 1.0f)).w - sphere.radius * glm::length(wAxis);
+			if (w <= std::numeric_limits<float>::epsilon()) {
+				return std::numeric_limits<float>::max();
+			}
+			return worldScale * std::abs(camera.getProjection()[1][1]) * viewportHeight * 0.5f / w;
+		}
+
+		inline uint32_t select(const MeshRange& mesh, float pixelsPerUnit, uint32_t previousLod, const LodSettings& settings) {
+			uint32_t lod = 0;
+			for (uint32_t level = 1; level < mesh.lodCount; ++level) {
+				const float tolerance = level > previousLod ? settings.pixelError * (1.0f - settings.hysteresis) : settings.pixelError;
+				// the errors increase with the level
+				if (mesh.lods[level].error * pixelsPerUnit > tolerance) {
+					break;
+				}
+				lod = level;
+			}
+			return lod;
+		}
+
+	}
+
+}
@@ -0,0 +1,226 @@
+#include "memory-sub-allocators.hpp"
+
+#include <algorithm>
+
+using namespace poc;
+
+namespace poc {
+
+	// index of the highest bit set, the value is not 0
+	static uint32_t findLastSet(uint64_t value) {
+		uint32_t index = 0;
+		for (uint32_t shift = 32; shift > 0; shift /= 2) {
+			if (value >> shift) {
+				value >>= shift;
+				index += shift;
+			}
+		}
+		return index;
+	}
+
+	// index of the lowest bit set, the value is not 0
+	static uint32_t findFirstSet(uint64_t value) {
+		return findLastSet(value & (~value + 1));
+	}
+
+	TlsfAllocator::TlsfAllocator(uint64_t size) :
+		size(size) {
+
+		assert(size > 0 && "empty block");
+		freeLists.fill(noNode);
+		insertFree(createNode(0, size));
+	}
+
+	TlsfAllocation TlsfAllocator::allocate(uint64_t allocationSize, uint64_t alignment) {
+		assert(alignment != 0 && (alignment & (alignment - 1)) == 0 && "alignment is not a power of two");
+		allocationSize = std::max<uint64_t>(allocationSize, 1);
+		if (allocationSize > size || alignment - 1 > size - allocationSize) {
+			return TlsfAllocation{};
+		}
+
+		const uint32_t node = findFree(allocationSize, alignment);
+		if (node == noNode) {
+			return TlsfAllocation{};
+		}
+		removeFree(node);
+
+		// the padding before the aligned offset stays free
+		const uint64_t padding = ((nodes[node].offset + alignment - 1) & ~(alignment - 1)) - nodes[node].offset;
+		uint32_t allocated = node;
+		if (padding > 0) {
+			splitFree(node, padding);
+			allocated = nodes[node].nextPhysical;
+			removeFree(allocated);
+			insertFree(node);
+		}
+		if (nodes[allocated].size > allocationSize) {
+			splitFree(allocated, allocationSize);
+		}
+
+		nodes[allocated].free = false;
+		usedSize += allocationSize;
+		++allocationCount;
+		return TlsfAllocation{ nodes[allocated].offset, allocated };
+	}
+
+	void TlsfAllocator::free(const TlsfAllocation& allocation) {
+		assert(allocation.isValid() && allocation.node < nodes.size() && !nodes[allocation.node].free && "not an allocation of this allocator");
+		uint32_t node = allocation.node;
+		nodes[node].free = true;
+		usedSize -= nodes[node].size;
+		--allocationCount;
+
+		const uint32_t next = nodes[node].nextPhysical;
+		if (next != noNode && nodes[next].free) {
+			removeFree(next);
+			nodes[node].size += nodes[next].size;
+			nodes[node].nextPhysical = nodes[next].nextPhysical;
+			if (nodes[next].nextPhysical != noNode) {
+				nodes[nodes[next].nextPhysical].previousPhysical = node;
+			}
+			releaseNode(next);
+		}
+
+		const uint32_t previous = nodes[node].previousPhysical;
+		if (previous != noNode && nodes[previous].free) {
+			removeFree(previous);
+			nodes[previous].size += nodes[node].size;
+			nodes[previous].nextPhysical = nodes[node].nextPhysical;
+			if (nodes[node].nextPhysical != noNode) {
+				nodes[nodes[node].nextPhysical].previousPhysical = previous;
+			}
+			releaseNode(node);
+			node = previous;
+		}
+
+		insertFree(node);
+	}
+
+	uint64_t TlsfAllocator::getLargestFreeSize() const {
+		if (firstLevelBitmap == 0) {
+			return 0;
+		}
+		const uint32_t firstLevel = findLastSet(firstLevelBitmap);
+		const uint32_t secondLevel = findLastSet(secondLevelBitmaps[firstLevel]);
+		uint64_t largest = 0;
+		for (uint32_t node = freeLists[firstLevel * secondLevelCount + secondLevel]; node != noNode; node = nodes[node].nextFree) {
+			largest = std::max(largest, nodes[node].size);
+		}
+		return largest;
+	}
+
+	// size class of a size: the sizes below the second level count have a class each
+	static void getSizeClass(uint64_t size, uint32_t secondLevelBits, uint32_t& firstLevel, uint32_t& secondLevel) {
+		const uint32_t secondLevelCount = 1u << secondLevelBits;
+		if (size < secondLevelCount) {
+			firstLevel = 0;
+			secondLevel = static_cast<uint32_t>(size);
+			return;
+		}
+		const uint32_t lastSet = findLastSet(size);
+		firstLevel = lastSet - secondLevelBits + 1;
+		secondLevel = static_cast<uint32_t>(size >> (lastSet - secondLevelBits)) - secondLevelCount;
+	}
+
+	uint32_t TlsfAllocator::createNode(uint64_t offset, uint64_t nodeSize) {
+		const Node node{ offset, nodeSize, noNode, noNode, noNode, noNode, true };
+		if (unusedNodes.empty()) {
+			nodes.push_back(node);
+			return static_cast<uint32_t>(nodes.size() - 1);
+		}
+		const uint32_t index = unusedNodes.back();
+		unusedNodes.pop_back();
+		nodes[index] = node;
+		return index;
+	}
+
+	void TlsfAllocator::releaseNode(uint32_t node) {
+		unusedNodes.push_back(node);
+	}
+
+	void TlsfAllocator::insertFree(uint32_t node) {
+		uint32_t firstLevel;
+		uint32_t secondLevel;
+		getSizeClass(nodes[node].size, secondLevelBits, firstLevel, secondLevel);
+		uint32_t& head = freeLists[firstLevel * secondLevelCount + secondLevel];
+
+		nodes[node].free = true;
+		nodes[node].previousFree = noNode;
+		nodes[node].nextFree = head;
+		if (head != noNode) {
+			nodes[head].previousFree = node;
+		}
+		head = node;
+		firstLevelBitmap |= uint64_t(1) << firstLevel;
+		secondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+	}
+
+	void TlsfAllocator::removeFree(uint32_t node) {
+		const Node& removed = nodes[node];
+		if (removed.previousFree != noNode) {
+			nodes[removed.previousFree].nextFree = removed.nextFree;
+		}
+		if (removed.nextFree != noNode) {
+			nodes[removed.nextFree].previousFree = removed.previousFree;
+		}
+
+		uint32_t firstLevel;
+		uint32_t secondLevel;
+		getSizeClass(removed.size, secondLevelBits, firstLevel, secondLevel);
+		uint32_t& head = freeLists[firstLevel * secondLevelCount + secondLevel];
+		if (head == node) {
+			head = removed.nextFree;
+			if (head == noNode) {
+				secondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+				if (secondLevelBitmaps[firstLevel] == 0) {
+					firstLevelBitmap &= ~(uint64_t(1) << firstLevel);
+				}
+			}
+		}
+	}
+
+	uint32_t TlsfAllocator::findFree(uint64_t allocationSize, uint64_t alignment) const {
+		uint32_t firstLevel;
+		uint32_t secondLevel;
+		getSizeClass(allocationSize + alignment - 1, secondLevelBits, firstLevel, secondLevel);
+
+		// the nodes of the classes above the size & the worst alignment padding all fit
+		const uint32_t secondLevelMask = secondLevel + 1 < secondLevelCount ? secondLevelBitmaps[firstLevel] & (~0u << (secondLevel + 1)) : 0;
+		if (secondLevelMask != 0) {
+			return freeLists[firstLevel * secondLevelCount + findFirstSet(secondLevelMask)];
+		}
+		const uint64_t firstLevelMask = firstLevel + 1 < firstLevelCount ? firstLevelBitmap & (~uint64_t(0) << (firstLevel + 1)) : 0;
+		if (firstLevelMask != 0) {
+			const uint32_t nextFirstLevel = findFirstSet(firstLevelMask);
+			return freeLists[nextFirstLevel * secondLevelCount + findFirstSet(secondLevelBitmaps[nextFirstLevel])];
+		}
+
+		// otherwise the nodes of the classes in between may fit once aligned
+		const uint32_t lastClass = firstLevel * secondLevelCount + secondLevel;
+		getSizeClass(allocationSize, secondLevelBits, firstLevel, secondLevel);
+		for (uint32_t sizeClass = firstLevel * secondLevelCount + secondLevel; sizeClass <= lastClass; ++sizeClass) {
+			for (uint32_t node = freeLists[sizeClass]; node != noNode; node = nodes[node].nextFree) {
+				const uint64_t offset = (nodes[node].offset + alignment - 1) & ~(alignment - 1);
+				if (nodes[node].size >= allocationSize && offset - nodes[node].offset <= nodes[node].size - allocationSize) {
+					return node;
+				}
+			}
+		}
+		return noNode;
+	}
+
+	void TlsfAllocator::splitFree(uint32_t node, uint64_t keptSize) {
+		const uint32_t split = createNode(nodes[node].offset + keptSize, nodes[node].size - keptSize);
+		// the node array may have grown
+		Node& kept = nodes[node];
+		kept.size = keptSize;
+		nodes[split].previousPhysical = node;
+		nodes[split].nextPhysical = kept.nextPhysical;
+		if (kept.nextPhysical != noNode) {
+			nodes[kept.nextPhysical].previousPhysical = split;
+		}
+		kept.nextPhysical = split;
+		insertFree(split);
+	}
+
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace poc {
+
+	// range of a TLSF allocation, node identifies it to free it
+	struct TlsfAllocation {
+		uint64_t offset{ std::numeric_limits<uint64_t>::max() };
+		uint32_t node{ std::numeric_limits<uint32_t>::max() };
+
+		bool isValid() const {
+			return node != std::numeric_limits<uint32_t>::max();
+		}
+	};
+
+	/*
+	 * Two level segregated fit allocator of the ranges of a memory block, the general purpose strategy.
+	 *
+	 * The free ranges are kept in lists by size class: a power of two then 32 subdivisions of it. The two
+	 * levels of bitmaps give the first non empty class fitting a size in constant time, freed ranges are
+	 * merged with their free neighbours. Only offsets are handled: the memory itself is never touched.
+	 */
+	class TlsfAllocator {
+	public:
+
+		explicit TlsfAllocator(uint64_t size);
+
+		// alignment: a power of two, invalid when no free range fits
+		TlsfAllocation allocate(uint64_t size, uint64_t alignment = 1);
+
+		void free(const TlsfAllocation& allocation);
+
+		uint64_t getSize() const {
+			return size;
+		}
+
+		// bytes of the allocations, alignment padding excluded
+		uint64_t getUsedSize() const {
+			return usedSize;
+		}
+
+		uint32_t getAllocationCount() const {
+			return allocationCount;
+		}
+
+		// largest free range: allocations up to this size, unaligned, succeed
+		uint64_t getLargestFreeSize() const;
+
+		bool isEmpty() const {
+			return allocationCount == 0;
+		}
+
+	private:
+		static constexpr uint32_t secondLevelBits = 5;
+		static constexpr uint32_t secondLevelCount = 1u << secondLevelBits;
+		static constexpr uint32_t firstLevelCount = 64 - secondLevelBits + 1;
+		static constexpr uint32_t noNode = std::numeric_limits<uint32_t>::max();
+
+		// physical neighbours are contiguous ranges of the block, free ones are linked in their size class
+		struct Node {
+			uint64_t offset;
+			uint64_t size;
+			uint32_t previousPhysical;
+			uint32_t nextPhysical;
+			uint32_t previousFree;
+			uint32_t nextFree;
+			bool free;
+		};
+
+		uint64_t size;
+		uint64_t usedSize{ 0 };
+		uint32_t allocationCount{ 0 };
+		std::vector<Node> nodes;
+		std::vector<uint32_t> unusedNodes;
+		uint64_t firstLevelBitmap{ 0 };
+		std::array<uint32_t, firstLevelCount> secondLevelBitmaps{};
+		std::array<uint32_t, firstLevelCount * secondLevelCount> freeLists;
+
+		uint32_t createNode(uint64_t offset, uint64_t nodeSize);
+		void releaseNode(uint32_t node);
+		void insertFree(uint32_t node);
+		void removeFree(uint32_t node);
+		uint32_t findFree(uint64_t allocationSize, uint64_t alignment) const;
+		// splits the end of a node into a free node
+		void splitFree(uint32_t node, uint64_t keptSize);
+
+	};
+
+	/*
+	 * Bump allocator of the ranges of a memory block, for data released all at once, e.g. every frame.
+	 */
+	class LinearAllocator {
+	public:
+
+		static constexpr uint64_t invalidOffset = std::numeric_limits<uint64_t>::max();
+
+		explicit LinearAllocator(uint64_t size) :
+			size(size) {}
+
+		// alignment: a power of two, invalid when the block is full
+		uint64_t allocate(uint64_t allocationSize, uint64_t alignment = 1) {
+			assert(alignment != 0 && (alignment & (alignment - 1)) == 0 && "alignment is not a power of two");
+			const uint64_t offset = (head + alignment - 1) & ~(alignment - 1);
+			if (offset > size || allocationSize > size - offset) {
+				return invalidOffset;
+			}
+			head = offset + allocationSize;
+			return offset;
+		}
+
+		void reset() {
+			head = 0;
+		}
+
+		uint64_t getSize() const {
+			return size;
+		}
+
+		uint64_t getUsedSize() const {
+			return head;
+		}
+
+	private:
+		uint64_t size;
+		uint64_t head{ 0 };
+	};
+
+	/*
+	 * Ring allocator of the ranges of a memory block, for data released in allocation order, e.g. once
+	 * the GPU has consumed it. The positions only grow: the offset of a position is its value modulo
+	 * the size, an allocation never wraps but skips the end of the block instead. Everything allocated
+	 * before a position returned by getHead() is released by release() of that position.
+	 */
+	class RingAllocator {
+	public:
+
+		static constexpr uint64_t invalidOffset = std::numeric_limits<uint64_t>::max();
+
+		explicit RingAllocator(uint64_t size) :
+			size(size) {}
+
+		// alignment: a power of two dividing the size, invalid when the free part of the ring is too small
+		uint64_t allocate(uint64_t allocationSize, uint64_t alignment = 1) {
+			assert(alignment != 0 && (alignment & (alignment - 1)) == 0 && size % alignment == 0 && "alignment is not a power of two dividing the size");
+			if (allocationSize > size) {
+				return invalidOffset;
+			}
+			uint64_t position = (head + alignment - 1) & ~(alignment - 1);
+			if (position % size + allocationSize > size) {
+				position += size - position % size;
+			}
+			// nothing is in use in an empty ring, not even the skipped end
+			if (head == tail) {
+				tail = position;
+			}
+			if (position + allocationSize - tail > size) {
+				return invalidOffset;
+			}
+			head = position + allocationSize;
+			return position % size;
+		}
+
+		// position after the last allocation
+		uint64_t getHead() const {
+			return head;
+		}
+
+		// releases the allocations made before the position, positions before the last released one are ignored
+		void release(uint64_t position) {
+			assert(position <= head && "position not in the ring");
+			tail = std::max(tail, position);
+		}
+
+		uint64_t getSize() const {
+			return size;
+		}
+
+		// bytes between the oldest allocation not released and the head, skipped ends included
+		uint64_t getUsedSize() const {
+			return head - tail;
+		}
+
+	private:
+		uint64_t size;
+		uint64_t head{ 0 };
+		uint64_t tail{ 0 };
+	};
+
+}
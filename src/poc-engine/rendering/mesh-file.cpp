@@ -0,0 +1,170 @@
+#include "mesh-file.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "../core/logger.hpp"
+#include "../plateform/mapped-file.hpp"
+
+using namespace poc;
+
+namespace poc {
+
+	static constexpr char logTag[]{ "POC::MeshFile" };
+
+	static_assert(std::is_trivially_copyable_v<Vertex>);
+	static_assert(std::is_trivially_copyable_v<PackedVertex>);
+	static_assert(std::is_trivially_copyable_v<Meshlet>);
+	static_assert(std::is_trivially_copyable_v<MeshRange>);
+
+	[[noreturn]] static void fail(const std::string& message) {
+		Logger::error(logTag, message);
+		throw std::runtime_error(message);
+	}
+
+	static uint64_t alignSection(uint64_t offset) {
+		return (offset + MeshFile::sectionAlignment - 1) / MeshFile::sectionAlignment * MeshFile::sectionAlignment;
+	}
+
+	// the ranges & indices are trusted by the renderer, robustBufferAccess is not enabled: each range must be
+	// inside its arena, each index inside the vertices of its mesh & each meshlet inside the indices of its mesh
+	static void validateMeshes(const SceneGeometry& geometry) {
+		for (size_t i = 0; i < geometry.meshes.size(); ++i) {
+			const MeshRange& mesh = geometry.meshes[i];
+			const uint64_t vertexCount = mesh.format == VertexFormat::FLOAT32 ? geometry.vertices.size() : geometry.packedVertices.size();
+			bool valid = static_cast<size_t>(mesh.format) < vertexFormats.size()
+				&& uint64_t(mesh.firstVertex) + mesh.vertexCount <= vertexCount
+				&& uint64_t(mesh.firstIndex) + mesh.indexCount <= geometry.indices.size()
+				&& mesh.lodCount >= 1 && mesh.lodCount <= maxMeshLods
+				&& uint64_t(mesh.firstMeshlet) + mesh.meshletCount <= geometry.meshlets.size();
+			for (uint32_t lod = 0; valid && lod < mesh.lodCount; ++lod) {
+				const MeshLodRange& range = mesh.lods[lod];
+				valid = uint64_t(range.firstIndex) + range.indexCount <= geometry.indices.size();
+				const span<const uint32_t> indices = valid ? geometry.indices.subspan(range.firstIndex, range.indexCount) : span<const uint32_t>();
+				valid = valid && std::all_of(indices.begin(), indices.end(), [&mesh](uint32_t index) { return index < mesh.vertexCount; });
+			}
+			for (uint32_t meshlet = 0; valid && meshlet < mesh.meshletCount; ++meshlet) {
+				const Meshlet& cluster = geometry.meshlets[mesh.firstMeshlet + meshlet];
+				valid = cluster.firstIndex >= mesh.firstIndex
+					&& uint64_t(cluster.firstIndex) + uint64_t(cluster.triangleCount) * 3 <= uint64_t(mesh.firstIndex) + mesh.indexCount;
+			}
+			if (!valid) {
+				fail("Mesh " + std::to_string(i) + " out of the arenas");
+			}
+		}
+	}
+
+	uint64_t MeshFile::writeSections(const std::string& path, const std::array<char, 8>& fileMagic, uint32_t fileVersion, span<const SectionData> sectionData) {
+		const Header header{ fileMagic, fileVersion, static_cast<uint32_t>(sectionData.size()) };
+		std::vector<Section> sections;
+		uint64_t offset = alignSection(sizeof(Header) + sizeof(Section) * sectionData.size());
+		for (const SectionData& data : sectionData) {
+			sections.push_back(Section{ data.type, data.recordSize, offset, data.bytes.size() / data.recordSize });
+			offset = alignSection(offset + data.bytes.size());
+		}
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			fail("Failed to create " + path);
+		}
+
+		const std::array<char, sectionAlignment> padding{};
+		file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		file.write(reinterpret_cast<const char*>(sections.data()), sizeof(Section) * sections.size());
+		uint64_t position = sizeof(Header) + sizeof(Section) * sections.size();
+		for (size_t i = 0; i < sectionData.size(); ++i) {
+			file.write(padding.data(), static_cast<std::streamsize>(sections[i].offset - position));
+			file.write(reinterpret_cast<const char*>(sectionData[i].bytes.data()), static_cast<std::streamsize>(sectionData[i].bytes.size()));
+			position = sections[i].offset + sectionData[i].bytes.size();
+		}
+
+		if (!file) {
+			fail("Failed to write " + path);
+		}
+		return position;
+	}
+
+	span<const MeshFile::Section> MeshFile::readSections(const std::string& path, span<const std::byte> content, const std::array<char, 8>& fileMagic, uint32_t fileVersion) {
+		Header header;
+		if (content.size() < sizeof(Header)) {
+			fail(path + " is truncated");
+		}
+		std::memcpy(&header, content.data(), sizeof(Header));
+		if (header.magic != fileMagic) {
+			fail(path + " is not a " + std::string(fileMagic.begin(), std::find(fileMagic.begin(), fileMagic.end(), '\0')) + " file");
+		}
+		if (header.version != fileVersion) {
+			fail(path + " has version " + std::to_string(header.version) + ", expected " + std::to_string(fileVersion));
+		}
+		if (header.sectionCount > (content.size() - sizeof(Header)) / sizeof(Section)) {
+			fail(path + " is truncated");
+		}
+
+		// the mapping is page aligned, the table follows the 16 bytes header
+		return span<const Section>(reinterpret_cast<const Section*>(content.data() + sizeof(Header)), header.sectionCount);
+	}
+
+	span<const std::byte> MeshFile::getSectionBytes(span<const std::byte> content, span<const Section> sections, SectionType type, uint32_t recordSize) {
+		for (const Section& section : sections) {
+			if (section.type != type) {
+				continue;
+			}
+			if (section.recordSize != recordSize) {
+				fail("Unexpected record size in section " + std::to_string(static_cast<uint32_t>(type)));
+			}
+			if (section.offset % sectionAlignment != 0
+				|| section.offset > content.size()
+				|| section.count > (content.size() - section.offset) / recordSize) {
+				fail("Section " + std::to_string(static_cast<uint32_t>(type)) + " out of the file");
+			}
+			return content.subspan(static_cast<size_t>(section.offset), static_cast<size_t>(section.count * recordSize));
+		}
+		return span<const std::byte>();
+	}
+
+	std::array<MeshFile::SectionData, 5> MeshFile::getGeometrySections(const SceneGeometry& geometry) {
+		return { {
+			makeSection(SectionType::VERTICES, geometry.vertices),
+			makeSection(SectionType::PACKED_VERTICES, geometry.packedVertices),
+			makeSection(SectionType::INDICES, geometry.indices),
+			makeSection(SectionType::MESHLETS, geometry.meshlets),
+			makeSection(SectionType::MESHES, geometry.meshes)
+		} };
+	}
+
+	SceneGeometry MeshFile::readGeometry(span<const std::byte> content, span<const Section> sections) {
+		const SceneGeometry geometry{
+			getSection<Vertex>(content, sections, SectionType::VERTICES),
+			getSection<PackedVertex>(content, sections, SectionType::PACKED_VERTICES),
+			getSection<uint32_t>(content, sections, SectionType::INDICES),
+			getSection<Meshlet>(content, sections, SectionType::MESHLETS),
+			getSection<MeshRange>(content, sections, SectionType::MESHES)
+		};
+		validateMeshes(geometry);
+		return geometry;
+	}
+
+	void MeshFile::write(const std::string& path, const Scene& scene) {
+		const SceneGeometry geometry = scene.getGeometry();
+		const auto sections = getGeometrySections(geometry);
+		const uint64_t size = writeSections(path, magic, version, span<const SectionData>(sections.data(), sections.size()));
+		Logger::info(logTag, "Written " + path + ", " + std::to_string(geometry.meshes.size()) + " meshes, " + std::to_string(size) + " bytes");
+	}
+
+	void MeshFile::load(const std::string& path, Scene& scene) {
+		if (!scene.getMeshes().empty() || !scene.getInstanceBatches().empty()) {
+			fail(path + " loaded into a scene with a geometry");
+		}
+
+		std::shared_ptr<const MappedFile> file = std::make_shared<const MappedFile>(path);
+		const span<const std::byte> content = file->getContent();
+		const SceneGeometry geometry = readGeometry(content, readSections(path, content, magic, version));
+		scene.setGeometry(geometry, std::move(file));
+		Logger::info(logTag, "Mapped " + path + ", " + std::to_string(geometry.meshes.size()) + " meshes, " + std::to_string(content.size()) + " bytes");
+	}
+
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "../core/scene.hpp"
+
+namespace poc {
+
+	/*
+	 * Binary mesh container, the .pocmesh files.
+	 *
+	 * A file holds the geometry arenas of a scene as they are in memory: a header, a table of sections
+	 * and the sections, each one aligned on 64 bytes. Loading maps the file and the scene views the
+	 * sections: nothing is parsed nor copied on the CPU, the pages are read from the disk when the upload
+	 * copies them to the staging buffers. Only the header, the table, the mesh ranges, their indices
+	 * and their meshlet ranges are validated, the scene must be empty.
+	 *
+	 * The records are stored with the layout of the engine, little endian: the version changes with them
+	 * and the size of the records of each section is checked when loading.
+	 */
+	namespace MeshFile {
+
+		inline constexpr std::array<char, 8> magic{ 'P', 'O', 'C', 'M', 'E', 'S', 'H', '\0' };
+		inline constexpr uint32_t version = 1;
+		inline constexpr uint64_t sectionAlignment = 64;
+
+		enum class SectionType : uint32_t {
+			VERTICES,
+			PACKED_VERTICES,
+			INDICES,
+			MESHLETS,
+			MESHES,
+			// scene snapshots
+			INSTANCES,
+			INSTANCE_BATCHES,
+			TRANSFORM_PARENTS,
+			TRANSFORM_DEPTHS,
+			TRANSFORM_POSITIONS,
+			TRANSFORM_ROTATIONS,
+			TRANSFORM_SCALES,
+			TRANSFORM_IDS,
+			ENTITIES,
+			CAMERA
+		};
+
+		struct Header {
+			std::array<char, 8> magic;
+			uint32_t version;
+			uint32_t sectionCount;
+		};
+
+		// records of a section: offset from the start of the file, record size & count
+		struct Section {
+			SectionType type;
+			uint32_t recordSize;
+			uint64_t offset;
+			uint64_t count;
+		};
+
+		// records of a section to write
+		struct SectionData {
+			SectionType type;
+			uint32_t recordSize;
+			span<const std::byte> bytes;
+		};
+
+		template<class T>
+		SectionData makeSection(SectionType type, span<const T> records) {
+			return SectionData{ type, sizeof(T), span<const std::byte>(reinterpret_cast<const std::byte*>(records.data()), records.size_bytes()) };
+		}
+
+		// header, table & aligned sections, returns the size of the file
+		uint64_t writeSections(const std::string& path, const std::array<char, 8>& fileMagic, uint32_t fileVersion, span<const SectionData> sections);
+
+		// table of a file content, throws when the header is not the expected one or the table is out of the content
+		span<const Section> readSections(const std::string& path, span<const std::byte> content, const std::array<char, 8>& fileMagic, uint32_t fileVersion);
+
+		// bytes of the section of the type, empty when the file has none
+		// throws when its records are not of the given size or it is out of the content
+		span<const std::byte> getSectionBytes(span<const std::byte> content, span<const Section> sections, SectionType type, uint32_t recordSize);
+
+		template<class T>
+		span<const T> getSection(span<const std::byte> content, span<const Section> sections, SectionType type) {
+			const span<const std::byte> bytes = getSectionBytes(content, sections, type, sizeof(T));
+			return span<const T>(reinterpret_cast<const T*>(bytes.data()), bytes.size() / sizeof(T));
+		}
+
+		// sections of the geometry arenas
+		std::array<SectionData, 5> getGeometrySections(const SceneGeometry& geometry);
+
+		// geometry viewing the content, throws when a mesh is out of the arenas
+		SceneGeometry readGeometry(span<const std::byte> content, span<const Section> sections);
+
+		// the geometry of the scene, its entities & instances are not part of the file
+		void write(const std::string& path, const Scene& scene);
+
+		// the scene must have no geometry, it keeps the file mapped while its arenas view it
+		// throws when the scene has a geometry, the file cannot be read, is not a mesh file of this version or has invalid meshes
+		void load(const std::string& path, Scene& scene);
+
+	}
+
+}
@@ -0,0 +1,419 @@
+#include "mesh-optimizer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <unordered_map>
+
+#include "../core/logger.hpp"
+
+using namespace poc;
+
+namespace poc {
+
+	namespace MeshOptimizer {
+
+		static constexpr char logTag[]{ "POC::MeshOptimizer" };
+
+		static constexpr uint32_t invalidIndex = ~0u;
+
+		// ---------------------------------------------------------------------------------------
+		// analysis
+		// ---------------------------------------------------------------------------------------
+
+		VertexCacheStatistics analyzeVertexCache(span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize) {
+			assert(indices.size() % 3 == 0 && "indices must describe a triangle list");
+
+			VertexCacheStatistics statistics{ 0.0f, 0.0f };
+			if (indices.empty()) {
+				return statistics;
+			}
+
+			// FIFO simulation: a vertex is in the cache if less than cacheSize misses happened since it was loaded
+			std::vector<uint32_t> loadedAt(vertexCount, 0);
+			std::vector<bool> referenced(vertexCount, false);
+			uint32_t time = cacheSize + 1;
+			uint32_t misses = 0;
+			uint32_t uniqueVertices = 0;
+
+			for (const uint32_t index : indices) {
+				assert(index < vertexCount && "index out of range");
+				if (time - loadedAt[index] > cacheSize) {
+					loadedAt[index] = time++;
+					misses++;
+				}
+				if (!referenced[index]) {
+					referenced[index] = true;
+					uniqueVertices++;
+				}
+			}
+
+			statistics.acmr = static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+			statistics.atvr = static_cast<float>(misses) / static_cast<float>(uniqueVertices);
+			return statistics;
+		}
+
+		// ---------------------------------------------------------------------------------------
+		// welding
+		// ---------------------------------------------------------------------------------------
+
+		struct VertexBitwiseHash {
+			size_t operator()(const Vertex& vertex) const {
+				// FNV-1a over the raw bytes
+				const auto* bytes = reinterpret_cast<const unsigned char*>(&vertex);
+				uint64_t hash = 14695981039346656037ull;
+				for (size_t i = 0; i < sizeof(Vertex); ++i) {
+					hash = (hash ^ bytes[i]) * 1099511628211ull;
+				}
+				return static_cast<size_t>(hash);
+			}
+		};
+
+		struct VertexBitwiseEqual {
+			bool operator()(const Vertex& lhs, const Vertex& rhs) const {
+				return std::memcmp(&lhs, &rhs, sizeof(Vertex)) == 0;
+			}
+		};
+
+		void weldVertices(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+			std::unordered_map<Vertex, uint32_t, VertexBitwiseHash, VertexBitwiseEqual> uniques;
+			uniques.reserve(vertices.size());
+
+			std::vector<uint32_t> remap(vertices.size());
+			std::vector<Vertex> welded;
+			welded.reserve(vertices.size());
+
+			for (size_t i = 0; i < vertices.size(); ++i) {
+				const auto [it, inserted] = uniques.try_emplace(vertices[i], static_cast<uint32_t>(welded.size()));
+				if (inserted) {
+					welded.push_back(vertices[i]);
+				}
+				remap[i] = it->second;
+			}
+
+			for (uint32_t& index : indices) {
+				index = remap[index];
+			}
+			vertices = std::move(welded);
+		}
+
+		// ---------------------------------------------------------------------------------------
+		// vertex cache: Tom Forsyth, "Linear-Speed Vertex Cache Optimisation"
+		// ---------------------------------------------------------------------------------------
+
+		static constexpr uint32_t forsythCacheSize = 32;
+		static constexpr uint32_t forsythMaxValence = 32;
+
+		struct ForsythScores {
+			std::array<float, forsythCacheSize> cache;
+			std::array<float, forsythMaxValence + 1> valence;
+
+			ForsythScores() {
+				constexpr float cacheDecayPower = 1.5f;
+				constexpr float lastTriangleScore = 0.75f;
+				constexpr float valenceBoostScale = 2.0f;
+				constexpr float valenceBoostPower = 0.5f;
+
+				for (uint32_t i = 0; i < forsythCacheSize; ++i) {
+					// the 3 vertices of the last triangle get a fixed score to avoid using them again right away
+					cache[i] = i < 3
+						? lastTriangleScore
+						: std::pow(1.0f - static_cast<float>(i - 3) / static_cast<float>(forsythCacheSize - 3), cacheDecayPower);
+				}
+
+				valence[0] = 0.0f;
+				for (uint32_t i = 1; i <= forsythMaxValence; ++i) {
+					valence[i] = valenceBoostScale * std::pow(static_cast<float>(i), -valenceBoostPower);
+				}
+			}
+
+			float score(int32_t cachePosition, uint32_t remainingValence) const {
+				if (remainingValence == 0) {
+					return -1.0f;
+				}
+				const float cacheScore = cachePosition >= 0 ? cache[cachePosition] : 0.0f;
+				return cacheScore + valence[std::min(remainingValence, forsythMaxValence)];
+			}
+		};
+
+		void optimizeVertexCache(span<uint32_t> indices, size_t vertexCount) {
+			assert(indices.size() % 3 == 0 && "indices must describe a triangle list");
+
+			static const ForsythScores scores{};
+
+			const size_t triangleCount = indices.size() / 3;
+			if (triangleCount == 0) {
+				return;
+			}
+
+			// vertex -> triangles adjacency, the live triangles of a vertex are kept at the front of its list
+			std::vector<uint32_t> valence(vertexCount, 0);
+			for (const uint32_t index : indices) {
+				valence[index]++;
+			}
+
+			std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+			for (size_t v = 0; v < vertexCount; ++v) {
+				adjacencyOffsets[v + 1] = adjacencyOffsets[v] + valence[v];
+			}
+
+			std::vector<uint32_t> adjacency(indices.size());
+			{
+				std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+				for (size_t i = 0; i < indices.size(); ++i) {
+					adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+				}
+			}
+
+			std::vector<int32_t> cachePosition(vertexCount, -1);
+			std::vector<float> vertexScore(vertexCount);
+			for (size_t v = 0; v < vertexCount; ++v) {
+				vertexScore[v] = scores.score(-1, valence[v]);
+			}
+
+			std::vector<float> triangleScore(triangleCount);
+			std::vector<bool> emitted(triangleCount, false);
+			for (size_t t = 0; t < triangleCount; ++t) {
+				triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+			}
+
+			std::vector<uint32_t> output;
+			output.reserve(indices.size());
+
+			std::array<uint32_t, forsythCacheSize + 3> cache{};
+			std::array<uint32_t, forsythCacheSize + 3> nextCache{};
+			uint32_t cacheCount = 0;
+
+			uint32_t best = static_cast<uint32_t>(std::max_element(triangleScore.cbegin(), triangleScore.cend()) - triangleScore.cbegin());
+			size_t scanCursor = 0;
+
+			while (output.size() < indices.size()) {
+
+				if (best == invalidIndex) {
+					// no candidate in the cache, restart from the next triangle in input order
+					while (emitted[scanCursor]) {
+						scanCursor++;
+					}
+					best = static_cast<uint32_t>(scanCursor);
+				}
+
+				emitted[best] = true;
+				const std::array<uint32_t, 3> triangle{ indices[best * 3], indices[best * 3 + 1], indices[best * 3 + 2] };
+
+				for (const uint32_t v : triangle) {
+					output.push_back(v);
+
+					// move the emitted triangle out of the live part of the adjacency list
+					uint32_t* live = adjacency.data() + adjacencyOffsets[v];
+					const auto it = std::find(live, live + valence[v], best);
+					assert(it != live + valence[v]);
+					std::swap(*it, live[valence[v] - 1]);
+					valence[v]--;
+				}
+
+				// the triangle vertices go to the front of the LRU cache
+				uint32_t nextCount = 0;
+				for (const uint32_t v : triangle) {
+					if (std::find(nextCache.begin(), nextCache.begin() + nextCount, v) == nextCache.begin() + nextCount) {
+						nextCache[nextCount++] = v;
+					}
+				}
+				for (uint32_t i = 0; i < cacheCount; ++i) {
+					const uint32_t v = cache[i];
+					if (std::find(triangle.cbegin(), triangle.cend(), v) == triangle.cend()) {
+						nextCache[nextCount++] = v;
+					}
+				}
+
+				// update the scores of the vertices touched and of their live triangles
+				best = invalidIndex;
+				float bestScore = -1.0f;
+				for (uint32_t i = 0; i < nextCount; ++i) {
+					const uint32_t v = nextCache[i];
+					cachePosition[v] = i < forsythCacheSize ? static_cast<int32_t>(i) : -1;
+
+					const float delta = scores.score(cachePosition[v], valence[v]) - vertexScore[v];
+					vertexScore[v] += delta;
+
+					const uint32_t* live = adjacency.data() + adjacencyOffsets[v];
+					for (uint32_t j = 0; j < valence[v]; ++j) {
+						const uint32_t t = live[j];
+						triangleScore[t] += delta;
+						if (triangleScore[t] > bestScore) {
+							bestScore = triangleScore[t];
+							best = t;
+						}
+					}
+				}
+
+				std::swap(cache, nextCache);
+				cacheCount = std::min(nextCount, forsythCacheSize);
+			}
+
+			std::copy(output.cbegin(), output.cend(), indices.begin());
+		}
+
+		// ---------------------------------------------------------------------------------------
+		// overdraw: Sander, Nehab, Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw"
+		// ---------------------------------------------------------------------------------------
+
+		struct Cluster {
+			uint32_t firstTriangle;
+			uint32_t triangleCount;
+			float sortKey;
+		};
+
+		static std::vector<Cluster> splitClusters(span<const uint32_t> indices, size_t vertexCount) {
+			// hard boundaries are the triangles missing all their vertices in the cache: moving the
+			// cluster that starts there does not degrade the vertex cache efficiency
+			std::vector<uint32_t> loadedAt(vertexCount, 0);
+			uint32_t time = defaultCacheSize + 1;
+
+			std::vector<Cluster> clusters;
+			const auto triangleCount = static_cast<uint32_t>(indices.size() / 3);
+			for (uint32_t t = 0; t < triangleCount; ++t) {
+				uint32_t misses = 0;
+				for (uint32_t k = 0; k < 3; ++k) {
+					const uint32_t v = indices[t * 3 + k];
+					if (time - loadedAt[v] > defaultCacheSize) {
+						loadedAt[v] = time++;
+						misses++;
+					}
+				}
+				if (t == 0 || misses == 3) {
+					clusters.push_back(Cluster{ t, 0, 0.0f });
+				}
+				clusters.back().triangleCount++;
+			}
+			return clusters;
+		}
+
+		void optimizeOverdraw(span<uint32_t> indices, span<const Vertex> vertices) {
+			assert(indices.size() % 3 == 0 && "indices must describe a triangle list");
+
+			if (indices.empty()) {
+				return;
+			}
+
+			std::vector<Cluster> clusters = splitClusters(indices, vertices.size());
+			if (clusters.size() < 2) {
+				return;
+			}
+
+			// area weighted centroids & normals
+			std::vector<glm::vec3> clusterCentroids(clusters.size(), glm::vec3(0.0f));
+			std::vector<glm::vec3> clusterNormals(clusters.size(), glm::vec3(0.0f));
+			glm::vec3 meshCentroid(0.0f);
+			float meshArea = 0.0f;
+
+			for (size_t c = 0; c < clusters.size(); ++c) {
+				float clusterArea = 0.0f;
+				for (uint32_t t = clusters[c].firstTriangle; t < clusters[c].firstTriangle + clusters[c].triangleCount; ++t) {
+					const glm::vec3& p0 = vertices[indices[t * 3]].position;
+					const glm::vec3& p1 = vertices[indices[t * 3 + 1]].position;
+					const glm::vec3& p2 = vertices[indices[t * 3 + 2]].position;
+
+					const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+					const float area = glm::length(normal);
+					const glm::vec3 centroid = (p0 + p1 + p2) / 3.0f;
+
+					clusterCentroids[c] += centroid * area;
+					clusterNormals[c] += normal;
+					clusterArea += area;
+				}
+
+				meshCentroid += clusterCentroids[c];
+				meshArea += clusterArea;
+				clusterCentroids[c] = clusterArea > 0.0f ? clusterCentroids[c] / clusterArea : clusterCentroids[c];
+			}
+			meshCentroid = meshArea > 0.0f ? meshCentroid / meshArea : meshCentroid;
+
+			// clusters facing away from the center are more likely to occlude the others: draw them first
+			for (size_t c = 0; c < clusters.size(); ++c) {
+				const float normalLength = glm::length(clusterNormals[c]);
+				const glm::vec3 normal = normalLength > 0.0f ? clusterNormals[c] / normalLength : glm::vec3(0.0f);
+				clusters[c].sortKey = glm::dot(clusterCentroids[c] - meshCentroid, normal);
+			}
+
+			std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& lhs, const Cluster& rhs) {
+				return lhs.sortKey > rhs.sortKey;
+			});
+
+			std::vector<uint32_t> output;
+			output.reserve(indices.size());
+			for (const Cluster& cluster : clusters) {
+				const uint32_t* first = indices.data() + cluster.firstTriangle * 3;
+				output.insert(output.end(), first, first + cluster.triangleCount * 3);
+			}
+			std::copy(output.cbegin(), output.cend(), indices.begin());
+		}
+
+		// ---------------------------------------------------------------------------------------
+		// vertex fetch
+		// ---------------------------------------------------------------------------------------
+
+		void optimizeVertexFetch(std::vector<Vertex>& vertices, span<uint32_t> indices) {
+			std::vector<uint32_t> remap(vertices.size(), invalidIndex);
+			std::vector<Vertex> ordered;
+			ordered.reserve(vertices.size());
+
+			// unreferenced vertices are dropped
+			for (uint32_t& index : indices) {
+				if (remap[index] == invalidIndex) {
+					remap[index] = static_cast<uint32_t>(ordered.size());
+					ordered.push_back(vertices[index]);
+				}
+				index = remap[index];
+			}
+
+			vertices = std::move(ordered);
+		}
+
+		// ---------------------------------------------------------------------------------------
+		// full pipeline
+		// ---------------------------------------------------------------------------------------
+
+		static std::string toString(const VertexCacheStatistics& statistics) {
+			std::ostringstream os;
+			os.precision(3);
+			os << "ACMR " << statistics.acmr << " ATVR " << statistics.atvr;
+			return os.str();
+		}
+
+		OptimizationReport optimize(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+			OptimizationReport report{};
+			report.before = analyzeVertexCache(indices, vertices.size());
+			report.vertexCountBefore = static_cast<uint32_t>(vertices.size());
+
+			weldVertices(vertices, indices);
+			optimizeVertexCache(indices, vertices.size());
+			optimizeOverdraw(indices, vertices);
+			optimizeVertexFetch(vertices, indices);
+
+			report.after = analyzeVertexCache(indices, vertices.size());
+			report.vertexCountAfter = static_cast<uint32_t>(vertices.size());
+
+			Logger::info(logTag, "Vertices " + std::to_string(report.vertexCountBefore) + " -> " + std::to_string(report.vertexCountAfter)
+				+ ", " + toString(report.before) + " -> " + toString(report.after));
+
+			return report;
+		}
+
+		Mesh optimize(const Mesh& mesh, OptimizationReport* report) {
+			std::vector<Vertex> vertices(mesh.getVertices().begin(), mesh.getVertices().end());
+			std::vector<uint32_t> indices(mesh.getIndices().begin(), mesh.getIndices().end());
+
+			const OptimizationReport result = optimize(vertices, indices);
+			if (report) {
+				*report = result;
+			}
+
+			return Mesh(std::move(vertices), std::move(indices), mesh.getVertexFormat());
+		}
+
+	}
+
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+
+#include "../core/span.hpp"
+#include "mesh.hpp"
+#include "vertex.hpp"
+
+namespace poc {
+
+	/*
+	 * Offline optimizations of indexed triangle lists.
+	 *
+	 * - weldVertices: merge bitwise identical vertices
+	 * - optimizeVertexCache: reorder triangles for post-transform cache hits (Forsyth)
+	 * - optimizeOverdraw: reorder cache-friendly clusters front to back (Sander et al.)
+	 * - optimizeVertexFetch: reorder vertices in order of first use
+	 */
+	namespace MeshOptimizer {
+
+		// cache size used to analyze the meshes, close to the typical hardware FIFO
+		inline constexpr uint32_t defaultCacheSize = 16;
+
+		struct VertexCacheStatistics {
+			float acmr; // average cache miss ratio: transformed vertices per triangle (0.5 is ideal)
+			float atvr; // average transform to vertex ratio: transformed vertices per vertex (1.0 is ideal)
+		};
+
+		struct OptimizationReport {
+			VertexCacheStatistics before;
+			VertexCacheStatistics after;
+			uint32_t vertexCountBefore;
+			uint32_t vertexCountAfter;
+		};
+
+		VertexCacheStatistics analyzeVertexCache(span<const uint32_t> indices, size_t vertexCount, uint32_t cacheSize = defaultCacheSize);
+
+		void weldVertices(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+		void optimizeVertexCache(span<uint32_t> indices, size_t vertexCount);
+		void optimizeOverdraw(span<uint32_t> indices, span<const Vertex> vertices);
+		void optimizeVertexFetch(std::vector<Vertex>& vertices, span<uint32_t> indices);
+
+		// run all the passes in order and log the vertex cache statistics
+		OptimizationReport optimize(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+		Mesh optimize(const Mesh& mesh, OptimizationReport* report = nullptr);
+
+	}
+
+}
@@ -0,0 +1,357 @@
+#include "mesh-simplifier.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <sstream>
+#include <unordered_map>
+
+#include "../core/logger.hpp"
+#include "mesh-optimizer.hpp"
+
+using namespace poc;
+
+namespace poc {
+
+	namespace MeshSimplifier {
+
+		static constexpr char logTag[]{ "POC::MeshSimplifier" };
+
+		// ---------------------------------------------------------------------------------------
+		// quadrics
+		// ---------------------------------------------------------------------------------------
+
+		// symmetric 4x4 matrix of the area weighted squared distances to the planes of the triangles
+		struct Quadric {
+			double a00, a01, a02, a03;
+			double a11, a12, a13;
+			double a22, a23;
+			double a33;
+			double weight;
+		};
+
+		static Quadric makePlaneQuadric(const glm::dvec3& normal, double distance, double weight) {
+			const double a = normal.x;
+			const double b = normal.y;
+			const double c = normal.z;
+			const double d = distance;
+			return Quadric{
+				a * a * weight, a * b * weight, a * c * weight, a * d * weight,
+				b * b * weight, b * c * weight, b * d * weight,
+				c * c * weight, c * d * weight,
+				d * d * weight,
+				weight
+			};
+		}
+
+		static void add(Quadric& q, const Quadric& other) {
+			q.a00 += other.a00;
+			q.a01 += other.a01;
+			q.a02 += other.a02;
+			q.a03 += other.a03;
+			q.a11 += other.a11;
+			q.a12 += other.a12;
+			q.a13 += other.a13;
+			q.a22 += other.a22;
+			q.a23 += other.a23;
+			q.a33 += other.a33;
+			q.weight += other.weight;
+		}
+
+		// mean squared distance of the point to the planes
+		static double evaluate(const Quadric& q, const glm::vec3& point) {
+			const double x = point.x;
+			const double y = point.y;
+			const double z = point.z;
+			const double error =
+				q.a00 * x * x + 2.0 * q.a01 * x * y + 2.0 * q.a02 * x * z + 2.0 * q.a03 * x +
+				q.a11 * y * y + 2.0 * q.a12 * y * z + 2.0 * q.a13 * y +
+				q.a22 * z * z + 2.0 * q.a23 * z +
+				q.a33;
+			return q.weight > 0.0 ? std::max(error, 0.0) / q.weight : 0.0;
+		}
+
+		static std::vector<Quadric> computeQuadrics(span<const Vertex> vertices, span<const uint32_t> indices) {
+			std::vector<Quadric> quadrics(vertices.size(), Quadric{});
+			for (size_t i = 0; i < indices.size(); i += 3) {
+				const glm::dvec3 p0 = vertices[indices[i]].position;
+				const glm::dvec3 p1 = vertices[indices[i + 1]].position;
+				const glm::dvec3 p2 = vertices[indices[i + 2]].position;
+				const glm::dvec3 normal = glm::cross(p1 - p0, p2 - p0);
+				const double length = glm::length(normal);
+				if (length == 0.0) {
+					continue;
+				}
+
+				const glm::dvec3 unitNormal = normal / length;
+				const Quadric quadric = makePlaneQuadric(unitNormal, -glm::dot(unitNormal, p0), length * 0.5);
+				for (size_t k = 0; k < 3; ++k) {
+					add(quadrics[indices[i + k]], quadric);
+				}
+			}
+			return quadrics;
+		}
+
+		// ---------------------------------------------------------------------------------------
+		// topology
+		// ---------------------------------------------------------------------------------------
+
+		struct PositionHash {
+			size_t operator()(const glm::vec3& position) const {
+				uint32_t bits[3];
+				std::memcpy(bits, &position, sizeof(bits));
+				return (size_t(bits[0]) * 73856093u) ^ (size_t(bits[1]) * 19349663u) ^ (size_t(bits[2]) * 83492791u);
+			}
+		};
+
+		// moving a border, non manifold or seam vertex would open a hole in the mesh
+		static std::vector<uint8_t> findLockedVertices(span<const Vertex> vertices, span<const uint32_t> indices) {
+			std::vector<uint8_t> locked(vertices.size(), 0);
+
+			std::unordered_map<uint64_t, uint32_t> edgeTriangleCounts;
+			edgeTriangleCounts.reserve(indices.size());
+			for (size_t i = 0; i < indices.size(); i += 3) {
+				for (size_t e = 0; e < 3; ++e) {
+					const uint32_t a = indices[i + e];
+					const uint32_t b = indices[i + (e + 1) % 3];
+					++edgeTriangleCounts[(uint64_t(std::min(a, b)) << 32) | std::max(a, b)];
+				}
+			}
+			for (const auto& [edge, count] : edgeTriangleCounts) {
+				if (count != 2) {
+					locked[edge >> 32] = 1;
+					locked[edge & 0xffffffffu] = 1;
+				}
+			}
+
+			std::unordered_map<glm::vec3, uint32_t, PositionHash> firstVertices;
+			firstVertices.reserve(vertices.size());
+			for (uint32_t v = 0; v < vertices.size(); ++v) {
+				const auto [first, inserted] = firstVertices.emplace(vertices[v].position, v);
+				if (!inserted) {
+					locked[first->second] = 1;
+					locked[v] = 1;
+				}
+			}
+
+			return locked;
+		}
+
+		// triangles using each vertex: triangles[offsets[v], offsets[v + 1])
+		static void buildAdjacency(span<const uint32_t> indices, size_t vertexCount, std::vector<uint32_t>& offsets, std::vector<uint32_t>& triangles) {
+			offsets.assign(vertexCount + 1, 0);
+			for (const uint32_t index : indices) {
+				++offsets[index + 1];
+			}
+			std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+			triangles.resize(indices.size());
+			std::vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+			for (size_t i = 0; i < indices.size(); ++i) {
+				triangles[cursors[indices[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+		}
+
+		// ---------------------------------------------------------------------------------------
+		// simplification
+		// ---------------------------------------------------------------------------------------
+
+		struct Collapse {
+			uint32_t from;
+			uint32_t to;
+			double error;
+		};
+
+		// a triangle around the collapsed vertex turning over would fold the surface
+		static bool flipsTriangles(
+			const Collapse& collapse,
+			span<const Vertex> vertices,
+			span<const uint32_t> indices,
+			const std::vector<uint32_t>& offsets,
+			const std::vector<uint32_t>& triangles) {
+
+			for (uint32_t t = offsets[collapse.from]; t < offsets[collapse.from + 1]; ++t) {
+				const uint32_t* triangle = indices.data() + triangles[t] * 3;
+				if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to) {
+					// removed by the collapse
+					continue;
+				}
+
+				glm::vec3 before[3];
+				glm::vec3 after[3];
+				for (size_t k = 0; k < 3; ++k) {
+					before[k] = vertices[triangle[k]].position;
+					after[k] = triangle[k] == collapse.from ? vertices[collapse.to].position : before[k];
+				}
+				const glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+				const glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+				if (glm::dot(normalBefore, normalAfter) <= 0.0f) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		std::vector<uint32_t> simplify(
+			span<const Vertex> vertices,
+			span<const uint32_t> indices,
+			size_t targetIndexCount,
+			float targetError,
+			float* resultError) {
+
+			assert(indices.size() % 3 == 0 && "indices must describe a triangle list");
+
+			std::vector<uint32_t> result(indices.begin(), indices.end());
+			const std::vector<uint8_t> locked = findLockedVertices(vertices, result);
+			std::vector<Quadric> quadrics = computeQuadrics(vertices, result);
+
+			const double maxError = targetError < std::numeric_limits<float>::max()
+				? double(targetError) * double(targetError)
+				: std::numeric_limits<double>::max();
+			double reachedError = 0.0;
+
+			std::vector<uint32_t> offsets;
+			std::vector<uint32_t> triangles;
+			std::vector<Collapse> collapses;
+			std::vector<uint32_t> remap(vertices.size());
+			std::vector<uint8_t> touched(vertices.size());
+
+			// each pass collapses the cheapest independent edges, the topology is updated between the passes
+			while (result.size() > targetIndexCount) {
+				buildAdjacency(result, vertices.size(), offsets, triangles);
+
+				collapses.clear();
+				for (size_t i = 0; i < result.size(); i += 3) {
+					for (size_t e = 0; e < 3; ++e) {
+						const uint32_t a = result[i + e];
+						const uint32_t b = result[i + (e + 1) % 3];
+						// interior edges are shared by 2 triangles in opposite directions: kept once
+						if (a > b) {
+							continue;
+						}
+
+						Quadric merged = quadrics[a];
+						add(merged, quadrics[b]);
+						if (!locked[a]) {
+							collapses.push_back(Collapse{ a, b, evaluate(merged, vertices[b].position) });
+						}
+						if (!locked[b]) {
+							collapses.push_back(Collapse{ b, a, evaluate(merged, vertices[a].position) });
+						}
+					}
+				}
+				std::sort(collapses.begin(), collapses.end(), [](const Collapse& lhs, const Collapse& rhs) {
+					return lhs.error < rhs.error;
+				});
+
+				std::iota(remap.begin(), remap.end(), 0u);
+				std::fill(touched.begin(), touched.end(), uint8_t(0));
+				size_t triangleCount = result.size() / 3;
+				size_t collapseCount = 0;
+
+				for (const Collapse& collapse : collapses) {
+					if (collapse.error > maxError || triangleCount <= targetIndexCount / 3) {
+						break;
+					}
+					if (touched[collapse.from] || touched[collapse.to] || flipsTriangles(collapse, vertices, result, offsets, triangles)) {
+						continue;
+					}
+
+					remap[collapse.from] = collapse.to;
+					add(quadrics[collapse.to], quadrics[collapse.from]);
+
+					// the triangles around the collapsed vertex change: their vertices wait for the next pass
+					for (uint32_t t = offsets[collapse.from]; t < offsets[collapse.from + 1]; ++t) {
+						const uint32_t* triangle = result.data() + triangles[t] * 3;
+						bool removed = false;
+						for (size_t k = 0; k < 3; ++k) {
+							touched[triangle[k]] = 1;
+							removed = removed || triangle[k] == collapse.to;
+						}
+						triangleCount -= removed ? 1 : 0;
+					}
+
+					reachedError = std::max(reachedError, collapse.error);
+					++collapseCount;
+				}
+
+				if (collapseCount == 0) {
+					break;
+				}
+
+				size_t write = 0;
+				for (size_t i = 0; i < result.size(); i += 3) {
+					const uint32_t a = remap[result[i]];
+					const uint32_t b = remap[result[i + 1]];
+					const uint32_t c = remap[result[i + 2]];
+					if (a != b && b != c && a != c) {
+						result[write++] = a;
+						result[write++] = b;
+						result[write++] = c;
+					}
+				}
+				result.resize(write);
+			}
+
+			if (resultError) {
+				*resultError = float(std::sqrt(reachedError));
+			}
+			return result;
+		}
+
+		// ---------------------------------------------------------------------------------------
+		// levels of detail
+		// ---------------------------------------------------------------------------------------
+
+		std::vector<MeshLod> generateLods(span<const Vertex> vertices, span<const uint32_t> indices, float reduction) {
+			assert(reduction > 0.0f && reduction < 1.0f && "the reduction must remove triangles");
+
+			std::vector<MeshLod> lods;
+			lods.reserve(maxMeshLods - 1);
+
+			span<const uint32_t> previous = indices;
+			float error = 0.0f;
+			while (lods.size() + 1 < maxMeshLods) {
+				const size_t targetIndexCount = static_cast<size_t>(float(previous.size() / 3) * reduction) * 3;
+				if (targetIndexCount < 3) {
+					break;
+				}
+
+				float levelError = 0.0f;
+				std::vector<uint32_t> lodIndices = simplify(vertices, previous, targetIndexCount, std::numeric_limits<float>::max(), &levelError);
+
+				// a level saving less than 10% of the triangles is not worth a switch
+				if (lodIndices.empty() || lodIndices.size() * 10 > previous.size() * 9) {
+					break;
+				}
+
+				MeshOptimizer::optimizeVertexCache(lodIndices, vertices.size());
+
+				// each level is simplified from the previous one: the distances add up
+				error += levelError;
+				lods.push_back(MeshLod{ std::move(lodIndices), error });
+				previous = lods.back().indices;
+			}
+			return lods;
+		}
+
+		Mesh generateLods(const Mesh& mesh, float reduction) {
+			Mesh result = mesh;
+			result.setLods(generateLods(mesh.getVertices(), mesh.getIndices(), reduction));
+
+			std::ostringstream os;
+			os.precision(3);
+			os << "Triangles " << mesh.getIndices().size() / 3;
+			for (const MeshLod& lod : result.getLods()) {
+				os << " -> " << lod.indices.size() / 3 << " (error " << lod.error << ")";
+			}
+			Logger::info(logTag, os.str());
+
+			return result;
+		}
+
+	}
+
+}
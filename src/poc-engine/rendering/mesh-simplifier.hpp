@@ -0,0 +1,40 @@
+#pragma once
+
+#include <limits>
+#include <vector>
+
+#include "../core/span.hpp"
+#include "mesh.hpp"
+#include "vertex.hpp"
+
+namespace poc {
+
+	/*
+	 * Quadric error mesh simplification (Garland & Heckbert) & level of detail chains.
+	 *
+	 * Edges are collapsed onto one of their vertices, by increasing quadric error: the simplified
+	 * indices reference the original vertices, so all the levels of a mesh share one vertex buffer.
+	 * Vertices on a border or a seam (same position, other attributes) are never moved to keep the
+	 * mesh watertight.
+	 */
+	namespace MeshSimplifier {
+
+		// triangles kept at each level of a chain relatively to the previous one
+		inline constexpr float defaultLodReduction = 0.5f;
+
+		// returns at most targetIndexCount indices when the error allows it
+		// targetError bounds the distance to the input surface, the reached error is returned in resultError
+		std::vector<uint32_t> simplify(
+			span<const Vertex> vertices,
+			span<const uint32_t> indices,
+			size_t targetIndexCount,
+			float targetError = std::numeric_limits<float>::max(),
+			float* resultError = nullptr);
+
+		// chain of levels each simplified from the previous one, stops when the mesh cannot be reduced further
+		std::vector<MeshLod> generateLods(span<const Vertex> vertices, span<const uint32_t> indices, float reduction = defaultLodReduction);
+		Mesh generateLods(const Mesh& mesh, float reduction = defaultLodReduction);
+
+	}
+
+}
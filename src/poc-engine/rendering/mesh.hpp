@@ -1,24 +1,148 @@
 #pragma once
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numeric>
 #include <vector>
 
+#include "../core/array-storage.hpp"
+#include "../core/bounds.hpp"
 #include "../core/logger.hpp"
+#include "../core/span.hpp"
+#include "meshlet.hpp"
 #include "vertex.hpp"
 
 namespace poc {
 
+	// levels of detail of a mesh at most, the full detail level included
+	inline constexpr uint32_t maxMeshLods = 8;
+
+	// simplified triangle list using the vertices of the full detail mesh
+	// error: distance to the full detail surface, in mesh units
+	struct MeshLod {
+		ArrayStorage<uint32_t> indices;
+		float error;
+	};
+
+	struct MeshBounds {
+		Aabb aabb;
+		BoundingSphere sphere;
+	};
+
+	// sphere centered on the box: not minimal but tighter than the box corners for the usual shapes
+	inline MeshBounds computeMeshBounds(span<const Vertex> vertices) {
+		MeshBounds bounds;
+		for (const Vertex& vertex : vertices) {
+			bounds.aabb.expand(vertex.position);
+		}
+
+		if (bounds.aabb.isEmpty()) {
+			return bounds;
+		}
+
+		float squaredRadius = 0.0f;
+		bounds.sphere.center = bounds.aabb.getCenter();
+		for (const Vertex& vertex : vertices) {
+			const glm::vec3 offset = vertex.position - bounds.sphere.center;
+			squaredRadius = std::max(squaredRadius, glm::dot(offset, offset));
+		}
+		bounds.sphere.radius = std::sqrt(squaredRadius);
+		return bounds;
+	}
+
 	class Mesh {
 	public:
 
 		Mesh() = default;
-		Mesh(std::vector<Vertex>&& v) : vertices(std::move(v)) {}
 
-		const std::vector<Vertex>& getVertices() const {
+		// non indexed triangle list, each vertex is referenced once
+		Mesh(std::vector<Vertex>&& v, VertexFormat f = VertexFormat::FLOAT32) :
+			vertices(std::move(v)),
+			indices(std::vector<uint32_t>(vertices.size())),
+			format(f),
+			bounds(computeMeshBounds(vertices)) {
+			std::vector<uint32_t>& sequence = indices.getVector();
+			std::iota(sequence.begin(), sequence.end(), 0);
+		}
+
+		// indexed triangle list, indices are relative to the mesh vertices
+		Mesh(std::vector<Vertex>&& v, std::vector<uint32_t>&& i, VertexFormat f = VertexFormat::FLOAT32) :
+			vertices(std::move(v)),
+			indices(std::move(i)),
+			format(f),
+			bounds(computeMeshBounds(vertices)) {}
+
+		// view of external storage, e.g. a mapped file, which must outlive the mesh & its copies
+		// nothing is copied, the bounds are given as they were computed when the storage was written
+		Mesh(span<const Vertex> v, span<const uint32_t> i, VertexFormat f, const MeshBounds& b) :
+			vertices(v),
+			indices(i),
+			format(f),
+			bounds(b) {}
+
+		span<const Vertex> getVertices() const {
 			return vertices;
 		}
 
+		span<const uint32_t> getIndices() const {
+			return indices;
+		}
+
+		// the geometry is a view of external storage
+		bool isExternal() const {
+			return vertices.isExternal();
+		}
+
+		// storage format on the GPU
+		VertexFormat getVertexFormat() const {
+			return format;
+		}
+
+		void setVertexFormat(VertexFormat f) {
+			format = f;
+		}
+
+		// bounds of the positions, computed once when the mesh is created
+		const MeshBounds& getBounds() const {
+			return bounds;
+		}
+
+		const Aabb& getAabb() const {
+			return bounds.aabb;
+		}
+
+		const BoundingSphere& getBoundingSphere() const {
+			return bounds.sphere;
+		}
+
+		// coarser levels after the full detail one, by increasing error
+		const std::vector<MeshLod>& getLods() const {
+			return lods;
+		}
+
+		void setLods(std::vector<MeshLod>&& l) {
+			assert(l.size() < maxMeshLods && "too many levels of detail");
+			lods = std::move(l);
+		}
+
+		// clusters of the full detail level, empty unless built with MeshletBuilder
+		// they describe the current indices which must not be reordered afterwards
+		span<const Meshlet> getMeshlets() const {
+			return meshlets;
+		}
+
+		void setMeshlets(ArrayStorage<Meshlet>&& m) {
+			meshlets = std::move(m);
+		}
+
 	private:
-		std::vector<Vertex> vertices;
+		ArrayStorage<Vertex> vertices;
+		ArrayStorage<uint32_t> indices;
+		VertexFormat format{ VertexFormat::FLOAT32 };
+		MeshBounds bounds;
+		std::vector<MeshLod> lods;
+		ArrayStorage<Meshlet> meshlets;
 	};
 
-}
\ No newline at end of file
+}
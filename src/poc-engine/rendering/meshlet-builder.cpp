@@ -0,0 +1,202 @@
+#include "meshlet-builder.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+using namespace poc;
+
+namespace poc {
+
+	namespace MeshletBuilder {
+
+		static constexpr uint32_t invalidIndex = ~0u;
+
+		static void computeBounds(Meshlet& meshlet, span<const Vertex> vertices, const uint32_t* indices) {
+			Aabb aabb;
+			for (uint32_t i = 0; i < meshlet.triangleCount * 3; ++i) {
+				aabb.expand(vertices[indices[i]].position);
+			}
+
+			float squaredRadius = 0.0f;
+			for (uint32_t i = 0; i < meshlet.triangleCount * 3; ++i) {
+				const glm::vec3 offset = vertices[indices[i]].position - aabb.getCenter();
+				squaredRadius = std::max(squaredRadius, glm::dot(offset, offset));
+			}
+			meshlet.sphere = BoundingSphere{ aabb.getCenter(), std::sqrt(squaredRadius) };
+
+			// the cone axis is the mean normal, its angle the largest deviation from it
+			std::vector<glm::vec3> normals;
+			normals.reserve(meshlet.triangleCount);
+			glm::vec3 axis(0.0f);
+			for (uint32_t t = 0; t < meshlet.triangleCount; ++t) {
+				const glm::vec3& p0 = vertices[indices[t * 3]].position;
+				const glm::vec3& p1 = vertices[indices[t * 3 + 1]].position;
+				const glm::vec3& p2 = vertices[indices[t * 3 + 2]].position;
+				const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+				const float length = glm::length(normal);
+				if (length > 0.0f) {
+					normals.push_back(normal / length);
+					axis += normals.back();
+				}
+			}
+
+			const float axisLength = glm::length(axis);
+			meshlet.coneAxis = axisLength > 0.0f ? axis / axisLength : glm::vec3(0.0f, 0.0f, 1.0f);
+			meshlet.coneCutoff = 1.0f;
+			if (axisLength > 0.0f) {
+				float minDot = 1.0f;
+				for (const glm::vec3& normal : normals) {
+					minDot = std::min(minDot, glm::dot(normal, meshlet.coneAxis));
+				}
+				// a cone of 90 degrees or more always has a triangle facing the camera
+				if (minDot > 0.0f) {
+					meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+				}
+			}
+		}
+
+		std::vector<Meshlet> build(span<const Vertex> vertices, span<uint32_t> indices, uint32_t maxVertices, uint32_t maxTriangles) {
+			assert(indices.size() % 3 == 0 && "indices must describe a triangle list");
+			assert(maxVertices >= 3 && maxTriangles >= 1 && "a meshlet must hold at least a triangle");
+
+			const size_t triangleCount = indices.size() / 3;
+			std::vector<Meshlet> meshlets;
+			if (triangleCount == 0) {
+				return meshlets;
+			}
+
+			// triangles using each vertex: vertexTriangles[offsets[v], offsets[v + 1])
+			std::vector<uint32_t> offsets(vertices.size() + 1, 0);
+			for (const uint32_t index : indices) {
+				++offsets[index + 1];
+			}
+			std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+			std::vector<uint32_t> vertexTriangles(indices.size());
+			std::vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+			for (size_t i = 0; i < indices.size(); ++i) {
+				vertexTriangles[cursors[indices[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+
+			std::vector<glm::vec3> centroids(triangleCount);
+			for (size_t t = 0; t < triangleCount; ++t) {
+				centroids[t] = (vertices[indices[t * 3]].position + vertices[indices[t * 3 + 1]].position + vertices[indices[t * 3 + 2]].position) / 3.0f;
+			}
+
+			// the last meshlet using each vertex & listing each triangle as a candidate
+			std::vector<uint32_t> vertexMeshlets(vertices.size(), invalidIndex);
+			std::vector<uint32_t> candidateMeshlets(triangleCount, invalidIndex);
+			std::vector<uint8_t> emitted(triangleCount, 0);
+			std::vector<uint32_t> candidates;
+			std::vector<uint32_t> output;
+			output.reserve(indices.size());
+
+			uint32_t meshletVertexCount = 0;
+			glm::vec3 centroidSum(0.0f);
+			size_t scan = 0;
+
+			const auto currentMeshlet = [&meshlets]() {
+				return static_cast<uint32_t>(meshlets.size() - 1);
+			};
+
+			const auto countNewVertices = [&](uint32_t triangle) {
+				const uint32_t* t = indices.data() + triangle * 3;
+				uint32_t count = 0;
+				for (uint32_t k = 0; k < 3; ++k) {
+					const bool duplicate = (k > 0 && t[k] == t[0]) || (k > 1 && t[k] == t[1]);
+					count += !duplicate && vertexMeshlets[t[k]] != currentMeshlet() ? 1 : 0;
+				}
+				return count;
+			};
+
+			const auto startMeshlet = [&]() {
+				meshlets.push_back(Meshlet{ static_cast<uint32_t>(output.size()), 0, BoundingSphere{}, glm::vec3(0.0f), 1.0f });
+				meshletVertexCount = 0;
+				centroidSum = glm::vec3(0.0f);
+				candidates.clear();
+			};
+
+			startMeshlet();
+			for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount) {
+				// the candidate sharing the most vertices, then the closest to the meshlet
+				candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&emitted](uint32_t t) { return emitted[t] != 0; }), candidates.end());
+				const glm::vec3 center = meshlets.back().triangleCount > 0 ? centroidSum / float(meshlets.back().triangleCount) : glm::vec3(0.0f);
+
+				uint32_t best = invalidIndex;
+				uint32_t bestNewVertices = 4;
+				float bestDistance = std::numeric_limits<float>::max();
+				for (const uint32_t candidate : candidates) {
+					const uint32_t newVertices = countNewVertices(candidate);
+					const glm::vec3 offset = centroids[candidate] - center;
+					const float distance = glm::dot(offset, offset);
+					if (newVertices < bestNewVertices || (newVertices == bestNewVertices && distance < bestDistance)) {
+						best = candidate;
+						bestNewVertices = newVertices;
+						bestDistance = distance;
+					}
+				}
+
+				// no neighbor left: continue with the next triangle in the original order
+				if (best == invalidIndex) {
+					while (emitted[scan]) {
+						++scan;
+					}
+					best = static_cast<uint32_t>(scan);
+				}
+
+				if (meshletVertexCount + countNewVertices(best) > maxVertices) {
+					startMeshlet();
+				}
+
+				emitted[best] = 1;
+				const uint32_t* triangle = indices.data() + best * 3;
+				output.insert(output.end(), triangle, triangle + 3);
+				centroidSum += centroids[best];
+				++meshlets.back().triangleCount;
+
+				for (uint32_t k = 0; k < 3; ++k) {
+					const uint32_t vertex = triangle[k];
+					if (vertexMeshlets[vertex] == currentMeshlet()) {
+						continue;
+					}
+					vertexMeshlets[vertex] = currentMeshlet();
+					++meshletVertexCount;
+
+					for (uint32_t i = offsets[vertex]; i < offsets[vertex + 1]; ++i) {
+						const uint32_t neighbor = vertexTriangles[i];
+						if (!emitted[neighbor] && candidateMeshlets[neighbor] != currentMeshlet()) {
+							candidateMeshlets[neighbor] = currentMeshlet();
+							candidates.push_back(neighbor);
+						}
+					}
+				}
+
+				if (meshlets.back().triangleCount == maxTriangles && emittedCount + 1 < triangleCount) {
+					startMeshlet();
+				}
+			}
+
+			std::copy(output.begin(), output.end(), indices.begin());
+			for (Meshlet& meshlet : meshlets) {
+				computeBounds(meshlet, vertices, indices.data() + meshlet.firstIndex);
+			}
+			return meshlets;
+		}
+
+		Mesh build(const Mesh& mesh, uint32_t maxVertices, uint32_t maxTriangles) {
+			std::vector<Vertex> vertices(mesh.getVertices().begin(), mesh.getVertices().end());
+			std::vector<uint32_t> indices(mesh.getIndices().begin(), mesh.getIndices().end());
+			std::vector<Meshlet> meshlets = build(vertices, indices, maxVertices, maxTriangles);
+
+			Mesh result(std::move(vertices), std::move(indices), mesh.getVertexFormat());
+			std::vector<MeshLod> lods = mesh.getLods();
+			result.setLods(std::move(lods));
+			result.setMeshlets(std::move(meshlets));
+			return result;
+		}
+
+	}
+
+}
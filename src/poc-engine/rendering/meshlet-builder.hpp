@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+
+#include "../core/span.hpp"
+#include "mesh.hpp"
+#include "meshlet.hpp"
+#include "vertex.hpp"
+
+namespace poc {
+
+	/*
+	 * Partition of a triangle list into meshlets small enough to be culled one by one.
+	 *
+	 * Triangles are added greedily to the current meshlet, preferring the ones sharing the most vertices
+	 * with it then the closest ones, until it reaches its vertex or triangle limit. The indices are reordered
+	 * meshlet by meshlet so each one is a contiguous range. Each meshlet gets a bounding sphere for the
+	 * frustum culling and a normal cone for the back-face culling.
+	 */
+	namespace MeshletBuilder {
+
+		inline constexpr uint32_t defaultMaxVertices = 64;
+		inline constexpr uint32_t defaultMaxTriangles = 124;
+
+		std::vector<Meshlet> build(
+			span<const Vertex> vertices,
+			span<uint32_t> indices,
+			uint32_t maxVertices = defaultMaxVertices,
+			uint32_t maxTriangles = defaultMaxTriangles);
+
+		// meshlets of the full detail level, the levels of detail are kept as is
+		Mesh build(const Mesh& mesh, uint32_t maxVertices = defaultMaxVertices, uint32_t maxTriangles = defaultMaxTriangles);
+
+	}
+
+}
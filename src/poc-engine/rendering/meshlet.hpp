@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+#include "../core/bounds.hpp"
+
+namespace poc {
+
+	// cluster of triangles drawn with one contiguous range of the mesh indices
+	struct Meshlet {
+		uint32_t firstIndex;
+		uint32_t triangleCount;
+		BoundingSphere sphere;
+		// the normals of the triangles are within asin(coneCutoff) of the axis,
+		// coneCutoff is 1 when they face too many directions to be culled together
+		glm::vec3 coneAxis;
+		float coneCutoff;
+	};
+
+	// facingPoint: Camera::getFacingPoint in the space of the meshlet, the whole cluster faces away from it
+	inline bool isBackFacing(const Meshlet& meshlet, const glm::vec4& facingPoint) {
+		if (meshlet.coneCutoff >= 1.0f) {
+			return false;
+		}
+
+		// orthographic projection: a direction
+		if (facingPoint.w == 0.0f) {
+			const glm::vec3 direction = -glm::vec3(facingPoint);
+			return glm::dot(direction, meshlet.coneAxis) > meshlet.coneCutoff * glm::length(direction);
+		}
+
+		// perspective projection: every point of the sphere is seen from behind the cone
+		const glm::vec3 eye = glm::vec3(facingPoint) / facingPoint.w;
+		const glm::vec3 direction = (meshlet.sphere.center - eye) * (facingPoint.w > 0.0f ? 1.0f : -1.0f);
+		return glm::dot(direction, meshlet.coneAxis) - meshlet.sphere.radius > meshlet.coneCutoff * (glm::length(direction) + meshlet.sphere.radius);
+	}
+
+}
@@ -9,22 +9,56 @@ namespace poc {
 	class RenderingSystemImpl : public RenderingSystem {
 	public:
 
-		RenderingSystemImpl(const Window& window, GraphicApi::Type type) :
-			graphicApi(GraphicApi::make(window, type)) {
+		RenderingSystemImpl(const Window& window, GraphicApi::Type type, JobSystem& j) :
+			graphicApi(GraphicApi::make(window, type)),
+			jobs(j) {
 		}
 
 		void render(const Window& window, const Scene& scene) override {
-			(*graphicApi).render(window, scene);
+			if (!graphicApi->isGpuDriven()) {
+				// refitted while the entities are the same, the subtrees outside of the frustum are skipped
+				sceneBvh.update(scene, jobs);
+				drawCollector.collect(scene, sceneBvh, jobs, window.getDrawableSurfaceSize().height);
+				(*graphicApi).render(window, scene, drawCollector);
+				return;
+			}
+
+			drawCollector.collectInstances(scene, window.getDrawableSurfaceSize().height);
+			(*graphicApi).render(window, scene, drawCollector);
+
+			// the instances are still culled on the CPU
+			const FrameStats& instanceStats = drawCollector.getFrameStats();
+			gpuFrameStats = graphicApi->getGpuFrameStats();
+			gpuFrameStats.triangleCount = instanceStats.triangleCount;
+			gpuFrameStats.lodTriangleCounts = instanceStats.lodTriangleCounts;
+			gpuFrameStats.instanceCount = instanceStats.instanceCount;
+			gpuFrameStats.culledInstanceCount = instanceStats.culledInstanceCount;
+		}
+
+		const FrameStats& getFrameStats() const override {
+			return graphicApi->isGpuDriven() ? gpuFrameStats : drawCollector.getFrameStats();
+		}
+
+		uint64_t getResidentGeneration(const Scene& scene) const override {
+			return graphicApi->getResidentGeneration(scene);
+		}
+
+		UploadStats getUploadStats() const override {
+			return graphicApi->getUploadStats();
 		}
 
 	private:
 
 		std::unique_ptr<GraphicApi> graphicApi;
+		JobSystem& jobs;
+		SceneBvh sceneBvh;
+		DrawCollector drawCollector;
+		FrameStats gpuFrameStats{};
 
 	};
 
-	std::unique_ptr<RenderingSystem> RenderingSystem::make(const Window& window, GraphicApi::Type type) {
-		return std::make_unique<RenderingSystemImpl>(window, type);
+	std::unique_ptr<RenderingSystem> RenderingSystem::make(const Window& window, GraphicApi::Type type, JobSystem& jobs) {
+		return std::make_unique<RenderingSystemImpl>(window, type, jobs);
 	}
 
 }
\ No newline at end of file
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "../plateform/window.hpp"
+#include "../core/job-system.hpp"
 #include "../core/scene.hpp"
+#include "draw-collector.hpp"
 #include "graphic-api.hpp"
 
 namespace poc {
@@ -12,7 +14,17 @@ namespace poc {
 		virtual void render(const Window& window, const Scene& scene) = 0;
 		virtual ~RenderingSystem() {};
 
-		static std::unique_ptr<RenderingSystem> make(const Window& window, GraphicApi::Type type);
+		// visible & culled objects, triangles per level of detail of the last rendered frame,
+		// only the object counts of a frame some frames back & the instances when the culling is GPU driven
+		virtual const FrameStats& getFrameStats() const = 0;
+
+		// generation of the scene drawn by the last frames, the meshes added up to it finished their upload
+		virtual uint64_t getResidentGeneration(const Scene& scene) const = 0;
+
+		// bytes uploaded to the GPU & time the CPU waited for them
+		virtual UploadStats getUploadStats() const = 0;
+
+		static std::unique_ptr<RenderingSystem> make(const Window& window, GraphicApi::Type type, JobSystem& jobs);
 
 	};
 
@@ -0,0 +1,54 @@
+#include "residency.hpp"
+
+#include <cassert>
+#include <numeric>
+
+using namespace poc;
+
+namespace poc {
+
+	void ResidencyTracker::add(uint64_t key, ResourceCategory category, uint64_t size, uint64_t frame) {
+		assert(!contains(key) && "resource already resident");
+		resources.push_front(Resource{ key, category, size, frame });
+		index.emplace(key, resources.begin());
+		residentSizes[static_cast<size_t>(category)] += size;
+	}
+
+	void ResidencyTracker::touch(uint64_t key, uint64_t frame) {
+		const auto it = index.find(key);
+		assert(it != index.end() && "resource not resident");
+		it->second->lastFrame = frame;
+		resources.splice(resources.begin(), resources, it->second);
+	}
+
+	void ResidencyTracker::remove(uint64_t key) {
+		const auto it = index.find(key);
+		assert(it != index.end() && "resource not resident");
+		residentSizes[static_cast<size_t>(it->second->category)] -= it->second->size;
+		resources.erase(it->second);
+		index.erase(it);
+	}
+
+	bool ResidencyTracker::contains(uint64_t key) const {
+		return index.find(key) != index.end();
+	}
+
+	uint64_t ResidencyTracker::getResidentSize() const {
+		return std::accumulate(residentSizes.begin(), residentSizes.end(), uint64_t(0));
+	}
+
+	std::vector<uint64_t> ResidencyTracker::selectEvictions(uint64_t size, uint64_t lastFrame) const {
+		std::vector<uint64_t> evictions;
+		uint64_t selectedSize = 0;
+		for (auto it = resources.rbegin(); it != resources.rend() && selectedSize < size; ++it) {
+			// the rest was used more recently
+			if (it->lastFrame > lastFrame) {
+				break;
+			}
+			evictions.push_back(it->key);
+			selectedSize += it->size;
+		}
+		return evictions;
+	}
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace poc {
+
+	// what the GPU memory is used for, the usage is reported per category
+	enum class ResourceCategory {
+		GEOMETRY,
+		TEXTURE,
+		RENDER_TARGET,
+		STAGING,
+		FRAME_DATA,
+		OTHER
+	};
+
+	constexpr size_t resourceCategoryCount = 6;
+
+	/*
+	 * Resident resources ordered by their last use, the least recently used are evicted first.
+	 *
+	 * A resource is identified by its key & touched by every frame using it. The evictions are only
+	 * selected: the caller releases the resources once the GPU no longer reads them, streams them again
+	 * when needed & removes them from the tracker.
+	 */
+	class ResidencyTracker {
+	public:
+
+		// the resource is resident & used by the frame
+		void add(uint64_t key, ResourceCategory category, uint64_t size, uint64_t frame);
+		void touch(uint64_t key, uint64_t frame);
+		void remove(uint64_t key);
+
+		bool contains(uint64_t key) const;
+
+		size_t getResidentCount() const {
+			return resources.size();
+		}
+
+		uint64_t getResidentSize() const;
+		uint64_t getResidentSize(ResourceCategory category) const {
+			return residentSizes[static_cast<size_t>(category)];
+		}
+
+		// least recently used first until size bytes are selected, resources used after lastFrame are
+		// kept: less than size may be selected
+		std::vector<uint64_t> selectEvictions(uint64_t size, uint64_t lastFrame) const;
+
+	private:
+		struct Resource {
+			uint64_t key;
+			ResourceCategory category;
+			uint64_t size;
+			uint64_t lastFrame;
+		};
+
+		// most recently used at the front
+		std::list<Resource> resources;
+		std::unordered_map<uint64_t, std::list<Resource>::iterator> index;
+		std::array<uint64_t, resourceCategoryCount> residentSizes{};
+	};
+
+}
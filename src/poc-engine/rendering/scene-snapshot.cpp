@@ -0,0 +1,140 @@
+#include "scene-snapshot.hpp"
+
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "../core/logger.hpp"
+#include "../plateform/mapped-file.hpp"
+#include "mesh-file.hpp"
+
+using namespace poc;
+
+namespace poc {
+
+	static constexpr char logTag[]{ "POC::SceneSnapshot" };
+
+	static_assert(std::is_trivially_copyable_v<Instance>);
+	static_assert(std::is_trivially_copyable_v<InstanceBatch>);
+	static_assert(std::is_trivially_copyable_v<glm::vec3>);
+	static_assert(std::is_trivially_copyable_v<glm::quat>);
+	static_assert(std::is_trivially_copyable_v<SceneSnapshot::EntityRecord>);
+	static_assert(std::is_trivially_copyable_v<SceneSnapshot::CameraRecord>);
+
+	using SectionType = MeshFile::SectionType;
+
+	[[noreturn]] static void fail(const std::string& message) {
+		Logger::error(logTag, message);
+		throw std::runtime_error(message);
+	}
+
+	static void validateInstances(span<const Instance> instances, span<const InstanceBatch> batches, size_t meshCount) {
+		for (size_t i = 0; i < batches.size(); ++i) {
+			if (batches[i].mesh >= meshCount || uint64_t(batches[i].firstInstance) + batches[i].instanceCount > instances.size()) {
+				fail("Instance batch " + std::to_string(i) + " out of the snapshot");
+			}
+		}
+	}
+
+	// the hierarchy is updated without checks: the parents must form levels of the stored depths
+	static void validateTransforms(const TransformHierarchyData& data) {
+		const size_t count = data.parents.size();
+		if (data.depths.size() != count || data.localPositions.size() != count || data.localRotations.size() != count
+			|| data.localScales.size() != count || data.ids.size() != count) {
+			fail("Transform sections of different sizes");
+		}
+
+		std::vector<uint8_t> used(count, 0);
+		for (size_t i = 0; i < count; ++i) {
+			const uint32_t parent = data.parents[i];
+			const bool valid = data.depths[i] < count && (parent == TransformHierarchy::noParent
+				? data.depths[i] == 0
+				: parent < count && data.depths[i] == data.depths[parent] + 1);
+			if (!valid || data.ids[i] >= count || used[data.ids[i]]) {
+				fail("Transform node " + std::to_string(i) + " is not consistent");
+			}
+			used[data.ids[i]] = 1;
+		}
+	}
+
+	void SceneSnapshot::write(const std::string& path, const Scene& scene) {
+		std::vector<EntityRecord> entities;
+		entities.reserve(scene.getWorld().getEntityCount());
+		scene.getWorld().forEach<const MeshComponent, const TransformComponent>([&](Entity, const MeshComponent& mesh, const TransformComponent& transform) {
+			entities.push_back(EntityRecord{ mesh.mesh, transform.node.id });
+		});
+		const CameraRecord camera{ scene.getCamera().getView(), scene.getCamera().getProjection() };
+
+		const SceneGeometry geometry = scene.getGeometry();
+		const TransformHierarchyData transforms = scene.getTransforms().getData();
+		std::vector<MeshFile::SectionData> sections;
+		for (const MeshFile::SectionData& section : MeshFile::getGeometrySections(geometry)) {
+			sections.push_back(section);
+		}
+		sections.push_back(MeshFile::makeSection(SectionType::INSTANCES, scene.getInstances()));
+		sections.push_back(MeshFile::makeSection(SectionType::INSTANCE_BATCHES, scene.getInstanceBatches()));
+		sections.push_back(MeshFile::makeSection(SectionType::TRANSFORM_PARENTS, transforms.parents));
+		sections.push_back(MeshFile::makeSection(SectionType::TRANSFORM_DEPTHS, transforms.depths));
+		sections.push_back(MeshFile::makeSection(SectionType::TRANSFORM_POSITIONS, transforms.localPositions));
+		sections.push_back(MeshFile::makeSection(SectionType::TRANSFORM_ROTATIONS, transforms.localRotations));
+		sections.push_back(MeshFile::makeSection(SectionType::TRANSFORM_SCALES, transforms.localScales));
+		sections.push_back(MeshFile::makeSection(SectionType::TRANSFORM_IDS, transforms.ids));
+		sections.push_back(MeshFile::makeSection(SectionType::ENTITIES, span<const EntityRecord>(entities)));
+		sections.push_back(MeshFile::makeSection(SectionType::CAMERA, span<const CameraRecord>(&camera, 1)));
+
+		const uint64_t size = MeshFile::writeSections(path, magic, version, sections);
+		Logger::info(logTag, "Written " + path + ", " + std::to_string(geometry.meshes.size()) + " meshes, "
+			+ std::to_string(entities.size()) + " entities, " + std::to_string(size) + " bytes");
+	}
+
+	void SceneSnapshot::load(const std::string& path, Scene& scene) {
+		if (!scene.getMeshes().empty() || !scene.getInstanceBatches().empty() || scene.getWorld().getEntityCount() != 0 || scene.getTransforms().getNodeCount() != 0) {
+			fail(path + " loaded into a scene that is not empty");
+		}
+
+		std::shared_ptr<const MappedFile> file = std::make_shared<const MappedFile>(path);
+		const span<const std::byte> content = file->getContent();
+		const span<const MeshFile::Section> sections = MeshFile::readSections(path, content, magic, version);
+
+		// everything is validated before the scene is modified
+		const SceneGeometry geometry = MeshFile::readGeometry(content, sections);
+		const span<const Instance> instances = MeshFile::getSection<Instance>(content, sections, SectionType::INSTANCES);
+		const span<const InstanceBatch> batches = MeshFile::getSection<InstanceBatch>(content, sections, SectionType::INSTANCE_BATCHES);
+		validateInstances(instances, batches, geometry.meshes.size());
+
+		const TransformHierarchyData transforms{
+			MeshFile::getSection<uint32_t>(content, sections, SectionType::TRANSFORM_PARENTS),
+			MeshFile::getSection<uint32_t>(content, sections, SectionType::TRANSFORM_DEPTHS),
+			MeshFile::getSection<glm::vec3>(content, sections, SectionType::TRANSFORM_POSITIONS),
+			MeshFile::getSection<glm::quat>(content, sections, SectionType::TRANSFORM_ROTATIONS),
+			MeshFile::getSection<glm::vec3>(content, sections, SectionType::TRANSFORM_SCALES),
+			MeshFile::getSection<uint32_t>(content, sections, SectionType::TRANSFORM_IDS)
+		};
+		validateTransforms(transforms);
+
+		const span<const EntityRecord> entities = MeshFile::getSection<EntityRecord>(content, sections, SectionType::ENTITIES);
+		for (size_t i = 0; i < entities.size(); ++i) {
+			if (entities[i].mesh >= geometry.meshes.size() || entities[i].node >= transforms.parents.size()) {
+				fail("Entity " + std::to_string(i) + " out of the snapshot");
+			}
+		}
+
+		const span<const CameraRecord> camera = MeshFile::getSection<CameraRecord>(content, sections, SectionType::CAMERA);
+		if (camera.size() != 1) {
+			fail(path + " has no camera");
+		}
+
+		scene.setGeometry(geometry, std::move(file));
+		scene.setInstances(instances, batches);
+		scene.getTransforms().setData(transforms);
+		for (const EntityRecord& entity : entities) {
+			scene.createEntity(entity.mesh, TransformNode{ entity.node });
+		}
+		scene.getCamera().setView(camera[0].view);
+		scene.getCamera().setProjection(camera[0].projection);
+
+		Logger::info(logTag, "Mapped " + path + ", " + std::to_string(geometry.meshes.size()) + " meshes, "
+			+ std::to_string(entities.size()) + " entities, " + std::to_string(content.size()) + " bytes");
+	}
+
+}
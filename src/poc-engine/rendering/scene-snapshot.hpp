@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "../core/scene.hpp"
+
+namespace poc {
+
+	/*
+	 * Binary snapshot of a whole scene, the .pocscene files.
+	 *
+	 * The same container as the mesh files: a header, a table of sections at offsets from the start of
+	 * the file and the sections, 64 bytes aligned, holding the records with the layout of the engine.
+	 * Besides the geometry arenas a snapshot holds the instances, the storage arrays of the transform
+	 * hierarchy, the entities drawing a mesh and the camera. Loading maps the file: the arenas view it
+	 * like a mesh file, the other sections are copied in bulk, only the entities are created one by one.
+	 *
+	 * The entities are saved with their mesh & transform components only: the other components of the
+	 * world are not part of the snapshot. A snapshot of another version is refused, not converted.
+	 */
+	namespace SceneSnapshot {
+
+		inline constexpr std::array<char, 8> magic{ 'P', 'O', 'C', 'S', 'C', 'E', 'N', 'E' };
+		inline constexpr uint32_t version = 1;
+
+		// entity drawing a mesh of the scene
+		struct EntityRecord {
+			uint32_t mesh;
+			uint32_t node;
+		};
+
+		struct CameraRecord {
+			glm::mat4 view;
+			glm::mat4 projection;
+		};
+
+		void write(const std::string& path, const Scene& scene);
+
+		// the scene must be empty, it keeps the file mapped while its arenas view it
+		// throws when the scene is not empty, the file cannot be read, is not a snapshot of this version or references out of its sections
+		void load(const std::string& path, Scene& scene);
+
+	}
+
+}
@@ -0,0 +1,180 @@
+#include "static-batcher.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+#include "../core/logger.hpp"
+#include "meshlet-builder.hpp"
+
+using namespace poc;
+
+namespace poc {
+
+	static constexpr char logTag[]{ "POC::StaticBatcher" };
+
+	// spreads the 10 low bits of the value every 3 bits
+	static uint32_t expandBits(uint32_t value) {
+		value = (value * 0x00010001u) & 0xFF0000FFu;
+		value = (value * 0x00000101u) & 0x0F00F00Fu;
+		value = (value * 0x00000011u) & 0xC30C30C3u;
+		value = (value * 0x00000005u) & 0x49249249u;
+		return value;
+	}
+
+	// position normalized in the unit cube
+	static uint32_t getMortonCode(const glm::vec3& position) {
+		const glm::vec3 cell = glm::clamp(position * 1024.0f, glm::vec3(0.0f), glm::vec3(1023.0f));
+		return expandBits(static_cast<uint32_t>(cell.x)) * 4
+			+ expandBits(static_cast<uint32_t>(cell.y)) * 2
+			+ expandBits(static_cast<uint32_t>(cell.z));
+	}
+
+	StaticBatchReport StaticBatcher::build(Scene& scene) {
+		StaticBatchReport report{ static_cast<uint32_t>(placements.size()), {} };
+
+		if (!settings.enabled) {
+			std::vector<uint32_t> sceneMeshes;
+			sceneMeshes.reserve(meshes.size());
+			for (Mesh& mesh : meshes) {
+				sceneMeshes.push_back(scene.addMesh(std::move(mesh)));
+			}
+
+			for (const Placement& placement : placements) {
+				const uint32_t mesh = sceneMeshes[placement.mesh];
+				const Entity entity = scene.createEntity(mesh);
+				const TransformNode node = scene.getWorld().get<TransformComponent>(entity).node;
+				scene.getTransforms().setLocalPosition(node, placement.position);
+				scene.getTransforms().setLocalRotation(node, placement.rotation);
+				scene.getTransforms().setLocalScale(node, placement.scale);
+
+				const MeshRange& range = scene.getMeshes()[mesh];
+				const BoundingSphere bounds = transformSphere(range.bounds.sphere, composeTransform(placement.position, placement.rotation, placement.scale));
+				report.batches.push_back(StaticBatch{ mesh, entity, range.format, 1, range.vertexCount, range.indexCount / 3, bounds });
+			}
+		}
+		else {
+			// world centers, normalized in the box of all the placements for the Morton codes
+			std::vector<glm::vec3> centers(placements.size());
+			Aabb sceneBox;
+			for (size_t i = 0; i < placements.size(); ++i) {
+				const Placement& placement = placements[i];
+				const glm::mat4 transform = composeTransform(placement.position, placement.rotation, placement.scale);
+				centers[i] = transformAabb(meshes[placement.mesh].getAabb(), transform).getCenter();
+				sceneBox.expand(centers[i]);
+			}
+			const glm::vec3 sceneSize = glm::max(sceneBox.max - sceneBox.min, glm::vec3(std::numeric_limits<float>::epsilon()));
+
+			// by format first: a batch is drawn with a single pipeline
+			std::vector<std::pair<uint64_t, uint32_t>> keys(placements.size());
+			for (uint32_t i = 0; i < placements.size(); ++i) {
+				const uint64_t format = static_cast<uint64_t>(meshes[placements[i].mesh].getVertexFormat());
+				keys[i] = { (format << 32) | getMortonCode((centers[i] - sceneBox.min) / sceneSize), i };
+			}
+			std::sort(keys.begin(), keys.end());
+
+			std::vector<Placement> sorted;
+			sorted.reserve(placements.size());
+			for (const auto& key : keys) {
+				sorted.push_back(placements[key.second]);
+			}
+
+			// greedy fill along the curve, a placement over the limits gets its own batch
+			size_t first = 0;
+			uint32_t vertexCount = 0;
+			Aabb box;
+			for (size_t i = 0; i < sorted.size(); ++i) {
+				const Mesh& mesh = meshes[sorted[i].mesh];
+				const Aabb placementBox = transformAabb(mesh.getAabb(), composeTransform(sorted[i].position, sorted[i].rotation, sorted[i].scale));
+				Aabb merged = box;
+				merged.expand(placementBox);
+
+				const bool sameFormat = i == first || meshes[sorted[first].mesh].getVertexFormat() == mesh.getVertexFormat();
+				const bool fits = vertexCount + mesh.getVertices().size() <= settings.maxVertices
+					&& glm::all(glm::lessThanEqual(merged.max - merged.min, glm::vec3(settings.maxExtent)));
+				if (i > first && (!sameFormat || !fits)) {
+					addBatch(scene, span<const Placement>(sorted).subspan(first, i - first), report);
+					first = i;
+					vertexCount = 0;
+					merged = placementBox;
+				}
+
+				vertexCount += static_cast<uint32_t>(mesh.getVertices().size());
+				box = merged;
+			}
+			if (first < sorted.size()) {
+				addBatch(scene, span<const Placement>(sorted).subspan(first, sorted.size() - first), report);
+			}
+		}
+
+		if (!report.batches.empty()) {
+			uint32_t minVertices = std::numeric_limits<uint32_t>::max();
+			uint32_t maxVertices = 0;
+			uint64_t vertices = 0;
+			for (const StaticBatch& batch : report.batches) {
+				minVertices = std::min(minVertices, batch.vertexCount);
+				maxVertices = std::max(maxVertices, batch.vertexCount);
+				vertices += batch.vertexCount;
+			}
+
+			std::ostringstream os;
+			os << "Placements " << report.placementCount << " -> " << report.batches.size() << " batches, vertices per batch "
+				<< minVertices << " / " << vertices / report.batches.size() << " / " << maxVertices << " (min / average / max)";
+			Logger::info(logTag, os.str());
+		}
+
+		meshes.clear();
+		placements.clear();
+		return report;
+	}
+
+	void StaticBatcher::addBatch(Scene& scene, span<const Placement> batchPlacements, StaticBatchReport& report) const {
+		const VertexFormat format = meshes[batchPlacements[0].mesh].getVertexFormat();
+
+		size_t vertexCount = 0;
+		size_t indexCount = 0;
+		for (const Placement& placement : batchPlacements) {
+			vertexCount += meshes[placement.mesh].getVertices().size();
+			indexCount += meshes[placement.mesh].getIndices().size();
+		}
+
+		std::vector<Vertex> vertices;
+		std::vector<uint32_t> indices;
+		vertices.reserve(vertexCount);
+		indices.reserve(indexCount);
+		for (const Placement& placement : batchPlacements) {
+			const Mesh& mesh = meshes[placement.mesh];
+			const glm::mat4 transform = composeTransform(placement.position, placement.rotation, placement.scale);
+			const uint32_t offset = static_cast<uint32_t>(vertices.size());
+			for (const Vertex& vertex : mesh.getVertices()) {
+				vertices.push_back(Vertex{ glm::vec3(transform * glm::vec4(vertex.position, 1.0f)), vertex.color });
+			}
+
+			// a mirrored placement turns the front faces to the back
+			const span<const uint32_t> meshIndices = mesh.getIndices();
+			const bool mirrored = glm::determinant(transform) < 0.0f;
+			for (size_t i = 0; i + 2 < meshIndices.size(); i += 3) {
+				indices.push_back(offset + meshIndices[i]);
+				indices.push_back(offset + meshIndices[mirrored ? i + 2 : i + 1]);
+				indices.push_back(offset + meshIndices[mirrored ? i + 1 : i + 2]);
+			}
+		}
+
+		Mesh merged(std::move(vertices), std::move(indices), format);
+		if (settings.buildMeshlets) {
+			merged = MeshletBuilder::build(merged);
+		}
+
+		const uint32_t mesh = scene.addMesh(std::move(merged));
+		const MeshRange& range = scene.getMeshes()[mesh];
+		report.batches.push_back(StaticBatch{
+			mesh,
+			scene.createEntity(mesh),
+			format,
+			static_cast<uint32_t>(batchPlacements.size()),
+			range.vertexCount,
+			range.indexCount / 3,
+			range.bounds.sphere });
+	}
+
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "../core/scene.hpp"
+#include "mesh.hpp"
+
+namespace poc {
+
+	struct StaticBatchSettings {
+		// false to create one entity per placement, e.g. to compare with the batched scene
+		bool enabled{ true };
+		// vertices of a batch, 65536 keeps the scene indices in 16 bits
+		uint32_t maxVertices{ 65536 };
+		// largest side of the box of a batch, a large batch is rarely outside of the frustum
+		float maxExtent{ 64.0f };
+		// meshlets of the merged geometry, culled one by one inside the visible batches
+		bool buildMeshlets{ true };
+	};
+
+	// merged placements drawn by a single entity
+	struct StaticBatch {
+		uint32_t mesh;
+		Entity entity;
+		VertexFormat format;
+		uint32_t placementCount;
+		uint32_t vertexCount;
+		uint32_t triangleCount;
+		BoundingSphere bounds;
+	};
+
+	struct StaticBatchReport {
+		// draws before the batching
+		uint32_t placementCount;
+		std::vector<StaticBatch> batches;
+	};
+
+	/*
+	 * Scene build step merging static meshes into combined meshes.
+	 *
+	 * The meshes are placed with transforms that never change. On build, the placements are grouped by
+	 * vertex format, i.e. by pipeline, and sorted along a Morton curve of their world centers so that
+	 * each batch, filled greedily up to its vertex & extent limits, covers a compact region. The vertices
+	 * of a batch are transformed to world space and its indices offset, the winding of the mirrored
+	 * placements is flipped. Each batch is added to the scene as one mesh & one entity: its bounds are
+	 * culled as any entity and a whole region of props is drawn with a single draw.
+	 *
+	 * The levels of detail of the placed meshes are not merged, the batches are drawn at full detail.
+	 */
+	class StaticBatcher {
+	public:
+
+		explicit StaticBatcher(const StaticBatchSettings& settings = {}) :
+			settings(settings) {}
+
+		// geometry shared by the placements, returns its index for place()
+		uint32_t addMesh(Mesh&& mesh) {
+			meshes.push_back(std::move(mesh));
+			return static_cast<uint32_t>(meshes.size() - 1);
+		}
+
+		void place(uint32_t mesh, const glm::vec3& position, const glm::quat& rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f), const glm::vec3& scale = glm::vec3(1.0f)) {
+			assert(mesh < meshes.size() && "unknown mesh");
+			placements.push_back(Placement{ mesh, position, rotation, scale });
+		}
+
+		// adds the batches to the scene, the meshes & placements are cleared
+		StaticBatchReport build(Scene& scene);
+
+	private:
+
+		struct Placement {
+			uint32_t mesh;
+			glm::vec3 position;
+			glm::quat rotation;
+			glm::vec3 scale;
+		};
+
+		void addBatch(Scene& scene, span<const Placement> batchPlacements, StaticBatchReport& report) const;
+
+		StaticBatchSettings settings;
+		std::vector<Mesh> meshes;
+		std::vector<Placement> placements;
+	};
+
+}
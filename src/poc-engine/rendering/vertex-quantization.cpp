@@ -0,0 +1,102 @@
+#include "vertex-quantization.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#include "glm/gtc/packing.hpp"
+
+using namespace poc;
+
+namespace poc {
+
+	namespace VertexQuantization {
+
+		static std::array<uint8_t, 4> packColor(const glm::vec3& color) {
+			return {
+				glm::packUnorm1x8(color.r),
+				glm::packUnorm1x8(color.g),
+				glm::packUnorm1x8(color.b),
+				glm::packUnorm1x8(1.0f)
+			};
+		}
+
+		static glm::vec3 unpackColor(const std::array<uint8_t, 4>& color) {
+			return glm::vec3(glm::unpackUnorm1x8(color[0]), glm::unpackUnorm1x8(color[1]), glm::unpackUnorm1x8(color[2]));
+		}
+
+		static Dequantization computeBounds(span<const Vertex> vertices) {
+			glm::vec3 min(std::numeric_limits<float>::max());
+			glm::vec3 max(std::numeric_limits<float>::lowest());
+			for (const Vertex& vertex : vertices) {
+				min = glm::min(min, vertex.position);
+				max = glm::max(max, vertex.position);
+			}
+
+			// flat axis: any non null scale works, keep 1 to avoid a division by zero
+			const glm::vec3 extent = (max - min) * 0.5f;
+			const glm::vec3 scale = glm::mix(extent, glm::vec3(1.0f), glm::equal(extent, glm::vec3(0.0f)));
+
+			Dequantization dequantization{};
+			dequantization.scale = glm::vec4(scale, 0.0f);
+			dequantization.offset = glm::vec4((min + max) * 0.5f, 0.0f);
+			return dequantization;
+		}
+
+		Dequantization quantize(span<const Vertex> vertices, VertexFormat format, std::vector<PackedVertex>& output) {
+			assert(format != VertexFormat::FLOAT32 && "FLOAT32 vertices are not packed");
+
+			output.reserve(output.size() + vertices.size());
+
+			if (format == VertexFormat::HALF_POSITION) {
+				for (const Vertex& vertex : vertices) {
+					output.push_back(PackedVertex{
+						{ glm::packHalf1x16(vertex.position.x), glm::packHalf1x16(vertex.position.y), glm::packHalf1x16(vertex.position.z), 0 },
+						packColor(vertex.color)
+						});
+				}
+				return Dequantization{};
+			}
+
+			const Dequantization dequantization = computeBounds(vertices);
+			const glm::vec3 scale(dequantization.scale);
+			const glm::vec3 offset(dequantization.offset);
+
+			for (const Vertex& vertex : vertices) {
+				const glm::vec3 normalized = (vertex.position - offset) / scale;
+				output.push_back(PackedVertex{
+					{ glm::packSnorm1x16(normalized.x), glm::packSnorm1x16(normalized.y), glm::packSnorm1x16(normalized.z), 0 },
+					packColor(vertex.color)
+					});
+			}
+			return dequantization;
+		}
+
+		Vertex dequantize(const PackedVertex& vertex, VertexFormat format, const Dequantization& dequantization) {
+			assert(format != VertexFormat::FLOAT32 && "FLOAT32 vertices are not packed");
+
+			glm::vec3 position{};
+			for (glm::length_t i = 0; i < 3; ++i) {
+				position[i] = format == VertexFormat::HALF_POSITION
+					? glm::unpackHalf1x16(vertex.position[i])
+					: glm::unpackSnorm1x16(vertex.position[i]);
+			}
+
+			return Vertex{
+				position * glm::vec3(dequantization.scale) + glm::vec3(dequantization.offset),
+				unpackColor(vertex.color)
+			};
+		}
+
+		Instance packInstance(const glm::mat4& transform, const glm::vec3& color) {
+			const glm::mat4 rows = glm::transpose(transform);
+			return Instance{ { rows[0], rows[1], rows[2] }, packColor(color) };
+		}
+
+		glm::mat4 unpackInstanceTransform(const Instance& instance) {
+			return glm::transpose(glm::mat4(instance.transform[0], instance.transform[1], instance.transform[2], glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)));
+		}
+
+	}
+
+}
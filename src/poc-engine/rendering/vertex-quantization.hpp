@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vector>
+
+#include "../core/span.hpp"
+#include "vertex.hpp"
+
+namespace poc {
+
+	namespace VertexQuantization {
+
+		// append the packed vertices to the output and return how to restore the positions
+		Dequantization quantize(span<const Vertex> vertices, VertexFormat format, std::vector<PackedVertex>& output);
+
+		// inverse conversion, mostly useful to measure the precision loss
+		Vertex dequantize(const PackedVertex& vertex, VertexFormat format, const Dequantization& dequantization);
+
+		// the transform must be affine, its last row is dropped
+		Instance packInstance(const glm::mat4& transform, const glm::vec3& color);
+
+		glm::mat4 unpackInstanceTransform(const Instance& instance);
+
+	}
+
+}
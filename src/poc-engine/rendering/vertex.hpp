@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+
 #include "../plateform/platform.hpp"
 
 namespace poc {
@@ -9,4 +12,40 @@ namespace poc {
 		glm::vec3 color;
 	};
 
+	// GPU storage of the vertices of a mesh, the conversion from Vertex is done when the mesh is added to the scene
+	enum class VertexFormat : uint8_t {
+		FLOAT32 = 0,		// Vertex as is (24 bytes)
+		HALF_POSITION,		// PackedVertex: half float position, RGBA8 color (12 bytes)
+		SNORM16_POSITION	// PackedVertex: snorm16 position relative to the mesh bounds, RGBA8 color (12 bytes)
+	};
+
+	inline constexpr std::array<VertexFormat, 3> vertexFormats{
+		VertexFormat::FLOAT32,
+		VertexFormat::HALF_POSITION,
+		VertexFormat::SNORM16_POSITION
+	};
+
+	// the 4th position component is unused, it keeps the color 4 bytes aligned
+	struct PackedVertex {
+		std::array<uint16_t, 4> position;
+		std::array<uint8_t, 4> color;
+	};
+
+	// position = quantized position * scale + offset, std140 compatible for the vertex shader push constants
+	struct Dequantization {
+		glm::vec4 scale{ 1.0f, 1.0f, 1.0f, 0.0f };
+		glm::vec4 offset{ 0.0f, 0.0f, 0.0f, 0.0f };
+	};
+
+	// per instance vertex data of an instanced mesh: rows of the affine world transform & RGBA8 color
+	// multiplying the vertex colors, read with an instance input rate (52 bytes)
+	struct Instance {
+		std::array<glm::vec4, 3> transform;
+		std::array<uint8_t, 4> color;
+	};
+
+	static_assert(sizeof(Vertex) == 24, "Vertex must be tightly packed");
+	static_assert(sizeof(PackedVertex) == 12, "PackedVertex must be tightly packed");
+	static_assert(sizeof(Instance) == 52, "Instance must be tightly packed");
+
 }
@@ -23,105 +23,90 @@ namespace poc {
 		);
 	}
 
-	static vk::UniqueDeviceMemory allocateDeviceMemory(
-		const VulkanPhysicalDevice& physicalDevice,
-		const vk::Device& device,
-		const vk::Buffer& buffer,
-		const vk::MemoryPropertyFlags& memoryPropertyFlags) {
-
-		assert(physicalDevice.getPhysicalDevice() && "physicalDevice not initialized");
-		assert(device && "device not initialized");
-		assert(buffer && "buffer not initialized");
-
-		vk::MemoryRequirements requirements = device.getBufferMemoryRequirements(buffer);
-		uint32_t memoryTypeIndex = physicalDevice.findMemoryTypeIndex(requirements.memoryTypeBits, memoryPropertyFlags);
-
-		auto allocateInfo = vk::MemoryAllocateInfo()
-			.setAllocationSize(requirements.size)
-			.setMemoryTypeIndex(memoryTypeIndex);
-		return device.allocateMemoryUnique(allocateInfo);
-	}
-
-
-
 	class VulkanBuffer::Impl {
 	public:
 
-		Impl(const VulkanPhysicalDevice& physicalDevice,
-			const VulkanDevice& device,
+		Impl(const VulkanDevice& device,
 			const vk::DeviceSize& size,
 			const vk::BufferUsageFlags& usage,
 			const vk::MemoryPropertyFlags& memoryProperty,
-			const void* data) :
+			const void* data,
+			ResourceCategory category) :
 			buffer(createBuffer(device.getDevice(), size, usage)),
-			memory(allocateDeviceMemory(physicalDevice, device.getDevice(), *buffer, memoryProperty)) {
-
-			device.getDevice().bindBufferMemory(*buffer, *memory, 0);
+			memory(device.getMemoryAllocator().allocateBuffer(*buffer, memoryProperty, category)) {
 
 			if (data) {
-				copyToBuffer(device.getDevice(), size, data);
+				copyToBuffer(size, data);
 			}
 
 		}
 
 	private:
 
-		void copyToBuffer(const vk::Device& device, const vk::DeviceSize& size, const void* src) {
-			void* dst = device.mapMemory(*memory, 0, size);
-			memcpy(dst, src, static_cast<size_t>(size));
-			device.unmapMemory(*memory);
+		// host visible memory stays mapped
+		void copyToBuffer(const vk::DeviceSize& size, const void* src) const {
+			assert(memory.getMappedData() && "memory not host visible");
+			memcpy(memory.getMappedData(), src, static_cast<size_t>(size));
+		}
+
+		void copyFromBuffer(const vk::DeviceSize& size, void* dst) const {
+			assert(memory.getMappedData() && "memory not host visible");
+			memcpy(dst, memory.getMappedData(), static_cast<size_t>(size));
 		}
 
 		vk::UniqueBuffer buffer;
-		vk::UniqueDeviceMemory memory;
+		VulkanAllocation memory;
 
 		friend VulkanBuffer;
 	};
 
 	VulkanBuffer::VulkanBuffer(
-		const VulkanPhysicalDevice& physicalDevice,
 		const VulkanDevice& device,
 		const vk::DeviceSize& size,
 		const vk::BufferUsageFlags& usage,
 		const vk::MemoryPropertyFlags& memoryProperty,
-		const void* data) :
-		pimpl(make_unique_pimpl<VulkanBuffer::Impl>(physicalDevice, device, size, usage, memoryProperty, data)) { }
+		const void* data,
+		ResourceCategory category) :
+		pimpl(make_unique_pimpl<VulkanBuffer::Impl>(device, size, usage, memoryProperty, data, category)) { }
 
 	const vk::Buffer& VulkanBuffer::getBuffer() const {
 		return *pimpl->buffer;
 	}
 
+	vk::DeviceSize VulkanBuffer::getSize() const {
+		return pimpl->memory.getSize();
+	}
+
+	void VulkanBuffer::write(const void* data, const vk::DeviceSize& size) const {
+		pimpl->copyToBuffer(size, data);
+	}
+
+	void VulkanBuffer::read(void* data, const vk::DeviceSize& size) const {
+		pimpl->copyFromBuffer(size, data);
+	}
+
+	std::byte* VulkanBuffer::getMappedData() const {
+		return pimpl->memory.getMappedData();
+	}
+
 	VulkanBuffer VulkanBuffer::createDeviceLocalBuffer(
-		const VulkanPhysicalDevice& physicalDevice,
 		const VulkanDevice& device,
-		const VulkanCommandPool& commandPool,
+		VulkanStagingRing& stagingRing,
 		const vk::DeviceSize& size,
 		const vk::BufferUsageFlags& usage,
-		const void* data) {
-
-		VulkanBuffer stagingBuffer{
-			physicalDevice,
-			device,
-			size,
-			vk::BufferUsageFlagBits::eTransferSrc,
-			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-			data
-		};
+		const void* data,
+		ResourceCategory category) {
 
 		VulkanBuffer localBuffer{
-			physicalDevice,
 			device,
 			size,
 			vk::BufferUsageFlagBits::eTransferDst | usage,
 			vk::MemoryPropertyFlagBits::eDeviceLocal,
-			nullptr
+			nullptr,
+			category
 		};
 
-		vk::UniqueCommandBuffer commandBuffer{ commandPool.beginCommandBuffer(device) };
-		auto bufferCopy = vk::BufferCopy().setSrcOffset(0).setDstOffset(0).setSize(size);
-		commandBuffer->copyBuffer(stagingBuffer.getBuffer(), localBuffer.getBuffer(), 1, &bufferCopy);
-		commandPool.endCommandBuffer(device, *commandBuffer);
-
+		stagingRing.upload(localBuffer.getBuffer(), 0, data, size);
 		return localBuffer;
 
 	}
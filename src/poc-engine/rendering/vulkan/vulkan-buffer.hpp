@@ -3,32 +3,43 @@
 #include "../../core/pimpl_ptr.hpp"
 #include "../../plateform/platform.hpp"
 
-#include "vulkan-command-pool.hpp"
 #include "vulkan-device.hpp"
-#include "vulkan-physical-device.hpp"
+#include "vulkan-staging-ring.hpp"
 
 namespace poc {
 
 	class VulkanBuffer {
 	public:
 
+		// the memory is sub-allocated by the memory allocator of the device
 		explicit VulkanBuffer(
-			const VulkanPhysicalDevice& physicalDevice,
 			const VulkanDevice& device,
 			const vk::DeviceSize& size,
 			const vk::BufferUsageFlags& usage,
 			const vk::MemoryPropertyFlags& memoryProperty,
-			const void* data);
+			const void* data,
+			ResourceCategory category = ResourceCategory::OTHER);
 
 		const vk::Buffer& getBuffer() const;
 
+		// bytes of its memory, alignment padding excluded
+		vk::DeviceSize getSize() const;
+
+		// the memory must be host visible & coherent
+		void write(const void* data, const vk::DeviceSize& size) const;
+		void read(void* data, const vk::DeviceSize& size) const;
+
+		// persistent mapping of host visible memory, nullptr otherwise
+		std::byte* getMappedData() const;
+
+		// the data is uploaded through the staging ring, usable by the commands submitted after its batch
 		static VulkanBuffer createDeviceLocalBuffer(
-			const VulkanPhysicalDevice& physicalDevice,
 			const VulkanDevice& device,
-			const VulkanCommandPool& commandPool,
+			VulkanStagingRing& stagingRing,
 			const vk::DeviceSize& size,
 			const vk::BufferUsageFlags& usage,
-			const void* data);
+			const void* data,
+			ResourceCategory category = ResourceCategory::OTHER);
 
 	private:
 		class Impl;
@@ -67,8 +67,10 @@ namespace poc {
 				.setCommandBufferCount(1)
 				.setPCommandBuffers(&commandBuffer);
 
-			device.getGraphicsQueue().submit(1, &submitInfo, vk::Fence{});
-			device.getGraphicsQueue().waitIdle();
+			// only this submission is waited for, not the whole queue
+			const vk::UniqueFence fence = device.getDevice().createFenceUnique(vk::FenceCreateInfo());
+			device.getGraphicsQueue().submit(1, &submitInfo, *fence);
+			device.getDevice().waitForFences(1, &*fence, VK_TRUE, UINT64_MAX);
 		}
 
 	private:
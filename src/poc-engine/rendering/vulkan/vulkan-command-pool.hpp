@@ -14,6 +14,7 @@ namespace poc {
 		std::vector<vk::UniqueCommandBuffer> createCommandBuffers(const VulkanDevice& device, const uint32_t count) const;
 
 		vk::UniqueCommandBuffer beginCommandBuffer(const VulkanDevice& device) const;
+		// submits the commands & waits for their completion
 		void endCommandBuffer(const VulkanDevice& device, const vk::CommandBuffer& commandBuffer) const;
 
 	private:
@@ -16,6 +16,8 @@ namespace poc {
 	{
 		std::optional<uint32_t> graphicsQueueIndex;
 		std::optional<uint32_t> presentationQueueIndex;
+		// transfer only family, the copies run alongside the graphics work
+		std::optional<uint32_t> transferQueueIndex;
 
 		bool isComplete() const {
 			return graphicsQueueIndex.has_value() && presentationQueueIndex.has_value();
@@ -52,15 +54,50 @@ namespace poc {
 
 		}
 
+		// the DMA engines are exposed as families with the transfer capability only
+		for (uint32_t i = 0; i < queueFamilies.size(); ++i) {
+			const vk::QueueFlags flags = queueFamilies[i].queueFlags;
+			if ((flags & vk::QueueFlagBits::eTransfer) && !(flags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute))) {
+				config.transferQueueIndex = i;
+				break;
+			}
+		}
+
 		assert(config.isComplete() && "physical is not compatible");
 		return config;
 
 	}
 
-	static vk::UniqueDevice createDevice(const QueueConfig& config, const vk::PhysicalDevice& physicalDevice) {
+	// optional features of the GPU driven rendering & memory budget, enabled when available
+	struct DeviceFeatures {
+		bool multiDrawIndirect;
+		bool drawIndirectFirstInstance;
+		bool drawIndirectCount;
+		bool memoryBudget;
+	};
+
+	static DeviceFeatures getDeviceFeatures(const VulkanPhysicalDevice& vulkanPhysicalDevice) {
+		const vk::PhysicalDevice& physicalDevice = vulkanPhysicalDevice.getPhysicalDevice();
+		assert(physicalDevice && "physicalDevice not initialized");
+
+		const vk::PhysicalDeviceFeatures features = physicalDevice.getFeatures();
+		DeviceFeatures deviceFeatures{ features.multiDrawIndirect == VK_TRUE, features.drawIndirectFirstInstance == VK_TRUE, false, vulkanPhysicalDevice.supportsMemoryBudget() };
+
+		// draw indirect count is core since Vulkan 1.2
+		if (physicalDevice.getProperties().apiVersion >= VK_API_VERSION_1_2) {
+			const auto chain = physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+			deviceFeatures.drawIndirectCount = chain.get<vk::PhysicalDeviceVulkan12Features>().drawIndirectCount == VK_TRUE;
+		}
+		return deviceFeatures;
+	}
+
+	static vk::UniqueDevice createDevice(const QueueConfig& config, const vk::PhysicalDevice& physicalDevice, const DeviceFeatures& deviceFeatures) {
 		assert(physicalDevice && "physicalDevice not initialized");
 
-		const std::set<uint32_t> queueIndexes{ *config.graphicsQueueIndex, *config.presentationQueueIndex };
+		std::set<uint32_t> queueIndexes{ *config.graphicsQueueIndex, *config.presentationQueueIndex };
+		if (config.transferQueueIndex) {
+			queueIndexes.insert(*config.transferQueueIndex);
+		}
 
 		const float queuePriority = 1.0f;
 		std::vector<vk::DeviceQueueCreateInfo> queueInfos(queueIndexes.size());
@@ -73,12 +110,24 @@ namespace poc {
 			i++;
 		});
 
-		const std::vector<const char*> deviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+		const auto features = vk::PhysicalDeviceFeatures()
+			.setMultiDrawIndirect(deviceFeatures.multiDrawIndirect)
+			.setDrawIndirectFirstInstance(deviceFeatures.drawIndirectFirstInstance);
+
+		auto vulkan12Features = vk::PhysicalDeviceVulkan12Features()
+			.setDrawIndirectCount(VK_TRUE);
+
+		std::vector<const char*> deviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+		if (deviceFeatures.memoryBudget) {
+			deviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+		}
 		auto createInfo = vk::DeviceCreateInfo()
+			.setPNext(deviceFeatures.drawIndirectCount ? &vulkan12Features : nullptr)
 			.setQueueCreateInfoCount(static_cast<uint32_t>(queueInfos.size()))
 			.setPQueueCreateInfos(queueInfos.data())
 			.setEnabledExtensionCount(static_cast<uint32_t>(deviceExtensions.size()))
-			.setPpEnabledExtensionNames(deviceExtensions.data());
+			.setPpEnabledExtensionNames(deviceExtensions.data())
+			.setPEnabledFeatures(&features);
 
 		return physicalDevice.createDeviceUnique(createInfo);
 	}
@@ -93,11 +142,16 @@ namespace poc {
 
 		Impl(const VulkanPhysicalDevice& physicalDevice, const VulkanSurface& surface) :
 			queueConfig(getQueueConfig(physicalDevice.getPhysicalDevice(), surface.getSurface())),
-			device(createDevice(queueConfig, physicalDevice.getPhysicalDevice())),
+			features(getDeviceFeatures(physicalDevice)),
+			device(createDevice(queueConfig, physicalDevice.getPhysicalDevice(), features)),
 			graphicQueue(getQueue(*device, *queueConfig.graphicsQueueIndex)),
-			presentationQueue(getQueue(*device, *queueConfig.presentationQueueIndex)) {
+			presentationQueue(getQueue(*device, *queueConfig.presentationQueueIndex)),
+			transferQueue(getQueue(*device, queueConfig.transferQueueIndex.value_or(*queueConfig.graphicsQueueIndex))),
+			memoryAllocator(physicalDevice.getPhysicalDevice(), *device, features.memoryBudget) {
 
 			Logger::info(logTag, "Device created");
+			Logger::info(logTag, std::string("Uploads: ") + (queueConfig.transferQueueIndex ? "transfer queue" : "graphics queue"));
+			Logger::info(logTag, std::string("GPU driven rendering: ") + (supportsGpuDrivenRendering() ? (features.drawIndirectCount ? "draw indirect count" : "draw indirect") : "unsupported"));
 		}
 
 		std::vector<vk::UniqueFence> createFences(const uint32_t nbFences) const {
@@ -124,11 +178,19 @@ namespace poc {
 			return semaphores;
 		}
 
+		bool supportsGpuDrivenRendering() const {
+			return features.multiDrawIndirect && features.drawIndirectFirstInstance;
+		}
+
 	private:
 		QueueConfig queueConfig;
+		DeviceFeatures features;
 		vk::UniqueDevice device;
 		vk::Queue graphicQueue;
 		vk::Queue presentationQueue;
+		vk::Queue transferQueue;
+		// destroyed before the device
+		VulkanMemoryAllocator memoryAllocator;
 
 		friend VulkanDevice;
 	};
@@ -156,10 +218,34 @@ namespace poc {
 		return pimpl->presentationQueue;
 	}
 
+	bool VulkanDevice::hasTransferQueue() const {
+		return pimpl->queueConfig.transferQueueIndex.has_value();
+	}
+
+	uint32_t VulkanDevice::getTransferQueueIndex() const {
+		return pimpl->queueConfig.transferQueueIndex.value_or(getGraphicsQueueIndex());
+	}
+
+	const vk::Queue& VulkanDevice::getTransferQueue() const {
+		return pimpl->transferQueue;
+	}
+
+	VulkanMemoryAllocator& VulkanDevice::getMemoryAllocator() const {
+		return pimpl->memoryAllocator;
+	}
+
 	bool VulkanDevice::hasDistinctPresentationQueue() const {
 		return !pimpl->queueConfig.useSameQueue();
 	}
 
+	bool VulkanDevice::supportsGpuDrivenRendering() const {
+		return pimpl->supportsGpuDrivenRendering();
+	}
+
+	bool VulkanDevice::supportsDrawIndirectCount() const {
+		return pimpl->features.drawIndirectCount;
+	}
+
 	std::vector<vk::UniqueFence> VulkanDevice::createFences(const uint32_t nbFences) const {
 		return pimpl->createFences(nbFences);
 	}
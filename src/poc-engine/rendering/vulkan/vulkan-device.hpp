@@ -2,6 +2,7 @@
 
 #include "../../core/pimpl_ptr.hpp"
 #include "../../plateform/platform.hpp"
+#include "vulkan-memory-allocator.hpp"
 #include "vulkan-physical-device.hpp"
 
 namespace poc {
@@ -21,6 +22,20 @@ namespace poc {
 
 		bool hasDistinctPresentationQueue() const;
 
+		// queue of a transfer only family when the device has one, the graphics queue otherwise:
+		// the resources written there are transferred to the graphics family before their use
+		bool hasTransferQueue() const;
+		uint32_t getTransferQueueIndex() const;
+		const vk::Queue& getTransferQueue() const;
+
+		// multi draw indirect with a first instance: the draws can be culled & written on the GPU
+		bool supportsGpuDrivenRendering() const;
+		// the draw count can be read from a buffer, otherwise the empty commands are submitted too
+		bool supportsDrawIndirectCount() const;
+
+		// memory of the buffers & images of the device
+		VulkanMemoryAllocator& getMemoryAllocator() const;
+
 		std::vector<vk::UniqueFence> createFences(const uint32_t nbFences) const;
 		std::vector<vk::UniqueSemaphore> createSemaphores(const uint32_t nbSemaphores) const;
 
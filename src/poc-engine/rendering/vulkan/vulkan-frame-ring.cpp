@@ -0,0 +1,120 @@
+#include "vulkan-frame-ring.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "../../core/logger.hpp"
+#include "../memory-sub-allocators.hpp"
+#include "vulkan-buffer.hpp"
+
+using namespace poc;
+
+namespace poc {
+
+	static constexpr char logTag[]{ "POC::VulkanFrameRing" };
+
+	// vertex attributes are at most 16 bytes wide
+	static constexpr vk::DeviceSize vertexAlignment = 16;
+
+	static VulkanBuffer createRegion(const VulkanDevice& device, vk::DeviceSize size) {
+		return VulkanBuffer(
+			device,
+			size,
+			vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eVertexBuffer |
+			vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eIndirectBuffer,
+			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+			nullptr,
+			ResourceCategory::FRAME_DATA);
+	}
+
+	struct FrameRegion {
+		std::optional<VulkanBuffer> buffer;
+		LinearAllocator allocator;
+		// regions replaced during the frame, still read by its commands
+		std::vector<VulkanBuffer> outgrown;
+	};
+
+	class VulkanFrameRing::Impl {
+	public:
+
+		Impl(const VulkanPhysicalDevice& physicalDevice, const VulkanDevice& device, uint32_t frameCount, vk::DeviceSize frameSize) :
+			limits(physicalDevice.getPhysicalDevice().getProperties().limits) {
+
+			assert(frameSize <= std::numeric_limits<uint32_t>::max() && "dynamic offsets are 32 bits");
+			regions.reserve(frameCount);
+			for (uint32_t frame = 0; frame < frameCount; ++frame) {
+				regions.push_back(FrameRegion{ createRegion(device, frameSize), LinearAllocator(frameSize), {} });
+			}
+			Logger::info(logTag, "Frame ring of " + std::to_string(frameCount) + " x " + std::to_string(frameSize >> 10) + " KB created");
+		}
+
+		void beginFrame(uint32_t frame) {
+			assert(frame < regions.size() && "frame out of range");
+			currentFrame = frame;
+			regions[frame].allocator.reset();
+			regions[frame].outgrown.clear();
+		}
+
+		FrameAllocation allocate(const VulkanDevice& device, vk::DeviceSize size, vk::DeviceSize alignment) {
+			FrameRegion& region = regions[currentFrame];
+			uint64_t offset = region.allocator.allocate(size, alignment);
+			if (offset == LinearAllocator::invalidOffset) {
+				grow(device, region, size);
+				offset = region.allocator.allocate(size, alignment);
+			}
+			return FrameAllocation{ region.buffer->getBuffer(), static_cast<uint32_t>(offset), region.buffer->getMappedData() + offset };
+		}
+
+		vk::DeviceSize getUsedSize() const {
+			return regions[currentFrame].allocator.getUsedSize();
+		}
+
+		const vk::PhysicalDeviceLimits limits;
+
+	private:
+		std::vector<FrameRegion> regions;
+		uint32_t currentFrame{ 0 };
+
+		// the new region starts empty: the size is enough whatever the alignment
+		void grow(const VulkanDevice& device, FrameRegion& region, vk::DeviceSize size) {
+			vk::DeviceSize regionSize = region.allocator.getSize() * 2;
+			while (regionSize < size) {
+				regionSize *= 2;
+			}
+			assert(regionSize <= std::numeric_limits<uint32_t>::max() && "dynamic offsets are 32 bits");
+
+			region.outgrown.push_back(std::move(*region.buffer));
+			region.buffer.emplace(createRegion(device, regionSize));
+			region.allocator = LinearAllocator(regionSize);
+			Logger::info(logTag, "Region of frame " + std::to_string(currentFrame) + " grown to " + std::to_string(regionSize >> 10) + " KB");
+		}
+
+	};
+
+	VulkanFrameRing::VulkanFrameRing(const VulkanPhysicalDevice& physicalDevice, const VulkanDevice& device, uint32_t frameCount, vk::DeviceSize frameSize) :
+		pimpl(make_unique_pimpl<VulkanFrameRing::Impl>(physicalDevice, device, frameCount, frameSize)) { }
+
+	void VulkanFrameRing::beginFrame(uint32_t frame) {
+		pimpl->beginFrame(frame);
+	}
+
+	FrameAllocation VulkanFrameRing::allocateUniform(const VulkanDevice& device, vk::DeviceSize size) {
+		return pimpl->allocate(device, size, pimpl->limits.minUniformBufferOffsetAlignment);
+	}
+
+	FrameAllocation VulkanFrameRing::allocateStorage(const VulkanDevice& device, vk::DeviceSize size) {
+		return pimpl->allocate(device, size, pimpl->limits.minStorageBufferOffsetAlignment);
+	}
+
+	FrameAllocation VulkanFrameRing::allocateVertices(const VulkanDevice& device, vk::DeviceSize size) {
+		return pimpl->allocate(device, size, vertexAlignment);
+	}
+
+	vk::DeviceSize VulkanFrameRing::getUsedSize() const {
+		return pimpl->getUsedSize();
+	}
+
+}
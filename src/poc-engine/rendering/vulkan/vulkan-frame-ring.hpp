@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../../core/pimpl_ptr.hpp"
+#include "../../plateform/platform.hpp"
+#include "vulkan-device.hpp"
+#include "vulkan-physical-device.hpp"
+
+namespace poc {
+
+	// range of the frame data, bound with its buffer & the offset as dynamic offset
+	struct FrameAllocation {
+		vk::Buffer buffer;
+		uint32_t offset{ 0 };
+		std::byte* data{ nullptr };
+	};
+
+	/*
+	 * Per frame data written by the CPU & read by the GPU: camera, per object constants, dynamic vertices.
+	 *
+	 * Each frame in flight owns a region of host visible memory, persistently mapped, allocated with a
+	 * bump pointer. The region of a frame is recycled by beginFrame() once its fence signaled: nothing is
+	 * freed. A region too small for the frame is replaced by a larger one, kept until the frame completes.
+	 */
+	class VulkanFrameRing {
+	public:
+
+		static constexpr vk::DeviceSize defaultFrameSize = 1ull << 20;
+
+		explicit VulkanFrameRing(const VulkanPhysicalDevice& physicalDevice, const VulkanDevice& device, uint32_t frameCount, vk::DeviceSize frameSize = defaultFrameSize);
+
+		// the fence of the frame signaled: the allocations of its previous use are released
+		void beginFrame(uint32_t frame);
+
+		// aligned for the dynamic offsets of their descriptor type, the data is written before the submission
+		FrameAllocation allocateUniform(const VulkanDevice& device, vk::DeviceSize size);
+		FrameAllocation allocateStorage(const VulkanDevice& device, vk::DeviceSize size);
+		FrameAllocation allocateVertices(const VulkanDevice& device, vk::DeviceSize size);
+
+		// bytes allocated by the current frame
+		vk::DeviceSize getUsedSize() const;
+
+	private:
+		class Impl;
+		pimpl_ptr<Impl> pimpl;
+	};
+
+}
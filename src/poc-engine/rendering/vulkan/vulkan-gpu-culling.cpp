@@ -0,0 +1,358 @@
+#include "vulkan-gpu-culling.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <vector>
+
+#include "../../core/logger.hpp"
+#include "../gpu-culling.hpp"
+#include "shaders/vulkan-shader-cull.hpp"
+
+using namespace poc;
+
+namespace poc {
+
+	static constexpr char logTag[]{ "POC::VulkanGpuCulling" };
+
+	// commands reserved per vertex format for the first frames, doubled when exceeded
+	static constexpr uint32_t minCommandCapacity = 64;
+
+	enum Binding : uint32_t {
+		objectsBinding = 0,
+		meshesBinding = 1,
+		commandsBinding = 2,
+		countsBinding = 3,
+		bindingCount = 4
+	};
+
+	// the objects are written in the frame ring every frame, bound at their dynamic offset
+	static vk::DescriptorType getDescriptorType(uint32_t binding) {
+		return binding == objectsBinding ? vk::DescriptorType::eStorageBufferDynamic : vk::DescriptorType::eStorageBuffer;
+	}
+
+	static vk::UniqueDescriptorSetLayout createSetLayout(const vk::Device& device) {
+		std::array<vk::DescriptorSetLayoutBinding, bindingCount> bindings;
+		for (uint32_t binding = 0; binding < bindingCount; ++binding) {
+			bindings[binding] = vk::DescriptorSetLayoutBinding()
+				.setBinding(binding)
+				.setDescriptorType(getDescriptorType(binding))
+				.setDescriptorCount(1)
+				.setStageFlags(vk::ShaderStageFlagBits::eCompute | vk::ShaderStageFlagBits::eVertex);
+		}
+
+		const auto createInfo = vk::DescriptorSetLayoutCreateInfo()
+			.setBindingCount(static_cast<uint32_t>(bindings.size()))
+			.setPBindings(bindings.data());
+
+		return device.createDescriptorSetLayoutUnique(createInfo);
+	}
+
+	static vk::UniquePipelineLayout createPipelineLayout(const vk::Device& device, const vk::DescriptorSetLayout& setLayout) {
+		const auto pushConstantRange = vk::PushConstantRange()
+			.setStageFlags(vk::ShaderStageFlagBits::eCompute)
+			.setOffset(0)
+			.setSize(sizeof(GpuCullingConstants));
+
+		const auto createInfo = vk::PipelineLayoutCreateInfo()
+			.setSetLayoutCount(1)
+			.setPSetLayouts(&setLayout)
+			.setPushConstantRangeCount(1)
+			.setPPushConstantRanges(&pushConstantRange);
+
+		return device.createPipelineLayoutUnique(createInfo);
+	}
+
+	static vk::UniquePipeline createPipeline(const vk::Device& device, const vk::PipelineLayout& layout) {
+		const auto moduleInfo = vk::ShaderModuleCreateInfo()
+			.setCodeSize(gShaderCullLength)
+			.setPCode(reinterpret_cast<const uint32_t*>(gShaderCull));
+		const auto module = device.createShaderModuleUnique(moduleInfo);
+
+		const auto stage = vk::PipelineShaderStageCreateInfo()
+			.setStage(vk::ShaderStageFlagBits::eCompute)
+			.setModule(*module)
+			.setPName("main");
+
+		const auto createInfo = vk::ComputePipelineCreateInfo()
+			.setStage(stage)
+			.setLayout(layout);
+
+		return device.createComputePipelineUnique(nullptr, createInfo);
+	}
+
+	static vk::UniqueDescriptorPool createDescriptorPool(const vk::Device& device, uint32_t frameCount) {
+		const std::array<vk::DescriptorPoolSize, 2> poolSizes{
+			vk::DescriptorPoolSize(vk::DescriptorType::eStorageBufferDynamic, frameCount),
+			vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, (bindingCount - 1) * frameCount)
+		};
+
+		const auto createInfo = vk::DescriptorPoolCreateInfo()
+			.setMaxSets(frameCount)
+			.setPoolSizeCount(static_cast<uint32_t>(poolSizes.size()))
+			.setPPoolSizes(poolSizes.data());
+
+		return device.createDescriptorPoolUnique(createInfo);
+	}
+
+	static constexpr vk::DeviceSize getObjectsSize(uint32_t capacity) {
+		return vk::DeviceSize(capacity) * sizeof(GpuObject);
+	}
+
+	static constexpr vk::DeviceSize getCommandsSize(uint32_t capacity) {
+		return vk::DeviceSize(vertexFormats.size()) * capacity * sizeof(DrawIndexedIndirectCommand);
+	}
+
+	// buffers of a frame in flight, the counts are read by the host
+	struct CullingFrame {
+		vk::DescriptorSet descriptorSet;
+		std::optional<VulkanBuffer> commands;
+		std::optional<VulkanBuffer> counts;
+		uint32_t capacity{ 0 };
+		uint32_t objectCount{ 0 };
+		// objects of each vertex format, the most draws of its range
+		std::array<uint32_t, vertexFormats.size()> formatCounts{};
+		// objects of the frame in the frame ring
+		FrameAllocation objects;
+		// buffers the descriptor set points to, the meshes change with the resident scene
+		vk::Buffer meshes;
+		vk::Buffer objectsBuffer;
+	};
+
+	class VulkanGpuCulling::Impl {
+	public:
+
+		const vk::UniqueDescriptorSetLayout setLayout;
+		const vk::UniquePipelineLayout pipelineLayout;
+		const vk::UniquePipeline pipeline;
+		const vk::UniqueDescriptorPool descriptorPool;
+		const uint32_t maxDrawIndirectCount;
+
+		std::vector<CullingFrame> frames;
+		std::vector<GpuObject> objects;
+
+		Impl(const VulkanPhysicalDevice& physicalDevice, const VulkanDevice& device, uint32_t frameCount) :
+			setLayout(createSetLayout(device.getDevice())),
+			pipelineLayout(createPipelineLayout(device.getDevice(), *setLayout)),
+			pipeline(createPipeline(device.getDevice(), *pipelineLayout)),
+			descriptorPool(createDescriptorPool(device.getDevice(), frameCount)),
+			maxDrawIndirectCount(physicalDevice.getPhysicalDevice().getProperties().limits.maxDrawIndirectCount),
+			frames(frameCount) {
+
+			const std::vector<vk::DescriptorSetLayout> layouts(frameCount, *setLayout);
+			const auto allocateInfo = vk::DescriptorSetAllocateInfo()
+				.setDescriptorPool(*descriptorPool)
+				.setDescriptorSetCount(frameCount)
+				.setPSetLayouts(layouts.data());
+			const std::vector<vk::DescriptorSet> descriptorSets = device.getDevice().allocateDescriptorSets(allocateInfo);
+
+			for (uint32_t frame = 0; frame < frameCount; ++frame) {
+				frames[frame].descriptorSet = descriptorSets[frame];
+				frames[frame].counts.emplace(
+					device,
+					vk::DeviceSize(vertexFormats.size() * sizeof(uint32_t)),
+					vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst,
+					vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+					nullptr);
+			}
+
+			Logger::info(logTag, "GPU culling initialized");
+		}
+
+		void reserve(const VulkanDevice& device, CullingFrame& frame, uint32_t objectCount) {
+			if (objectCount <= frame.capacity) {
+				return;
+			}
+
+			uint32_t capacity = std::max(frame.capacity, minCommandCapacity);
+			while (capacity < objectCount) {
+				capacity *= 2;
+			}
+
+			frame.commands.emplace(
+				device,
+				getCommandsSize(capacity),
+				vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst,
+				vk::MemoryPropertyFlagBits::eDeviceLocal,
+				nullptr);
+			frame.capacity = capacity;
+			// the descriptor set is rewritten with the new buffers
+			frame.meshes = nullptr;
+		}
+
+		void updateDescriptorSet(const VulkanDevice& device, CullingFrame& frame, const vk::Buffer& meshes) {
+			if (frame.meshes == meshes && frame.objectsBuffer == frame.objects.buffer) {
+				return;
+			}
+
+			// the objects range is the capacity from their dynamic offset
+			const std::array<vk::DescriptorBufferInfo, bindingCount> bufferInfos{
+				vk::DescriptorBufferInfo(frame.objects.buffer, 0, getObjectsSize(frame.capacity)),
+				vk::DescriptorBufferInfo(meshes, 0, VK_WHOLE_SIZE),
+				vk::DescriptorBufferInfo(frame.commands->getBuffer(), 0, VK_WHOLE_SIZE),
+				vk::DescriptorBufferInfo(frame.counts->getBuffer(), 0, VK_WHOLE_SIZE)
+			};
+
+			std::array<vk::WriteDescriptorSet, bindingCount> writes;
+			for (uint32_t binding = 0; binding < bindingCount; ++binding) {
+				writes[binding] = vk::WriteDescriptorSet()
+					.setDstSet(frame.descriptorSet)
+					.setDstBinding(binding)
+					.setDescriptorCount(1)
+					.setDescriptorType(getDescriptorType(binding))
+					.setPBufferInfo(&bufferInfos[binding]);
+			}
+
+			device.getDevice().updateDescriptorSets(static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+			frame.meshes = meshes;
+			frame.objectsBuffer = frame.objects.buffer;
+		}
+
+		void record(
+			const VulkanDevice& device,
+			VulkanFrameRing& frameRing,
+			const vk::CommandBuffer& commandBuffer,
+			uint32_t frameIndex,
+			const VulkanScene& vScene,
+			const Scene& scene,
+			float viewportHeight,
+			const LodSettings& lodSettings) {
+
+			CullingFrame& frame = frames[frameIndex];
+
+			GpuCulling::makeObjects(scene, objects);
+			frame.objectCount = static_cast<uint32_t>(objects.size());
+			if (objects.empty()) {
+				return;
+			}
+			frame.formatCounts = GpuCulling::countObjects(scene, objects);
+
+			reserve(device, frame, frame.objectCount);
+			// the whole capacity is allocated: the range of the descriptor fits past any offset
+			frame.objects = frameRing.allocateStorage(device, getObjectsSize(frame.capacity));
+			std::memcpy(frame.objects.data, objects.data(), objects.size() * sizeof(GpuObject));
+			updateDescriptorSet(device, frame, vScene.getMeshBuffer().getBuffer());
+
+			commandBuffer.fillBuffer(frame.counts->getBuffer(), 0, VK_WHOLE_SIZE, 0);
+			if (!device.supportsDrawIndirectCount()) {
+				// only the commands the draws read, the ones of the objects of each format
+				for (size_t format = 0; format < vertexFormats.size(); ++format) {
+					if (frame.formatCounts[format] > 0) {
+						commandBuffer.fillBuffer(
+							frame.commands->getBuffer(),
+							getCommandsSize(frame.capacity) / vertexFormats.size() * format,
+							vk::DeviceSize(frame.formatCounts[format]) * sizeof(DrawIndexedIndirectCommand),
+							0);
+					}
+				}
+			}
+
+			const auto clearBarrier = vk::MemoryBarrier()
+				.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+				.setDstAccessMask(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite);
+			commandBuffer.pipelineBarrier(
+				vk::PipelineStageFlagBits::eTransfer,
+				vk::PipelineStageFlagBits::eComputeShader,
+				{}, 1, &clearBarrier, 0, nullptr, 0, nullptr);
+
+			const GpuCullingConstants constants = GpuCulling::makeConstants(scene.getCamera(), viewportHeight, lodSettings, frame.objectCount, frame.capacity);
+			commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline);
+			commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipelineLayout, 0, 1, &frame.descriptorSet, 1, &frame.objects.offset);
+			commandBuffer.pushConstants(*pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(GpuCullingConstants), &constants);
+			commandBuffer.dispatch((frame.objectCount + GpuCulling::workgroupSize - 1) / GpuCulling::workgroupSize, 1, 1);
+
+			// the commands & counts are read by the draws, the counts by the host for the frame statistics
+			const auto cullingBarrier = vk::MemoryBarrier()
+				.setSrcAccessMask(vk::AccessFlagBits::eShaderWrite)
+				.setDstAccessMask(vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eHostRead);
+			commandBuffer.pipelineBarrier(
+				vk::PipelineStageFlagBits::eComputeShader,
+				vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eHost,
+				{}, 1, &cullingBarrier, 0, nullptr, 0, nullptr);
+		}
+
+		void draw(const VulkanDevice& device, const vk::CommandBuffer& commandBuffer, uint32_t frameIndex, VertexFormat format) const {
+			const CullingFrame& frame = frames[frameIndex];
+			const uint32_t formatCount = frame.objectCount > 0 ? frame.formatCounts[static_cast<size_t>(format)] : 0;
+			if (formatCount == 0) {
+				return;
+			}
+
+			const vk::DeviceSize offset = getCommandsSize(frame.capacity) / vertexFormats.size() * static_cast<size_t>(format);
+			if (device.supportsDrawIndirectCount()) {
+				commandBuffer.drawIndexedIndirectCount(
+					frame.commands->getBuffer(),
+					offset,
+					frame.counts->getBuffer(),
+					vk::DeviceSize(static_cast<size_t>(format) * sizeof(uint32_t)),
+					formatCount,
+					sizeof(DrawIndexedIndirectCommand));
+				return;
+			}
+
+			// the commands past the draw count were cleared, they draw nothing
+			for (uint32_t first = 0; first < formatCount; first += maxDrawIndirectCount) {
+				const uint32_t drawCount = std::min(formatCount - first, maxDrawIndirectCount);
+				commandBuffer.drawIndexedIndirect(
+					frame.commands->getBuffer(),
+					offset + vk::DeviceSize(first) * sizeof(DrawIndexedIndirectCommand),
+					drawCount,
+					sizeof(DrawIndexedIndirectCommand));
+			}
+		}
+
+		FrameStats readFrameStats(uint32_t frameIndex) const {
+			const CullingFrame& frame = frames[frameIndex];
+
+			FrameStats stats{};
+			stats.objectCount = frame.objectCount;
+			if (frame.objectCount > 0) {
+				std::array<uint32_t, vertexFormats.size()> counts{};
+				frame.counts->read(counts.data(), vk::DeviceSize(sizeof(counts)));
+				for (const uint32_t count : counts) {
+					stats.visibleCount += count;
+				}
+			}
+			stats.culledCount = stats.objectCount - stats.visibleCount;
+			return stats;
+		}
+
+	};
+
+	VulkanGpuCulling::VulkanGpuCulling(const VulkanPhysicalDevice& physicalDevice, const VulkanDevice& device, uint32_t frameCount) :
+		pimpl(make_unique_pimpl<VulkanGpuCulling::Impl>(physicalDevice, device, frameCount)) { }
+
+	const vk::DescriptorSetLayout& VulkanGpuCulling::getObjectSetLayout() const {
+		return *pimpl->setLayout;
+	}
+
+	void VulkanGpuCulling::record(
+		const VulkanDevice& device,
+		VulkanFrameRing& frameRing,
+		const vk::CommandBuffer& commandBuffer,
+		uint32_t frame,
+		const VulkanScene& vScene,
+		const Scene& scene,
+		float viewportHeight,
+		const LodSettings& lodSettings) {
+		pimpl->record(device, frameRing, commandBuffer, frame, vScene, scene, viewportHeight, lodSettings);
+	}
+
+	void VulkanGpuCulling::bindObjects(const vk::CommandBuffer& commandBuffer, uint32_t frame, const vk::PipelineLayout& pipelineLayout) const {
+		// the descriptor set is written with the first objects
+		if (pimpl->frames[frame].objectCount == 0) {
+			return;
+		}
+		const CullingFrame& cullingFrame = pimpl->frames[frame];
+		commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipelineLayout, 0, 1, &cullingFrame.descriptorSet, 1, &cullingFrame.objects.offset);
+	}
+
+	void VulkanGpuCulling::draw(const VulkanDevice& device, const vk::CommandBuffer& commandBuffer, uint32_t frame, VertexFormat format) const {
+		pimpl->draw(device, commandBuffer, frame, format);
+	}
+
+	FrameStats VulkanGpuCulling::readFrameStats(uint32_t frame) const {
+		return pimpl->readFrameStats(frame);
+	}
+
+}
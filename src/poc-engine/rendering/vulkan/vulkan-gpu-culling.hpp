@@ -0,0 +1,53 @@
+#pragma once
+
+#include "../../core/pimpl_ptr.hpp"
+#include "../../core/scene.hpp"
+#include "../../plateform/platform.hpp"
+#include "../draw-collector.hpp"
+#include "vulkan-device.hpp"
+#include "vulkan-frame-ring.hpp"
+#include "vulkan-physical-device.hpp"
+#include "vulkan-scene.hpp"
+
+namespace poc {
+
+	/*
+	 * Culling & level of detail selection of the scene objects in a compute pass.
+	 *
+	 * The objects are written in the frame ring every frame. Each buffered frame owns its draw commands
+	 * & draw counts buffers, grown when the scene has more objects. The commands are written by the culling shader and submitted with one indirect
+	 * draw per vertex format, bounded by the objects of the format. Without draw indirect count, the
+	 * commands of each format up to its object count are cleared before the dispatch and submitted, the
+	 * empty ones included: the GPU still walks one command per object.
+	 */
+	class VulkanGpuCulling {
+	public:
+
+		explicit VulkanGpuCulling(const VulkanPhysicalDevice& physicalDevice, const VulkanDevice& device, uint32_t frameCount);
+
+		// objects, meshes, commands & counts storage buffers, the first two are read by the indirect vertex shader
+		const vk::DescriptorSetLayout& getObjectSetLayout() const;
+
+		// writes the objects in the frame ring & records the culling dispatch, outside of a render pass
+		void record(
+			const VulkanDevice& device,
+			VulkanFrameRing& frameRing,
+			const vk::CommandBuffer& commandBuffer,
+			uint32_t frame,
+			const VulkanScene& vScene,
+			const Scene& scene,
+			float viewportHeight,
+			const LodSettings& lodSettings);
+
+		void bindObjects(const vk::CommandBuffer& commandBuffer, uint32_t frame, const vk::PipelineLayout& pipelineLayout) const;
+		void draw(const VulkanDevice& device, const vk::CommandBuffer& commandBuffer, uint32_t frame, VertexFormat format) const;
+
+		// objects, visible & culled counts of the last culling of the frame, its fence must be signaled
+		FrameStats readFrameStats(uint32_t frame) const;
+
+	private:
+		class Impl;
+		pimpl_ptr<Impl> pimpl;
+	};
+
+}
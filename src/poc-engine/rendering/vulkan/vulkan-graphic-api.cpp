@@ -6,6 +6,8 @@
 #include "vulkan-instance.hpp"
 #include "vulkan-physical-device.hpp"
 #include "vulkan-render.hpp"
+#include "vulkan-scene-cache.hpp"
+#include "vulkan-staging-ring.hpp"
 #include "vulkan-surface.hpp"
 
 using namespace poc;
@@ -22,7 +24,9 @@ namespace poc {
 		const VulkanPhysicalDevice physicalDevice;
 		const VulkanDevice device;
 		const VulkanCommandPool commandPool;
+		VulkanStagingRing stagingRing;
 		VulkanRender vRender;
+		VulkanSceneCache sceneCache;
 
 		Impl(const Window& window) :
 			instance(),
@@ -30,14 +34,22 @@ namespace poc {
 			physicalDevice(instance, surface),
 			device(physicalDevice, surface),
 			commandPool(device),
-			vRender(VulkanRender(window, physicalDevice, device, surface, commandPool)) {
+			stagingRing(device),
+			vRender(VulkanRender(window, physicalDevice, device, surface, commandPool)),
+			sceneCache() {
 
 			Logger::info(logTag, "Vulkan API fully initialized");
 		}
 
-		void render(const Window& window, const Scene& scene) {
+		~Impl() {
+			// the frames & uploads in flight still read the resources
+			device.getDevice().waitIdle();
+		}
+
+		void render(const Window& window, const Scene& scene, const DrawCollector& drawCollector) {
 			if (!scene.isEmpty()) {
-				if (!vRender.render(device, VulkanScene(physicalDevice, device, commandPool, scene))) {
+				const VulkanScene& vScene = sceneCache.getResidentScene(device, stagingRing, scene);
+				if (!vRender.render(device, vScene, scene, drawCollector)) {
 					window.waitWhileMinimized();
 					vRender = vRender.recreate(window, physicalDevice, device, surface, commandPool);
 				}
@@ -49,9 +61,25 @@ namespace poc {
 	VulkanGraphicApi::VulkanGraphicApi(const Window& window) :
 		pimpl(make_unique_pimpl<VulkanGraphicApi::Impl>(window)) {};
 
-	void VulkanGraphicApi::render(const Window& window, const Scene& scene) {
-		pimpl->render(window, scene);
+	void VulkanGraphicApi::render(const Window& window, const Scene& scene, const DrawCollector& drawCollector) {
+		pimpl->render(window, scene, drawCollector);
 	};
 
+	bool VulkanGraphicApi::isGpuDriven() const {
+		return pimpl->vRender.isGpuDriven();
+	}
+
+	const FrameStats& VulkanGraphicApi::getGpuFrameStats() const {
+		return pimpl->vRender.getGpuFrameStats();
+	}
+
+	uint64_t VulkanGraphicApi::getResidentGeneration(const Scene& scene) const {
+		return pimpl->sceneCache.getResidentGeneration(pimpl->stagingRing, scene);
+	}
+
+	UploadStats VulkanGraphicApi::getUploadStats() const {
+		return pimpl->stagingRing.getStats();
+	}
+
 }
 
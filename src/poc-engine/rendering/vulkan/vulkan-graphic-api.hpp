@@ -11,7 +11,11 @@ namespace poc {
 	public:
 
 		explicit VulkanGraphicApi(const Window& window);
-		virtual void render(const Window& window, const Scene& scene) override;
+		virtual void render(const Window& window, const Scene& scene, const DrawCollector& drawCollector) override;
+		virtual bool isGpuDriven() const override;
+		virtual const FrameStats& getGpuFrameStats() const override;
+		virtual uint64_t getResidentGeneration(const Scene& scene) const override;
+		virtual UploadStats getUploadStats() const override;
 
 	private:
 		class Impl;
@@ -36,27 +36,6 @@ namespace poc {
 		return device.createImageUnique(createInfo);
 	}
 
-	static vk::UniqueDeviceMemory allocateImageMemory(
-		const VulkanPhysicalDevice& physicalDevice,
-		const vk::Device& device,
-		const vk::Image& image,
-		const vk::MemoryPropertyFlags& memoryProperties) {
-
-		assert(physicalDevice.getPhysicalDevice() && "physicalDevice not initialized");
-		assert(device && "device not initialized");
-
-		const vk::MemoryRequirements requirements = device.getImageMemoryRequirements(image);
-		const uint32_t memoryTypeIndex = physicalDevice.findMemoryTypeIndex(requirements.memoryTypeBits, memoryProperties);
-
-		const auto allocateInfo = vk::MemoryAllocateInfo()
-			.setAllocationSize(requirements.size)
-			.setMemoryTypeIndex(memoryTypeIndex);
-
-		vk::UniqueDeviceMemory memory{ device.allocateMemoryUnique(allocateInfo) };
-		device.bindImageMemory(image, *memory, { 0 });
-		return memory;
-	}
-
 	static void executeTransitionCommand(
 		const VulkanCommandPool& commandPool,
 		const VulkanDevice& device,
@@ -122,16 +101,20 @@ namespace poc {
 		}
 	}
 
+	static ResourceCategory getCategory(const vk::ImageUsageFlags& usage) {
+		const vk::ImageUsageFlags attachments = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eDepthStencilAttachment;
+		return (usage & attachments) ? ResourceCategory::RENDER_TARGET : ResourceCategory::TEXTURE;
+	}
+
 	class VulkanImage::Impl {
 	public:
 
 		const vk::Format format;
 		const vk::UniqueImage image;
-		const vk::UniqueDeviceMemory imageMemory;
+		const VulkanAllocation imageMemory;
 
 		Impl(
 			const VulkanCommandPool& commandPool,
-			const VulkanPhysicalDevice& physicalDevice,
 			const VulkanDevice& device,
 			const vk::Format& format,
 			const uint32_t width,
@@ -143,7 +126,7 @@ namespace poc {
 			const vk::ImageLayout& imageLayout) :
 			format(format),
 			image(createImage(device.getDevice(), format, width, height, tiling, usage, sampleCount)),
-			imageMemory(allocateImageMemory(physicalDevice, device.getDevice(), *image, memoryProperties)) {
+			imageMemory(device.getMemoryAllocator().allocateImage(*image, memoryProperties, tiling, getCategory(usage))) {
 
 			transitionToImageLayout(commandPool, device, *image, imageLayout);
 
@@ -153,7 +136,6 @@ namespace poc {
 
 	VulkanImage::VulkanImage(
 		const VulkanCommandPool& commandPool,
-		const VulkanPhysicalDevice& physicalDevice,
 		const VulkanDevice& device,
 		const vk::Format& format,
 		const uint32_t width,
@@ -164,7 +146,7 @@ namespace poc {
 		const vk::MemoryPropertyFlags& memoryProperties,
 		const vk::ImageLayout& imageLayout) :
 		pimpl(make_unique_pimpl<VulkanImage::Impl>(
-			commandPool, physicalDevice, device, format, width, height, tiling, usage, sampleCount, memoryProperties, imageLayout)) { }
+			commandPool, device, format, width, height, tiling, usage, sampleCount, memoryProperties, imageLayout)) { }
 
 	const vk::Image VulkanImage::getImage() const {
 		return *pimpl->image;
@@ -13,7 +13,6 @@ namespace poc {
 
 		explicit VulkanImage(
 			const VulkanCommandPool& commandPool,
-			const VulkanPhysicalDevice& physicalDevice,
 			const VulkanDevice& device,
 			const vk::Format& format,
 			const uint32_t width,
@@ -0,0 +1,340 @@
+#include "vulkan-memory-allocator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "../../core/logger.hpp"
+#include "../memory-sub-allocators.hpp"
+
+using namespace poc;
+
+namespace poc {
+
+	static constexpr char logTag[]{ "POC::VulkanMemoryAllocator" };
+
+	static constexpr uint32_t dedicatedBlock = std::numeric_limits<uint32_t>::max();
+
+	struct MemoryBlock {
+		vk::UniqueDeviceMemory memory;
+		std::byte* mappedData;
+		uint32_t memoryTypeIndex;
+		VulkanResourceTiling tiling;
+		TlsfAllocator allocator;
+	};
+
+	class VulkanMemoryAllocator::Impl {
+	public:
+
+		Impl(const vk::PhysicalDevice& physicalDevice, const vk::Device& device, bool memoryBudget, vk::DeviceSize blockSize) :
+			physicalDevice(physicalDevice),
+			device(device),
+			memoryProperties(physicalDevice.getMemoryProperties()),
+			memoryBudget(memoryBudget),
+			blockSize(blockSize),
+			stats(memoryProperties.memoryTypeCount) {
+
+			assert(physicalDevice && "physicalDevice not initialized");
+			assert(device && "device not initialized");
+		}
+
+		~Impl() {
+			assert(std::all_of(stats.begin(), stats.end(), [](const VulkanMemoryStats& typeStats) { return typeStats.allocationCount == 0; })
+				&& "allocations outlive their allocator");
+		}
+
+		VulkanAllocation allocate(const vk::MemoryRequirements& requirements, const vk::MemoryPropertyFlags& properties, VulkanResourceTiling tiling, ResourceCategory category) {
+			const uint32_t memoryTypeIndex = findMemoryTypeIndex(requirements.memoryTypeBits, properties);
+			const vk::DeviceSize typeBlockSize = getBlockSize(memoryTypeIndex);
+
+			// owned once complete: nothing to free when the device memory cannot be allocated
+			VulkanAllocation allocation;
+			allocation.size = requirements.size;
+			allocation.memoryTypeIndex = memoryTypeIndex;
+			allocation.category = category;
+
+			const std::lock_guard<std::mutex> lock(mutex);
+			VulkanMemoryStats& typeStats = stats[memoryTypeIndex];
+			if (requirements.size > typeBlockSize / 2 || requirements.alignment > typeBlockSize / 2) {
+				vk::UniqueDeviceMemory memory = allocateMemory(requirements.size, memoryTypeIndex);
+				allocation.mappedData = map(*memory, memoryTypeIndex);
+				allocation.memory = memory.release();
+				allocation.block = dedicatedBlock;
+				++typeStats.dedicatedCount;
+				typeStats.dedicatedBytes += requirements.size;
+			}
+			else {
+				TlsfAllocation range;
+				uint32_t block = 0;
+				for (; block < blocks.size(); ++block) {
+					if (blocks[block] && blocks[block]->memoryTypeIndex == memoryTypeIndex && blocks[block]->tiling == tiling) {
+						range = blocks[block]->allocator.allocate(requirements.size, requirements.alignment);
+						if (range.isValid()) {
+							break;
+						}
+					}
+				}
+				if (!range.isValid()) {
+					block = createBlock(memoryTypeIndex, tiling, typeBlockSize);
+					range = blocks[block]->allocator.allocate(requirements.size, requirements.alignment);
+					assert(range.isValid() && "allocation larger than a block");
+				}
+
+				allocation.memory = *blocks[block]->memory;
+				allocation.offset = range.offset;
+				allocation.mappedData = blocks[block]->mappedData ? blocks[block]->mappedData + range.offset : nullptr;
+				allocation.block = block;
+				allocation.node = range.node;
+			}
+
+			++typeStats.allocationCount;
+			typeStats.allocatedBytes += requirements.size;
+			++typeStats.totalAllocationCount;
+			VulkanCategoryStats& allocationCategoryStats = categoryStats[static_cast<size_t>(category)];
+			++allocationCategoryStats.allocationCount;
+			allocationCategoryStats.allocatedBytes += requirements.size;
+			allocation.owner = this;
+			return allocation;
+		}
+
+		void free(const VulkanAllocation& allocation) {
+			const std::lock_guard<std::mutex> lock(mutex);
+			VulkanMemoryStats& typeStats = stats[allocation.memoryTypeIndex];
+			--typeStats.allocationCount;
+			typeStats.allocatedBytes -= allocation.size;
+			++typeStats.totalFreeCount;
+			VulkanCategoryStats& allocationCategoryStats = categoryStats[static_cast<size_t>(allocation.category)];
+			--allocationCategoryStats.allocationCount;
+			allocationCategoryStats.allocatedBytes -= allocation.size;
+
+			if (allocation.block == dedicatedBlock) {
+				device.freeMemory(allocation.memory);
+				--typeStats.dedicatedCount;
+				typeStats.dedicatedBytes -= allocation.size;
+				return;
+			}
+
+			MemoryBlock& block = *blocks[allocation.block];
+			block.allocator.free(TlsfAllocation{ allocation.offset, allocation.node });
+
+			// an empty block is kept only when it is the last of its kind, ready for the next allocations
+			const bool lastOfItsKind = std::none_of(blocks.begin(), blocks.end(), [&block](const std::unique_ptr<MemoryBlock>& other) {
+				return other && other.get() != &block && other->memoryTypeIndex == block.memoryTypeIndex && other->tiling == block.tiling;
+			});
+			if (block.allocator.isEmpty() && !lastOfItsKind) {
+				--typeStats.blockCount;
+				typeStats.blockBytes -= block.allocator.getSize();
+				blocks[allocation.block].reset();
+			}
+		}
+
+		VulkanMemoryStats getStats(uint32_t memoryTypeIndex) const {
+			const std::lock_guard<std::mutex> lock(mutex);
+			return stats[memoryTypeIndex];
+		}
+
+		VulkanMemoryStats getStats() const {
+			const std::lock_guard<std::mutex> lock(mutex);
+			VulkanMemoryStats total;
+			for (const VulkanMemoryStats& typeStats : stats) {
+				total.blockCount += typeStats.blockCount;
+				total.blockBytes += typeStats.blockBytes;
+				total.dedicatedCount += typeStats.dedicatedCount;
+				total.dedicatedBytes += typeStats.dedicatedBytes;
+				total.allocationCount += typeStats.allocationCount;
+				total.allocatedBytes += typeStats.allocatedBytes;
+				total.totalAllocationCount += typeStats.totalAllocationCount;
+				total.totalFreeCount += typeStats.totalFreeCount;
+			}
+			return total;
+		}
+
+		VulkanCategoryStats getStats(ResourceCategory category) const {
+			const std::lock_guard<std::mutex> lock(mutex);
+			return categoryStats[static_cast<size_t>(category)];
+		}
+
+		std::vector<VulkanHeapBudget> getHeapBudgets() const {
+			std::vector<VulkanHeapBudget> budgets(memoryProperties.memoryHeapCount);
+			if (memoryBudget) {
+				const auto chain = physicalDevice.getMemoryProperties2<vk::PhysicalDeviceMemoryProperties2, vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+				const auto& budgetProperties = chain.get<vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+				for (uint32_t heap = 0; heap < memoryProperties.memoryHeapCount; ++heap) {
+					budgets[heap].budget = budgetProperties.heapBudget[heap];
+					budgets[heap].usage = budgetProperties.heapUsage[heap];
+				}
+			}
+
+			const std::lock_guard<std::mutex> lock(mutex);
+			for (uint32_t type = 0; type < memoryProperties.memoryTypeCount; ++type) {
+				budgets[memoryProperties.memoryTypes[type].heapIndex].allocatorBytes += stats[type].blockBytes + stats[type].dedicatedBytes;
+			}
+			if (!memoryBudget) {
+				// the rest of the heap is left to the other processes & the driver
+				for (uint32_t heap = 0; heap < memoryProperties.memoryHeapCount; ++heap) {
+					budgets[heap].budget = memoryProperties.memoryHeaps[heap].size / 5 * 4;
+					budgets[heap].usage = budgets[heap].allocatorBytes;
+				}
+			}
+			return budgets;
+		}
+
+		uint32_t getHeapIndex(const vk::MemoryPropertyFlags& properties) const {
+			return memoryProperties.memoryTypes[findMemoryTypeIndex(~0u, properties)].heapIndex;
+		}
+
+		vk::Device getDevice() const {
+			return device;
+		}
+
+	private:
+		vk::PhysicalDevice physicalDevice;
+		vk::Device device;
+		vk::PhysicalDeviceMemoryProperties memoryProperties;
+		bool memoryBudget;
+		vk::DeviceSize blockSize;
+
+		mutable std::mutex mutex;
+		// freed blocks leave an empty slot, the allocations keep the index of their block
+		std::vector<std::unique_ptr<MemoryBlock>> blocks;
+		std::vector<VulkanMemoryStats> stats;
+		std::array<VulkanCategoryStats, resourceCategoryCount> categoryStats{};
+
+		uint32_t findMemoryTypeIndex(uint32_t memoryTypeBits, const vk::MemoryPropertyFlags& properties) const {
+			for (uint32_t index = 0; index < memoryProperties.memoryTypeCount; ++index) {
+				if ((memoryTypeBits & (1u << index)) && (memoryProperties.memoryTypes[index].propertyFlags & properties) == properties) {
+					return index;
+				}
+			}
+			Logger::error(logTag, "Failed to find suitable memory type.");
+			throw std::runtime_error("Failed to find suitable memory type.");
+		}
+
+		vk::DeviceSize getBlockSize(uint32_t memoryTypeIndex) const {
+			const vk::DeviceSize heapSize = memoryProperties.memoryHeaps[memoryProperties.memoryTypes[memoryTypeIndex].heapIndex].size;
+			return std::min(blockSize, heapSize / 8);
+		}
+
+		vk::UniqueDeviceMemory allocateMemory(vk::DeviceSize size, uint32_t memoryTypeIndex) const {
+			return device.allocateMemoryUnique(vk::MemoryAllocateInfo()
+				.setAllocationSize(size)
+				.setMemoryTypeIndex(memoryTypeIndex));
+		}
+
+		std::byte* map(const vk::DeviceMemory& memory, uint32_t memoryTypeIndex) const {
+			if (!(memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible)) {
+				return nullptr;
+			}
+			return static_cast<std::byte*>(device.mapMemory(memory, 0, VK_WHOLE_SIZE));
+		}
+
+		uint32_t createBlock(uint32_t memoryTypeIndex, VulkanResourceTiling tiling, vk::DeviceSize size) {
+			vk::UniqueDeviceMemory memory = allocateMemory(size, memoryTypeIndex);
+			std::byte* mappedData = map(*memory, memoryTypeIndex);
+			auto block = std::make_unique<MemoryBlock>(MemoryBlock{ std::move(memory), mappedData, memoryTypeIndex, tiling, TlsfAllocator(size) });
+
+			++stats[memoryTypeIndex].blockCount;
+			stats[memoryTypeIndex].blockBytes += size;
+			Logger::info(logTag, "Block of " + std::to_string(size >> 20) + " MB allocated in memory type " + std::to_string(memoryTypeIndex));
+
+			const auto slot = std::find(blocks.begin(), blocks.end(), nullptr);
+			if (slot != blocks.end()) {
+				*slot = std::move(block);
+				return static_cast<uint32_t>(slot - blocks.begin());
+			}
+			blocks.push_back(std::move(block));
+			return static_cast<uint32_t>(blocks.size() - 1);
+		}
+
+	};
+
+	VulkanMemoryAllocator::VulkanMemoryAllocator(const vk::PhysicalDevice& physicalDevice, const vk::Device& device, bool memoryBudget, vk::DeviceSize blockSize) :
+		pimpl(make_unique_pimpl<VulkanMemoryAllocator::Impl>(physicalDevice, device, memoryBudget, blockSize)) { }
+
+	VulkanAllocation VulkanMemoryAllocator::allocate(const vk::MemoryRequirements& requirements, const vk::MemoryPropertyFlags& properties, VulkanResourceTiling tiling,
+		ResourceCategory category) {
+		return pimpl->allocate(requirements, properties, tiling, category);
+	}
+
+	VulkanAllocation VulkanMemoryAllocator::allocateBuffer(const vk::Buffer& buffer, const vk::MemoryPropertyFlags& properties, ResourceCategory category) {
+		assert(buffer && "buffer not initialized");
+		const vk::Device device = pimpl->getDevice();
+		VulkanAllocation allocation = allocate(device.getBufferMemoryRequirements(buffer), properties, VulkanResourceTiling::LINEAR, category);
+		device.bindBufferMemory(buffer, allocation.getMemory(), allocation.getOffset());
+		return allocation;
+	}
+
+	VulkanAllocation VulkanMemoryAllocator::allocateImage(const vk::Image& image, const vk::MemoryPropertyFlags& properties, const vk::ImageTiling& tiling,
+		ResourceCategory category) {
+		assert(image && "image not initialized");
+		const vk::Device device = pimpl->getDevice();
+		VulkanAllocation allocation = allocate(device.getImageMemoryRequirements(image), properties,
+			tiling == vk::ImageTiling::eOptimal ? VulkanResourceTiling::OPTIMAL : VulkanResourceTiling::LINEAR, category);
+		device.bindImageMemory(image, allocation.getMemory(), allocation.getOffset());
+		return allocation;
+	}
+
+	VulkanMemoryStats VulkanMemoryAllocator::getStats() const {
+		return pimpl->getStats();
+	}
+
+	VulkanMemoryStats VulkanMemoryAllocator::getStats(uint32_t memoryTypeIndex) const {
+		return pimpl->getStats(memoryTypeIndex);
+	}
+
+	VulkanCategoryStats VulkanMemoryAllocator::getStats(ResourceCategory category) const {
+		return pimpl->getStats(category);
+	}
+
+	std::vector<VulkanHeapBudget> VulkanMemoryAllocator::getHeapBudgets() const {
+		return pimpl->getHeapBudgets();
+	}
+
+	uint32_t VulkanMemoryAllocator::getHeapIndex(const vk::MemoryPropertyFlags& properties) const {
+		return pimpl->getHeapIndex(properties);
+	}
+
+	VulkanAllocation::VulkanAllocation(VulkanAllocation&& other) noexcept :
+		owner(std::exchange(other.owner, nullptr)),
+		memory(other.memory),
+		offset(other.offset),
+		size(other.size),
+		memoryTypeIndex(other.memoryTypeIndex),
+		category(other.category),
+		mappedData(other.mappedData),
+		block(other.block),
+		node(other.node) { }
+
+	VulkanAllocation& VulkanAllocation::operator=(VulkanAllocation&& other) noexcept {
+		if (this != &other) {
+			release();
+			owner = std::exchange(other.owner, nullptr);
+			memory = other.memory;
+			offset = other.offset;
+			size = other.size;
+			memoryTypeIndex = other.memoryTypeIndex;
+			category = other.category;
+			mappedData = other.mappedData;
+			block = other.block;
+			node = other.node;
+		}
+		return *this;
+	}
+
+	VulkanAllocation::~VulkanAllocation() {
+		release();
+	}
+
+	void VulkanAllocation::release() {
+		if (owner) {
+			owner->free(*this);
+			owner = nullptr;
+		}
+	}
+
+}
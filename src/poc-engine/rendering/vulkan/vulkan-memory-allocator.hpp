@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../../core/pimpl_ptr.hpp"
+#include "../../plateform/platform.hpp"
+#include "../residency.hpp"
+
+namespace poc {
+
+	// linear resources, buffers & linear images, and optimal images never share a memory block:
+	// bufferImageGranularity never applies between two neighbours of a block
+	enum class VulkanResourceTiling {
+		LINEAR,
+		OPTIMAL
+	};
+
+	struct VulkanMemoryStats {
+		uint32_t blockCount{ 0 };
+		vk::DeviceSize blockBytes{ 0 };
+		// allocations larger than half a block have a device memory of their own
+		uint32_t dedicatedCount{ 0 };
+		vk::DeviceSize dedicatedBytes{ 0 };
+		// live allocations, dedicated ones included, alignment padding excluded
+		uint32_t allocationCount{ 0 };
+		vk::DeviceSize allocatedBytes{ 0 };
+		// since the creation of the allocator
+		uint64_t totalAllocationCount{ 0 };
+		uint64_t totalFreeCount{ 0 };
+	};
+
+	// live allocations of a resource category, all memory types included
+	struct VulkanCategoryStats {
+		uint32_t allocationCount{ 0 };
+		vk::DeviceSize allocatedBytes{ 0 };
+	};
+
+	struct VulkanHeapBudget {
+		// memory the process can use before the driver pages: reported by the driver, otherwise 80% of the heap
+		vk::DeviceSize budget{ 0 };
+		// memory of the process in the heap: reported by the driver, otherwise the blocks & dedicated memories
+		vk::DeviceSize usage{ 0 };
+		// blocks & dedicated memories of the allocator in the heap
+		vk::DeviceSize allocatorBytes{ 0 };
+	};
+
+	class VulkanAllocation;
+
+	/*
+	 * Device memory allocator: resources are placed in large blocks of device memory allocated per memory
+	 * type and resource tiling, their ranges sub-allocated with a TLSF allocator. The driver allocates
+	 * a block once for many resources, far below its allocation count limit. An allocation larger than
+	 * half a block gets a dedicated device memory, a block left empty is freed unless it is the last one
+	 * of its memory type & tiling. Host visible blocks stay mapped for their whole life.
+	 *
+	 * Thread safe, the allocations must be destroyed before their allocator.
+	 */
+	class VulkanMemoryAllocator {
+	public:
+
+		static constexpr vk::DeviceSize defaultBlockSize = 64ull << 20;
+
+		// blocks are at most an eighth of their heap, memoryBudget: VK_EXT_memory_budget is enabled on the device
+		explicit VulkanMemoryAllocator(const vk::PhysicalDevice& physicalDevice, const vk::Device& device, bool memoryBudget = false, vk::DeviceSize blockSize = defaultBlockSize);
+
+		// throws when no memory type has the properties or the device is out of memory
+		VulkanAllocation allocate(const vk::MemoryRequirements& requirements, const vk::MemoryPropertyFlags& properties, VulkanResourceTiling tiling,
+			ResourceCategory category = ResourceCategory::OTHER);
+
+		// allocates & binds the memory of the resource
+		VulkanAllocation allocateBuffer(const vk::Buffer& buffer, const vk::MemoryPropertyFlags& properties, ResourceCategory category = ResourceCategory::OTHER);
+		VulkanAllocation allocateImage(const vk::Image& image, const vk::MemoryPropertyFlags& properties, const vk::ImageTiling& tiling,
+			ResourceCategory category = ResourceCategory::OTHER);
+
+		// all the memory types
+		VulkanMemoryStats getStats() const;
+		VulkanMemoryStats getStats(uint32_t memoryTypeIndex) const;
+		VulkanCategoryStats getStats(ResourceCategory category) const;
+
+		// queried from the driver at each call when it reports them
+		std::vector<VulkanHeapBudget> getHeapBudgets() const;
+		// heap of the first memory type with the properties, throws when there is none
+		uint32_t getHeapIndex(const vk::MemoryPropertyFlags& properties) const;
+
+	private:
+		class Impl;
+		pimpl_ptr<Impl> pimpl;
+
+		friend VulkanAllocation;
+	};
+
+	/*
+	 * Range of device memory of a resource, given back to its allocator when destroyed.
+	 */
+	class VulkanAllocation {
+	public:
+
+		VulkanAllocation() = default;
+		VulkanAllocation(const VulkanAllocation&) = delete;
+		VulkanAllocation(VulkanAllocation&& other) noexcept;
+		VulkanAllocation& operator=(const VulkanAllocation&) = delete;
+		VulkanAllocation& operator=(VulkanAllocation&& other) noexcept;
+		~VulkanAllocation();
+
+		vk::DeviceMemory getMemory() const {
+			return memory;
+		}
+
+		vk::DeviceSize getOffset() const {
+			return offset;
+		}
+
+		vk::DeviceSize getSize() const {
+			return size;
+		}
+
+		uint32_t getMemoryTypeIndex() const {
+			return memoryTypeIndex;
+		}
+
+		ResourceCategory getCategory() const {
+			return category;
+		}
+
+		// start of the allocation in the persistent mapping of host visible memory, nullptr otherwise
+		std::byte* getMappedData() const {
+			return mappedData;
+		}
+
+	private:
+		VulkanMemoryAllocator::Impl* owner{ nullptr };
+		vk::DeviceMemory memory;
+		vk::DeviceSize offset{ 0 };
+		vk::DeviceSize size{ 0 };
+		uint32_t memoryTypeIndex{ 0 };
+		ResourceCategory category{ ResourceCategory::OTHER };
+		std::byte* mappedData{ nullptr };
+		// block & node of the sub-allocation, no block for a dedicated memory
+		uint32_t block{ 0 };
+		uint32_t node{ 0 };
+
+		void release();
+
+		friend VulkanMemoryAllocator;
+	};
+
+}
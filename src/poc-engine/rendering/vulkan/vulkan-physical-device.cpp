@@ -36,6 +36,18 @@ namespace poc {
 
 	}
 
+	// the memory properties are chained since Vulkan 1.1
+	static bool isMemoryBudgetSupportedBy(const vk::PhysicalDevice device) {
+		if (device.getProperties().apiVersion < VK_API_VERSION_1_1) {
+			return false;
+		}
+		const std::vector<vk::ExtensionProperties> extensions = device.enumerateDeviceExtensionProperties();
+		return std::any_of(extensions.cbegin(), extensions.cend(),
+			[](const auto ep) {
+				return strcmp(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME, ep.extensionName) == 0;
+			});
+	}
+
 	static bool isSurfaceCompatibleWith(const vk::PhysicalDevice device, const vk::SurfaceKHR& surface) {
 		const auto formats = device.getSurfaceFormatsKHR(surface);
 		const auto modes = device.getSurfacePresentModesKHR(surface);
@@ -136,15 +148,18 @@ namespace poc {
 		const vk::PhysicalDevice physicalDevice;
 		const vk::Format depthFormat;
 		const vk::SampleCountFlagBits maxSampleCount;
+		const bool memoryBudget;
 
 		Impl(const VulkanInstance& instance, const VulkanSurface& surface) :
 			physicalDevice(selectPhysicalDevice(instance.getInstance(), surface.getSurface())),
 			depthFormat(selectDepthFormat(physicalDevice)),
-			maxSampleCount(computeMaxSampleCount(physicalDevice)) {
+			maxSampleCount(computeMaxSampleCount(physicalDevice)),
+			memoryBudget(isMemoryBudgetSupportedBy(physicalDevice)) {
 
 			Logger::info(logTag, "GPU chosen: " + std::string(physicalDevice.getProperties().deviceName));
 			Logger::info(logTag, "Depth format used: " + std::string(vk::to_string(depthFormat)));
 			Logger::info(logTag, "Max sample count: " + std::string(vk::to_string(maxSampleCount)));
+			Logger::info(logTag, std::string("Memory budget: ") + (memoryBudget ? "reported by the driver" : "heap sizes"));
 		}
 
 		uint32_t findMemoryTypeIndex(uint32_t type, vk::MemoryPropertyFlags properties) {
@@ -179,5 +194,9 @@ namespace poc {
 		return pimpl->maxSampleCount;
 	}
 
+	bool VulkanPhysicalDevice::supportsMemoryBudget() const {
+		return pimpl->memoryBudget;
+	}
+
 }
 
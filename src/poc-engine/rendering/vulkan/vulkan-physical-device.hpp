@@ -16,6 +16,9 @@ namespace poc {
 		const vk::Format& getDepthFormat() const;
 		const vk::SampleCountFlagBits& getMaxSampleCount() const;
 
+		// VK_EXT_memory_budget: the budget & usage of the heaps are reported by the driver
+		bool supportsMemoryBudget() const;
+
 		const uint32_t findMemoryTypeIndex(uint32_t type, vk::MemoryPropertyFlags properties) const;
 
 	private:
@@ -2,9 +2,12 @@
 
 #include "../../core/logger.hpp"
 #include "../vertex.hpp"
+#include "vulkan-vertex-layout.hpp"
 
 #include "shaders/vulkan-shader-fragment.hpp"
 #include "shaders/vulkan-shader-vertex.hpp"
+#include "shaders/vulkan-shader-vertex-indirect.hpp"
+#include "shaders/vulkan-shader-vertex-instanced.hpp"
 
 
 using namespace poc;
@@ -24,23 +27,69 @@ namespace poc {
 		return device.createShaderModuleUnique(createInfo);
 	}
 
-	static vk::UniquePipelineLayout createPipelineLayout(const vk::Device& device) {
+	static vk::UniquePipelineLayout createPipelineLayout(const vk::Device& device, const DrawMode drawMode, const vk::DescriptorSetLayout& objectSetLayout) {
+		assert((drawMode != DrawMode::GPU_DRIVEN || objectSetLayout) && "GPU driven draws need the object set layout");
+		const bool gpuDriven = drawMode == DrawMode::GPU_DRIVEN;
+
+		// per draw transform & dequantization of the positions, or per frame view projection for the GPU driven draws
+		const auto pushConstantRange = vk::PushConstantRange()
+			.setStageFlags(vk::ShaderStageFlagBits::eVertex)
+			.setOffset(0)
+			.setSize(gpuDriven ? sizeof(IndirectDrawConstants) : sizeof(DrawConstants));
+
 		const auto createInfo = vk::PipelineLayoutCreateInfo()
-			.setSetLayoutCount(0)
-			.setPSetLayouts(nullptr)
-			.setPushConstantRangeCount(0)
-			.setPPushConstantRanges(nullptr)
-			.setSetLayoutCount(0)
-			.setPSetLayouts(nullptr);
+			.setSetLayoutCount(gpuDriven ? 1 : 0)
+			.setPSetLayouts(gpuDriven ? &objectSetLayout : nullptr)
+			.setPushConstantRangeCount(1)
+			.setPPushConstantRanges(&pushConstantRange);
 		return device.createPipelineLayoutUnique(createInfo);
 	}
 
+	template<size_t... F>
+	static constexpr std::array<const vk::PipelineVertexInputStateCreateInfo*, sizeof...(F)> makeVertexInputStates(std::index_sequence<F...>) {
+		return { &VertexInputState<VertexFormatLayout<static_cast<VertexFormat>(F)>::value>::createInfo... };
+	}
+
+	template<size_t... F>
+	static constexpr std::array<const vk::PipelineVertexInputStateCreateInfo*, sizeof...(F)> makeInstancedVertexInputStates(std::index_sequence<F...>) {
+		return { &VertexInputState<VertexFormatLayout<static_cast<VertexFormat>(F)>::value, InstanceLayout::value>::createInfo... };
+	}
+
+	// generated at compile time, indexed by the format value
+	static constexpr std::array<const vk::PipelineVertexInputStateCreateInfo*, vertexFormats.size()> vertexInputStates =
+		makeVertexInputStates(std::make_index_sequence<vertexFormats.size()>());
+
+	static constexpr std::array<const vk::PipelineVertexInputStateCreateInfo*, vertexFormats.size()> instancedVertexInputStates =
+		makeInstancedVertexInputStates(std::make_index_sequence<vertexFormats.size()>());
+
+	static const vk::PipelineVertexInputStateCreateInfo& getVertexInputState(const VertexFormat format, const DrawMode drawMode) {
+		const size_t index = static_cast<size_t>(format);
+		if (index >= vertexInputStates.size()) {
+			Logger::error(logTag, "Unsupported vertex format");
+			throw std::runtime_error("Unsupported vertex format");
+		}
+		return drawMode == DrawMode::INSTANCED ? *instancedVertexInputStates[index] : *vertexInputStates[index];
+	}
+
+	static vk::UniqueShaderModule createVertexShaderModule(const vk::Device& device, const DrawMode drawMode) {
+		switch (drawMode) {
+		case DrawMode::INSTANCED:
+			return createShaderModule(device, gShaderVertexInstanced, gShaderVertexInstancedLength);
+		case DrawMode::GPU_DRIVEN:
+			return createShaderModule(device, gShaderVertexIndirect, gShaderVertexIndirectLength);
+		default:
+			return createShaderModule(device, gShaderVertex, gShaderVertexLength);
+		}
+	}
+
 	static vk::UniquePipeline createPipeline(
 		const VulkanPhysicalDevice& physicalDevice,
 		const vk::Device& device,
 		const VulkanSwapchain& swapchain,
 		const vk::RenderPass& renderPass,
-		const vk::PipelineLayout& layout) {
+		const vk::PipelineLayout& layout,
+		const VertexFormat vertexFormat,
+		const DrawMode drawMode) {
 
 		assert(physicalDevice.getPhysicalDevice() && "physicalDevice not initialized");
 		assert(device && "device not initialized");
@@ -48,7 +97,7 @@ namespace poc {
 		assert(renderPass && "renderPass not initialized");
 		assert(layout && "layout not initialized");
 
-		const auto vertexModule = createShaderModule(device, gShaderVertex, gShaderVertexLength);
+		const auto vertexModule = createVertexShaderModule(device, drawMode);
 		const auto vertexShader = vk::PipelineShaderStageCreateInfo()
 			.setStage(vk::ShaderStageFlagBits::eVertex)
 			.setModule(*vertexModule)
@@ -62,33 +111,6 @@ namespace poc {
 
 		const std::vector<vk::PipelineShaderStageCreateInfo> shaderInfos{ vertexShader, fragmentShader };
 
-		const auto vertexBindingDesc = vk::VertexInputBindingDescription()
-			.setBinding(0)
-			.setStride(sizeof(Vertex))
-			.setInputRate(vk::VertexInputRate::eVertex);
-
-		const std::array<vk::VertexInputAttributeDescription, 2> vertexAttributeDescs = {
-
-			vk::VertexInputAttributeDescription()
-			.setBinding(0)
-			.setLocation(0)
-			.setFormat(vk::Format::eR32G32B32Sfloat)
-			.setOffset(offsetof(Vertex, position)),
-
-			vk::VertexInputAttributeDescription()
-			.setBinding(0)
-			.setLocation(1)
-			.setFormat(vk::Format::eR32G32B32Sfloat)
-			.setOffset(offsetof(Vertex, color))
-
-		};
-
-		const auto vertexInputState = vk::PipelineVertexInputStateCreateInfo()
-			.setVertexBindingDescriptionCount(1)
-			.setPVertexBindingDescriptions(&vertexBindingDesc)
-			.setVertexAttributeDescriptionCount(static_cast<uint32_t>(vertexAttributeDescs.size()))
-			.setPVertexAttributeDescriptions(vertexAttributeDescs.data());
-
 		const auto inputAssemblyState = vk::PipelineInputAssemblyStateCreateInfo()
 			.setTopology(vk::PrimitiveTopology::eTriangleList)
 			.setPrimitiveRestartEnable(VK_FALSE);
@@ -148,7 +170,7 @@ namespace poc {
 		const auto createInfo = vk::GraphicsPipelineCreateInfo()
 			.setStageCount(static_cast<uint32_t>(shaderInfos.size()))
 			.setPStages(shaderInfos.data())
-			.setPVertexInputState(&vertexInputState)
+			.setPVertexInputState(&getVertexInputState(vertexFormat, drawMode))
 			.setPInputAssemblyState(&inputAssemblyState)
 			.setPTessellationState(nullptr)
 			.setPViewportState(&viewportState)
@@ -175,9 +197,12 @@ namespace poc {
 			const VulkanPhysicalDevice& physicalDevice,
 			const VulkanDevice& device,
 			const VulkanSwapchain& swapchain,
-			const VulkanRenderPass& renderPass) :
-			pipelineLayout(createPipelineLayout(device.getDevice())),
-			pipeline(createPipeline(physicalDevice, device.getDevice(), swapchain, renderPass.getRenderPass(), *pipelineLayout)) {
+			const VulkanRenderPass& renderPass,
+			const VertexFormat vertexFormat,
+			const DrawMode drawMode,
+			const vk::DescriptorSetLayout& objectSetLayout) :
+			pipelineLayout(createPipelineLayout(device.getDevice(), drawMode, objectSetLayout)),
+			pipeline(createPipeline(physicalDevice, device.getDevice(), swapchain, renderPass.getRenderPass(), *pipelineLayout, vertexFormat, drawMode)) {
 
 			Logger::info(logTag, "Pipeline created");
 		}
@@ -188,12 +213,19 @@ namespace poc {
 		const VulkanPhysicalDevice& physicalDevice,
 		const VulkanDevice& device,
 		const VulkanSwapchain& swapchain,
-		const VulkanRenderPass& renderPass) :
-		pimpl(make_unique_pimpl<VulkanPipeline::Impl>(physicalDevice, device, swapchain, renderPass)) { }
+		const VulkanRenderPass& renderPass,
+		const VertexFormat vertexFormat,
+		const DrawMode drawMode,
+		const vk::DescriptorSetLayout& objectSetLayout) :
+		pimpl(make_unique_pimpl<VulkanPipeline::Impl>(physicalDevice, device, swapchain, renderPass, vertexFormat, drawMode, objectSetLayout)) { }
 
 	const vk::Pipeline& VulkanPipeline::getPipeline() const {
 		return *pimpl->pipeline;
 	}
 
+	const vk::PipelineLayout& VulkanPipeline::getPipelineLayout() const {
+		return *pimpl->pipelineLayout;
+	}
+
 }
 
@@ -2,21 +2,45 @@
 
 #include "../../core/pimpl_ptr.hpp"
 #include "../../plateform/platform.hpp"
+#include "../vertex.hpp"
 #include "vulkan-device.hpp"
 #include "vulkan-render-pass.hpp"
 #include "vulkan-swapchain.hpp"
 
 namespace poc {
 
+	// vertex shader push constants of a draw
+	struct DrawConstants {
+		glm::mat4 transform;
+		Dequantization dequantization;
+	};
+
+	// vertex shader push constants of the GPU driven draws, the objects are read from a storage buffer
+	struct IndirectDrawConstants {
+		glm::mat4 viewProjection;
+	};
+
+	enum class DrawMode {
+		PER_DRAW,	// DrawConstants pushed for each draw
+		INSTANCED,	// DrawConstants with the view projection, the instances are bound after the vertices
+		GPU_DRIVEN	// IndirectDrawConstants, the instance index selects the object in the storage buffers
+	};
+
 	class VulkanPipeline {
 	public:
 
+		// the object set layout is required by the GPU driven draws only
 		explicit VulkanPipeline(
 			const VulkanPhysicalDevice& physicalDevice,
 			const VulkanDevice& device,
 			const VulkanSwapchain& swapchain,
-			const VulkanRenderPass& renderPass);
+			const VulkanRenderPass& renderPass,
+			const VertexFormat vertexFormat,
+			const DrawMode drawMode = DrawMode::PER_DRAW,
+			const vk::DescriptorSetLayout& objectSetLayout = nullptr);
+
 		const vk::Pipeline& getPipeline() const;
+		const vk::PipelineLayout& getPipelineLayout() const;
 
 	private:
 		class Impl;
@@ -1,8 +1,12 @@
 #include "vulkan-render.hpp"
 
+#include <limits>
+#include <optional>
 #include <vector>
 
 #include "../../core/logger.hpp"
+#include "vulkan-frame-ring.hpp"
+#include "vulkan-gpu-culling.hpp"
 #include "vulkan-image.hpp"
 #include "vulkan-pipeline.hpp"
 #include "vulkan-render-pass.hpp"
@@ -25,7 +29,6 @@ namespace poc {
 
 		return VulkanImage(
 			commandPool,
-			physicalDevice,
 			device,
 			swapchain.getFormat(),
 			width,
@@ -53,7 +56,6 @@ namespace poc {
 
 		return VulkanImage(
 			commandPool,
-			physicalDevice,
 			device,
 			physicalDevice.getDepthFormat(),
 			width,
@@ -103,16 +105,59 @@ namespace poc {
 		return frameBuffers;
 	}
 
+	static std::vector<VulkanPipeline> createPipelines(
+		const VulkanPhysicalDevice& physicalDevice,
+		const VulkanDevice& device,
+		const VulkanSwapchain& swapchain,
+		const VulkanRenderPass& renderPass,
+		const DrawMode drawMode,
+		const std::optional<VulkanGpuCulling>& gpuCulling = std::nullopt) {
+
+		if (drawMode == DrawMode::GPU_DRIVEN && !gpuCulling) {
+			return {};
+		}
+
+		// one pipeline per vertex format, indexed by the format value
+		// the GPU driven ones read the objects from the storage buffers of the culling
+		const vk::DescriptorSetLayout objectSetLayout = gpuCulling ? gpuCulling->getObjectSetLayout() : vk::DescriptorSetLayout();
+		std::vector<VulkanPipeline> pipelines;
+		pipelines.reserve(vertexFormats.size());
+		for (const VertexFormat format : vertexFormats) {
+			pipelines.emplace_back(physicalDevice, device, swapchain, renderPass, format, drawMode, objectSetLayout);
+		}
+		return pipelines;
+	}
+
+	static std::optional<VulkanGpuCulling> createGpuCulling(
+		const VulkanPhysicalDevice& physicalDevice,
+		const VulkanDevice& device,
+		const uint32_t frameCount) {
+
+		if (!device.supportsGpuDrivenRendering()) {
+			return std::nullopt;
+		}
+		return std::optional<VulkanGpuCulling>(std::in_place, physicalDevice, device, frameCount);
+	}
+
 	class VulkanRender::Impl {
 	public:
 
 		const VulkanSwapchain swapchain;
 		const VulkanRenderPass renderPass;
-		const VulkanPipeline pipeline;
+		const std::vector<VulkanPipeline> pipelines;
+		const std::vector<VulkanPipeline> instancedPipelines;
 
 		uint32_t currentFrame{ 0 };
 		const uint32_t maxBufferingFrames;
 
+		// per frame data, the region of a frame is recycled once its fence signaled
+		VulkanFrameRing frameRing;
+
+		// culling & indirect draws of the scene objects when the device supports them
+		std::optional<VulkanGpuCulling> gpuCulling;
+		const std::vector<VulkanPipeline> indirectPipelines;
+		FrameStats gpuFrameStats{};
+
 		const VulkanImage colorImage;
 		const VulkanImageView colorImageView;
 
@@ -136,8 +181,12 @@ namespace poc {
 			const vk::SwapchainKHR& oldSwapchain) :
 			swapchain(VulkanSwapchain(window, physicalDevice, device, surface, oldSwapchain)),
 			renderPass(VulkanRenderPass(physicalDevice, device, swapchain)),
-			pipeline(VulkanPipeline(physicalDevice, device, swapchain, renderPass)),
+			pipelines(createPipelines(physicalDevice, device, swapchain, renderPass, DrawMode::PER_DRAW)),
+			instancedPipelines(createPipelines(physicalDevice, device, swapchain, renderPass, DrawMode::INSTANCED)),
 			maxBufferingFrames(swapchain.getNumberOfImages()),
+			frameRing(physicalDevice, device, maxBufferingFrames),
+			gpuCulling(createGpuCulling(physicalDevice, device, maxBufferingFrames)),
+			indirectPipelines(createPipelines(physicalDevice, device, swapchain, renderPass, DrawMode::GPU_DRIVEN, gpuCulling)),
 			colorImage(createColorImage(commandPool, physicalDevice, device, swapchain)),
 			colorImageView(createColorImageView(device.getDevice(), colorImage)),
 			depthImage(createDepthImage(commandPool, physicalDevice, device, swapchain)),
@@ -152,9 +201,13 @@ namespace poc {
 			Logger::info(logTag, "Vulkan render initialized");
 		}
 
-		bool render(const VulkanDevice& device, const VulkanScene& scene) {
+		bool render(
+			const VulkanDevice& device,
+			const VulkanScene& vScene,
+			const Scene& scene,
+			const DrawCollector& drawCollector) {
 			try {
-				if (doRender(device, scene)) {
+				if (doRender(device, vScene, scene, drawCollector)) {
 					return true;
 				}
 			}
@@ -165,7 +218,11 @@ namespace poc {
 			return false;
 		}
 
-		bool doRender(const VulkanDevice& device, const VulkanScene& scene) {
+		bool doRender(
+			const VulkanDevice& device,
+			const VulkanScene& vScene,
+			const Scene& scene,
+			const DrawCollector& drawCollector) {
 
 			const vk::Fence frameFence{ *frameFences[currentFrame] };
 			const vk::Semaphore imageSemaphore{ *imageAcquisitionSemaphores[currentFrame] };
@@ -173,6 +230,11 @@ namespace poc {
 
 			// ensure the number of frames is not exceeding the number of images in the swapchain
 			device.getDevice().waitForFences(1, &frameFence, VK_TRUE, UINT64_MAX);
+			frameRing.beginFrame(currentFrame);
+
+			if (gpuCulling) {
+				gpuFrameStats = gpuCulling->readFrameStats(currentFrame);
+			}
 
 			const auto [result, currentImage] = device.getDevice().acquireNextImageKHR(swapchain.getSwapchain(), UINT64_MAX, imageSemaphore, nullptr);
 
@@ -192,6 +254,11 @@ namespace poc {
 			const auto beginInfo = vk::CommandBufferBeginInfo().setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
 			commandbuffer.begin(beginInfo);
 
+			if (gpuCulling) {
+				const float viewportHeight = static_cast<float>(swapchain.getExtent().height);
+				gpuCulling->record(device, frameRing, commandbuffer, currentFrame, vScene, scene, viewportHeight, drawCollector.getLodSettings());
+			}
+
 			std::array<vk::ClearValue, 2> clearValues{
 				vk::ClearColorValue{std::array<float, 4>{ 0.0f, 0.0f, 0.0f, 1.0f }},
 				vk::ClearDepthStencilValue{ 1.0f, 0 }
@@ -205,11 +272,13 @@ namespace poc {
 				.setPClearValues(clearValues.data());
 
 			commandbuffer.beginRenderPass(renderPassBeginInfo, vk::SubpassContents::eInline);
-			commandbuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline.getPipeline());
+			commandbuffer.bindIndexBuffer(vScene.getIndexBuffer().getBuffer(), 0, vScene.getIndexType());
 
-			vk::DeviceSize offsets{ 0 };
-			commandbuffer.bindVertexBuffers(0, 1, &scene.getVertexBuffer().getBuffer(), &offsets);
-			commandbuffer.draw(scene.getVertexCount(), 1, 0, 0);
+			// the packets only hold the instanced draws when the culling is GPU driven
+			if (gpuCulling) {
+				recordIndirectDraws(device, commandbuffer, vScene, scene);
+			}
+			recordPackets(commandbuffer, vScene, scene, drawCollector);
 
 			commandbuffer.endRenderPass();
 			commandbuffer.end();
@@ -244,6 +313,81 @@ namespace poc {
 			return true;
 		}
 
+		// replays the sorted packets, the pipelines, vertex buffers & constants are only bound when they change
+		void recordPackets(const vk::CommandBuffer& commandBuffer, const VulkanScene& vScene, const Scene& scene, const DrawCollector& drawCollector) const {
+			constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+			const span<const MeshRange> meshes = scene.getMeshes();
+			const span<const InstanceBatch> batches = scene.getInstanceBatches();
+			const TransformHierarchy& transforms = scene.getTransforms();
+			const glm::mat4& viewProjection = scene.getCamera().getViewProjection();
+
+			const VulkanPipeline* pipeline = nullptr;
+			uint32_t boundPipeline = none;
+			uint32_t boundMesh = none;
+			uint32_t boundNode = none;
+			for (const DrawPacket& packet : drawCollector.getPackets()) {
+				const uint32_t packetPipeline = SortKey::getPipeline(packet.key);
+				const VertexFormat format = SortKey::getFormat(packetPipeline);
+				const bool instanced = SortKey::isInstanced(packetPipeline);
+				if (packetPipeline != boundPipeline) {
+					pipeline = instanced ? &instancedPipelines[static_cast<size_t>(format)] : &pipelines[static_cast<size_t>(format)];
+					commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline->getPipeline());
+
+					const std::array<vk::Buffer, 2> buffers{ vScene.getVertexBuffer(format).getBuffer(), instanced ? vScene.getInstanceBuffer().getBuffer() : vk::Buffer() };
+					const std::array<vk::DeviceSize, 2> offsets{ 0, 0 };
+					commandBuffer.bindVertexBuffers(0, instanced ? 2 : 1, buffers.data(), offsets.data());
+
+					boundPipeline = packetPipeline;
+					boundMesh = none;
+					boundNode = none;
+				}
+
+				if (instanced) {
+					// the instances carry their transforms, the constants only change with the mesh
+					const InstancedDraw& draw = drawCollector.getInstancedDraws(format)[packet.payload];
+					const InstanceBatch& batch = batches[draw.batch];
+					const MeshRange& mesh = meshes[batch.mesh];
+					if (batch.mesh != boundMesh) {
+						const DrawConstants constants{ viewProjection, mesh.dequantization };
+						commandBuffer.pushConstants(pipeline->getPipelineLayout(), vk::ShaderStageFlagBits::eVertex, 0, sizeof(DrawConstants), &constants);
+						boundMesh = batch.mesh;
+					}
+					commandBuffer.drawIndexed(draw.indexCount, batch.instanceCount, draw.firstIndex, static_cast<int32_t>(mesh.firstVertex), batch.firstInstance);
+				}
+				else {
+					// the meshlet draws of an entity follow each other and share its constants
+					const Draw& draw = drawCollector.getDraws(format)[packet.payload];
+					const MeshRange& mesh = meshes[draw.mesh];
+					if (draw.mesh != boundMesh || draw.node.id != boundNode) {
+						const DrawConstants constants{ viewProjection * transforms.getWorldMatrix(draw.node), mesh.dequantization };
+						commandBuffer.pushConstants(pipeline->getPipelineLayout(), vk::ShaderStageFlagBits::eVertex, 0, sizeof(DrawConstants), &constants);
+						boundMesh = draw.mesh;
+						boundNode = draw.node.id;
+					}
+					commandBuffer.drawIndexed(draw.indexCount, 1, draw.firstIndex, static_cast<int32_t>(mesh.firstVertex), 0);
+				}
+			}
+		}
+
+		// one indirect draw per vertex format, the culling shader wrote the commands of the visible objects
+		void recordIndirectDraws(const VulkanDevice& device, const vk::CommandBuffer& commandBuffer, const VulkanScene& vScene, const Scene& scene) const {
+			const IndirectDrawConstants constants{ scene.getCamera().getViewProjection() };
+			for (const VertexFormat format : vertexFormats) {
+				if (!vScene.hasVertexBuffer(format)) {
+					continue;
+				}
+
+				const VulkanPipeline& pipeline = indirectPipelines[static_cast<size_t>(format)];
+				commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline.getPipeline());
+				gpuCulling->bindObjects(commandBuffer, currentFrame, pipeline.getPipelineLayout());
+				commandBuffer.pushConstants(pipeline.getPipelineLayout(), vk::ShaderStageFlagBits::eVertex, 0, sizeof(IndirectDrawConstants), &constants);
+
+				vk::DeviceSize offsets{ 0 };
+				commandBuffer.bindVertexBuffers(0, 1, &vScene.getVertexBuffer(format).getBuffer(), &offsets);
+				gpuCulling->draw(device, commandBuffer, currentFrame, format);
+			}
+		}
+
 	};
 
 	VulkanRender::VulkanRender(
@@ -255,8 +399,20 @@ namespace poc {
 		const vk::SwapchainKHR& oldSwapchain) :
 		pimpl(make_unique_pimpl<VulkanRender::Impl>(window, physicalDevice, device, surface, commandPool, oldSwapchain)) { }
 
-	bool VulkanRender::render(const VulkanDevice& device, const VulkanScene& scene) const {
-		return pimpl->render(device, scene);
+	bool VulkanRender::render(
+		const VulkanDevice& device,
+		const VulkanScene& vScene,
+		const Scene& scene,
+		const DrawCollector& drawCollector) const {
+		return pimpl->render(device, vScene, scene, drawCollector);
+	}
+
+	bool VulkanRender::isGpuDriven() const {
+		return pimpl->gpuCulling.has_value();
+	}
+
+	const FrameStats& VulkanRender::getGpuFrameStats() const {
+		return pimpl->gpuFrameStats;
 	}
 
 	VulkanRender VulkanRender::recreate(
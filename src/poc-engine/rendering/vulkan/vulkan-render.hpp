@@ -4,6 +4,7 @@
 #include "../../core/scene.hpp"
 #include "../../plateform/platform.hpp"
 #include "../../plateform/window.hpp"
+#include "../draw-collector.hpp"
 #include "vulkan-command-pool.hpp"
 #include "vulkan-device.hpp"
 #include "vulkan-physical-device.hpp"
@@ -23,7 +24,16 @@ namespace poc {
 			const VulkanCommandPool& commandPool,
 			const vk::SwapchainKHR& oldSwapchain = nullptr);
 
-		bool render(const VulkanDevice& device, const VulkanScene& scene) const;
+		// the draws of the collector are submitted, or the scene is culled on the GPU with the LOD settings of the collector
+		bool render(
+			const VulkanDevice& device,
+			const VulkanScene& vScene,
+			const Scene& scene,
+			const DrawCollector& drawCollector) const;
+
+		bool isGpuDriven() const;
+		// statistics of the last GPU culling read back, some frames late
+		const FrameStats& getGpuFrameStats() const;
 
 		VulkanRender recreate(
 			const Window& window,
@@ -0,0 +1,203 @@
+#include "vulkan-scene-cache.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../../core/logger.hpp"
+#include "../residency.hpp"
+
+using namespace poc;
+
+namespace poc {
+
+	static constexpr char logTag[]{ "POC::VulkanSceneCache" };
+
+	// generation of the last completed upload of a resident scene, the batches of the next ones with their generation
+	struct SceneUploads {
+		uint64_t generation{ 0 };
+		std::deque<std::pair<uint64_t, uint64_t>> pending;
+	};
+
+	class VulkanSceneCache::Impl {
+	public:
+
+		const VulkanScene& getResidentScene(
+			const VulkanDevice& device,
+			VulkanStagingRing& stagingRing,
+			const Scene& scene) {
+
+			releaseRetiredScenes(stagingRing);
+			++frame;
+
+			const auto it = residentScenes.find(scene.getId());
+			const bool upToDate = it != residentScenes.end() && it->second.isUpToDate(scene);
+			// grown by appends, e.g. streamed meshes: only the appended data is uploaded
+			const bool appended = it != residentScenes.end() && !upToDate && it->second.canAppend(scene);
+			if (upToDate || appended) {
+				residency.touch(scene.getId(), frame);
+			}
+
+			// outdated copy, previous buffers may still be read by frames in flight
+			std::vector<VulkanScene> retiringScenes;
+			if (it != residentScenes.end() && !upToDate && !appended) {
+				retiringScenes.push_back(std::move(it->second));
+				residentScenes.erase(it);
+				residency.remove(scene.getId());
+				uploads.erase(scene.getId());
+			}
+
+			const vk::DeviceSize sceneSize = upToDate ? 0 : VulkanScene::computeSize(scene);
+			const vk::DeviceSize residentSize = appended ? it->second.getSize() : 0;
+			evictOverBudget(device, sceneSize - std::min(sceneSize, residentSize), retiringScenes);
+
+			if (upToDate) {
+				if (!retiringScenes.empty()) {
+					retire(stagingRing, retiringScenes, {});
+				}
+				return it->second;
+			}
+
+			if (appended) {
+				VulkanScene& residentScene = it->second;
+				std::vector<VulkanBuffer> outgrownBuffers = residentScene.append(device, stagingRing, scene);
+				residency.remove(scene.getId());
+				residency.add(scene.getId(), ResourceCategory::GEOMETRY, residentScene.getSize(), frame);
+				const uint64_t batch = retire(stagingRing, retiringScenes, std::move(outgrownBuffers));
+				uploads[scene.getId()].pending.emplace_back(batch, scene.getGeneration());
+				uploadCount++;
+
+				Logger::debug(logTag, "Scene " + std::to_string(scene.getId()) + " appended (generation " + std::to_string(scene.getGeneration()) + ")");
+				return residentScene;
+			}
+
+			const VulkanScene& residentScene = residentScenes.emplace(scene.getId(), VulkanScene(device, stagingRing, scene)).first->second;
+			residency.add(scene.getId(), ResourceCategory::GEOMETRY, residentScene.getSize(), frame);
+			const uint64_t batch = retire(stagingRing, retiringScenes, {});
+			uploads[scene.getId()].pending.emplace_back(batch, scene.getGeneration());
+			uploadCount++;
+
+			Logger::debug(logTag, "Scene " + std::to_string(scene.getId()) + " uploaded (generation " + std::to_string(scene.getGeneration()) + ")");
+			return residentScene;
+		}
+
+		uint64_t getResidentGeneration(VulkanStagingRing& stagingRing, const Scene& scene) {
+			const auto it = residentScenes.find(scene.getId());
+			if (it == residentScenes.end() || it->second.getGeneration(scene) == 0) {
+				return 0;
+			}
+
+			// the batches complete in order
+			SceneUploads& sceneUploads = uploads[scene.getId()];
+			while (!sceneUploads.pending.empty() && stagingRing.isComplete(sceneUploads.pending.front().first)) {
+				sceneUploads.generation = sceneUploads.pending.front().second;
+				sceneUploads.pending.pop_front();
+			}
+			return sceneUploads.generation;
+		}
+
+		uint32_t uploadCount{ 0 };
+		uint32_t evictionCount{ 0 };
+
+	private:
+		std::unordered_map<uint64_t, VulkanScene> residentScenes;
+		std::unordered_map<uint64_t, SceneUploads> uploads;
+		ResidencyTracker residency;
+		// incremented by each getResidentScene
+		uint64_t frame{ 0 };
+		// warned once until the heap is back within its budget
+		bool overBudget{ false };
+		// replaced & evicted scenes, outgrown buffers of the appended ones, with the upload batch completing
+		// after their last frame
+		std::vector<std::pair<uint64_t, VulkanScene>> retiredScenes;
+		std::vector<std::pair<uint64_t, VulkanBuffer>> retiredBuffers;
+
+		// submits the current batch, the frames drawing the scenes were submitted before it: the scenes & buffers
+		// are released once it completed; returns the batch
+		uint64_t retire(VulkanStagingRing& stagingRing, std::vector<VulkanScene>& scenes, std::vector<VulkanBuffer> buffers) {
+			const uint64_t batch = stagingRing.submit();
+			for (VulkanScene& retiredScene : scenes) {
+				retiredScenes.emplace_back(batch, std::move(retiredScene));
+			}
+			for (VulkanBuffer& retiredBuffer : buffers) {
+				retiredBuffers.emplace_back(batch, std::move(retiredBuffer));
+			}
+			return batch;
+		}
+
+		void releaseRetiredScenes(VulkanStagingRing& stagingRing) {
+			retiredScenes.erase(std::remove_if(retiredScenes.begin(), retiredScenes.end(), [&stagingRing](const std::pair<uint64_t, VulkanScene>& retired) {
+				return stagingRing.isComplete(retired.first);
+			}), retiredScenes.end());
+			retiredBuffers.erase(std::remove_if(retiredBuffers.begin(), retiredBuffers.end(), [&stagingRing](const std::pair<uint64_t, VulkanBuffer>& retired) {
+				return stagingRing.isComplete(retired.first);
+			}), retiredBuffers.end());
+		}
+
+		// the least recently drawn scenes leave the device local heap until the upload fits in its budget,
+		// the scenes drawn by the current frame are kept
+		void evictOverBudget(const VulkanDevice& device, vk::DeviceSize uploadSize, std::vector<VulkanScene>& retiringScenes) {
+			const VulkanMemoryAllocator& allocator = device.getMemoryAllocator();
+			const VulkanHeapBudget heap = allocator.getHeapBudgets()[allocator.getHeapIndex(vk::MemoryPropertyFlagBits::eDeviceLocal)];
+
+			// retired & replaced scenes & buffers are released in a few frames
+			const vk::DeviceSize leavingSize = std::accumulate(retiredScenes.begin(), retiredScenes.end(), vk::DeviceSize(0),
+				[](vk::DeviceSize size, const std::pair<uint64_t, VulkanScene>& retired) { return size + retired.second.getSize(); })
+				+ std::accumulate(retiredBuffers.begin(), retiredBuffers.end(), vk::DeviceSize(0),
+				[](vk::DeviceSize size, const std::pair<uint64_t, VulkanBuffer>& retired) { return size + retired.second.getSize(); })
+				+ std::accumulate(retiringScenes.begin(), retiringScenes.end(), vk::DeviceSize(0),
+				[](vk::DeviceSize size, const VulkanScene& retiring) { return size + retiring.getSize(); });
+			if (heap.usage + uploadSize <= heap.budget + leavingSize) {
+				overBudget = false;
+				return;
+			}
+
+			const vk::DeviceSize overBudgetSize = heap.usage + uploadSize - heap.budget - leavingSize;
+			vk::DeviceSize evictedSize = 0;
+			for (const uint64_t sceneId : residency.selectEvictions(overBudgetSize, frame - 1)) {
+				auto evicted = residentScenes.find(sceneId);
+				evictedSize += evicted->second.getSize();
+				retiringScenes.push_back(std::move(evicted->second));
+				residentScenes.erase(evicted);
+				residency.remove(sceneId);
+				uploads.erase(sceneId);
+				evictionCount++;
+				Logger::info(logTag, "Scene " + std::to_string(sceneId) + " evicted, device local heap: "
+					+ std::to_string(heap.usage >> 20) + " MB used of " + std::to_string(heap.budget >> 20) + " MB");
+			}
+
+			if (evictedSize < overBudgetSize && !overBudget) {
+				overBudget = true;
+				Logger::warn(logTag, "Device local heap over budget by " + std::to_string((overBudgetSize - evictedSize) >> 20) + " MB, nothing left to evict");
+			}
+		}
+
+	};
+
+	VulkanSceneCache::VulkanSceneCache() :
+		pimpl(make_unique_pimpl<VulkanSceneCache::Impl>()) {}
+
+	const VulkanScene& VulkanSceneCache::getResidentScene(
+		const VulkanDevice& device,
+		VulkanStagingRing& stagingRing,
+		const Scene& scene) {
+		return pimpl->getResidentScene(device, stagingRing, scene);
+	}
+
+	uint32_t VulkanSceneCache::getUploadCount() const {
+		return pimpl->uploadCount;
+	}
+
+	uint32_t VulkanSceneCache::getEvictionCount() const {
+		return pimpl->evictionCount;
+	}
+
+	uint64_t VulkanSceneCache::getResidentGeneration(VulkanStagingRing& stagingRing, const Scene& scene) {
+		return pimpl->getResidentGeneration(stagingRing, scene);
+	}
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "../../core/pimpl_ptr.hpp"
+#include "../../core/scene.hpp"
+#include "../../plateform/platform.hpp"
+
+#include "vulkan-device.hpp"
+#include "vulkan-scene.hpp"
+#include "vulkan-staging-ring.hpp"
+
+namespace poc {
+
+	/*
+	 * Keep the GPU copies of the rendered scenes alive across frames.
+	 *
+	 * A resident VulkanScene is keyed by the scene id and generation: it is only
+	 * updated when the scene has been modified since the last upload. A scene grown
+	 * by appends (streamed meshes) only uploads the appended data to its copy, other
+	 * modifications rebuild it (new buffers + transfer). The copies of several scenes stay resident while the device local
+	 * heap is within its budget, otherwise the least recently drawn ones are evicted
+	 * & uploaded again when drawn. The replaced & evicted buffers are destroyed once
+	 * the frames in flight reading them completed.
+	 */
+	class VulkanSceneCache {
+	public:
+
+		explicit VulkanSceneCache();
+
+		// called once per frame: the scene is drawn by the frame
+		const VulkanScene& getResidentScene(
+			const VulkanDevice& device,
+			VulkanStagingRing& stagingRing,
+			const Scene& scene);
+
+		uint32_t getUploadCount() const;
+		uint32_t getEvictionCount() const;
+
+		// generation of the last upload of the scene whose staging batch fence signaled, 0 when it is not resident
+		uint64_t getResidentGeneration(VulkanStagingRing& stagingRing, const Scene& scene);
+
+	private:
+		class Impl;
+		pimpl_ptr<Impl> pimpl;
+	};
+
+}
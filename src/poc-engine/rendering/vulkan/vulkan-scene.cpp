@@ -1,55 +1,231 @@
 #include "vulkan-scene.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "../gpu-culling.hpp"
+
 namespace poc {
 
-	static VulkanBuffer createVertexBuffer(
-		const VulkanPhysicalDevice& physicalDevice,
+	// device copy of a scene arena, uploaded up to size, room up to capacity for the appended data
+	struct SceneArena {
+		std::optional<VulkanBuffer> buffer;
+		vk::DeviceSize capacity{ 0 };
+		vk::DeviceSize size{ 0 };
+	};
+
+	static vk::IndexType selectIndexType(const Scene& scene) {
+		// indices are relative to their mesh, 16 bits are enough when every mesh fits in 65536 vertices
+		return scene.getMaxMeshVertexCount() <= std::numeric_limits<uint16_t>::max() + 1u
+			? vk::IndexType::eUint16
+			: vk::IndexType::eUint32;
+	}
+
+	// the first buffer fits the arena, a full one is replaced by a buffer twice as large: its content is
+	// copied on the GPU & the replaced buffer is outgrown, read by the frames in flight
+	static void reserveArena(
 		const VulkanDevice& device,
-		const VulkanCommandPool& commandPool,
-		const Scene& scene) {
+		VulkanStagingRing& stagingRing,
+		SceneArena& arena,
+		vk::DeviceSize size,
+		const vk::BufferUsageFlags& usage,
+		std::vector<VulkanBuffer>& outgrown) {
 
-		const auto size = vk::DeviceSize(sizeof(Vertex) * scene.getVertexCount());
-		assert(size > 0);
+		if (size <= arena.capacity) {
+			return;
+		}
 
-		return VulkanBuffer::createDeviceLocalBuffer(
-			physicalDevice,
+		const vk::DeviceSize capacity = arena.buffer ? std::max(size, arena.capacity * 2) : size;
+		VulkanBuffer buffer(
 			device,
-			commandPool,
-			size,
-			vk::BufferUsageFlagBits::eVertexBuffer,
-			scene.getVertexes().data());
+			capacity,
+			vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eTransferSrc | usage,
+			vk::MemoryPropertyFlagBits::eDeviceLocal,
+			nullptr,
+			ResourceCategory::GEOMETRY);
+
+		if (arena.buffer) {
+			stagingRing.copy(arena.buffer->getBuffer(), buffer.getBuffer(), arena.size);
+			outgrown.push_back(std::move(*arena.buffer));
+		}
+		arena.buffer.emplace(std::move(buffer));
+		arena.capacity = capacity;
+	}
+
+	// tail: the bytes of the arena from its uploaded size to size, only them are uploaded
+	static void appendArena(
+		const VulkanDevice& device,
+		VulkanStagingRing& stagingRing,
+		SceneArena& arena,
+		const void* tail,
+		vk::DeviceSize size,
+		const vk::BufferUsageFlags& usage,
+		std::vector<VulkanBuffer>& outgrown) {
+
+		assert(size >= arena.size && "arena not grown by appends");
+		if (size == arena.size) {
+			return;
+		}
+
+		reserveArena(device, stagingRing, arena, size, usage, outgrown);
+		stagingRing.upload(arena.buffer->getBuffer(), arena.size, tail, size - arena.size);
+		arena.size = size;
+	}
+
+	// the scene arenas are contiguous, they are uploaded without intermediate copy
+	template<class T>
+	static void appendArena(
+		const VulkanDevice& device,
+		VulkanStagingRing& stagingRing,
+		SceneArena& arena,
+		span<const T> items,
+		const vk::BufferUsageFlags& usage,
+		std::vector<VulkanBuffer>& outgrown) {
+
+		const size_t first = static_cast<size_t>(arena.size / sizeof(T));
+		appendArena(device, stagingRing, arena, items.data() + first, vk::DeviceSize(items.size_bytes()), usage, outgrown);
 	}
 
 	class VulkanScene::Impl {
 	public:
 
-		Impl(const VulkanPhysicalDevice& physicalDevice,
-			const VulkanDevice& device,
-			const VulkanCommandPool& commandPool,
+		Impl(const VulkanDevice& device,
+			VulkanStagingRing& stagingRing,
 			const Scene& scene) :
-			vertexCount(scene.getVertexCount()),
-			vertexBuffer(createVertexBuffer(physicalDevice, device, commandPool, scene)) {
+			sceneId(scene.getId()),
+			lineage(scene.getLineage()),
+			indexType(selectIndexType(scene)) {
+
+			// nothing is outgrown by the first buffers
+			std::vector<VulkanBuffer> outgrown;
+			append(device, stagingRing, scene, outgrown);
+		}
+
+		void append(const VulkanDevice& device, VulkanStagingRing& stagingRing, const Scene& scene, std::vector<VulkanBuffer>& outgrown) {
+			appendArena(device, stagingRing, vertices, scene.getVertices(), vk::BufferUsageFlagBits::eVertexBuffer, outgrown);
+			appendArena(device, stagingRing, packedVertices, scene.getPackedVertices(), vk::BufferUsageFlagBits::eVertexBuffer, outgrown);
+			appendIndices(device, stagingRing, scene, outgrown);
+
+			const uint32_t firstMesh = static_cast<uint32_t>(meshes.size / sizeof(GpuMesh));
+			const std::vector<GpuMesh> gpuMeshes = GpuCulling::makeMeshes(scene, firstMesh);
+			appendArena(device, stagingRing, meshes, gpuMeshes.data(), meshes.size + sizeof(GpuMesh) * gpuMeshes.size(), vk::BufferUsageFlagBits::eStorageBuffer, outgrown);
+
+			appendArena(device, stagingRing, instances, scene.getInstances(), vk::BufferUsageFlagBits::eVertexBuffer, outgrown);
+
+			sceneGeneration = scene.getGeneration();
+			vertexCount = scene.getVertexCount();
+		}
+
+		// same lineage: the uploaded arenas are a prefix of the scene ones
+		bool canAppend(const Scene& scene) const {
+			return sceneId == scene.getId() && lineage == scene.getLineage() && indexType == selectIndexType(scene);
+		}
 
+		vk::DeviceSize getSize() const {
+			return vertices.capacity + packedVertices.capacity + indices.capacity + meshes.capacity + instances.capacity;
 		}
 
-		uint32_t vertexCount;
-		VulkanBuffer vertexBuffer;
+		uint64_t sceneId;
+		uint64_t lineage;
+		uint64_t sceneGeneration{ 0 };
+		uint32_t vertexCount{ 0 };
+		vk::IndexType indexType;
+		SceneArena vertices;
+		SceneArena packedVertices;
+		SceneArena indices;
+		// GpuMesh of each mesh range
+		SceneArena meshes;
+		SceneArena instances;
+
+	private:
+
+		void appendIndices(const VulkanDevice& device, VulkanStagingRing& stagingRing, const Scene& scene, std::vector<VulkanBuffer>& outgrown) {
+			const span<const uint32_t> sceneIndices = scene.getIndices();
+			if (indexType == vk::IndexType::eUint32) {
+				appendArena(device, stagingRing, indices, sceneIndices, vk::BufferUsageFlagBits::eIndexBuffer, outgrown);
+				return;
+			}
+
+			// only the appended indices are narrowed
+			const size_t first = static_cast<size_t>(indices.size / sizeof(uint16_t));
+			const std::vector<uint16_t> shortIndices(sceneIndices.begin() + first, sceneIndices.end());
+			appendArena(device, stagingRing, indices, shortIndices.data(), vk::DeviceSize(sizeof(uint16_t) * sceneIndices.size()), vk::BufferUsageFlagBits::eIndexBuffer, outgrown);
+		}
 
 	};
 
 	VulkanScene::VulkanScene(
-		const VulkanPhysicalDevice& physicalDevice,
 		const VulkanDevice& device,
-		const VulkanCommandPool& commandPool,
+		VulkanStagingRing& stagingRing,
 		const Scene& scene) :
-		pimpl(make_unique_pimpl<VulkanScene::Impl>(physicalDevice, device, commandPool, scene)) {}
+		pimpl(make_unique_pimpl<VulkanScene::Impl>(device, stagingRing, scene)) {}
+
+	bool VulkanScene::isUpToDate(const Scene& scene) const {
+		return pimpl->sceneId == scene.getId() && pimpl->sceneGeneration == scene.getGeneration();
+	}
+
+	uint64_t VulkanScene::getGeneration(const Scene& scene) const {
+		return pimpl->sceneId == scene.getId() ? pimpl->sceneGeneration : 0;
+	}
+
+	bool VulkanScene::canAppend(const Scene& scene) const {
+		return pimpl->canAppend(scene);
+	}
+
+	std::vector<VulkanBuffer> VulkanScene::append(const VulkanDevice& device, VulkanStagingRing& stagingRing, const Scene& scene) {
+		assert(canAppend(scene) && "scene arenas replaced");
+		std::vector<VulkanBuffer> outgrown;
+		pimpl->append(device, stagingRing, scene, outgrown);
+		return outgrown;
+	}
 
 	uint32_t VulkanScene::getVertexCount() const {
 		return pimpl->vertexCount;
 	}
 
-	const VulkanBuffer& VulkanScene::getVertexBuffer() const {
-		return pimpl->vertexBuffer;
+	vk::DeviceSize VulkanScene::getSize() const {
+		return pimpl->getSize();
+	}
+
+	vk::DeviceSize VulkanScene::computeSize(const Scene& scene) {
+		const vk::DeviceSize indexSize = selectIndexType(scene) == vk::IndexType::eUint16 ? sizeof(uint16_t) : sizeof(uint32_t);
+		return vk::DeviceSize(scene.getVertices().size_bytes())
+			+ scene.getPackedVertices().size_bytes()
+			+ indexSize * scene.getIndices().size()
+			+ sizeof(GpuMesh) * scene.getMeshes().size()
+			+ scene.getInstances().size_bytes();
+	}
+
+	bool VulkanScene::hasVertexBuffer(VertexFormat format) const {
+		return (format == VertexFormat::FLOAT32 ? pimpl->vertices : pimpl->packedVertices).buffer.has_value();
+	}
+
+	const VulkanBuffer& VulkanScene::getVertexBuffer(VertexFormat format) const {
+		// both packed formats share the same 12 bytes layout, only the pipeline interpretation differs
+		const std::optional<VulkanBuffer>& buffer = (format == VertexFormat::FLOAT32 ? pimpl->vertices : pimpl->packedVertices).buffer;
+		assert(buffer.has_value() && "no vertex in this format");
+		return *buffer;
+	}
+
+	const VulkanBuffer& VulkanScene::getIndexBuffer() const {
+		assert(pimpl->indices.buffer.has_value() && "no index in the scene");
+		return *pimpl->indices.buffer;
+	}
+
+	vk::IndexType VulkanScene::getIndexType() const {
+		return pimpl->indexType;
+	}
+
+	const VulkanBuffer& VulkanScene::getMeshBuffer() const {
+		assert(pimpl->meshes.buffer.has_value() && "no mesh in the scene");
+		return *pimpl->meshes.buffer;
+	}
+
+	const VulkanBuffer& VulkanScene::getInstanceBuffer() const {
+		assert(pimpl->instances.buffer.has_value() && "no instance in the scene");
+		return *pimpl->instances.buffer;
 	}
 
-}
\ No newline at end of file
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "../../core/pimpl_ptr.hpp"
 #include "../../core/scene.hpp"
 #include "../../plateform/platform.hpp"
@@ -8,17 +10,51 @@
 
 namespace poc {
 
+	/*
+	 * GPU copy of the scene arenas, one buffer per arena.
+	 *
+	 * A scene grown by appends, e.g. streamed meshes, is updated in place: only the appended data is
+	 * uploaded. A full buffer is replaced by one twice as large, the content copied on the GPU, so the
+	 * bytes uploaded stay linear in the size of the scene.
+	 */
 	class VulkanScene {
 	public:
 
+		// the buffers are uploaded in the current batch of the staging ring
 		explicit VulkanScene(
-			const VulkanPhysicalDevice& physicalDevice,
 			const VulkanDevice& device,
-			const VulkanCommandPool& commandPool,
+			VulkanStagingRing& stagingRing,
 			const Scene& scene);
 
+		bool isUpToDate(const Scene& scene) const;
+
+		// generation of the scene when it was uploaded, 0 when this is the copy of another scene
+		uint64_t getGeneration(const Scene& scene) const;
+
+		// the scene only grew by appends since the upload & keeps its index type
+		bool canAppend(const Scene& scene) const;
+
+		// uploads the data appended to the arenas in the current batch of the staging ring, returns the
+		// replaced buffers: the frames in flight still read them
+		std::vector<VulkanBuffer> append(const VulkanDevice& device, VulkanStagingRing& stagingRing, const Scene& scene);
+
 		uint32_t getVertexCount() const;
-		const VulkanBuffer& getVertexBuffer() const;
+
+		// bytes of the buffers, room for the appends included, alignment padding excluded
+		vk::DeviceSize getSize() const;
+		// bytes of the buffers of the scene, known before its upload
+		static vk::DeviceSize computeSize(const Scene& scene);
+
+		bool hasVertexBuffer(VertexFormat format) const;
+		const VulkanBuffer& getVertexBuffer(VertexFormat format) const;
+		const VulkanBuffer& getIndexBuffer() const;
+		vk::IndexType getIndexType() const;
+
+		// GpuMesh of each mesh range, read by the culling & indirect vertex shaders
+		const VulkanBuffer& getMeshBuffer() const;
+
+		// Instance of all the instance batches, bound after the vertices of the instanced draws
+		const VulkanBuffer& getInstanceBuffer() const;
 
 
 	private:
@@ -0,0 +1,364 @@
+#include "vulkan-staging-ring.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <optional>
+#include <vector>
+
+#include "../../core/logger.hpp"
+#include "../memory-sub-allocators.hpp"
+
+using namespace poc;
+
+namespace poc {
+
+	static constexpr char logTag[]{ "POC::VulkanStagingRing" };
+
+	// copies start on 16 bytes: the memcpy to the ring stays aligned
+	static constexpr vk::DeviceSize copyAlignment = 16;
+
+	static vk::UniqueCommandPool createCommandPool(const vk::Device& device, uint32_t queueIndex) {
+		assert(device && "device not initialized");
+
+		const auto createInfo = vk::CommandPoolCreateInfo()
+			.setFlags(vk::CommandPoolCreateFlagBits::eTransient | vk::CommandPoolCreateFlagBits::eResetCommandBuffer)
+			.setQueueFamilyIndex(queueIndex);
+
+		return device.createCommandPoolUnique(createInfo);
+	}
+
+	static vk::UniqueCommandBuffer allocateCommandBuffer(const vk::Device& device, const vk::CommandPool& commandPool) {
+		const auto allocateInfo = vk::CommandBufferAllocateInfo()
+			.setCommandPool(commandPool)
+			.setLevel(vk::CommandBufferLevel::ePrimary)
+			.setCommandBufferCount(1);
+		return std::move(device.allocateCommandBuffersUnique(allocateInfo)[0]);
+	}
+
+	static vk::UniqueBuffer createRingBuffer(const vk::Device& device, vk::DeviceSize size) {
+		assert(device && "device not initialized");
+
+		return device.createBufferUnique(
+			vk::BufferCreateInfo()
+			.setSize(size)
+			.setUsage(vk::BufferUsageFlagBits::eTransferSrc)
+			.setSharingMode(vk::SharingMode::eExclusive)
+		);
+	}
+
+	struct BufferCopy {
+		vk::Buffer source;
+		vk::Buffer destination;
+		vk::DeviceSize size;
+	};
+
+	// uploads submitted together, the ring is released up to the position once the fence signaled
+	struct UploadBatch {
+		uint64_t id;
+		uint64_t ringPosition;
+		vk::UniqueCommandBuffer commandBuffer;
+		vk::UniqueFence fence;
+		// with a transfer queue, the graphics family acquires the uploaded ranges once the semaphore signaled
+		vk::UniqueCommandBuffer acquireCommandBuffer;
+		vk::UniqueSemaphore semaphore;
+		std::vector<vk::BufferMemoryBarrier> ownershipTransfers;
+		// buffer to buffer copies run by the graphics family, after the acquisitions
+		std::vector<BufferCopy> copies;
+	};
+
+	class VulkanStagingRing::Impl {
+	public:
+
+		Impl(const VulkanDevice& device, vk::DeviceSize size) :
+			device(device.getDevice()),
+			transferQueue(device.getTransferQueue()),
+			graphicsQueue(device.getGraphicsQueue()),
+			transferQueueIndex(device.getTransferQueueIndex()),
+			graphicsQueueIndex(device.getGraphicsQueueIndex()),
+			transferCommandPool(createCommandPool(device.getDevice(), transferQueueIndex)),
+			graphicsCommandPool(hasTransferQueue() ? createCommandPool(device.getDevice(), graphicsQueueIndex) : vk::UniqueCommandPool()),
+			buffer(createRingBuffer(device.getDevice(), size)),
+			memory(device.getMemoryAllocator().allocateBuffer(*buffer, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, ResourceCategory::STAGING)),
+			ring(size) {
+
+			assert(size % 256 == 0 && "size not a multiple of 256");
+			Logger::info(logTag, "Staging ring of " + std::to_string(size >> 20) + " MB created on the " + (hasTransferQueue() ? "transfer" : "graphics") + " queue");
+		}
+
+		~Impl() {
+			// the copies in flight read the ring
+			for (const UploadBatch& batch : pending) {
+				device.waitForFences(1, &*batch.fence, VK_TRUE, UINT64_MAX);
+			}
+		}
+
+		void upload(const vk::Buffer& destination, vk::DeviceSize offset, const void* data, vk::DeviceSize size) {
+			assert(destination && "buffer not initialized");
+			assert(data && "no data");
+			if (size == 0) {
+				return;
+			}
+
+			// a chunk never takes the whole ring: the next uploads are recorded while the previous batches are in flight
+			const vk::DeviceSize maxChunkSize = ring.getSize() / 4;
+			const std::byte* source = static_cast<const std::byte*>(data);
+			for (vk::DeviceSize copied = 0; copied < size;) {
+				const vk::DeviceSize chunkSize = std::min(size - copied, maxChunkSize);
+				const uint64_t ringOffset = allocate(chunkSize);
+				std::memcpy(memory.getMappedData() + ringOffset, source + copied, static_cast<size_t>(chunkSize));
+
+				const auto copy = vk::BufferCopy().setSrcOffset(ringOffset).setDstOffset(offset + copied).setSize(chunkSize);
+				getCommandBuffer().copyBuffer(*buffer, destination, 1, &copy);
+				copied += chunkSize;
+			}
+
+			if (hasTransferQueue()) {
+				recording->ownershipTransfers.push_back(vk::BufferMemoryBarrier()
+					.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+					.setSrcQueueFamilyIndex(transferQueueIndex)
+					.setDstQueueFamilyIndex(graphicsQueueIndex)
+					.setBuffer(destination)
+					.setOffset(offset)
+					.setSize(size));
+			}
+
+			++stats.uploadCount;
+			stats.uploadedBytes += size;
+		}
+
+		void copy(const vk::Buffer& source, const vk::Buffer& destination, vk::DeviceSize size) {
+			assert(source && destination && "buffer not initialized");
+			if (size == 0) {
+				return;
+			}
+			getCommandBuffer();
+			recording->copies.push_back(BufferCopy{ source, destination, size });
+		}
+
+		uint64_t submit() {
+			const vk::CommandBuffer commandBuffer = getCommandBuffer();
+			UploadBatch& batch = *recording;
+			batch.id = ++lastBatch;
+			batch.ringPosition = ring.getHead();
+
+			if (hasTransferQueue()) {
+				submitOwnershipTransfers(batch);
+			}
+			else {
+				recordCopies(commandBuffer, batch.copies);
+				// the copies are visible to every command submitted after them on the queue
+				const auto barrier = vk::MemoryBarrier()
+					.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+					.setDstAccessMask(vk::AccessFlagBits::eMemoryRead);
+				commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, 1, &barrier, 0, nullptr, 0, nullptr);
+				commandBuffer.end();
+
+				const auto submitInfo = vk::SubmitInfo()
+					.setCommandBufferCount(1)
+					.setPCommandBuffers(&commandBuffer);
+				graphicsQueue.submit(1, &submitInfo, *batch.fence);
+			}
+
+			pending.push_back(std::move(batch));
+			recording.reset();
+			++stats.batchCount;
+			return lastBatch;
+		}
+
+		bool isComplete(uint64_t batch) {
+			assert(batch <= lastBatch && "batch not submitted");
+			reclaim();
+			return batch <= completedBatch;
+		}
+
+		void wait(uint64_t batch) {
+			assert(batch <= lastBatch && "batch not submitted");
+			reclaim();
+			while (completedBatch < batch) {
+				waitOldest();
+			}
+		}
+
+		void reclaim() {
+			while (!pending.empty() && device.getFenceStatus(*pending.front().fence) == vk::Result::eSuccess) {
+				retireOldest();
+			}
+		}
+
+		UploadStats stats{};
+
+	private:
+		vk::Device device;
+		vk::Queue transferQueue;
+		vk::Queue graphicsQueue;
+		uint32_t transferQueueIndex;
+		uint32_t graphicsQueueIndex;
+		vk::UniqueCommandPool transferCommandPool;
+		// acquisitions of the uploaded ranges, with a transfer queue only
+		vk::UniqueCommandPool graphicsCommandPool;
+		vk::UniqueBuffer buffer;
+		VulkanAllocation memory;
+		RingAllocator ring;
+
+		// submitted batches in submission order, the completed ones are recycled
+		std::deque<UploadBatch> pending;
+		std::vector<UploadBatch> completed;
+		std::optional<UploadBatch> recording;
+		uint64_t lastBatch{ 0 };
+		uint64_t completedBatch{ 0 };
+
+		uint64_t allocate(vk::DeviceSize size) {
+			reclaim();
+			uint64_t ringOffset = ring.allocate(size, copyAlignment);
+			while (ringOffset == RingAllocator::invalidOffset) {
+				// the ring is full of the current batch: it is submitted to be waited for
+				if (pending.empty()) {
+					submit();
+				}
+				waitOldest();
+				ringOffset = ring.allocate(size, copyAlignment);
+			}
+			return ringOffset;
+		}
+
+		vk::CommandBuffer getCommandBuffer() {
+			if (recording) {
+				return *recording->commandBuffer;
+			}
+
+			if (completed.empty()) {
+				recording.emplace(UploadBatch{ 0, 0, allocateCommandBuffer(device, *transferCommandPool), device.createFenceUnique(vk::FenceCreateInfo()), {}, {}, {}, {} });
+				if (hasTransferQueue()) {
+					recording->acquireCommandBuffer = allocateCommandBuffer(device, *graphicsCommandPool);
+					recording->semaphore = device.createSemaphoreUnique(vk::SemaphoreCreateInfo());
+				}
+			}
+			else {
+				recording.emplace(std::move(completed.back()));
+				completed.pop_back();
+				device.resetFences(1, &*recording->fence);
+				recording->commandBuffer->reset(vk::CommandBufferResetFlags());
+				recording->ownershipTransfers.clear();
+				recording->copies.clear();
+			}
+
+			recording->commandBuffer->begin(vk::CommandBufferBeginInfo().setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+			return *recording->commandBuffer;
+		}
+
+		bool hasTransferQueue() const {
+			return transferQueueIndex != graphicsQueueIndex;
+		}
+
+		// the transfer family releases the uploaded ranges & signals the semaphore, the graphics family
+		// waits for it to acquire them: the graphics commands submitted after the batch read the data
+		void submitOwnershipTransfers(UploadBatch& batch) {
+			const vk::CommandBuffer commandBuffer = *batch.commandBuffer;
+			commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe, {},
+				0, nullptr, static_cast<uint32_t>(batch.ownershipTransfers.size()), batch.ownershipTransfers.data(), 0, nullptr);
+			commandBuffer.end();
+
+			const auto transferSubmitInfo = vk::SubmitInfo()
+				.setCommandBufferCount(1)
+				.setPCommandBuffers(&commandBuffer)
+				.setSignalSemaphoreCount(1)
+				.setPSignalSemaphores(&*batch.semaphore);
+			transferQueue.submit(1, &transferSubmitInfo, vk::Fence());
+
+			for (vk::BufferMemoryBarrier& barrier : batch.ownershipTransfers) {
+				barrier.setSrcAccessMask(vk::AccessFlags()).setDstAccessMask(vk::AccessFlagBits::eMemoryRead);
+			}
+			const vk::CommandBuffer acquireCommandBuffer = *batch.acquireCommandBuffer;
+			acquireCommandBuffer.reset(vk::CommandBufferResetFlags());
+			acquireCommandBuffer.begin(vk::CommandBufferBeginInfo().setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+			acquireCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eAllCommands, {},
+				0, nullptr, static_cast<uint32_t>(batch.ownershipTransfers.size()), batch.ownershipTransfers.data(), 0, nullptr);
+			if (!batch.copies.empty()) {
+				recordCopies(acquireCommandBuffer, batch.copies);
+				const auto barrier = vk::MemoryBarrier()
+					.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+					.setDstAccessMask(vk::AccessFlagBits::eMemoryRead);
+				acquireCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {}, 1, &barrier, 0, nullptr, 0, nullptr);
+			}
+			acquireCommandBuffer.end();
+
+			// the fence of the batch signals once the data is owned by the graphics family
+			const vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eAllCommands;
+			const auto graphicsSubmitInfo = vk::SubmitInfo()
+				.setWaitSemaphoreCount(1)
+				.setPWaitSemaphores(&*batch.semaphore)
+				.setPWaitDstStageMask(&waitStage)
+				.setCommandBufferCount(1)
+				.setPCommandBuffers(&acquireCommandBuffer);
+			graphicsQueue.submit(1, &graphicsSubmitInfo, *batch.fence);
+		}
+
+		// the uploads of the batch write the destinations past the copied ranges
+		void recordCopies(const vk::CommandBuffer& commandBuffer, const std::vector<BufferCopy>& copies) {
+			if (copies.empty()) {
+				return;
+			}
+			// the uploads recorded before in the same command buffer may target a source
+			const auto barrier = vk::MemoryBarrier()
+				.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+				.setDstAccessMask(vk::AccessFlagBits::eTransferRead);
+			commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, {}, 1, &barrier, 0, nullptr, 0, nullptr);
+			for (const BufferCopy& bufferCopy : copies) {
+				const auto region = vk::BufferCopy().setSize(bufferCopy.size);
+				commandBuffer.copyBuffer(bufferCopy.source, bufferCopy.destination, 1, &region);
+			}
+		}
+
+		void waitOldest() {
+			assert(!pending.empty() && "no batch in flight");
+			const auto start = std::chrono::steady_clock::now();
+			device.waitForFences(1, &*pending.front().fence, VK_TRUE, UINT64_MAX);
+			++stats.stallCount;
+			stats.stallMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			retireOldest();
+		}
+
+		void retireOldest() {
+			UploadBatch& batch = pending.front();
+			completedBatch = batch.id;
+			ring.release(batch.ringPosition);
+			completed.push_back(std::move(batch));
+			pending.pop_front();
+		}
+
+	};
+
+	VulkanStagingRing::VulkanStagingRing(const VulkanDevice& device, vk::DeviceSize size) :
+		pimpl(make_unique_pimpl<VulkanStagingRing::Impl>(device, size)) { }
+
+	void VulkanStagingRing::upload(const vk::Buffer& buffer, vk::DeviceSize offset, const void* data, vk::DeviceSize size) {
+		pimpl->upload(buffer, offset, data, size);
+	}
+
+	void VulkanStagingRing::copy(const vk::Buffer& source, const vk::Buffer& destination, vk::DeviceSize size) {
+		pimpl->copy(source, destination, size);
+	}
+
+	uint64_t VulkanStagingRing::submit() {
+		return pimpl->submit();
+	}
+
+	bool VulkanStagingRing::isComplete(uint64_t batch) {
+		return pimpl->isComplete(batch);
+	}
+
+	void VulkanStagingRing::wait(uint64_t batch) {
+		pimpl->wait(batch);
+	}
+
+	void VulkanStagingRing::reclaim() {
+		pimpl->reclaim();
+	}
+
+	UploadStats VulkanStagingRing::getStats() const {
+		return pimpl->stats;
+	}
+
+}
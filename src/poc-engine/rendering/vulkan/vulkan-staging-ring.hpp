@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+
+#include "../../core/pimpl_ptr.hpp"
+#include "../../plateform/platform.hpp"
+#include "../graphic-api.hpp"
+#include "vulkan-device.hpp"
+
+namespace poc {
+
+	/*
+	 * Uploads to device local buffers through a persistently mapped staging ring.
+	 *
+	 * The data is copied in the ring & its copy recorded in the current batch: the uploads of a frame are
+	 * submitted at once by submit(), no queue waits for them. The space of a batch is reclaimed once its
+	 * fence signaled, the CPU only waits when the ring is full. Uploads larger than a quarter of the ring
+	 * are split in several copies.
+	 *
+	 * The copies run on the transfer queue of the device when it has one, alongside the frames: the
+	 * uploaded ranges are released to the graphics family, which acquires them once the semaphore of
+	 * the batch signaled. Otherwise they are submitted on the graphics queue.
+	 *
+	 * Not thread safe, the destination buffers must outlive the batches of their uploads.
+	 */
+	class VulkanStagingRing {
+	public:
+
+		static constexpr vk::DeviceSize defaultSize = 32ull << 20;
+
+		// size: a multiple of 256
+		explicit VulkanStagingRing(const VulkanDevice& device, vk::DeviceSize size = defaultSize);
+
+		// the range is new or only written by uploads: with a transfer queue, the range is owned by the
+		// graphics family after the batch, a range in use by the graphics queue would lose its content
+		void upload(const vk::Buffer& buffer, vk::DeviceSize offset, const void* data, vk::DeviceSize size);
+
+		// copies the start of a buffer to a new one, on the graphics queue after the uploads of the batch:
+		// a buffer replaced by a larger one keeps its content without a new upload
+		void copy(const vk::Buffer& source, const vk::Buffer& destination, vk::DeviceSize size);
+
+		// submits the uploads of the current batch, the commands submitted to the graphics queue after
+		// them read the uploaded data; returns the batch, an empty batch is submitted too
+		uint64_t submit();
+
+		// the batch & the commands submitted before it completed
+		bool isComplete(uint64_t batch);
+		void wait(uint64_t batch);
+
+		// releases the space of the completed batches, done by every upload
+		void reclaim();
+
+		UploadStats getStats() const;
+
+	private:
+		class Impl;
+		pimpl_ptr<Impl> pimpl;
+	};
+
+}
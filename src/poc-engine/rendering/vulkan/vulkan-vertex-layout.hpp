@@ -0,0 +1,150 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "../../plateform/platform.hpp"
+#include "../vertex.hpp"
+
+/*
+ * Compile time vertex layouts: a vertex struct declares its attributes once with makeVertexLayout,
+ * VertexInputState generates the binding & attribute descriptions and the pipeline vertex input state
+ * from one or several layouts (one binding per layout, in order) without any runtime building.
+ *
+ * template<> struct VertexFormatLayout<VertexFormat::XXX> {
+ *     static constexpr auto value = makeVertexLayout<MyVertex>(vk::VertexInputRate::eVertex, {
+ *         { 0, vk::Format::eR32G32B32Sfloat, offsetof(MyVertex, position) }
+ *     });
+ * };
+ */
+namespace poc {
+
+	// attribute read by the vertex shader at the given location
+	struct VertexAttribute {
+		uint32_t location;
+		vk::Format format;
+		uint32_t offset;
+	};
+
+	template<class V, size_t AttributeCount>
+	struct VertexLayout {
+		using VertexType = V;
+		static constexpr uint32_t stride = sizeof(V);
+
+		vk::VertexInputRate inputRate;
+		std::array<VertexAttribute, AttributeCount> attributes;
+	};
+
+	template<class V, size_t AttributeCount>
+	constexpr VertexLayout<V, AttributeCount> makeVertexLayout(
+		const vk::VertexInputRate inputRate,
+		const VertexAttribute(&attributes)[AttributeCount]) {
+
+		VertexLayout<V, AttributeCount> layout{ inputRate, {} };
+		for (size_t i = 0; i < AttributeCount; ++i) {
+			layout.attributes[i] = attributes[i];
+		}
+		return layout;
+	}
+
+	namespace vertex_layout_helpers {
+
+		struct BoundAttribute {
+			uint32_t binding;
+			VertexAttribute attribute;
+		};
+
+		template<const auto&... Layouts>
+		inline constexpr size_t attributeCount = (Layouts.attributes.size() + ...);
+
+		template<const auto&... Layouts, size_t... B>
+		constexpr std::array<vk::VertexInputBindingDescription, sizeof...(Layouts)> makeBindings(std::index_sequence<B...>) {
+			return { vk::VertexInputBindingDescription(static_cast<uint32_t>(B), Layouts.stride, Layouts.inputRate)... };
+		}
+
+		template<const auto&... Layouts>
+		constexpr std::array<BoundAttribute, attributeCount<Layouts...>> flattenAttributes() {
+			std::array<BoundAttribute, attributeCount<Layouts...>> flat{};
+			size_t index = 0;
+			uint32_t binding = 0;
+			const auto append = [&](const auto& attributes) {
+				for (const VertexAttribute& attribute : attributes) {
+					flat[index++] = BoundAttribute{ binding, attribute };
+				}
+				++binding;
+			};
+			(append(Layouts.attributes), ...);
+			return flat;
+		}
+
+		template<const auto&... Layouts, size_t... A>
+		constexpr std::array<vk::VertexInputAttributeDescription, sizeof...(A)> makeAttributes(std::index_sequence<A...>) {
+			constexpr std::array<BoundAttribute, sizeof...(A)> flat = flattenAttributes<Layouts...>();
+			return { vk::VertexInputAttributeDescription(
+				flat[A].attribute.location,
+				flat[A].binding,
+				flat[A].attribute.format,
+				flat[A].attribute.offset)... };
+		}
+
+	}
+
+	template<const auto&... Layouts>
+	struct VertexInputState {
+		static constexpr std::array<vk::VertexInputBindingDescription, sizeof...(Layouts)> bindings =
+			vertex_layout_helpers::makeBindings<Layouts...>(std::make_index_sequence<sizeof...(Layouts)>());
+
+		static constexpr std::array<vk::VertexInputAttributeDescription, vertex_layout_helpers::attributeCount<Layouts...>> attributes =
+			vertex_layout_helpers::makeAttributes<Layouts...>(std::make_index_sequence<vertex_layout_helpers::attributeCount<Layouts...>>());
+
+		static constexpr vk::PipelineVertexInputStateCreateInfo createInfo{
+			{},
+			static_cast<uint32_t>(bindings.size()),
+			bindings.data(),
+			static_cast<uint32_t>(attributes.size()),
+			attributes.data()
+		};
+	};
+
+	// layout of the vertices stored in each VertexFormat
+	template<VertexFormat F>
+	struct VertexFormatLayout;
+
+	// the shader always reads vec3 position & color, the fixed function conversion handles the packed formats
+	template<>
+	struct VertexFormatLayout<VertexFormat::FLOAT32> {
+		static constexpr auto value = makeVertexLayout<Vertex>(vk::VertexInputRate::eVertex, {
+			{ 0, vk::Format::eR32G32B32Sfloat, offsetof(Vertex, position) },
+			{ 1, vk::Format::eR32G32B32Sfloat, offsetof(Vertex, color) }
+		});
+	};
+
+	template<>
+	struct VertexFormatLayout<VertexFormat::HALF_POSITION> {
+		static constexpr auto value = makeVertexLayout<PackedVertex>(vk::VertexInputRate::eVertex, {
+			{ 0, vk::Format::eR16G16B16A16Sfloat, offsetof(PackedVertex, position) },
+			{ 1, vk::Format::eR8G8B8A8Unorm, offsetof(PackedVertex, color) }
+		});
+	};
+
+	template<>
+	struct VertexFormatLayout<VertexFormat::SNORM16_POSITION> {
+		static constexpr auto value = makeVertexLayout<PackedVertex>(vk::VertexInputRate::eVertex, {
+			{ 0, vk::Format::eR16G16B16A16Snorm, offsetof(PackedVertex, position) },
+			{ 1, vk::Format::eR8G8B8A8Unorm, offsetof(PackedVertex, color) }
+		});
+	};
+
+	// second binding of the instanced draws, after the vertices of any format
+	struct InstanceLayout {
+		static constexpr auto value = makeVertexLayout<Instance>(vk::VertexInputRate::eInstance, {
+			{ 2, vk::Format::eR32G32B32A32Sfloat, offsetof(Instance, transform) },
+			{ 3, vk::Format::eR32G32B32A32Sfloat, offsetof(Instance, transform) + sizeof(glm::vec4) },
+			{ 4, vk::Format::eR32G32B32A32Sfloat, offsetof(Instance, transform) + 2 * sizeof(glm::vec4) },
+			{ 5, vk::Format::eR8G8B8A8Unorm, offsetof(Instance, color) }
+		});
+	};
+
+}
@@ -0,0 +1,139 @@
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include "assets/asset-cooker.hpp"
+#include "rendering/mesh-file.hpp"
+
+using namespace poc;
+
+namespace fs = std::filesystem;
+
+// empty source & output directories in the temporary directory
+static fs::path makeProject(const std::string& name) {
+	const fs::path root = fs::temp_directory_path() / name;
+	fs::remove_all(root);
+	fs::create_directories(root / "source" / "props");
+	return root;
+}
+
+static void writeText(const fs::path& path, const std::string& text) {
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file << text;
+}
+
+static std::string makeQuad(float size) {
+	const std::string s = std::to_string(size);
+	return "v 0 0 0\nv " + s + " 0 0\nv " + s + " " + s + " 0\nv 0 " + s + " 0\nf 1 2 3 4\n";
+}
+
+static CookSettings makeSettings() {
+	CookSettings settings;
+	settings.shaderCompiler.clear();
+	return settings;
+}
+
+TEST(AssetCooker, OnlyChangedAssetsAreCookedAgain) {
+	const fs::path root = makeProject("poc-asset-cooker-tests");
+	writeText(root / "source" / "props" / "a.obj", makeQuad(1.0f));
+	writeText(root / "source" / "b.obj", makeQuad(2.0f));
+	writeText(root / "source" / "notes.txt", "not an asset");
+
+	JobSystem jobs(2);
+	AssetCooker cooker((root / "source").string(), (root / "cooked").string(), makeSettings());
+	CookReport report = cooker.cook(jobs);
+	EXPECT_EQ(report.assetCount, 2u);
+	EXPECT_EQ(report.cookedCount, 2u);
+	ASSERT_TRUE(fs::exists(root / "cooked" / "props" / "a.obj.pocmesh"));
+
+	Scene scene;
+	MeshFile::load((root / "cooked" / "props" / "a.obj.pocmesh").string(), scene);
+	EXPECT_EQ(scene.getMeshes().size(), 1u);
+	EXPECT_EQ(scene.getMeshes()[0].vertexCount, 4u);
+
+	report = cooker.cook(jobs);
+	EXPECT_EQ(report.unchangedCount, 2u);
+	EXPECT_EQ(report.cookedCount, 0u);
+
+	// touched without change: hashed, not cooked
+	const fs::path a = root / "source" / "props" / "a.obj";
+	fs::last_write_time(a, fs::last_write_time(a) + std::chrono::seconds(10));
+	report = cooker.cook(jobs);
+	EXPECT_EQ(report.sameContentCount, 1u);
+	EXPECT_EQ(report.unchangedCount, 1u);
+	EXPECT_EQ(report.cookedCount, 0u);
+	EXPECT_EQ(cooker.cook(jobs).unchangedCount, 2u);
+
+	// a new cooker reads the cache of the previous one
+	writeText(a, makeQuad(3.0f));
+	fs::last_write_time(a, fs::last_write_time(a) + std::chrono::seconds(20));
+	AssetCooker nextCooker((root / "source").string(), (root / "cooked").string(), makeSettings());
+	report = nextCooker.cook(jobs);
+	EXPECT_EQ(report.cookedCount, 1u);
+	EXPECT_EQ(report.unchangedCount, 1u);
+
+	// other settings: everything again
+	CookSettings settings = makeSettings();
+	settings.vertexFormat = VertexFormat::SNORM16_POSITION;
+	AssetCooker packedCooker((root / "source").string(), (root / "cooked").string(), settings);
+	EXPECT_EQ(packedCooker.cook(jobs).cookedCount, 2u);
+
+	// the output of a removed source is removed
+	fs::remove(root / "source" / "b.obj");
+	report = packedCooker.cook(jobs);
+	EXPECT_EQ(report.assetCount, 1u);
+	EXPECT_FALSE(fs::exists(root / "cooked" / "b.obj.pocmesh"));
+
+	fs::remove_all(root);
+}
+
+TEST(AssetCooker, FailedAssetsAreReportedAndRetried) {
+	const fs::path root = makeProject("poc-asset-cooker-failure-tests");
+	writeText(root / "source" / "broken.obj", "v 0 0\n");
+	writeText(root / "source" / "quad.obj", makeQuad(1.0f));
+
+	JobSystem jobs(2);
+	AssetCooker cooker((root / "source").string(), (root / "cooked").string(), makeSettings());
+	CookReport report = cooker.cook(jobs);
+	EXPECT_EQ(report.failedCount, 1u);
+	EXPECT_EQ(report.cookedCount, 1u);
+	EXPECT_FALSE(fs::exists(root / "cooked" / "broken.obj.pocmesh"));
+
+	report = cooker.cook(jobs);
+	EXPECT_EQ(report.failedCount, 1u);
+	EXPECT_EQ(report.unchangedCount, 1u);
+
+	fs::remove_all(root);
+}
+
+TEST(AssetCooker, GltfBufferChangesCookTheAssetAgain) {
+	const fs::path root = makeProject("poc-asset-cooker-gltf-tests");
+	float positions[]{ 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f };
+	const auto writeBuffer = [&]() {
+		std::ofstream file(root / "source" / "props" / "triangle.bin", std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(positions), sizeof(positions));
+	};
+	writeBuffer();
+	writeText(root / "source" / "props" / "triangle.gltf", R"({
+		"asset": { "version": "2.0" },
+		"meshes": [ { "primitives": [ { "attributes": { "POSITION": 0 } } ] } ],
+		"buffers": [ { "uri": "triangle.bin", "byteLength": 36 } ],
+		"bufferViews": [ { "buffer": 0, "byteLength": 36 } ],
+		"accessors": [ { "bufferView": 0, "componentType": 5126, "count": 3, "type": "VEC3" } ]
+	})");
+
+	JobSystem jobs(2);
+	AssetCooker cooker((root / "source").string(), (root / "cooked").string(), makeSettings());
+	EXPECT_EQ(cooker.cook(jobs).cookedCount, 1u);
+	EXPECT_EQ(cooker.cook(jobs).unchangedCount, 1u);
+
+	const fs::path buffer = root / "source" / "props" / "triangle.bin";
+	const auto writeTime = fs::last_write_time(buffer);
+	positions[6] = 2.0f;
+	writeBuffer();
+	fs::last_write_time(buffer, writeTime + std::chrono::seconds(10));
+	EXPECT_EQ(cooker.cook(jobs).cookedCount, 1u);
+
+	fs::remove_all(root);
+}
@@ -0,0 +1,294 @@
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#include "assets/gltf-importer.hpp"
+#include "assets/json.hpp"
+#include "assets/obj-importer.hpp"
+#include "assets/text-parsing.hpp"
+#include "test-meshes.hpp"
+
+using namespace poc;
+
+static Mesh parseObj(const std::string& text, JobSystem& jobs, const ImportSettings& settings = {}) {
+	return ObjImporter::parse(span<const char>(text.data(), text.size()), jobs, settings);
+}
+
+static void writeFile(const std::string& path, const void* data, size_t size) {
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+}
+
+static std::string encodeBase64(const std::vector<uint8_t>& data) {
+	static constexpr char alphabet[]{ "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/" };
+	std::string result;
+	for (size_t i = 0; i < data.size(); i += 3) {
+		const uint32_t bits = (uint32_t(data[i]) << 16)
+			| (i + 1 < data.size() ? uint32_t(data[i + 1]) << 8 : 0)
+			| (i + 2 < data.size() ? uint32_t(data[i + 2]) : 0);
+		result += alphabet[(bits >> 18) & 63];
+		result += alphabet[(bits >> 12) & 63];
+		result += i + 1 < data.size() ? alphabet[(bits >> 6) & 63] : '=';
+		result += i + 2 < data.size() ? alphabet[bits & 63] : '=';
+	}
+	return result;
+}
+
+// quad of 4 float positions with 2 ushort triangles, indices first then positions
+static std::vector<uint8_t> makeQuadBuffer() {
+	const uint16_t indices[]{ 0, 1, 2, 0, 2, 3 };
+	const float positions[]{ 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f };
+	std::vector<uint8_t> buffer(sizeof(indices) + sizeof(positions));
+	std::memcpy(buffer.data(), indices, sizeof(indices));
+	std::memcpy(buffer.data() + sizeof(indices), positions, sizeof(positions));
+	return buffer;
+}
+
+// a root node translated and scaled, with the quad, and a child node rotated with the quad too
+static std::string makeQuadDescription(const std::string& bufferUri) {
+	return R"({
+		"asset": { "version": "2.0" },
+		"scene": 0,
+		"scenes": [ { "nodes": [ 0 ] } ],
+		"nodes": [
+			{ "mesh": 0, "translation": [ 1, 2, 3 ], "scale": [ 2, 2, 2 ], "children": [ 1 ] },
+			{ "mesh": 0, "rotation": [ 0, 0.7071068, 0, 0.7071068 ] }
+		],
+		"meshes": [ { "primitives": [ { "attributes": { "POSITION": 1 }, "indices": 0 } ] } ],
+		"buffers": [ { )" + bufferUri + R"("byteLength": 60 } ],
+		"bufferViews": [
+			{ "buffer": 0, "byteOffset": 0, "byteLength": 12 },
+			{ "buffer": 0, "byteOffset": 12, "byteLength": 48 }
+		],
+		"accessors": [
+			{ "bufferView": 0, "componentType": 5123, "count": 6, "type": "SCALAR" },
+			{ "bufferView": 1, "componentType": 5126, "count": 4, "type": "VEC3" }
+		]
+	})";
+}
+
+static void expectQuadScene(const Scene& scene, const std::vector<Entity>& entities) {
+	ASSERT_EQ(entities.size(), 2u);
+	ASSERT_EQ(scene.getMeshes().size(), 1u);
+	EXPECT_EQ(scene.getMeshes()[0].vertexCount, 4u);
+	EXPECT_EQ(scene.getMeshes()[0].indexCount, 6u);
+
+	const TransformHierarchy& transforms = scene.getTransforms();
+	const TransformNode root = scene.getWorld().get<TransformComponent>(entities[0]).node;
+	const TransformNode child = scene.getWorld().get<TransformComponent>(entities[1]).node;
+	EXPECT_EQ(transforms.getLocalPosition(root), glm::vec3(1.0f, 2.0f, 3.0f));
+	EXPECT_EQ(transforms.getLocalScale(root), glm::vec3(2.0f));
+	EXPECT_NEAR(glm::angle(transforms.getLocalRotation(child)), glm::half_pi<float>(), 1e-5f);
+}
+
+TEST(AssetImport, FloatParsingMatchesTheStandardLibrary) {
+	const char* samples[]{ "0", "-0.0", "1", "3.14159", "-2.5e-3", "1e10", "6.02214076e23", ".5", "5.", "+7.25",
+		"0.1", "0.30000000000000004", "123456789012345678901234", "1.17549435e-38", "3.4028234e38", "9.999999e-5" };
+	for (const char* sample : samples) {
+		float value = 0.0f;
+		const char* end = sample + std::strlen(sample);
+		EXPECT_EQ(TextParsing::parseFloat(sample, end, value), end) << sample;
+		EXPECT_EQ(value, std::strtof(sample, nullptr)) << sample;
+	}
+
+	float value = 0.0f;
+	const char* invalid[]{ "", "-", ".", "e5", "x1" };
+	for (const char* sample : invalid) {
+		EXPECT_EQ(TextParsing::parseFloat(sample, sample + std::strlen(sample), value), nullptr) << sample;
+	}
+
+	// the number stops at the first character that cannot continue it
+	const char text[]{ "1.5e/2" };
+	EXPECT_EQ(TextParsing::parseFloat(text, text + 6, value), text + 3);
+	EXPECT_EQ(value, 1.5f);
+}
+
+TEST(AssetImport, ObjStatementsAreParsed) {
+	JobSystem jobs(2);
+	const Mesh mesh = parseObj(
+		"# quad & triangle\n"
+		"o object\r\n"
+		"v 0 0 0 1 0 0\n"
+		"v 1 0 0 0 1 0\n"
+		"v 1 1 0 0 0 1\n"
+		"v 0 1 0 1 1 1\n"
+		"vt 0 0\n"
+		"vn 0 0 1\n"
+		"f 1/1/1 2/1/1 3/1/1 4/1/1\n"
+		"v 2 0 0\n"
+		"f -1 -4 -3\n", jobs);
+
+	ASSERT_EQ(mesh.getVertices().size(), 5u);
+	EXPECT_EQ(mesh.getVertices()[1].color, glm::vec3(0.0f, 1.0f, 0.0f));
+	// no color: white
+	EXPECT_EQ(mesh.getVertices()[4].color, glm::vec3(1.0f));
+
+	const std::vector<uint32_t> indices(mesh.getIndices().begin(), mesh.getIndices().end());
+	EXPECT_EQ(indices, (std::vector<uint32_t>{ 0, 1, 2, 0, 2, 3, 4, 1, 2 }));
+}
+
+TEST(AssetImport, ObjChunksGiveTheSameMeshAsOneThread) {
+	// a grid of quads, large enough for several chunks, with relative indices across the chunk boundaries
+	std::string text;
+	const int size = 200;
+	for (int y = 0; y < size; ++y) {
+		for (int x = 0; x < size; ++x) {
+			text += "v " + std::to_string(x * 0.25) + " " + std::to_string(y * 0.25) + " 0\n";
+		}
+		if (y > 0) {
+			for (int x = 0; x + 1 < size; ++x) {
+				const int previous = -(size * 2) + x;
+				text += "f " + std::to_string(previous) + " " + std::to_string(previous + 1) + " " + std::to_string(-size + x + 1) + " " + std::to_string(-size + x) + "\n";
+			}
+		}
+	}
+	ASSERT_GT(text.size(), ObjImporter::minChunkSize * 2);
+
+	JobSystem serial(1);
+	JobSystem parallel(4);
+	const ImportSettings settings{ false };
+	const Mesh reference = parseObj(text, serial, settings);
+	const Mesh mesh = parseObj(text, parallel, settings);
+
+	ASSERT_EQ(reference.getVertices().size(), size_t(size * size));
+	ASSERT_EQ(reference.getIndices().size(), size_t((size - 1) * (size - 1) * 6));
+	ASSERT_EQ(mesh.getVertices().size(), reference.getVertices().size());
+	EXPECT_EQ(std::memcmp(mesh.getVertices().data(), reference.getVertices().data(), mesh.getVertices().size() * sizeof(Vertex)), 0);
+	ASSERT_EQ(mesh.getIndices().size(), reference.getIndices().size());
+	EXPECT_TRUE(std::equal(mesh.getIndices().begin(), mesh.getIndices().end(), reference.getIndices().begin()));
+	EXPECT_EQ(reference.getIndices()[0], 0u);
+	EXPECT_EQ(reference.getIndices()[2], uint32_t(size + 1));
+}
+
+TEST(AssetImport, DuplicatedObjVerticesAreWelded) {
+	JobSystem jobs(1);
+	const std::string text = "v 0 0 0\nv 1 0 0\nv 0 1 0\nv 1 0 0\nv 0 1 0\nv 1 1 0\nf 1 2 3\nf 4 6 5\n";
+	EXPECT_EQ(parseObj(text, jobs).getVertices().size(), 4u);
+	EXPECT_EQ(parseObj(text, jobs, ImportSettings{ false }).getVertices().size(), 6u);
+}
+
+TEST(AssetImport, MalformedObjThrows) {
+	JobSystem jobs(2);
+	EXPECT_THROW(parseObj("v 0 0\n", jobs), std::runtime_error);
+	EXPECT_THROW(parseObj("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 4\n", jobs), std::runtime_error);
+	EXPECT_THROW(parseObj("v 0 0 0\nv 1 0 0\nf 1 2\n", jobs), std::runtime_error);
+	EXPECT_THROW(parseObj("v 0 0 0\nf 0 1 1\n", jobs), std::runtime_error);
+	EXPECT_THROW(ObjImporter::import(getTemporaryPath("poc-missing-file.obj"), jobs), std::runtime_error);
+}
+
+TEST(AssetImport, GltfWithEmbeddedBufferBuildsTheHierarchy) {
+	const std::string path = getTemporaryPath("poc-asset-import-tests.gltf");
+	const std::string description = makeQuadDescription(R"("uri": "data:application/octet-stream;base64,)" + encodeBase64(makeQuadBuffer()) + R"(", )");
+	writeFile(path, description.data(), description.size());
+
+	Scene scene;
+	JobSystem jobs(2);
+	const std::vector<Entity> entities = GltfImporter::import(path, scene, jobs);
+	expectQuadScene(scene, entities);
+
+	std::filesystem::remove(path);
+}
+
+TEST(AssetImport, InvalidGltfIndicesThrow) {
+	const std::string path = getTemporaryPath("poc-asset-import-tests-invalid.gltf");
+	const std::string description = makeQuadDescription(R"("uri": "data:application/octet-stream;base64,)" + encodeBase64(makeQuadBuffer()) + R"(", )");
+	// negative, fractional, huge, not a number or out of range indices & counts
+	const std::pair<std::string, std::string> replacements[]{
+		{ "\"bufferView\": 0", "\"bufferView\": -1" },
+		{ "\"count\": 6", "\"count\": 1e300" },
+		{ "\"buffer\": 0, \"byteOffset\": 12", "\"buffer\": 0.5, \"byteOffset\": 12" },
+		{ "\"byteOffset\": 12", "\"byteOffset\": 1.8446744073709552e19" },
+		{ "\"componentType\": 5126", "\"componentType\": -5126" },
+		{ "\"POSITION\": 1", "\"POSITION\": \"1\"" },
+		{ "\"indices\": 0", "\"indices\": 2" },
+		{ "\"byteLength\": 60", "\"byteLength\": -60" },
+		{ "\"scene\": 0", "\"scene\": -1" },
+		{ "\"nodes\": [ 0 ]", "\"nodes\": [ 2 ]" },
+		{ "\"children\": [ 1 ]", "\"children\": [ -1 ]" },
+		{ "\"mesh\": 0, \"rotation\"", "\"mesh\": 1e20, \"rotation\"" } };
+
+	JobSystem jobs(2);
+	for (const auto& [valid, invalid] : replacements) {
+		std::string invalidDescription = description;
+		ASSERT_NE(invalidDescription.find(valid), std::string::npos) << valid;
+		invalidDescription.replace(invalidDescription.find(valid), valid.size(), invalid);
+		writeFile(path, invalidDescription.data(), invalidDescription.size());
+
+		Scene scene;
+		EXPECT_THROW(GltfImporter::import(path, scene, jobs), std::runtime_error) << invalid;
+	}
+
+	std::filesystem::remove(path);
+}
+
+TEST(AssetImport, GlbReadsItsBinaryChunk) {
+	std::string json = makeQuadDescription("");
+	json.append((4 - json.size() % 4) % 4, ' ');
+	const std::vector<uint8_t> buffer = makeQuadBuffer();
+	const std::vector<uint8_t> paddedBuffer = [&]() {
+		std::vector<uint8_t> padded = buffer;
+		padded.resize((buffer.size() + 3) / 4 * 4, 0);
+		return padded;
+	}();
+
+	std::vector<uint8_t> file;
+	const auto append = [&file](const void* data, size_t size) {
+		file.insert(file.end(), static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+	};
+	const uint32_t header[]{ 0x46546C67, 2, uint32_t(12 + 8 + json.size() + 8 + paddedBuffer.size()) };
+	const uint32_t jsonChunk[]{ uint32_t(json.size()), 0x4E4F534A };
+	const uint32_t binaryChunk[]{ uint32_t(paddedBuffer.size()), 0x004E4942 };
+	append(header, sizeof(header));
+	append(jsonChunk, sizeof(jsonChunk));
+	append(json.data(), json.size());
+	append(binaryChunk, sizeof(binaryChunk));
+	append(paddedBuffer.data(), paddedBuffer.size());
+
+	const std::string path = getTemporaryPath("poc-asset-import-tests.glb");
+	writeFile(path, file.data(), file.size());
+
+	Scene scene;
+	JobSystem jobs(2);
+	const std::vector<Entity> entities = GltfImporter::import(path, scene, jobs);
+	expectQuadScene(scene, entities);
+
+	// an accessor past the end of its view
+	std::string invalid = makeQuadDescription("");
+	invalid.replace(invalid.find("\"count\": 4"), 10, "\"count\": 5");
+	invalid.append((4 - invalid.size() % 4) % 4, ' ');
+	file.clear();
+	const uint32_t invalidHeader[]{ 0x46546C67, 2, uint32_t(12 + 8 + invalid.size() + 8 + paddedBuffer.size()) };
+	const uint32_t invalidJsonChunk[]{ uint32_t(invalid.size()), 0x4E4F534A };
+	append(invalidHeader, sizeof(invalidHeader));
+	append(invalidJsonChunk, sizeof(invalidJsonChunk));
+	append(invalid.data(), invalid.size());
+	append(binaryChunk, sizeof(binaryChunk));
+	append(paddedBuffer.data(), paddedBuffer.size());
+	writeFile(path, file.data(), file.size());
+	Scene invalidScene;
+	EXPECT_THROW(GltfImporter::import(path, invalidScene, jobs), std::runtime_error);
+
+	std::filesystem::remove(path);
+}
+
+TEST(AssetImport, JsonIsParsed) {
+	const JsonValue value = JsonValue::parse(R"({ "a": [ 1, -2.5e2, true, null ], "b": "x\n\u00e9\ud83d\ude00", "c": {} })");
+	ASSERT_TRUE(value.isObject());
+	EXPECT_EQ(value["a"].size(), 4u);
+	EXPECT_EQ(value["a"][1].getNumber(), -250.0);
+	EXPECT_TRUE(value["a"][2].getBool());
+	EXPECT_EQ(value["a"][3].getType(), JsonValue::Type::NULL_VALUE);
+	EXPECT_EQ(value["b"].getString(), "x\n\xC3\xA9\xF0\x9F\x98\x80");
+	EXPECT_TRUE(value["c"].isObject());
+	EXPECT_FALSE(value.contains("d"));
+	EXPECT_EQ(value["d"]["e"][0].getNumber(1.0), 1.0);
+
+	for (const char* invalid : { "", "{", "[1,]", "{\"a\" 1}", "tru", "\"\\x\"", "[1] 2", "01" }) {
+		EXPECT_THROW(JsonValue::parse(invalid), std::runtime_error) << invalid;
+	}
+}
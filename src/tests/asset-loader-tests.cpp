@@ -0,0 +1,237 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "assets/asset-loader.hpp"
+#include "rendering/mesh-file.hpp"
+#include "rendering/meshlet-builder.hpp"
+
+using namespace poc;
+
+namespace fs = std::filesystem;
+
+static fs::path writeQuad(const std::string& name, float size) {
+	const fs::path path = fs::temp_directory_path() / name;
+	const std::string s = std::to_string(size);
+	std::ofstream file(path, std::ios::trunc);
+	file << "v 0 0 0\nv " << s << " 0 0\nv " << s << " " << s << " 0\nv 0 " << s << " 0\nf 1 2 3 4\n";
+	return path;
+}
+
+static void waitLoaded(const AssetLoader& loader) {
+	while (loader.getLoadingCount() > 0) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+// updates as the engine loop, with a renderer uploading every generation at once
+static void updateUntilDone(AssetLoader& loader, Scene& scene) {
+	for (int frame = 0; frame < 10000 && (loader.getLoadingCount() > 0 || loader.getPendingCount() > 0); ++frame) {
+		loader.update(scene, scene.getGeneration());
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+TEST(AssetLoader, AddedGeometryKeepsItsRanges) {
+	Scene source;
+	Mesh packed = MeshletBuilder::build(Mesh({ Vertex{ glm::vec3(0.0f), glm::vec3(1.0f) }, Vertex{ glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(1.0f) }, Vertex{ glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f) } }, { 0, 1, 2 }));
+	packed.setVertexFormat(VertexFormat::SNORM16_POSITION);
+	source.addMesh(Mesh({ Vertex{ glm::vec3(0.0f), glm::vec3(1.0f) }, Vertex{ glm::vec3(2.0f, 0.0f, 0.0f), glm::vec3(1.0f) }, Vertex{ glm::vec3(0.0f, 2.0f, 0.0f), glm::vec3(1.0f) } }, { 0, 2, 1 }));
+	source.addMesh(std::move(packed));
+
+	Scene scene;
+	scene.addMesh(Mesh({ Vertex{ glm::vec3(0.0f), glm::vec3(1.0f) }, Vertex{ glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(1.0f) }, Vertex{ glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f) } }, { 0, 1, 2 }));
+	const uint64_t generation = scene.getGeneration();
+	const uint32_t firstMesh = scene.addGeometry(source.getGeometry());
+
+	EXPECT_EQ(firstMesh, 1u);
+	EXPECT_GT(scene.getGeneration(), generation);
+	ASSERT_EQ(scene.getMeshes().size(), 3u);
+	for (uint32_t i = 0; i < 2; ++i) {
+		const MeshRange& added = scene.getMeshes()[firstMesh + i];
+		const MeshRange& original = source.getMeshes()[i];
+		const span<const uint32_t> addedIndices = scene.getMeshIndices(added);
+		const span<const uint32_t> originalIndices = source.getMeshIndices(original);
+		EXPECT_TRUE(std::equal(addedIndices.begin(), addedIndices.end(), originalIndices.begin(), originalIndices.end()));
+		EXPECT_EQ(added.meshletCount, original.meshletCount);
+		for (uint32_t m = 0; m < added.meshletCount; ++m) {
+			EXPECT_EQ(scene.getMeshMeshlets(added)[m].firstIndex - added.firstIndex, source.getMeshMeshlets(original)[m].firstIndex - original.firstIndex);
+		}
+	}
+	EXPECT_EQ(scene.getMeshVertices(scene.getMeshes()[1])[1].position, glm::vec3(2.0f, 0.0f, 0.0f));
+	EXPECT_EQ(std::memcmp(scene.getMeshPackedVertices(scene.getMeshes()[2]).data(), source.getMeshPackedVertices(source.getMeshes()[1]).data(), 3 * sizeof(PackedVertex)), 0);
+}
+
+TEST(AssetLoader, LoadsCompleteWhenResident) {
+	const fs::path obj = writeQuad("poc-asset-loader-tests.obj", 1.0f);
+	Scene cooked;
+	cooked.addMesh(Mesh({ Vertex{ glm::vec3(0.0f), glm::vec3(1.0f) }, Vertex{ glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(1.0f) }, Vertex{ glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f) } }, { 0, 1, 2 }));
+	const fs::path pocmesh = fs::temp_directory_path() / "poc-asset-loader-tests.pocmesh";
+	MeshFile::write(pocmesh.string(), cooked);
+
+	AssetLoader loader;
+	Scene scene;
+	std::vector<Entity> entities;
+	const auto createEntities = [&entities](Scene& s, const LoadResult& result) {
+		for (const uint32_t mesh : result.meshes) {
+			entities.push_back(s.createEntity(mesh));
+		}
+	};
+	const std::shared_future<LoadResult> objLoad = loader.load(obj.string(), 0, {}, createEntities);
+	const std::shared_future<LoadResult> fileLoad = loader.load(pocmesh.string(), 0, {}, createEntities);
+
+	// added but not drawn yet: not complete
+	waitLoaded(loader);
+	loader.update(scene, 0);
+	EXPECT_EQ(scene.getMeshes().size(), 2u);
+	EXPECT_EQ(objLoad.wait_for(std::chrono::seconds(0)), std::future_status::timeout);
+	EXPECT_TRUE(entities.empty());
+
+	loader.update(scene, scene.getGeneration());
+	ASSERT_EQ(objLoad.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+	ASSERT_EQ(fileLoad.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+	EXPECT_EQ(objLoad.get().status, LoadStatus::RESIDENT);
+	EXPECT_EQ(fileLoad.get().status, LoadStatus::RESIDENT);
+	ASSERT_EQ(objLoad.get().meshes.size() + fileLoad.get().meshes.size(), 2u);
+	EXPECT_EQ(scene.getMeshes()[objLoad.get().meshes[0]].vertexCount, 4u);
+	EXPECT_EQ(scene.getMeshes()[fileLoad.get().meshes[0]].vertexCount, 3u);
+	EXPECT_EQ(entities.size(), 2u);
+	EXPECT_EQ(loader.getPendingCount(), 0u);
+
+	fs::remove(obj);
+	fs::remove(pocmesh);
+}
+
+TEST(AssetLoader, HigherPrioritiesAreAddedFirst) {
+	std::vector<fs::path> paths;
+	for (int i = 0; i < 3; ++i) {
+		paths.push_back(writeQuad("poc-asset-loader-priority-" + std::to_string(i) + ".obj", float(i + 1)));
+	}
+
+	// one load per update
+	AssetLoaderSettings settings;
+	settings.maxBytesPerUpdate = 1;
+	AssetLoader loader(settings);
+	Scene scene;
+	std::vector<std::string> order;
+	const auto record = [&order](Scene&, const LoadResult& result) {
+		order.push_back(result.path);
+	};
+	loader.load(paths[0].string(), -1, {}, record);
+	loader.load(paths[1].string(), 0, {}, record);
+	loader.load(paths[2].string(), 5, {}, record);
+
+	waitLoaded(loader);
+	loader.update(scene, 0);
+	EXPECT_EQ(scene.getMeshes().size(), 1u);
+	updateUntilDone(loader, scene);
+
+	EXPECT_EQ(order, (std::vector<std::string>{ paths[2].string(), paths[1].string(), paths[0].string() }));
+	for (const fs::path& path : paths) {
+		fs::remove(path);
+	}
+}
+
+TEST(AssetLoader, LoaderThreadsShareTheImportJobSystem) {
+	// rows of quads, split in chunks parsed by the workers
+	const fs::path grid = fs::temp_directory_path() / "poc-asset-loader-grid.obj";
+	{
+		std::ofstream file(grid, std::ios::trunc);
+		for (int row = 0; row <= 256; ++row) {
+			file << "v 0 " << row << " 0\nv 1 " << row << " 0\n";
+		}
+		for (int row = 0; row < 256; ++row) {
+			file << "f " << 2 * row + 1 << " " << 2 * row + 2 << " " << 2 * row + 4 << " " << 2 * row + 3 << "\n";
+		}
+	}
+
+	AssetLoaderSettings settings;
+	settings.threadCount = 3;
+	settings.importThreadCount = 4;
+	AssetLoader loader(settings);
+	Scene scene;
+	std::vector<std::shared_future<LoadResult>> loads;
+	for (int i = 0; i < 6; ++i) {
+		loads.push_back(loader.load(grid.string()));
+	}
+	updateUntilDone(loader, scene);
+
+	for (const std::shared_future<LoadResult>& load : loads) {
+		ASSERT_EQ(load.get().status, LoadStatus::RESIDENT);
+		ASSERT_EQ(load.get().meshes.size(), 1u);
+		EXPECT_EQ(scene.getMeshes()[load.get().meshes[0]].indexCount, 256u * 6u);
+	}
+	fs::remove(grid);
+}
+
+TEST(AssetLoader, FramesKeepRunningDuringALargeImport) {
+	const fs::path grid = fs::temp_directory_path() / "poc-asset-loader-large.obj";
+	{
+		std::ofstream file(grid, std::ios::trunc);
+		const int rows = 200000;
+		for (int row = 0; row <= rows; ++row) {
+			file << "v 0.000000 " << row << ".000000 0.000000\nv 1.000000 " << row << ".000000 0.000000\n";
+		}
+		for (int row = 0; row < rows; ++row) {
+			file << "f " << 2 * row + 1 << " " << 2 * row + 2 << " " << 2 * row + 4 << " " << 2 * row + 3 << "\n";
+		}
+	}
+
+	// the job system of the frames, as the transforms & the culling use it
+	JobSystem frameJobs(2);
+	AssetLoader loader;
+	Scene scene;
+	const auto start = std::chrono::steady_clock::now();
+	const std::shared_future<LoadResult> load = loader.load(grid.string());
+
+	std::chrono::steady_clock::duration longestFrame{ 0 };
+	int frameCount = 0;
+	while (loader.getLoadingCount() > 0) {
+		const auto frameStart = std::chrono::steady_clock::now();
+		frameJobs.parallelFor(64, 1, [](size_t, size_t) {});
+		longestFrame = std::max(longestFrame, std::chrono::steady_clock::now() - frameStart);
+		++frameCount;
+	}
+	const auto importTime = std::chrono::steady_clock::now() - start;
+	updateUntilDone(loader, scene);
+
+	ASSERT_EQ(load.get().status, LoadStatus::RESIDENT);
+	EXPECT_GT(frameCount, 1);
+	// far shorter than the parse passes of the import
+	EXPECT_LT(longestFrame, std::chrono::milliseconds(20)) << "import " << std::chrono::duration_cast<std::chrono::milliseconds>(importTime).count() << " ms";
+	fs::remove(grid);
+}
+
+TEST(AssetLoader, CancelledAndFailedLoadsComplete) {
+	const fs::path obj = writeQuad("poc-asset-loader-cancel.obj", 1.0f);
+	AssetLoader loader;
+	Scene scene;
+
+	const CancellationToken token;
+	int callbackCount = 0;
+	const std::shared_future<LoadResult> cancelled = loader.load(obj.string(), 0, token, [&callbackCount](Scene&, const LoadResult&) { ++callbackCount; });
+	const std::shared_future<LoadResult> missing = loader.load((fs::temp_directory_path() / "poc-missing-mesh.obj").string());
+	waitLoaded(loader);
+	token.cancel();
+	updateUntilDone(loader, scene);
+
+	EXPECT_EQ(cancelled.get().status, LoadStatus::CANCELLED);
+	EXPECT_EQ(callbackCount, 1);
+	EXPECT_EQ(missing.get().status, LoadStatus::FAILED);
+	EXPECT_FALSE(missing.get().error.empty());
+	EXPECT_TRUE(scene.getMeshes().empty());
+
+	// the loader completes what is left when destroyed
+	std::shared_future<LoadResult> abandoned;
+	{
+		AssetLoader stopped;
+		abandoned = stopped.load(obj.string());
+	}
+	EXPECT_EQ(abandoned.get().status, LoadStatus::CANCELLED);
+
+	fs::remove(obj);
+}
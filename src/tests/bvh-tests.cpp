@@ -0,0 +1,200 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <random>
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "core/bvh.hpp"
+#include "core/scene-bvh.hpp"
+
+using namespace poc;
+
+static std::vector<Aabb> makeBoxes(size_t count, float range, uint32_t seed) {
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> position(-range, range);
+	std::uniform_real_distribution<float> size(0.1f, 2.0f);
+	std::vector<Aabb> boxes(count);
+	for (Aabb& box : boxes) {
+		const glm::vec3 center(position(random), position(random), position(random));
+		const glm::vec3 extent(size(random), size(random), size(random));
+		box = Aabb{ center - extent, center + extent };
+	}
+	return boxes;
+}
+
+static Frustum makeFrustum() {
+	const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 1.0f, 0.1f, 40.0f);
+	const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 30.0f), glm::vec3(10.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	return Frustum::fromViewProjection(projection * view);
+}
+
+static std::vector<uint32_t> sorted(std::vector<uint32_t> objects) {
+	std::sort(objects.begin(), objects.end());
+	return objects;
+}
+
+// the queries of the tree give the same objects as testing all the boxes
+static void expectSameQueries(const Bvh& bvh, const std::vector<Aabb>& boxes) {
+	const Frustum frustum = makeFrustum();
+	std::vector<uint32_t> expected;
+	for (uint32_t i = 0; i < boxes.size(); ++i) {
+		if (frustum.intersects(boxes[i])) {
+			expected.push_back(i);
+		}
+	}
+	std::vector<uint32_t> visible;
+	bvh.cull(frustum, visible);
+	EXPECT_EQ(sorted(visible), expected);
+
+	const Aabb region{ glm::vec3(-5.0f), glm::vec3(5.0f) };
+	expected.clear();
+	for (uint32_t i = 0; i < boxes.size(); ++i) {
+		if (boxes[i].overlaps(region)) {
+			expected.push_back(i);
+		}
+	}
+	std::vector<uint32_t> overlapping;
+	bvh.overlap(region, overlapping);
+	EXPECT_EQ(sorted(overlapping), expected);
+
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+	for (int r = 0; r < 20; ++r) {
+		const Ray ray{ glm::vec3(0.0f, 0.0f, 60.0f), glm::normalize(glm::vec3(direction(random) * 0.5f, direction(random) * 0.5f, -1.0f)) };
+		const glm::vec3 inverseDirection = 1.0f / ray.direction;
+
+		float nearest = std::numeric_limits<float>::max();
+		for (const Aabb& box : boxes) {
+			const glm::vec3 t1 = (box.min - ray.origin) * inverseDirection;
+			const glm::vec3 t2 = (box.max - ray.origin) * inverseDirection;
+			const float entry = std::max({ std::min(t1.x, t2.x), std::min(t1.y, t2.y), std::min(t1.z, t2.z), 0.0f });
+			const float exit = std::min({ std::max(t1.x, t2.x), std::max(t1.y, t2.y), std::max(t1.z, t2.z) });
+			if (entry <= exit) {
+				nearest = std::min(nearest, entry);
+			}
+		}
+
+		const RayHit hit = bvh.raycast(ray);
+		ASSERT_EQ(hit.isHit(), nearest != std::numeric_limits<float>::max());
+		if (hit.isHit()) {
+			EXPECT_FLOAT_EQ(hit.distance, nearest);
+		}
+	}
+}
+
+TEST(Bvh, QueriesMatchTestingAllTheObjects) {
+	const std::vector<Aabb> boxes = makeBoxes(5000, 50.0f, 1);
+	Bvh bvh;
+	bvh.build(boxes);
+
+	EXPECT_EQ(bvh.getObjectCount(), boxes.size());
+	EXPECT_GT(bvh.getNodes().size(), boxes.size() / (4 * Bvh::maxLeafSize));
+	expectSameQueries(bvh, boxes);
+}
+
+TEST(Bvh, FewObjectsFitInTheRoot) {
+	const std::vector<Aabb> boxes = makeBoxes(3, 10.0f, 2);
+	Bvh bvh;
+	bvh.build(boxes);
+	EXPECT_EQ(bvh.getNodes().size(), 1u);
+	expectSameQueries(bvh, boxes);
+
+	bvh.build({});
+	std::vector<uint32_t> visible;
+	bvh.cull(makeFrustum(), visible);
+	EXPECT_TRUE(visible.empty());
+	EXPECT_FALSE(bvh.raycast(Ray{}).isHit());
+}
+
+TEST(Bvh, RefitFollowsMovingObjects) {
+	std::vector<Aabb> boxes = makeBoxes(2000, 50.0f, 3);
+	Bvh bvh;
+	bvh.build(boxes);
+	const size_t nodeCount = bvh.getNodes().size();
+
+	for (Aabb& box : boxes) {
+		box.min.x += 0.5f;
+		box.max.x += 0.5f;
+	}
+	bvh.update(boxes);
+
+	// a small motion keeps the topology
+	EXPECT_EQ(bvh.getLastRebuildCount(), 0u);
+	EXPECT_EQ(bvh.getNodes().size(), nodeCount);
+	expectSameQueries(bvh, boxes);
+}
+
+TEST(Bvh, DegradedSubtreesAreRebuilt) {
+	std::vector<Aabb> boxes = makeBoxes(4000, 50.0f, 4);
+	Bvh bvh;
+	bvh.build(boxes);
+	const float buildCost = bvh.getCost();
+
+	// scatter the objects of one corner only: the subtrees containing them degrade, not the whole tree
+	std::mt19937 random(5);
+	std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+	size_t movedCount = 0;
+	for (Aabb& box : boxes) {
+		if (box.getCenter().x > 40.0f && box.getCenter().y > 40.0f) {
+			const glm::vec3 move(position(random) - box.getCenter().x, 0.0f, 0.0f);
+			box = Aabb{ box.min + move, box.max + move };
+			++movedCount;
+		}
+	}
+	ASSERT_GT(movedCount, 0u);
+	bvh.refit(boxes);
+	const float degradedCost = bvh.getCost();
+	EXPECT_GT(degradedCost, buildCost);
+
+	bvh.update(boxes);
+	EXPECT_GT(bvh.getLastRebuildCount(), 1u);
+	EXPECT_LT(bvh.getCost(), degradedCost);
+	expectSameQueries(bvh, boxes);
+
+	// shuffle everything: the root itself degrades and the whole tree is rebuilt
+	boxes = makeBoxes(4000, 50.0f, 6);
+	bvh.update(boxes);
+	EXPECT_EQ(bvh.getLastRebuildCount(), 1u);
+	EXPECT_LT(bvh.getCost(), buildCost * Bvh::rebuildRatio);
+	expectSameQueries(bvh, boxes);
+}
+
+TEST(SceneBvh, PicksTheNearestEntity) {
+	Scene scene;
+	const uint32_t mesh = scene.addMesh(Mesh(std::vector<Vertex>{
+		Vertex{ glm::vec3(-0.5f, -0.5f, 0.0f), glm::vec3(1.0f) },
+		Vertex{ glm::vec3(0.5f, -0.5f, 0.0f), glm::vec3(1.0f) },
+		Vertex{ glm::vec3(0.0f, 0.5f, 0.0f), glm::vec3(1.0f) }
+	}));
+
+	std::vector<Entity> entities;
+	for (int i = 0; i < 100; ++i) {
+		entities.push_back(scene.createEntity(mesh));
+		const TransformNode node = scene.getWorld().get<TransformComponent>(entities.back()).node;
+		scene.getTransforms().setLocalPosition(node, glm::vec3(float(i % 10) * 2.0f, float(i / 10) * 2.0f, -float(i)));
+	}
+
+	JobSystem jobs(2);
+	scene.getTransforms().update(jobs);
+	SceneBvh sceneBvh;
+	sceneBvh.update(scene, jobs);
+
+	// entity 23 is at (6, 4, -23)
+	SceneRayHit hit = sceneBvh.raycast(Ray{ glm::vec3(6.0f, 4.0f, 10.0f), glm::vec3(0.0f, 0.0f, -1.0f) });
+	ASSERT_TRUE(hit.isHit());
+	EXPECT_EQ(hit.entity, entities[23]);
+	EXPECT_FLOAT_EQ(hit.distance, 33.0f);
+
+	std::vector<Entity> overlapping;
+	sceneBvh.overlap(Aabb{ glm::vec3(-0.1f, -0.1f, -1.0f), glm::vec3(0.1f, 0.1f, 1.0f) }, overlapping);
+	ASSERT_EQ(overlapping.size(), 1u);
+	EXPECT_EQ(overlapping[0], entities[0]);
+
+	// destroyed entities leave the tree
+	scene.getWorld().destroy(entities[23]);
+	sceneBvh.update(scene, jobs);
+	hit = sceneBvh.raycast(Ray{ glm::vec3(6.0f, 4.0f, 10.0f), glm::vec3(0.0f, 0.0f, -1.0f) });
+	EXPECT_FALSE(hit.isHit());
+	EXPECT_EQ(sceneBvh.getEntities().size(), 99u);
+}
@@ -0,0 +1,111 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "rendering/draw-collector.hpp"
+#include "test-meshes.hpp"
+
+using namespace poc;
+
+TEST(DrawPackets, KeysOrderPassPipelineMaterialThenDepth) {
+	const uint64_t key = SortKey::make(DrawPass::OPAQUE, 4, 1000, 12.5f);
+	EXPECT_EQ(SortKey::getPass(key), DrawPass::OPAQUE);
+	EXPECT_EQ(SortKey::getPipeline(key), 4u);
+	EXPECT_EQ(SortKey::getMaterial(key), 1000u);
+
+	EXPECT_LT(SortKey::make(DrawPass::OPAQUE, 0, 1, 0.5f), SortKey::make(DrawPass::OPAQUE, 0, 1, 100.0f));
+	EXPECT_LT(SortKey::make(DrawPass::OPAQUE, 0, 1, 100.0f), SortKey::make(DrawPass::OPAQUE, 0, 2, 0.5f));
+	EXPECT_LT(SortKey::make(DrawPass::OPAQUE, 0, 1000, 100.0f), SortKey::make(DrawPass::OPAQUE, 1, 0, 0.5f));
+	// behind the camera is the nearest
+	EXPECT_EQ(SortKey::make(DrawPass::OPAQUE, 0, 0, -3.0f), SortKey::make(DrawPass::OPAQUE, 0, 0, 0.0f));
+
+	for (const VertexFormat format : vertexFormats) {
+		for (const bool instanced : { false, true }) {
+			const uint32_t pipeline = SortKey::getPacketPipeline(format, instanced);
+			EXPECT_EQ(SortKey::getFormat(pipeline), format);
+			EXPECT_EQ(SortKey::isInstanced(pipeline), instanced);
+		}
+	}
+}
+
+TEST(DrawPackets, RadixSortIsStable) {
+	std::mt19937 generator(5);
+	std::uniform_int_distribution<uint32_t> pipeline(0, 5);
+	std::uniform_int_distribution<uint32_t> material(0, 300);
+	std::uniform_real_distribution<float> depth(-10.0f, 1000.0f);
+
+	std::vector<DrawPacket> packets;
+	for (uint32_t i = 0; i < 20000; ++i) {
+		// few depths: many equal keys
+		packets.push_back(DrawPacket{ SortKey::make(DrawPass::OPAQUE, pipeline(generator), material(generator), std::floor(depth(generator) / 100.0f)), i });
+	}
+	std::vector<DrawPacket> expected = packets;
+	std::stable_sort(expected.begin(), expected.end(), [](const DrawPacket& a, const DrawPacket& b) {
+		return a.key < b.key;
+	});
+
+	std::vector<DrawPacket> scratch;
+	DrawPackets::sort(packets, scratch);
+	ASSERT_EQ(packets.size(), expected.size());
+	for (size_t i = 0; i < packets.size(); ++i) {
+		EXPECT_EQ(packets[i].key, expected[i].key);
+		EXPECT_EQ(packets[i].payload, expected[i].payload);
+	}
+}
+
+TEST(DrawPackets, CollectedDrawsAreGroupedAndFrontToBack) {
+	Scene scene;
+	scene.getCamera().setProjection(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f));
+	scene.getCamera().setView(glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+
+	const uint32_t quad = scene.addMesh(makeQuad(0.5f));
+	Mesh packedQuad = makeQuad(0.5f);
+	packedQuad.setVertexFormat(VertexFormat::SNORM16_POSITION);
+	const uint32_t packed = scene.addMesh(std::move(packedQuad));
+
+	// the meshes alternate, the farthest first
+	for (int i = 0; i < 20; ++i) {
+		const Entity entity = scene.createEntity(i % 2 == 0 ? quad : packed);
+		scene.getTransforms().setLocalPosition(scene.getWorld().get<TransformComponent>(entity).node, glm::vec3(0.0f, 0.0f, -float(40 - i)));
+	}
+	const std::vector<glm::mat4> instances{ glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -5.0f)) };
+	scene.addInstances(quad, instances);
+
+	JobSystem jobs(2);
+	scene.getTransforms().update(jobs);
+	DrawCollector collector;
+	collector.collect(scene, jobs, 720);
+
+	const std::vector<DrawPacket>& packets = collector.getPackets();
+	ASSERT_EQ(packets.size(), 21u);
+	EXPECT_TRUE(std::is_sorted(packets.begin(), packets.end(), [](const DrawPacket& a, const DrawPacket& b) {
+		return a.key < b.key;
+	}));
+
+	// a pipeline change per format & the instanced one
+	uint32_t pipelineChanges = 0;
+	float previousDepth = 0.0f;
+	for (size_t i = 0; i < packets.size(); ++i) {
+		const uint32_t pipeline = SortKey::getPipeline(packets[i].key);
+		const VertexFormat format = SortKey::getFormat(pipeline);
+		if (i == 0 || pipeline != SortKey::getPipeline(packets[i - 1].key)) {
+			++pipelineChanges;
+			previousDepth = 0.0f;
+		}
+
+		if (SortKey::isInstanced(pipeline)) {
+			EXPECT_EQ(collector.getInstancedDraws(format)[packets[i].payload].batch, 0u);
+			continue;
+		}
+		const Draw& draw = collector.getDraws(format)[packets[i].payload];
+		EXPECT_EQ(SortKey::getMaterial(packets[i].key), draw.mesh);
+		const float depth = -scene.getTransforms().getWorldMatrix(draw.node)[3].z;
+		EXPECT_GT(depth, previousDepth);
+		previousDepth = depth;
+	}
+	EXPECT_EQ(pipelineChanges, 3u);
+}
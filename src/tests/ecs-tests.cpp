@@ -0,0 +1,144 @@
+#include "gtest/gtest.h"
+
+#include "core/ecs/command-buffer.hpp"
+#include "core/ecs/world.hpp"
+
+using namespace poc;
+
+namespace {
+
+	struct Position {
+		float x, y, z;
+	};
+
+	struct Velocity {
+		float x, y, z;
+	};
+
+	struct Tag {
+		uint32_t value;
+	};
+
+}
+
+TEST(World, DestroyedEntitiesAreNotAliveAndTheirSlotIsReused) {
+	World world;
+	const Entity first = world.create(Position{ 1.0f, 2.0f, 3.0f });
+	world.destroy(first);
+	EXPECT_FALSE(world.isAlive(first));
+
+	const Entity second = world.create(Position{ 4.0f, 5.0f, 6.0f });
+	EXPECT_EQ(second.index, first.index);
+	EXPECT_NE(second.generation, first.generation);
+	EXPECT_TRUE(world.isAlive(second));
+	EXPECT_FALSE(world.isAlive(Entity{}));
+	EXPECT_EQ(world.getEntityCount(), 1u);
+}
+
+TEST(World, AddingAndRemovingComponentsKeepsTheValues) {
+	World world;
+	const Entity entity = world.create(Position{ 1.0f, 2.0f, 3.0f });
+
+	world.add(entity, Velocity{ 4.0f, 5.0f, 6.0f });
+	ASSERT_TRUE(world.has<Velocity>(entity));
+	EXPECT_FLOAT_EQ(world.get<Position>(entity).y, 2.0f);
+	EXPECT_FLOAT_EQ(world.get<Velocity>(entity).z, 6.0f);
+
+	world.remove<Position>(entity);
+	EXPECT_FALSE(world.has<Position>(entity));
+	EXPECT_FLOAT_EQ(world.get<Velocity>(entity).x, 4.0f);
+}
+
+TEST(World, ChunksStayPackedWhenEntitiesAreDestroyed) {
+	World world;
+	std::vector<Entity> entities;
+	for (uint32_t i = 0; i < 5000; ++i) {
+		entities.push_back(world.create(Position{ float(i), 0.0f, 0.0f }, Tag{ i }));
+	}
+	for (uint32_t i = 0; i < 5000; i += 2) {
+		world.destroy(entities[i]);
+	}
+
+	size_t count = 0;
+	size_t chunks = 0;
+	world.forEachChunk<Position, const Tag>([&](span<const Entity> chunkEntities, span<Position> positions, span<const Tag> tags) {
+		++chunks;
+		for (size_t i = 0; i < chunkEntities.size(); ++i) {
+			// components of a row belong to the entity of the row
+			EXPECT_EQ(positions[i].x, float(tags[i].value));
+			EXPECT_EQ(tags[i].value % 2, 1u);
+			EXPECT_EQ(world.get<Tag>(chunkEntities[i]).value, tags[i].value);
+		}
+		count += chunkEntities.size();
+	});
+
+	EXPECT_EQ(count, 2500u);
+	EXPECT_GT(chunks, 1u);
+}
+
+TEST(World, IterationOnlyVisitsMatchingArchetypes) {
+	World world;
+	world.create(Position{ 0.0f, 0.0f, 0.0f });
+	world.create(Position{ 0.0f, 0.0f, 0.0f }, Velocity{ 1.0f, 0.0f, 0.0f });
+	world.create(Velocity{ 1.0f, 0.0f, 0.0f });
+
+	world.forEach<Position, const Velocity>([](Entity, Position& position, const Velocity& velocity) {
+		position.x += velocity.x;
+	});
+
+	float sum = 0.0f;
+	size_t count = 0;
+	const World& constWorld = world;
+	constWorld.forEach<const Position>([&](Entity, const Position& position) {
+		sum += position.x;
+		++count;
+	});
+	EXPECT_EQ(count, 2u);
+	EXPECT_FLOAT_EQ(sum, 1.0f);
+}
+
+TEST(World, CopiesAreIndependent) {
+	World world;
+	const Entity entity = world.create(Position{ 1.0f, 0.0f, 0.0f });
+
+	World copy = world;
+	copy.get<Position>(entity).x = 2.0f;
+
+	EXPECT_FLOAT_EQ(world.get<Position>(entity).x, 1.0f);
+	EXPECT_FLOAT_EQ(copy.get<Position>(entity).x, 2.0f);
+}
+
+TEST(CommandBuffer, StructuralChangesAreAppliedAfterIteration) {
+	World world;
+	for (uint32_t i = 0; i < 10; ++i) {
+		world.create(Tag{ i });
+	}
+
+	CommandBuffer commands;
+	world.forEach<const Tag>([&](Entity entity, const Tag& tag) {
+		if (tag.value < 5) {
+			commands.destroy(entity);
+		}
+		else {
+			commands.add(entity, Velocity{ float(tag.value), 0.0f, 0.0f });
+		}
+	});
+	const CommandBuffer::PendingEntity pending = commands.create(Position{ 7.0f, 8.0f, 9.0f }, Tag{ 42 });
+	commands.add(pending, Velocity{ 1.0f, 2.0f, 3.0f });
+
+	EXPECT_EQ(world.getEntityCount(), 10u);
+	commands.apply(world);
+	EXPECT_TRUE(commands.isEmpty());
+
+	EXPECT_EQ(world.getEntityCount(), 6u);
+	const Entity created = commands.getEntity(pending);
+	EXPECT_EQ(world.get<Tag>(created).value, 42u);
+	EXPECT_FLOAT_EQ(world.get<Position>(created).y, 8.0f);
+	EXPECT_FLOAT_EQ(world.get<Velocity>(created).z, 3.0f);
+
+	size_t moving = 0;
+	world.forEach<const Velocity>([&](Entity, const Velocity&) {
+		++moving;
+	});
+	EXPECT_EQ(moving, 6u);
+}
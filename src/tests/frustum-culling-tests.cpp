@@ -0,0 +1,143 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <random>
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "core/camera.hpp"
+#include "core/frustum-culling.hpp"
+#include "rendering/draw-collector.hpp"
+#include "test-meshes.hpp"
+
+using namespace poc;
+
+static Mesh makeTriangle() {
+	return Mesh(std::vector<Vertex>{
+		Vertex{ glm::vec3(0.0f, -0.5f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f) },
+		Vertex{ glm::vec3(-0.5f, 0.5f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f) },
+		Vertex{ glm::vec3(0.5f, 0.5f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f) }
+	});
+}
+
+TEST(Frustum, PlanesMatchTheCameraVolume) {
+	const Frustum frustum = makePerspectiveCamera(glm::vec3(0.0f, 0.0f, 5.0f), glm::vec3(0.0f)).getFrustum();
+
+	EXPECT_TRUE(frustum.intersects(BoundingSphere{ glm::vec3(0.0f), 0.1f }));
+	// behind the camera, beyond the far plane & far on the side
+	EXPECT_FALSE(frustum.intersects(BoundingSphere{ glm::vec3(0.0f, 0.0f, 10.0f), 1.0f }));
+	EXPECT_FALSE(frustum.intersects(BoundingSphere{ glm::vec3(0.0f, 0.0f, -200.0f), 1.0f }));
+	EXPECT_FALSE(frustum.intersects(BoundingSphere{ glm::vec3(50.0f, 0.0f, 0.0f), 1.0f }));
+	// center outside but touching the volume
+	EXPECT_TRUE(frustum.intersects(BoundingSphere{ glm::vec3(0.0f, 0.0f, 10.0f), 6.0f }));
+}
+
+TEST(FrustumCulling, SimdMatchesTheScalarTest) {
+	const Frustum frustum = makePerspectiveCamera(glm::vec3(0.0f, 0.0f, 5.0f), glm::vec3(0.0f)).getFrustum();
+
+	// not a multiple of the SIMD width nor of the batch size to cover the tails
+	const size_t count = FrustumCulling::batchSize * 2 + 7;
+	std::mt19937 random(42);
+	std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+	std::uniform_real_distribution<float> radius(0.0f, 5.0f);
+	std::vector<float> x(count), y(count), z(count), r(count);
+	for (size_t i = 0; i < count; ++i) {
+		x[i] = position(random);
+		y[i] = position(random);
+		z[i] = position(random);
+		r[i] = radius(random);
+	}
+
+	std::vector<uint8_t> visibility(count);
+	JobSystem jobs(2);
+	const size_t visibleCount = FrustumCulling::cull(frustum, SphereArrays{ x, y, z, r }, visibility, jobs);
+
+	size_t expectedCount = 0;
+	for (size_t i = 0; i < count; ++i) {
+		const bool expected = frustum.intersects(BoundingSphere{ glm::vec3(x[i], y[i], z[i]), r[i] });
+		EXPECT_EQ(visibility[i] != 0, expected) << "sphere " << i;
+		expectedCount += expected ? 1 : 0;
+	}
+	EXPECT_EQ(visibleCount, expectedCount);
+	EXPECT_GT(visibleCount, 0u);
+	EXPECT_LT(visibleCount, count);
+}
+
+TEST(MeshBounds, SphereContainsAllTheVertices) {
+	const Mesh mesh = makeTriangle();
+	const Aabb& aabb = mesh.getAabb();
+	EXPECT_FLOAT_EQ(aabb.min.x, -0.5f);
+	EXPECT_FLOAT_EQ(aabb.max.y, 0.5f);
+
+	const BoundingSphere& sphere = mesh.getBoundingSphere();
+	for (const Vertex& vertex : mesh.getVertices()) {
+		EXPECT_LE(glm::length(vertex.position - sphere.center), sphere.radius + 1e-6f);
+	}
+
+	const BoundingSphere scaled = transformSphere(sphere, glm::scale(glm::mat4(1.0f), glm::vec3(1.0f, 3.0f, 2.0f)));
+	EXPECT_FLOAT_EQ(scaled.radius, sphere.radius * 3.0f);
+}
+
+TEST(DrawCollector, OnlyVisibleEntitiesAreDrawn) {
+	Scene scene;
+	scene.getCamera() = makePerspectiveCamera(glm::vec3(0.0f, 0.0f, 5.0f), glm::vec3(0.0f));
+	const uint32_t mesh = scene.addMesh(makeTriangle());
+
+	for (int i = 0; i < 10; ++i) {
+		const Entity entity = scene.createEntity(mesh);
+		const TransformNode node = scene.getWorld().get<TransformComponent>(entity).node;
+		// the odd entities are behind the camera
+		scene.getTransforms().setLocalPosition(node, glm::vec3(0.0f, 0.0f, i % 2 == 0 ? -float(i) : 10.0f + float(i)));
+	}
+
+	JobSystem jobs(2);
+	scene.getTransforms().update(jobs);
+
+	DrawCollector collector;
+	collector.collect(scene, jobs, 720);
+
+	const FrameStats& stats = collector.getFrameStats();
+	EXPECT_EQ(stats.objectCount, 10u);
+	EXPECT_EQ(stats.visibleCount, 5u);
+	EXPECT_EQ(stats.culledCount, 5u);
+	EXPECT_EQ(collector.getDraws(VertexFormat::FLOAT32).size(), 5u);
+	EXPECT_TRUE(collector.getDraws(VertexFormat::SNORM16_POSITION).empty());
+}
+
+TEST(DrawCollector, BvhCullingDrawsTheSameEntities) {
+	Scene scene;
+	scene.getCamera() = makePerspectiveCamera(glm::vec3(0.0f, 0.0f, 5.0f), glm::vec3(0.0f));
+	const uint32_t mesh = scene.addMesh(makeSphere(4, 8));
+
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+	for (int i = 0; i < 2000; ++i) {
+		const Entity entity = scene.createEntity(mesh);
+		const TransformNode node = scene.getWorld().get<TransformComponent>(entity).node;
+		scene.getTransforms().setLocalPosition(node, glm::vec3(position(random), position(random), position(random)));
+	}
+
+	JobSystem jobs(2);
+	scene.getTransforms().update(jobs);
+	SceneBvh sceneBvh;
+	sceneBvh.update(scene, jobs);
+
+	DrawCollector linear;
+	linear.collect(scene, jobs, 720);
+	DrawCollector hierarchical;
+	hierarchical.collect(scene, sceneBvh, jobs, 720);
+
+	const auto getNodes = [](const DrawCollector& collector) {
+		std::vector<uint32_t> nodes;
+		for (const Draw& draw : collector.getDraws(VertexFormat::FLOAT32)) {
+			nodes.push_back(draw.node.id);
+		}
+		std::sort(nodes.begin(), nodes.end());
+		return nodes;
+	};
+	EXPECT_GT(linear.getFrameStats().visibleCount, 0u);
+	EXPECT_LT(linear.getFrameStats().visibleCount, 2000u);
+	EXPECT_EQ(getNodes(hierarchical), getNodes(linear));
+	EXPECT_EQ(hierarchical.getFrameStats().objectCount, 2000u);
+	EXPECT_EQ(hierarchical.getFrameStats().visibleCount, linear.getFrameStats().visibleCount);
+}
@@ -0,0 +1,132 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "rendering/draw-collector.hpp"
+#include "rendering/gpu-culling.hpp"
+#include "rendering/mesh-simplifier.hpp"
+#include "test-meshes.hpp"
+
+using namespace poc;
+
+// same steps as shaders/cull.comp, the commands of each format are appended in the object order
+static std::vector<std::vector<DrawIndexedIndirectCommand>> cullLikeTheShader(
+	span<const GpuObject> objects,
+	span<const GpuMesh> meshes,
+	const GpuCullingConstants& constants) {
+
+	std::vector<std::vector<DrawIndexedIndirectCommand>> commands(vertexFormats.size());
+	for (uint32_t index = 0; index < constants.objectCount; ++index) {
+		const GpuObject& object = objects[index];
+		const GpuMesh& mesh = meshes[object.mesh];
+		const glm::vec3 center = glm::vec3(object.transform * glm::vec4(glm::vec3(mesh.sphere), 1.0f));
+		const float radius = mesh.sphere.w * object.maxScale;
+
+		bool visible = true;
+		for (const glm::vec4& plane : constants.planes) {
+			visible = visible && glm::dot(glm::vec3(plane), center) + plane.w >= -radius;
+		}
+		if (!visible) {
+			continue;
+		}
+
+		const float w = glm::dot(constants.wRow, glm::vec4(center, 1.0f));
+		uint32_t lod = 0;
+		if (w > 1.0e-7f) {
+			const float pixelsPerUnit = object.maxScale * constants.lodScale / w;
+			for (uint32_t level = 1; level < mesh.lodCount; ++level) {
+				lod += mesh.lods[level].error * pixelsPerUnit <= 1.0f ? 1 : 0;
+			}
+		}
+
+		commands[mesh.format].push_back(DrawIndexedIndirectCommand{
+			mesh.lods[lod].indexCount, 1, mesh.lods[lod].firstIndex, mesh.vertexOffset, index });
+	}
+	return commands;
+}
+
+TEST(GpuCulling, MeshesMirrorTheSceneRanges) {
+	Scene scene;
+	scene.addMesh(makeSphere(8, 16));
+	scene.addMesh(MeshSimplifier::generateLods(makeSphere(16, 32)));
+
+	const std::vector<GpuMesh> meshes = GpuCulling::makeMeshes(scene);
+	ASSERT_EQ(meshes.size(), 2u);
+	for (size_t i = 0; i < meshes.size(); ++i) {
+		const MeshRange& range = scene.getMeshes()[i];
+		EXPECT_EQ(meshes[i].vertexOffset, static_cast<int32_t>(range.firstVertex));
+		EXPECT_EQ(meshes[i].format, static_cast<uint32_t>(range.format));
+		EXPECT_EQ(meshes[i].lodCount, range.lodCount);
+		EXPECT_EQ(meshes[i].sphere.w, range.bounds.sphere.radius);
+		for (uint32_t lod = 0; lod < range.lodCount; ++lod) {
+			EXPECT_EQ(meshes[i].lods[lod].firstIndex, range.lods[lod].firstIndex);
+			EXPECT_EQ(meshes[i].lods[lod].indexCount, range.lods[lod].indexCount);
+		}
+	}
+	EXPECT_GT(meshes[1].lodCount, 1u);
+}
+
+TEST(GpuCulling, CommandsMatchTheCpuDrawsWithoutHysteresis) {
+	Scene scene;
+	scene.getCamera().setProjection(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f));
+	scene.getCamera().setView(glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+	const uint32_t mesh = scene.addMesh(MeshSimplifier::generateLods(makeSphere(32, 64)));
+
+	// a row of spheres going away from the camera, the odd ones are behind it
+	for (int i = 0; i < 40; ++i) {
+		const Entity entity = scene.createEntity(mesh);
+		const float distance = 3.0f + float(i * i) / 2.0f;
+		scene.getTransforms().setLocalPosition(
+			scene.getWorld().get<TransformComponent>(entity).node,
+			glm::vec3(float(i % 5) - 2.0f, 0.0f, i % 2 == 0 ? -distance : distance));
+	}
+
+	JobSystem jobs(2);
+	scene.getTransforms().update(jobs);
+
+	const LodSettings settings{ 1.0f, 0.0f };
+	DrawCollector collector;
+	collector.setLodSettings(settings);
+	collector.collect(scene, jobs, 720);
+
+	std::vector<GpuObject> objects;
+	GpuCulling::makeObjects(scene, objects);
+	const std::vector<GpuMesh> meshes = GpuCulling::makeMeshes(scene);
+	const uint32_t objectCount = static_cast<uint32_t>(objects.size());
+	const GpuCullingConstants constants = GpuCulling::makeConstants(scene.getCamera(), 720.0f, settings, objectCount, objectCount);
+	const std::vector<std::vector<DrawIndexedIndirectCommand>> commands = cullLikeTheShader(objects, meshes, constants);
+
+	ASSERT_EQ(objectCount, collector.getFrameStats().objectCount);
+	// the range of each format is bounded by its objects
+	const std::array<uint32_t, vertexFormats.size()> formatCounts = GpuCulling::countObjects(scene, objects);
+	for (size_t format = 0; format < vertexFormats.size(); ++format) {
+		EXPECT_EQ(formatCounts[format], format == static_cast<size_t>(VertexFormat::FLOAT32) ? objectCount : 0u);
+		EXPECT_LE(commands[format].size(), formatCounts[format]);
+	}
+	const std::vector<Draw>& draws = collector.getDraws(VertexFormat::FLOAT32);
+	const std::vector<DrawIndexedIndirectCommand>& gpuDraws = commands[static_cast<size_t>(VertexFormat::FLOAT32)];
+	ASSERT_EQ(gpuDraws.size(), draws.size());
+	EXPECT_EQ(gpuDraws.size(), 20u);
+
+	// same levels drawn, whatever the order of the entities
+	std::vector<std::tuple<uint32_t, uint32_t>> cpuRanges;
+	for (const Draw& draw : draws) {
+		cpuRanges.emplace_back(draw.firstIndex, draw.indexCount);
+	}
+	std::vector<std::tuple<uint32_t, uint32_t>> gpuRanges;
+	for (const DrawIndexedIndirectCommand& command : gpuDraws) {
+		gpuRanges.emplace_back(command.firstIndex, command.indexCount);
+		EXPECT_EQ(command.instanceCount, 1u);
+		EXPECT_LT(command.firstInstance, objectCount);
+	}
+	std::sort(cpuRanges.begin(), cpuRanges.end());
+	std::sort(gpuRanges.begin(), gpuRanges.end());
+	EXPECT_EQ(gpuRanges, cpuRanges);
+
+	// the far spheres are drawn coarser
+	EXPECT_NE(gpuRanges.front(), gpuRanges.back());
+}
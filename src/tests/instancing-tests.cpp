@@ -0,0 +1,137 @@
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "rendering/draw-collector.hpp"
+#include "rendering/mesh-simplifier.hpp"
+#include "test-meshes.hpp"
+
+using namespace poc;
+
+// rows x rows instances in the plane y = 0, centered on the given position
+static std::vector<glm::mat4> makeGrid(const glm::vec3& center, int rows, float spacing) {
+	std::vector<glm::mat4> transforms;
+	for (int x = 0; x < rows; ++x) {
+		for (int z = 0; z < rows; ++z) {
+			const glm::vec3 offset = glm::vec3(float(x), 0.0f, float(z)) * spacing - glm::vec3(float(rows - 1) * spacing * 0.5f, 0.0f, float(rows - 1) * spacing * 0.5f);
+			transforms.push_back(glm::translate(glm::mat4(1.0f), center + offset));
+		}
+	}
+	return transforms;
+}
+
+TEST(Instancing, InstancesDoNotCopyTheGeometry) {
+	Scene scene;
+	const uint32_t mesh = scene.addMesh(makeSphere(8, 16));
+	const uint32_t vertexCount = scene.getVertexCount();
+	const uint32_t indexCount = scene.getIndexCount();
+
+	const std::vector<glm::mat4> transforms = makeGrid(glm::vec3(0.0f), 100, 3.0f);
+	const uint64_t generation = scene.getGeneration();
+	const uint32_t batch = scene.addInstances(mesh, transforms);
+
+	EXPECT_EQ(scene.getVertexCount(), vertexCount);
+	EXPECT_EQ(scene.getIndexCount(), indexCount);
+	EXPECT_EQ(scene.getInstances().size(), 10000u);
+	EXPECT_NE(scene.getGeneration(), generation);
+
+	const InstanceBatch& instances = scene.getInstanceBatches()[batch];
+	EXPECT_EQ(instances.mesh, mesh);
+	EXPECT_EQ(instances.firstInstance, 0u);
+	EXPECT_EQ(instances.instanceCount, 10000u);
+	EXPECT_FLOAT_EQ(instances.maxScale, 1.0f);
+
+	// the batch sphere bounds every instance sphere
+	const BoundingSphere& sphere = scene.getMeshes()[mesh].bounds.sphere;
+	for (const glm::mat4& transform : transforms) {
+		const BoundingSphere instanceSphere = transformSphere(sphere, transform);
+		EXPECT_LE(glm::distance(instances.bounds.center, instanceSphere.center) + instanceSphere.radius, instances.bounds.radius * 1.0001f);
+	}
+}
+
+TEST(Instancing, PackedInstancesKeepTheTransformAndColor) {
+	const glm::mat4 transform = glm::scale(glm::rotate(glm::translate(glm::mat4(1.0f), glm::vec3(1.0f, 2.0f, 3.0f)), 0.5f, glm::vec3(0.0f, 1.0f, 0.0f)), glm::vec3(2.0f));
+	const Instance instance = VertexQuantization::packInstance(transform, glm::vec3(1.0f, 0.5f, 0.0f));
+
+	const glm::mat4 unpacked = VertexQuantization::unpackInstanceTransform(instance);
+	for (glm::length_t column = 0; column < 4; ++column) {
+		for (glm::length_t row = 0; row < 4; ++row) {
+			EXPECT_FLOAT_EQ(unpacked[column][row], transform[column][row]);
+		}
+	}
+	EXPECT_EQ(instance.color[0], 255);
+	EXPECT_EQ(instance.color[1], 128);
+	EXPECT_EQ(instance.color[2], 0);
+	EXPECT_EQ(instance.color[3], 255);
+}
+
+TEST(Instancing, BatchesAreCulledAndDrawnOnce) {
+	Scene scene;
+	scene.getCamera() = makePerspectiveCamera(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), 1000.0f);
+	const uint32_t mesh = scene.addMesh(MeshSimplifier::generateLods(makeSphere(32, 64)));
+
+	const std::vector<glm::mat4> near = makeGrid(glm::vec3(0.0f, 0.0f, -20.0f), 4, 3.0f);
+	const std::vector<glm::mat4> far = makeGrid(glm::vec3(0.0f, 0.0f, -800.0f), 4, 3.0f);
+	const std::vector<glm::mat4> behind = makeGrid(glm::vec3(0.0f, 0.0f, 50.0f), 4, 3.0f);
+	scene.addInstances(mesh, near);
+	scene.addInstances(mesh, far);
+	scene.addInstances(mesh, behind);
+
+	DrawCollector collector;
+	collector.collectInstances(scene, 720);
+
+	const std::vector<InstancedDraw>& draws = collector.getInstancedDraws(VertexFormat::FLOAT32);
+	ASSERT_EQ(draws.size(), 2u);
+	EXPECT_EQ(draws[0].batch, 0u);
+	EXPECT_EQ(draws[1].batch, 1u);
+	// the whole far batch is drawn coarser
+	EXPECT_LT(draws[0].lod, draws[1].lod);
+	EXPECT_LT(draws[1].indexCount, draws[0].indexCount);
+
+	const FrameStats& stats = collector.getFrameStats();
+	EXPECT_EQ(stats.instanceCount, 48u);
+	EXPECT_EQ(stats.culledInstanceCount, 16u);
+	EXPECT_EQ(stats.triangleCount, (draws[0].indexCount + draws[1].indexCount) / 3 * 16);
+	EXPECT_EQ(stats.objectCount, 0u);
+}
+
+TEST(Instancing, AppendsKeepTheBatchLevels) {
+	Scene scene;
+	const uint32_t mesh = scene.addMesh(MeshSimplifier::generateLods(makeSphere(32, 64)));
+	const std::vector<glm::mat4> transforms{ glm::mat4(1.0f) };
+	scene.addInstances(mesh, transforms);
+	const InstanceBatch batch = scene.getInstanceBatches()[0];
+	const MeshRange range = scene.getMeshes()[mesh];
+
+	DrawCollector collector;
+	scene.getCamera() = makePerspectiveCamera(glm::vec3(0.0f, 0.0f, 400.0f), glm::vec3(0.0f), 1000.0f);
+	collector.collectInstances(scene, 720);
+	ASSERT_EQ(collector.getInstancedDraws(VertexFormat::FLOAT32).size(), 1u);
+	const uint32_t level = collector.getInstancedDraws(VertexFormat::FLOAT32)[0].lod;
+	ASSERT_GT(level, 0u);
+
+	// closer, where the level is only kept by the hysteresis
+	float distance = 400.0f;
+	for (; distance > 1.0f; distance *= 0.99f) {
+		const Camera camera = makePerspectiveCamera(glm::vec3(0.0f, 0.0f, distance), glm::vec3(0.0f), 1000.0f);
+		const float pixelsPerUnit = LodSelection::getPixelsPerUnit(camera, batch.bounds, batch.maxScale, 720.0f);
+		if (range.lods[level].error * pixelsPerUnit > 0.85f) {
+			ASSERT_LE(range.lods[level].error * pixelsPerUnit, 1.0f);
+			break;
+		}
+	}
+	scene.getCamera() = makePerspectiveCamera(glm::vec3(0.0f, 0.0f, distance), glm::vec3(0.0f), 1000.0f);
+
+	// a streamed mesh does not reset the level of the batch
+	scene.addMesh(makeQuad(1.0f));
+	collector.collectInstances(scene, 720);
+	ASSERT_EQ(collector.getInstancedDraws(VertexFormat::FLOAT32).size(), 1u);
+	EXPECT_EQ(collector.getInstancedDraws(VertexFormat::FLOAT32)[0].lod, level);
+
+	// without a previous level, a finer one is drawn
+	DrawCollector fresh;
+	fresh.collectInstances(scene, 720);
+	EXPECT_LT(fresh.getInstancedDraws(VertexFormat::FLOAT32)[0].lod, level);
+}
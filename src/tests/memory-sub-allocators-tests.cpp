@@ -0,0 +1,132 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+#include "rendering/memory-sub-allocators.hpp"
+
+using namespace poc;
+
+TEST(TlsfAllocator, AllocationsAreAlignedAndDisjoint) {
+	constexpr uint64_t blockSize = 1 << 20;
+	TlsfAllocator allocator(blockSize);
+	std::mt19937 random(1);
+	std::uniform_int_distribution<uint64_t> sizes(1, 4096);
+	std::uniform_int_distribution<uint32_t> alignmentShifts(0, 8);
+
+	// offset -> (end, allocation) of the live allocations
+	std::map<uint64_t, std::pair<uint64_t, TlsfAllocation>> live;
+	uint64_t usedSize = 0;
+	for (int i = 0; i < 20000; ++i) {
+		if (!live.empty() && random() % 3 == 0) {
+			auto it = live.begin();
+			std::advance(it, random() % live.size());
+			usedSize -= it->second.first - it->first;
+			allocator.free(it->second.second);
+			live.erase(it);
+			continue;
+		}
+
+		const uint64_t size = sizes(random);
+		const uint64_t alignment = uint64_t(1) << alignmentShifts(random);
+		const TlsfAllocation allocation = allocator.allocate(size, alignment);
+		if (!allocation.isValid()) {
+			continue;
+		}
+		EXPECT_EQ(allocation.offset % alignment, 0u);
+		EXPECT_LE(allocation.offset + size, blockSize);
+
+		const auto next = live.lower_bound(allocation.offset);
+		if (next != live.end()) {
+			EXPECT_LE(allocation.offset + size, next->first);
+		}
+		if (next != live.begin()) {
+			EXPECT_LE(std::prev(next)->second.first, allocation.offset);
+		}
+		live.emplace(allocation.offset, std::make_pair(allocation.offset + size, allocation));
+		usedSize += size;
+	}
+	EXPECT_EQ(allocator.getAllocationCount(), live.size());
+	EXPECT_EQ(allocator.getUsedSize(), usedSize);
+
+	// the free ranges are merged back into the whole block
+	for (const auto& entry : live) {
+		allocator.free(entry.second.second);
+	}
+	EXPECT_TRUE(allocator.isEmpty());
+	EXPECT_EQ(allocator.getLargestFreeSize(), blockSize);
+	const TlsfAllocation whole = allocator.allocate(blockSize);
+	ASSERT_TRUE(whole.isValid());
+	EXPECT_EQ(whole.offset, 0u);
+	EXPECT_FALSE(allocator.allocate(1).isValid());
+}
+
+TEST(TlsfAllocator, FreedRangesAreReused) {
+	TlsfAllocator allocator(1024);
+	const TlsfAllocation a = allocator.allocate(256);
+	const TlsfAllocation b = allocator.allocate(256, 256);
+	const TlsfAllocation c = allocator.allocate(512);
+	ASSERT_TRUE(a.isValid() && b.isValid() && c.isValid());
+	EXPECT_EQ(b.offset, 256u);
+	EXPECT_FALSE(allocator.allocate(1).isValid());
+	EXPECT_EQ(allocator.getLargestFreeSize(), 0u);
+
+	// two freed neighbours make a range of both sizes
+	allocator.free(a);
+	allocator.free(b);
+	EXPECT_EQ(allocator.getLargestFreeSize(), 512u);
+	const TlsfAllocation d = allocator.allocate(512, 512);
+	ASSERT_TRUE(d.isValid());
+	EXPECT_EQ(d.offset, 0u);
+
+	// a range too small once aligned is not used
+	allocator.free(c);
+	allocator.free(d);
+	const TlsfAllocation e = allocator.allocate(100);
+	ASSERT_TRUE(e.isValid());
+	const TlsfAllocation f = allocator.allocate(800, 512);
+	EXPECT_FALSE(f.isValid());
+	const TlsfAllocation g = allocator.allocate(512, 512);
+	ASSERT_TRUE(g.isValid());
+	EXPECT_EQ(g.offset, 512u);
+	EXPECT_EQ(allocator.getUsedSize(), 612u);
+}
+
+TEST(LinearAllocator, AllocationsFollowEachOtherUntilReset) {
+	LinearAllocator allocator(256);
+	EXPECT_EQ(allocator.allocate(10), 0u);
+	EXPECT_EQ(allocator.allocate(16, 16), 16u);
+	EXPECT_EQ(allocator.getUsedSize(), 32u);
+	EXPECT_EQ(allocator.allocate(256), LinearAllocator::invalidOffset);
+	EXPECT_EQ(allocator.allocate(224, 32), 32u);
+	EXPECT_EQ(allocator.allocate(1), LinearAllocator::invalidOffset);
+
+	allocator.reset();
+	EXPECT_EQ(allocator.allocate(256), 0u);
+}
+
+TEST(RingAllocator, SpaceIsReleasedInOrder) {
+	RingAllocator allocator(1024);
+	EXPECT_EQ(allocator.allocate(400), 0u);
+	const uint64_t firstFrame = allocator.getHead();
+	EXPECT_EQ(allocator.allocate(400, 256), 512u);
+	const uint64_t secondFrame = allocator.getHead();
+
+	// the end of the ring is too small: the allocation skips it, once the start is released
+	EXPECT_EQ(allocator.allocate(300), RingAllocator::invalidOffset);
+	allocator.release(firstFrame);
+	EXPECT_EQ(allocator.allocate(300), 0u);
+	EXPECT_EQ(allocator.getUsedSize(), 1024u - 400u + 300u);
+	EXPECT_EQ(allocator.allocate(300), RingAllocator::invalidOffset);
+
+	allocator.release(secondFrame);
+	EXPECT_EQ(allocator.allocate(600, 4), 300u);
+	const uint64_t thirdFrame = allocator.getHead();
+	allocator.release(thirdFrame);
+	EXPECT_EQ(allocator.getUsedSize(), 0u);
+	EXPECT_EQ(allocator.allocate(1024), 0u);
+	allocator.release(thirdFrame);
+	EXPECT_EQ(allocator.getUsedSize(), 1024u);
+	EXPECT_EQ(allocator.allocate(1025), RingAllocator::invalidOffset);
+}
@@ -0,0 +1,164 @@
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include "rendering/mesh-file.hpp"
+#include "rendering/mesh-simplifier.hpp"
+#include "rendering/meshlet-builder.hpp"
+#include "test-meshes.hpp"
+
+using namespace poc;
+
+// scene with a full precision mesh with levels & meshlets and a packed mesh
+static void fillScene(Scene& scene) {
+	scene.addMesh(MeshletBuilder::build(MeshSimplifier::generateLods(makeSphere(16, 32))));
+	Mesh packed = makeSphere(8, 16);
+	packed.setVertexFormat(VertexFormat::SNORM16_POSITION);
+	scene.addMesh(std::move(packed));
+}
+
+TEST(MeshFile, LoadedSceneViewsTheSameGeometry) {
+	Scene source;
+	fillScene(source);
+	const std::string path = getTemporaryPath("poc-mesh-file-tests.pocmesh");
+	MeshFile::write(path, source);
+
+	Scene scene;
+	MeshFile::load(path, scene);
+
+	ASSERT_EQ(scene.getMeshes().size(), source.getMeshes().size());
+	ASSERT_EQ(scene.getVertexCount(), source.getVertexCount());
+	ASSERT_EQ(scene.getIndexCount(), source.getIndexCount());
+	ASSERT_EQ(scene.getMeshlets().size(), source.getMeshlets().size());
+	EXPECT_EQ(scene.getMaxMeshVertexCount(), source.getMaxMeshVertexCount());
+	EXPECT_EQ(std::memcmp(scene.getVertices().data(), source.getVertices().data(), source.getVertices().size_bytes()), 0);
+	EXPECT_EQ(std::memcmp(scene.getPackedVertices().data(), source.getPackedVertices().data(), source.getPackedVertices().size_bytes()), 0);
+	EXPECT_EQ(std::memcmp(scene.getIndices().data(), source.getIndices().data(), source.getIndices().size_bytes()), 0);
+	EXPECT_EQ(std::memcmp(scene.getMeshlets().data(), source.getMeshlets().data(), source.getMeshlets().size_bytes()), 0);
+	for (size_t i = 0; i < source.getMeshes().size(); ++i) {
+		const MeshRange& loaded = scene.getMeshes()[i];
+		const MeshRange& expected = source.getMeshes()[i];
+		EXPECT_EQ(loaded.format, expected.format);
+		EXPECT_EQ(loaded.lodCount, expected.lodCount);
+		EXPECT_EQ(loaded.meshletCount, expected.meshletCount);
+		EXPECT_EQ(loaded.dequantization.scale, expected.dequantization.scale);
+		EXPECT_EQ(loaded.bounds.sphere.radius, expected.bounds.sphere.radius);
+	}
+	EXPECT_GT(scene.getMeshes()[0].lodCount, 1u);
+
+	// the sections are aligned in the mapping
+	EXPECT_EQ(reinterpret_cast<uintptr_t>(scene.getVertices().data()) % MeshFile::sectionAlignment, 0u);
+	EXPECT_EQ(reinterpret_cast<uintptr_t>(scene.getIndices().data()) % MeshFile::sectionAlignment, 0u);
+
+	// a new mesh copies the arenas, the loaded meshes are kept
+	const uint64_t generation = scene.getGeneration();
+	const uint32_t mesh = scene.addMesh(makeSphere(4, 8));
+	EXPECT_EQ(mesh, 2u);
+	EXPECT_NE(scene.getGeneration(), generation);
+	EXPECT_EQ(scene.getVertexCount(), source.getVertexCount() + makeSphere(4, 8).getVertices().size());
+	EXPECT_EQ(std::memcmp(scene.getIndices().data(), source.getIndices().data(), source.getIndices().size_bytes()), 0);
+
+	// the scene already has a geometry
+	EXPECT_THROW(MeshFile::load(path, scene), std::runtime_error);
+	EXPECT_EQ(scene.getMeshes().size(), 3u);
+
+	std::filesystem::remove(path);
+}
+
+TEST(MeshFile, InvalidFilesAreRejected) {
+	Scene source;
+	fillScene(source);
+	const std::string path = getTemporaryPath("poc-mesh-file-tests-invalid.pocmesh");
+	MeshFile::write(path, source);
+
+	std::vector<char> content;
+	{
+		std::ifstream file(path, std::ios::binary);
+		content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+	const auto writeAndLoad = [&path](const std::vector<char>& bytes) {
+		{
+			std::ofstream file(path, std::ios::binary | std::ios::trunc);
+			file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+		}
+		Scene scene;
+		MeshFile::load(path, scene);
+	};
+
+	std::vector<char> badMagic = content;
+	badMagic[0] = 'X';
+	EXPECT_THROW(writeAndLoad(badMagic), std::runtime_error);
+
+	std::vector<char> badVersion = content;
+	const uint32_t nextVersion = MeshFile::version + 1;
+	std::memcpy(badVersion.data() + offsetof(MeshFile::Header, version), &nextVersion, sizeof(nextVersion));
+	EXPECT_THROW(writeAndLoad(badVersion), std::runtime_error);
+
+	// the last section, the meshes, is cut
+	const std::vector<char> truncated(content.begin(), content.end() - 8);
+	EXPECT_THROW(writeAndLoad(truncated), std::runtime_error);
+
+	// a mesh out of the index arena
+	std::vector<char> badRange = content;
+	MeshFile::Section meshes;
+	std::memcpy(&meshes, badRange.data() + sizeof(MeshFile::Header) + 4 * sizeof(MeshFile::Section), sizeof(meshes));
+	ASSERT_EQ(meshes.type, MeshFile::SectionType::MESHES);
+	MeshRange range;
+	std::memcpy(&range, badRange.data() + meshes.offset, sizeof(range));
+	range.lods[0].indexCount = source.getIndexCount() + 1;
+	std::memcpy(badRange.data() + meshes.offset, &range, sizeof(range));
+	EXPECT_THROW(writeAndLoad(badRange), std::runtime_error);
+
+	// an index past the vertices of its mesh
+	std::vector<char> badIndex = content;
+	MeshFile::Section indices;
+	std::memcpy(&indices, badIndex.data() + sizeof(MeshFile::Header) + 2 * sizeof(MeshFile::Section), sizeof(indices));
+	ASSERT_EQ(indices.type, MeshFile::SectionType::INDICES);
+	const uint32_t pastVertex = source.getMeshes()[0].vertexCount;
+	std::memcpy(badIndex.data() + indices.offset + sizeof(uint32_t) * source.getMeshes()[0].lods[1].firstIndex, &pastVertex, sizeof(pastVertex));
+	EXPECT_THROW(writeAndLoad(badIndex), std::runtime_error);
+
+	// a meshlet past the indices of its mesh, inside the index arena
+	std::vector<char> badMeshlet = content;
+	MeshFile::Section meshlets;
+	std::memcpy(&meshlets, badMeshlet.data() + sizeof(MeshFile::Header) + 3 * sizeof(MeshFile::Section), sizeof(meshlets));
+	ASSERT_EQ(meshlets.type, MeshFile::SectionType::MESHLETS);
+	Meshlet meshlet;
+	std::memcpy(&meshlet, badMeshlet.data() + meshlets.offset, sizeof(meshlet));
+	meshlet.firstIndex = source.getMeshes()[0].firstIndex + source.getMeshes()[0].indexCount;
+	ASSERT_LT(meshlet.firstIndex + meshlet.triangleCount * 3, source.getIndexCount());
+	std::memcpy(badMeshlet.data() + meshlets.offset, &meshlet, sizeof(meshlet));
+	EXPECT_THROW(writeAndLoad(badMeshlet), std::runtime_error);
+
+	EXPECT_THROW(writeAndLoad({}), std::runtime_error);
+	EXPECT_NO_THROW(writeAndLoad(content));
+
+	std::filesystem::remove(path);
+	Scene scene;
+	EXPECT_THROW(MeshFile::load(path, scene), std::runtime_error);
+}
+
+TEST(MeshFile, MeshesViewExternalStorage) {
+	const Mesh source = makeSphere(8, 16);
+	const Mesh view(source.getVertices(), source.getIndices(), VertexFormat::FLOAT32, source.getBounds());
+
+	EXPECT_TRUE(view.isExternal());
+	EXPECT_FALSE(source.isExternal());
+	EXPECT_EQ(view.getVertices().data(), source.getVertices().data());
+	EXPECT_EQ(view.getIndices().data(), source.getIndices().data());
+
+	// copies share the storage, processing creates an owned mesh
+	const Mesh copy = view;
+	EXPECT_EQ(copy.getVertices().data(), source.getVertices().data());
+	const Mesh built = MeshletBuilder::build(view);
+	EXPECT_FALSE(built.isExternal());
+	EXPECT_EQ(built.getIndices().size(), source.getIndices().size());
+
+	Scene scene;
+	const uint32_t mesh = scene.addMesh(Mesh(view));
+	EXPECT_EQ(scene.getMeshes()[mesh].vertexCount, source.getVertices().size());
+}
@@ -0,0 +1,89 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <random>
+
+#include "rendering/mesh-optimizer.hpp"
+
+using namespace poc;
+
+// non indexed grid of size x size quads, triangles shuffled to defeat the vertex cache
+static std::vector<Vertex> makeShuffledGrid(uint32_t size) {
+	std::vector<std::array<Vertex, 3>> triangles;
+	for (uint32_t y = 0; y < size; ++y) {
+		for (uint32_t x = 0; x < size; ++x) {
+			const auto vertex = [](uint32_t vx, uint32_t vy) {
+				return Vertex{ glm::vec3(vx, vy, 0.0f), glm::vec3(1.0f, 1.0f, 1.0f) };
+			};
+			triangles.push_back({ vertex(x, y), vertex(x + 1, y), vertex(x + 1, y + 1) });
+			triangles.push_back({ vertex(x, y), vertex(x + 1, y + 1), vertex(x, y + 1) });
+		}
+	}
+
+	std::shuffle(triangles.begin(), triangles.end(), std::mt19937(42));
+
+	std::vector<Vertex> vertices;
+	for (const auto& triangle : triangles) {
+		vertices.insert(vertices.end(), triangle.cbegin(), triangle.cend());
+	}
+	return vertices;
+}
+
+static std::vector<std::array<float, 9>> sortedTriangles(span<const Vertex> vertices, span<const uint32_t> indices) {
+	std::vector<std::array<float, 9>> triangles;
+	for (size_t i = 0; i < indices.size(); i += 3) {
+		std::array<float, 9> triangle{};
+		for (size_t k = 0; k < 3; ++k) {
+			const glm::vec3& p = vertices[indices[i + k]].position;
+			triangle[k * 3] = p.x;
+			triangle[k * 3 + 1] = p.y;
+			triangle[k * 3 + 2] = p.z;
+		}
+		triangles.push_back(triangle);
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+TEST(MeshOptimizer, AnalyzeVertexCache) {
+	// two triangles sharing an edge: 4 transformed vertices
+	const std::vector<uint32_t> indices{ 0, 1, 2, 2, 1, 3 };
+	const auto statistics = MeshOptimizer::analyzeVertexCache(indices, 4);
+	EXPECT_FLOAT_EQ(statistics.acmr, 2.0f);
+	EXPECT_FLOAT_EQ(statistics.atvr, 1.0f);
+}
+
+TEST(MeshOptimizer, WeldVertices) {
+	std::vector<Vertex> vertices = makeShuffledGrid(4);
+	std::vector<uint32_t> indices(vertices.size());
+	std::iota(indices.begin(), indices.end(), 0);
+
+	MeshOptimizer::weldVertices(vertices, indices);
+	EXPECT_EQ(vertices.size(), 25u);
+	EXPECT_EQ(indices.size(), 4u * 4u * 6u);
+}
+
+TEST(MeshOptimizer, OptimizeKeepsTrianglesAndImprovesCache) {
+	const Mesh mesh(makeShuffledGrid(32));
+	const auto trianglesBefore = sortedTriangles(mesh.getVertices(), mesh.getIndices());
+
+	MeshOptimizer::OptimizationReport report{};
+	const Mesh optimized = MeshOptimizer::optimize(mesh, &report);
+
+	EXPECT_EQ(report.vertexCountBefore, 32u * 32u * 6u);
+	EXPECT_EQ(report.vertexCountAfter, 33u * 33u);
+	EXPECT_FLOAT_EQ(report.before.acmr, 3.0f);
+	EXPECT_LT(report.after.acmr, 1.0f);
+	EXPECT_LT(report.after.atvr, 1.5f);
+
+	EXPECT_EQ(sortedTriangles(optimized.getVertices(), optimized.getIndices()), trianglesBefore);
+
+	// vertex fetch order follows the index buffer
+	uint32_t highest = 0;
+	for (const uint32_t index : optimized.getIndices()) {
+		EXPECT_LE(index, highest + 1);
+		highest = std::max(highest, index);
+	}
+}
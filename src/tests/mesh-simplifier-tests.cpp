@@ -0,0 +1,137 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "rendering/draw-collector.hpp"
+#include "rendering/mesh-simplifier.hpp"
+#include "test-meshes.hpp"
+
+using namespace poc;
+
+static void expectValidTriangles(span<const uint32_t> indices, size_t vertexCount) {
+	ASSERT_EQ(indices.size() % 3, 0u);
+	for (size_t i = 0; i < indices.size(); i += 3) {
+		EXPECT_LT(indices[i], vertexCount);
+		EXPECT_NE(indices[i], indices[i + 1]);
+		EXPECT_NE(indices[i + 1], indices[i + 2]);
+		EXPECT_NE(indices[i], indices[i + 2]);
+	}
+}
+
+TEST(MeshSimplifier, FlatSurfacesSimplifyWithoutError) {
+	// 16 x 16 grid of quads in a plane
+	std::vector<Vertex> vertices;
+	std::vector<uint32_t> indices;
+	for (uint32_t y = 0; y <= 16; ++y) {
+		for (uint32_t x = 0; x <= 16; ++x) {
+			vertices.push_back(Vertex{ glm::vec3(float(x), float(y), 0.0f), glm::vec3(1.0f) });
+		}
+	}
+	for (uint32_t y = 0; y < 16; ++y) {
+		for (uint32_t x = 0; x < 16; ++x) {
+			const uint32_t i = y * 17 + x;
+			indices.insert(indices.end(), { i, i + 1, i + 18, i, i + 18, i + 17 });
+		}
+	}
+
+	float error = -1.0f;
+	const std::vector<uint32_t> simplified = MeshSimplifier::simplify(vertices, indices, indices.size() / 4, 0.001f, &error);
+
+	EXPECT_LE(simplified.size(), indices.size() / 4);
+	EXPECT_FLOAT_EQ(error, 0.0f);
+	expectValidTriangles(simplified, vertices.size());
+
+	// the border vertices are locked: the outline of the grid is kept
+	for (const uint32_t corner : { 0u, 16u, 17u * 16u, 17u * 17u - 1u }) {
+		EXPECT_NE(std::find(simplified.begin(), simplified.end(), corner), simplified.end());
+	}
+}
+
+TEST(MeshSimplifier, TargetErrorLimitsTheSimplification) {
+	const Mesh sphere = makeSphere(32, 64);
+	const span<const uint32_t> indices = sphere.getIndices();
+
+	float error = 0.0f;
+	const std::vector<uint32_t> simplified = MeshSimplifier::simplify(sphere.getVertices(), indices, 0, 0.01f, &error);
+
+	EXPECT_LT(simplified.size(), indices.size());
+	EXPECT_GT(simplified.size(), 0u);
+	EXPECT_LE(error, 0.01f);
+	expectValidTriangles(simplified, sphere.getVertices().size());
+}
+
+TEST(MeshSimplifier, LodChainReducesTheTriangles) {
+	const Mesh mesh = MeshSimplifier::generateLods(makeSphere(32, 64));
+	const std::vector<MeshLod>& lods = mesh.getLods();
+
+	ASSERT_GE(lods.size(), 3u);
+	EXPECT_LT(lods.size(), maxMeshLods);
+	size_t previousCount = mesh.getIndices().size();
+	float previousError = 0.0f;
+	for (const MeshLod& lod : lods) {
+		EXPECT_LE(lod.indices.size(), previousCount * 6 / 10);
+		EXPECT_GT(lod.error, previousError);
+		expectValidTriangles(lod.indices, mesh.getVertices().size());
+		previousCount = lod.indices.size();
+		previousError = lod.error;
+	}
+	// half of the triangles of a sphere are removed without moving the surface much
+	EXPECT_LT(lods[0].error, 0.02f);
+}
+
+TEST(MeshSimplifier, SceneStoresTheLodsAfterTheMesh) {
+	Scene scene;
+	const uint32_t mesh = scene.addMesh(MeshSimplifier::generateLods(makeSphere(16, 32)));
+	const MeshRange& range = scene.getMeshes()[mesh];
+
+	ASSERT_GT(range.lodCount, 1u);
+	EXPECT_EQ(range.lods[0].firstIndex, range.firstIndex);
+	EXPECT_EQ(range.lods[0].indexCount, range.indexCount);
+	EXPECT_EQ(range.lods[1].firstIndex, range.firstIndex + range.indexCount);
+	EXPECT_EQ(range.lods[range.lodCount - 1].firstIndex + range.lods[range.lodCount - 1].indexCount, scene.getIndexCount());
+}
+
+TEST(LodSelection, HysteresisAvoidsSwitchingBack) {
+	MeshRange mesh{};
+	mesh.lodCount = 3;
+	mesh.lods[1].error = 0.1f;
+	mesh.lods[2].error = 1.0f;
+	const LodSettings settings{ 1.0f, 0.25f };
+
+	// level 1 projects to 1 pixel: within the tolerance to stay, not to switch
+	EXPECT_EQ(LodSelection::select(mesh, 10.0f, 0, settings), 0u);
+	EXPECT_EQ(LodSelection::select(mesh, 10.0f, 1, settings), 1u);
+	EXPECT_EQ(LodSelection::select(mesh, 7.0f, 0, settings), 1u);
+	EXPECT_EQ(LodSelection::select(mesh, 0.5f, 1, settings), 2u);
+	EXPECT_EQ(LodSelection::select(mesh, 20.0f, 2, settings), 0u);
+}
+
+TEST(DrawCollector, DistantEntitiesUseCoarserLevels) {
+	Scene scene;
+	scene.getCamera().setProjection(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f));
+	scene.getCamera().setView(glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+	const uint32_t mesh = scene.addMesh(MeshSimplifier::generateLods(makeSphere(32, 64)));
+
+	for (const float distance : { 3.0f, 500.0f }) {
+		const Entity entity = scene.createEntity(mesh);
+		scene.getTransforms().setLocalPosition(scene.getWorld().get<TransformComponent>(entity).node, glm::vec3(0.0f, 0.0f, -distance));
+	}
+
+	JobSystem jobs(1);
+	scene.getTransforms().update(jobs);
+	DrawCollector collector;
+	collector.collect(scene, jobs, 720);
+
+	const std::vector<Draw>& draws = collector.getDraws(VertexFormat::FLOAT32);
+	ASSERT_EQ(draws.size(), 2u);
+	EXPECT_EQ(std::min(draws[0].lod, draws[1].lod), 0u);
+	EXPECT_GT(std::max(draws[0].lod, draws[1].lod), 1u);
+
+	const FrameStats& stats = collector.getFrameStats();
+	const MeshRange& range = scene.getMeshes()[mesh];
+	EXPECT_EQ(stats.lodTriangleCounts[0], range.indexCount / 3);
+	EXPECT_LT(stats.triangleCount, 2 * range.indexCount / 3);
+}
@@ -0,0 +1,172 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <set>
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "rendering/draw-collector.hpp"
+#include "rendering/meshlet-builder.hpp"
+#include "test-meshes.hpp"
+
+using namespace poc;
+
+// winding seen by the rasterizer: signed area of the triangle in normalized device coordinates
+static bool isFrontFacingOnScreen(const glm::mat4& worldViewProjection, const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2) {
+	std::array<glm::vec2, 3> points;
+	const std::array<glm::vec3, 3> positions{ p0, p1, p2 };
+	for (size_t i = 0; i < 3; ++i) {
+		const glm::vec4 clip = worldViewProjection * glm::vec4(positions[i], 1.0f);
+		points[i] = glm::vec2(clip) / clip.w;
+	}
+	float area = 0.0f;
+	for (size_t i = 0; i < 3; ++i) {
+		area -= 0.5f * (points[i].x * points[(i + 1) % 3].y - points[(i + 1) % 3].x * points[i].y);
+	}
+	return area > 0.0f;
+}
+
+static bool isFrontFacing(const glm::vec4& facingPoint, const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2) {
+	const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+	return glm::dot(glm::vec4(normal, -glm::dot(normal, p0)), facingPoint) > 0.0f;
+}
+
+TEST(MeshletBuilder, MeshletsRespectTheLimits) {
+	const Mesh sphere = makeSphere(32, 64);
+	const Mesh mesh = MeshletBuilder::build(sphere);
+	const span<const Vertex> vertices = mesh.getVertices();
+	const span<const uint32_t> indices = mesh.getIndices();
+	const span<const Meshlet> meshlets = mesh.getMeshlets();
+	ASSERT_FALSE(meshlets.empty());
+
+	uint32_t nextIndex = 0;
+	for (const Meshlet& meshlet : meshlets) {
+		EXPECT_EQ(meshlet.firstIndex, nextIndex);
+		EXPECT_GT(meshlet.triangleCount, 0u);
+		EXPECT_LE(meshlet.triangleCount, MeshletBuilder::defaultMaxTriangles);
+		nextIndex += meshlet.triangleCount * 3;
+
+		const std::set<uint32_t> meshletVertices(indices.begin() + meshlet.firstIndex, indices.begin() + meshlet.firstIndex + meshlet.triangleCount * 3);
+		EXPECT_LE(meshletVertices.size(), MeshletBuilder::defaultMaxVertices);
+
+		// no cone to check when the meshlet is never culled
+		const float minDot = meshlet.coneCutoff < 1.0f ? std::sqrt(1.0f - meshlet.coneCutoff * meshlet.coneCutoff) : -1.0f;
+		for (uint32_t i = meshlet.firstIndex; i < meshlet.firstIndex + meshlet.triangleCount * 3; i += 3) {
+			const glm::vec3& p0 = vertices[indices[i]].position;
+			const glm::vec3& p1 = vertices[indices[i + 1]].position;
+			const glm::vec3& p2 = vertices[indices[i + 2]].position;
+			for (const glm::vec3& p : { p0, p1, p2 }) {
+				EXPECT_LE(glm::length(p - meshlet.sphere.center), meshlet.sphere.radius + 1e-5f);
+			}
+			EXPECT_GE(glm::dot(glm::normalize(glm::cross(p1 - p0, p2 - p0)), meshlet.coneAxis), minDot - 1e-4f);
+		}
+	}
+	EXPECT_EQ(nextIndex, indices.size());
+
+	// the same triangles, reordered
+	const auto triangles = [](span<const uint32_t> list) {
+		std::vector<std::array<uint32_t, 3>> result;
+		for (size_t i = 0; i < list.size(); i += 3) {
+			result.push_back({ list[i], list[i + 1], list[i + 2] });
+		}
+		std::sort(result.begin(), result.end());
+		return result;
+	};
+	EXPECT_EQ(triangles(indices), triangles(sphere.getIndices()));
+
+	// mostly full meshlets
+	EXPECT_LT(meshlets.size(), 2 * indices.size() / 3 / MeshletBuilder::defaultMaxTriangles + 1);
+}
+
+TEST(Camera, FacingPointMatchesTheRasterizerWinding) {
+	std::mt19937 random(11);
+	std::uniform_real_distribution<float> position(-1.0f, 1.0f);
+
+	for (const Camera& camera : { makePerspectiveCamera(glm::vec3(1.0f, 2.0f, 5.0f), glm::vec3(0.0f)), Camera() }) {
+		const glm::vec4 facingPoint = camera.getFacingPoint();
+		size_t frontCount = 0;
+		for (int t = 0; t < 200; ++t) {
+			const glm::vec3 p0(position(random), position(random), position(random) * 0.5f + 0.5f);
+			const glm::vec3 p1(position(random), position(random), position(random) * 0.5f + 0.5f);
+			const glm::vec3 p2(position(random), position(random), position(random) * 0.5f + 0.5f);
+			const bool front = isFrontFacingOnScreen(camera.getViewProjection(), p0, p1, p2);
+			EXPECT_EQ(isFrontFacing(facingPoint, p0, p1, p2), front) << "triangle " << t;
+			frontCount += front ? 1 : 0;
+		}
+		EXPECT_GT(frontCount, 50u);
+		EXPECT_LT(frontCount, 150u);
+	}
+}
+
+TEST(MeshletCulling, OnlyBackFacingMeshletsAreCulled) {
+	const Mesh mesh = MeshletBuilder::build(makeSphere(64, 128));
+	const span<const Vertex> vertices = mesh.getVertices();
+	const span<const uint32_t> indices = mesh.getIndices();
+	const glm::vec4 facingPoint = makePerspectiveCamera(glm::vec3(1.0f, 2.0f, 5.0f), glm::vec3(0.0f)).getFacingPoint();
+
+	size_t culledCount = 0;
+	for (const Meshlet& meshlet : mesh.getMeshlets()) {
+		if (!isBackFacing(meshlet, facingPoint)) {
+			continue;
+		}
+		++culledCount;
+		for (uint32_t i = meshlet.firstIndex; i < meshlet.firstIndex + meshlet.triangleCount * 3; i += 3) {
+			EXPECT_FALSE(isFrontFacing(facingPoint, vertices[indices[i]].position, vertices[indices[i + 1]].position, vertices[indices[i + 2]].position));
+		}
+	}
+
+	// the back of the sphere, less the meshlets near the silhouette
+	EXPECT_GT(culledCount, mesh.getMeshlets().size() / 8);
+	EXPECT_LT(culledCount, mesh.getMeshlets().size() / 2);
+}
+
+TEST(DrawCollector, HiddenMeshletsAreNotDrawn) {
+	Scene scene;
+	scene.getCamera() = makePerspectiveCamera(glm::vec3(1.0f, 2.0f, 5.0f), glm::vec3(0.0f));
+	const uint32_t mesh = scene.addMesh(MeshletBuilder::build(makeSphere(32, 64)));
+	const MeshRange& range = scene.getMeshes()[mesh];
+	ASSERT_GT(range.meshletCount, 0u);
+
+	// a mirrored sphere flips the winding of its triangles: the other half is seen from the camera
+	for (const glm::vec3& scale : { glm::vec3(1.0f), glm::vec3(-1.0f, 1.0f, 1.0f) }) {
+		Scene entityScene = scene;
+		const Entity entity = entityScene.createEntity(mesh);
+		const TransformNode node = entityScene.getWorld().get<TransformComponent>(entity).node;
+		entityScene.getTransforms().setLocalPosition(node, glm::vec3(0.5f, 0.0f, 0.0f));
+		entityScene.getTransforms().setLocalScale(node, scale);
+
+		JobSystem jobs(1);
+		entityScene.getTransforms().update(jobs);
+		DrawCollector collector;
+		collector.collect(entityScene, jobs, 720);
+
+		const FrameStats& stats = collector.getFrameStats();
+		EXPECT_EQ(stats.clusterCount, range.meshletCount);
+		EXPECT_GT(stats.culledClusterCount, 0u);
+		EXPECT_LT(stats.triangleCount, range.indexCount / 3);
+
+		// every triangle seen by the rasterizer is drawn
+		const glm::mat4 worldViewProjection = entityScene.getCamera().getViewProjection() * entityScene.getTransforms().getWorldMatrix(node);
+		const span<const Vertex> meshVertices = entityScene.getMeshVertices(range);
+		const span<const uint32_t> allIndices = entityScene.getIndices();
+		std::vector<uint8_t> drawn(entityScene.getIndexCount(), 0);
+		uint32_t drawnTriangleCount = 0;
+		for (const Draw& draw : collector.getDraws(VertexFormat::FLOAT32)) {
+			std::fill(drawn.begin() + draw.firstIndex, drawn.begin() + draw.firstIndex + draw.indexCount, uint8_t(1));
+			drawnTriangleCount += draw.indexCount / 3;
+		}
+		EXPECT_EQ(drawnTriangleCount, stats.triangleCount);
+
+		for (uint32_t i = range.firstIndex; i < range.firstIndex + range.indexCount; i += 3) {
+			const glm::vec3& p0 = meshVertices[allIndices[i]].position;
+			const glm::vec3& p1 = meshVertices[allIndices[i + 1]].position;
+			const glm::vec3& p2 = meshVertices[allIndices[i + 2]].position;
+			if (isFrontFacingOnScreen(worldViewProjection, p0, p1, p2)) {
+				EXPECT_TRUE(drawn[i]) << "triangle " << i / 3;
+			}
+		}
+	}
+}
@@ -0,0 +1,49 @@
+#include "gtest/gtest.h"
+
+#include "rendering/residency.hpp"
+
+using namespace poc;
+
+TEST(ResidencyTracker, SizesAreTrackedPerCategory) {
+	ResidencyTracker tracker;
+	tracker.add(1, ResourceCategory::GEOMETRY, 100, 0);
+	tracker.add(2, ResourceCategory::GEOMETRY, 50, 0);
+	tracker.add(3, ResourceCategory::TEXTURE, 30, 0);
+
+	EXPECT_EQ(tracker.getResidentCount(), 3u);
+	EXPECT_EQ(tracker.getResidentSize(), 180u);
+	EXPECT_EQ(tracker.getResidentSize(ResourceCategory::GEOMETRY), 150u);
+	EXPECT_EQ(tracker.getResidentSize(ResourceCategory::TEXTURE), 30u);
+	EXPECT_EQ(tracker.getResidentSize(ResourceCategory::STAGING), 0u);
+
+	tracker.remove(1);
+	EXPECT_FALSE(tracker.contains(1));
+	EXPECT_TRUE(tracker.contains(2));
+	EXPECT_EQ(tracker.getResidentSize(ResourceCategory::GEOMETRY), 50u);
+	EXPECT_EQ(tracker.getResidentSize(), 80u);
+}
+
+TEST(ResidencyTracker, LeastRecentlyUsedAreEvictedFirst) {
+	ResidencyTracker tracker;
+	tracker.add(1, ResourceCategory::GEOMETRY, 100, 0);
+	tracker.add(2, ResourceCategory::GEOMETRY, 100, 1);
+	tracker.add(3, ResourceCategory::GEOMETRY, 100, 2);
+	tracker.touch(1, 3);
+
+	// 2 then 3 are the oldest, 1 was used again
+	EXPECT_EQ(tracker.selectEvictions(150, 3), (std::vector<uint64_t>{ 2, 3 }));
+	EXPECT_EQ(tracker.selectEvictions(100, 3), (std::vector<uint64_t>{ 2 }));
+	EXPECT_EQ(tracker.selectEvictions(1000, 3), (std::vector<uint64_t>{ 2, 3, 1 }));
+	EXPECT_TRUE(tracker.selectEvictions(0, 3).empty());
+}
+
+TEST(ResidencyTracker, RecentlyUsedAreKept) {
+	ResidencyTracker tracker;
+	tracker.add(1, ResourceCategory::GEOMETRY, 100, 5);
+	tracker.add(2, ResourceCategory::GEOMETRY, 100, 6);
+	tracker.add(3, ResourceCategory::GEOMETRY, 100, 7);
+
+	// the frames after 5 may still be in flight
+	EXPECT_EQ(tracker.selectEvictions(300, 5), (std::vector<uint64_t>{ 1 }));
+	EXPECT_TRUE(tracker.selectEvictions(300, 4).empty());
+}
@@ -0,0 +1,167 @@
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "rendering/mesh-file.hpp"
+#include "rendering/scene-snapshot.hpp"
+#include "test-meshes.hpp"
+
+using namespace poc;
+
+// two meshes, a batch of instances and entities on a hierarchy not stored breadth-first
+static void fillScene(Scene& scene) {
+	const uint32_t quad = scene.addMesh(makeQuad(1.0f));
+	Mesh packed = makeQuad(1.0f);
+	packed.setVertexFormat(VertexFormat::SNORM16_POSITION);
+	const uint32_t packedQuad = scene.addMesh(std::move(packed));
+
+	const std::vector<glm::mat4> transforms{ glm::translate(glm::mat4(1.0f), glm::vec3(4.0f, 0.0f, 0.0f)), glm::mat4(2.0f) };
+	scene.addInstances(packedQuad, transforms);
+
+	TransformHierarchy& hierarchy = scene.getTransforms();
+	const TransformNode root = hierarchy.create();
+	const TransformNode child = hierarchy.create(root);
+	const TransformNode secondRoot = hierarchy.create();
+	const TransformNode grandChild = hierarchy.create(child);
+	hierarchy.setLocalPosition(root, glm::vec3(1.0f, 2.0f, 3.0f));
+	hierarchy.setLocalRotation(child, glm::angleAxis(0.5f, glm::vec3(0.0f, 1.0f, 0.0f)));
+	hierarchy.setLocalScale(grandChild, glm::vec3(2.0f));
+	hierarchy.setLocalPosition(secondRoot, glm::vec3(-5.0f, 0.0f, 0.0f));
+
+	scene.createEntity(quad, grandChild);
+	scene.createEntity(packedQuad, secondRoot);
+	scene.createEntity(quad, child);
+
+	scene.getCamera().setView(glm::lookAt(glm::vec3(0.0f, 0.0f, 10.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+	scene.getCamera().setProjection(glm::perspective(1.0f, 1.5f, 0.1f, 100.0f));
+}
+
+TEST(SceneSnapshot, LoadedSceneIsTheSavedOne) {
+	Scene source;
+	fillScene(source);
+	const std::string path = getTemporaryPath("poc-scene-snapshot-tests.pocscene");
+	SceneSnapshot::write(path, source);
+
+	Scene scene;
+	SceneSnapshot::load(path, scene);
+
+	ASSERT_EQ(scene.getMeshes().size(), source.getMeshes().size());
+	EXPECT_EQ(std::memcmp(scene.getMeshes().data(), source.getMeshes().data(), source.getMeshes().size_bytes()), 0);
+	EXPECT_EQ(std::memcmp(scene.getVertices().data(), source.getVertices().data(), source.getVertices().size_bytes()), 0);
+	EXPECT_EQ(std::memcmp(scene.getPackedVertices().data(), source.getPackedVertices().data(), source.getPackedVertices().size_bytes()), 0);
+	EXPECT_EQ(scene.getMaxMeshVertexCount(), source.getMaxMeshVertexCount());
+
+	ASSERT_EQ(scene.getInstances().size(), 2u);
+	ASSERT_EQ(scene.getInstanceBatches().size(), 1u);
+	EXPECT_EQ(std::memcmp(scene.getInstances().data(), source.getInstances().data(), source.getInstances().size_bytes()), 0);
+	EXPECT_EQ(scene.getInstanceBatches()[0].mesh, 1u);
+	EXPECT_EQ(scene.getInstanceBatches()[0].bounds.radius, source.getInstanceBatches()[0].bounds.radius);
+
+	// the world matrices are recomputed from the restored local transforms
+	JobSystem jobs(1);
+	source.getTransforms().update(jobs);
+	scene.getTransforms().update(jobs);
+	ASSERT_EQ(scene.getTransforms().getNodeCount(), 4u);
+	for (uint32_t id = 0; id < 4; ++id) {
+		EXPECT_EQ(scene.getTransforms().getWorldMatrix(TransformNode{ id }), source.getTransforms().getWorldMatrix(TransformNode{ id }));
+	}
+
+	// the restored hierarchy keeps growing like the saved one
+	const TransformNode node = scene.getTransforms().create(TransformNode{ 3 });
+	EXPECT_EQ(node.id, 4u);
+	scene.getTransforms().update(jobs);
+	EXPECT_EQ(scene.getTransforms().getLastUpdateCount(), 1u);
+	EXPECT_EQ(scene.getTransforms().getWorldMatrix(node), source.getTransforms().getWorldMatrix(TransformNode{ 3 }));
+
+	std::vector<std::pair<uint32_t, uint32_t>> entities;
+	scene.getWorld().forEach<const MeshComponent, const TransformComponent>([&](Entity, const MeshComponent& mesh, const TransformComponent& transform) {
+		entities.emplace_back(mesh.mesh, transform.node.id);
+	});
+	EXPECT_EQ(entities, (std::vector<std::pair<uint32_t, uint32_t>>{ { 0, 3 }, { 1, 2 }, { 0, 1 } }));
+
+	EXPECT_EQ(scene.getCamera().getView(), source.getCamera().getView());
+	EXPECT_EQ(scene.getCamera().getViewProjection(), source.getCamera().getViewProjection());
+
+	// the scene is not empty anymore
+	EXPECT_THROW(SceneSnapshot::load(path, scene), std::runtime_error);
+	EXPECT_EQ(scene.getMeshes().size(), source.getMeshes().size());
+
+	std::filesystem::remove(path);
+}
+
+TEST(SceneSnapshot, InvalidSnapshotsAreRejected) {
+	Scene source;
+	fillScene(source);
+	const std::string path = getTemporaryPath("poc-scene-snapshot-tests-invalid.pocscene");
+	SceneSnapshot::write(path, source);
+
+	std::vector<char> content;
+	{
+		std::ifstream file(path, std::ios::binary);
+		content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+	const auto writeAndLoad = [&path](const std::vector<char>& bytes) {
+		{
+			std::ofstream file(path, std::ios::binary | std::ios::trunc);
+			file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+		}
+		Scene scene;
+		SceneSnapshot::load(path, scene);
+	};
+	const auto findSection = [&content](MeshFile::SectionType type) {
+		MeshFile::Header header;
+		std::memcpy(&header, content.data(), sizeof(header));
+		for (uint32_t i = 0; i < header.sectionCount; ++i) {
+			MeshFile::Section section;
+			std::memcpy(&section, content.data() + sizeof(header) + i * sizeof(section), sizeof(section));
+			if (section.type == type) {
+				return section;
+			}
+		}
+		throw std::logic_error("no section");
+	};
+
+	// a mesh file is not a snapshot
+	Scene meshes;
+	fillScene(meshes);
+	MeshFile::write(path, meshes);
+	Scene scene;
+	EXPECT_THROW(SceneSnapshot::load(path, scene), std::runtime_error);
+
+	std::vector<char> badVersion = content;
+	const uint32_t nextVersion = SceneSnapshot::version + 1;
+	std::memcpy(badVersion.data() + offsetof(MeshFile::Header, version), &nextVersion, sizeof(nextVersion));
+	EXPECT_THROW(writeAndLoad(badVersion), std::runtime_error);
+
+	// the last section, the camera, is cut
+	const std::vector<char> truncated(content.begin(), content.end() - 8);
+	EXPECT_THROW(writeAndLoad(truncated), std::runtime_error);
+
+	// an entity on a node that does not exist
+	std::vector<char> badEntity = content;
+	const MeshFile::Section entities = findSection(MeshFile::SectionType::ENTITIES);
+	const SceneSnapshot::EntityRecord record{ 0, 4 };
+	std::memcpy(badEntity.data() + entities.offset, &record, sizeof(record));
+	EXPECT_THROW(writeAndLoad(badEntity), std::runtime_error);
+
+	// a node deeper than its parent + 1
+	std::vector<char> badDepth = content;
+	const MeshFile::Section depths = findSection(MeshFile::SectionType::TRANSFORM_DEPTHS);
+	const uint32_t depth = 3;
+	std::memcpy(badDepth.data() + depths.offset + 3 * sizeof(uint32_t), &depth, sizeof(depth));
+	EXPECT_THROW(writeAndLoad(badDepth), std::runtime_error);
+
+	// two nodes with the same id
+	std::vector<char> badId = content;
+	const MeshFile::Section ids = findSection(MeshFile::SectionType::TRANSFORM_IDS);
+	std::memcpy(badId.data() + ids.offset, badId.data() + ids.offset + sizeof(uint32_t), sizeof(uint32_t));
+	EXPECT_THROW(writeAndLoad(badId), std::runtime_error);
+
+	EXPECT_NO_THROW(writeAndLoad(content));
+	std::filesystem::remove(path);
+}
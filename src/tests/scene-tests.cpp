@@ -0,0 +1,85 @@
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+
+#include "core/scene.hpp"
+
+using namespace poc;
+
+static Mesh makeTriangle(float z) {
+	return Mesh(std::vector<Vertex>{
+		Vertex{ glm::vec3(0.0f, -0.5f, z), glm::vec3(1.0f, 0.0f, 0.0f) },
+		Vertex{ glm::vec3(-0.5f, 0.5f, z), glm::vec3(0.0f, 1.0f, 0.0f) },
+		Vertex{ glm::vec3(0.5f, 0.5f, z), glm::vec3(0.0f, 0.0f, 1.0f) }
+	});
+}
+
+TEST(Scene, MeshesAreStoredContiguously) {
+	Scene scene;
+	scene.addMesh(makeTriangle(0.0f));
+	scene.addMesh(makeTriangle(0.5f));
+
+	ASSERT_EQ(scene.getVertexCount(), 6u);
+	ASSERT_EQ(scene.getMeshes().size(), 2u);
+
+	const MeshRange second = scene.getMeshes()[1];
+	EXPECT_EQ(second.firstVertex, 3u);
+	EXPECT_EQ(second.vertexCount, 3u);
+	EXPECT_EQ(scene.getMeshVertices(second).data(), scene.getVertices().data() + 3);
+	EXPECT_FLOAT_EQ(scene.getMeshVertices(second)[0].position.z, 0.5f);
+}
+
+TEST(Scene, GenerationChangesOnModification) {
+	Scene scene;
+	const uint64_t initial = scene.getGeneration();
+
+	scene.addMesh(makeTriangle(0.0f));
+	EXPECT_NE(scene.getGeneration(), initial);
+
+	const Scene copy = scene;
+	EXPECT_EQ(copy.getId(), scene.getId());
+	EXPECT_EQ(copy.getGeneration(), scene.getGeneration());
+
+	Scene other;
+	EXPECT_NE(other.getId(), scene.getId());
+}
+
+TEST(Scene, LineageIsKeptByAppends) {
+	Scene scene;
+	scene.addMesh(makeTriangle(0.0f));
+	const uint64_t lineage = scene.getLineage();
+
+	scene.addMesh(makeTriangle(0.5f));
+	EXPECT_EQ(scene.getLineage(), lineage);
+
+	// the copies diverge: the one appending leaves the lineage
+	Scene copy = scene;
+	copy.addMesh(makeTriangle(1.0f));
+	EXPECT_NE(copy.getLineage(), lineage);
+	EXPECT_EQ(scene.getLineage(), lineage);
+
+	// replaced arenas start a lineage
+	Scene restored;
+	const uint64_t emptyLineage = restored.getLineage();
+	restored.setGeometry(copy.getGeometry(), nullptr);
+	EXPECT_NE(restored.getLineage(), emptyLineage);
+	EXPECT_NE(restored.getLineage(), copy.getLineage());
+
+	// the arenas are replaced only in an empty scene
+	EXPECT_THROW(restored.setGeometry(scene.getGeometry(), nullptr), std::runtime_error);
+}
+
+TEST(Scene, EntitiesReferenceTheSharedMeshes) {
+	Scene scene;
+	const uint32_t mesh = scene.addMesh(makeTriangle(0.0f));
+	const uint64_t generation = scene.getGeneration();
+
+	scene.createEntity(mesh);
+	const Entity second = scene.createEntity(mesh);
+
+	// entities do not change the geometry, the GPU copy stays valid
+	EXPECT_EQ(scene.getGeneration(), generation);
+	EXPECT_EQ(scene.getVertexCount(), 3u);
+	EXPECT_EQ(scene.getWorld().getEntityCount(), 2u);
+	EXPECT_EQ(scene.getWorld().get<MeshComponent>(second).mesh, mesh);
+}
@@ -0,0 +1,175 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "rendering/vulkan/shaders/vulkan-shader-cull.hpp"
+#include "rendering/vulkan/shaders/vulkan-shader-fragment.hpp"
+#include "rendering/vulkan/shaders/vulkan-shader-vertex-indirect.hpp"
+#include "rendering/vulkan/shaders/vulkan-shader-vertex-instanced.hpp"
+#include "rendering/vulkan/shaders/vulkan-shader-vertex.hpp"
+
+using namespace poc;
+
+namespace {
+
+	constexpr uint32_t spirvMagic = 0x07230203;
+
+	enum Op : uint32_t {
+		OpEntryPoint = 15,
+		OpExecutionMode = 16,
+		OpCapability = 17,
+		OpFunction = 54,
+		OpFunctionEnd = 56,
+		OpDecorate = 71,
+		OpMemberDecorate = 72
+	};
+
+	constexpr uint32_t executionModelVertex = 0;
+	constexpr uint32_t executionModelFragment = 4;
+	constexpr uint32_t executionModelGLCompute = 5;
+	constexpr uint32_t capabilityShader = 1;
+	constexpr uint32_t executionModeLocalSize = 17;
+	constexpr uint32_t decorationBuiltIn = 11;
+	constexpr uint32_t builtInPosition = 0;
+	// "Shaderc over Glslang": glslc, run by shaders/generate-shader-headers.bat
+	constexpr uint32_t generatorGlslc = 13;
+
+	struct Instruction {
+		uint32_t opcode;
+		std::vector<uint32_t> operands;
+	};
+
+	struct Module {
+		uint32_t bound{ 0 };
+		std::vector<Instruction> instructions;
+	};
+
+	template<size_t N>
+	std::vector<uint32_t> toWords(const unsigned char(&bytes)[N]) {
+		static_assert(N % 4 == 0, "SPIR-V is made of 32 bits words");
+		std::vector<uint32_t> words(N / 4);
+		for (size_t i = 0; i < words.size(); ++i) {
+			words[i] = uint32_t(bytes[4 * i]) | uint32_t(bytes[4 * i + 1]) << 8 | uint32_t(bytes[4 * i + 2]) << 16 | uint32_t(bytes[4 * i + 3]) << 24;
+		}
+		return words;
+	}
+
+	// tool of the generator word, its high 16 bits
+	template<size_t N>
+	uint32_t getGeneratorTool(const unsigned char(&bytes)[N]) {
+		return toWords(bytes)[2] >> 16;
+	}
+
+	// checks the header & the instruction lengths, the stream must end on the last instruction
+	template<size_t N>
+	Module parseModule(const unsigned char(&bytes)[N]) {
+		const std::vector<uint32_t> words = toWords(bytes);
+		Module module;
+		EXPECT_GE(words.size(), 5u);
+		if (words.size() < 5) {
+			return module;
+		}
+		EXPECT_EQ(words[0], spirvMagic);
+		EXPECT_EQ(words[4], 0u) << "reserved schema word";
+		module.bound = words[3];
+
+		size_t position = 5;
+		while (position < words.size()) {
+			const uint32_t wordCount = words[position] >> 16;
+			EXPECT_GE(wordCount, 1u) << "at word " << position;
+			EXPECT_LE(position + wordCount, words.size()) << "instruction past the end at word " << position;
+			if (wordCount == 0 || position + wordCount > words.size()) {
+				break;
+			}
+			module.instructions.push_back(Instruction{ words[position] & 0xffff,
+				std::vector<uint32_t>(words.begin() + position + 1, words.begin() + position + wordCount) });
+			position += wordCount;
+		}
+		return module;
+	}
+
+	size_t count(const Module& module, uint32_t opcode) {
+		return std::count_if(module.instructions.begin(), module.instructions.end(), [opcode](const Instruction& instruction) {
+			return instruction.opcode == opcode;
+		});
+	}
+
+	// shader capability, a single "main" entry point of the model with its function defined
+	void expectEntryPoint(const Module& module, uint32_t executionModel) {
+		EXPECT_TRUE(std::any_of(module.instructions.begin(), module.instructions.end(), [](const Instruction& instruction) {
+			return instruction.opcode == OpCapability && instruction.operands[0] == capabilityShader;
+		}));
+		EXPECT_EQ(count(module, OpFunction), count(module, OpFunctionEnd));
+
+		ASSERT_EQ(count(module, OpEntryPoint), 1u);
+		const auto entryPoint = std::find_if(module.instructions.begin(), module.instructions.end(), [](const Instruction& instruction) {
+			return instruction.opcode == OpEntryPoint;
+		});
+		ASSERT_GE(entryPoint->operands.size(), 3u);
+		EXPECT_EQ(entryPoint->operands[0], executionModel);
+		EXPECT_LT(entryPoint->operands[1], module.bound);
+		EXPECT_EQ(std::string(reinterpret_cast<const char*>(&entryPoint->operands[2])), "main");
+
+		const uint32_t function = entryPoint->operands[1];
+		EXPECT_TRUE(std::any_of(module.instructions.begin(), module.instructions.end(), [function](const Instruction& instruction) {
+			return instruction.opcode == OpFunction && instruction.operands.size() >= 2 && instruction.operands[1] == function;
+		}));
+	}
+
+	// as the member of the gl_PerVertex block declared by glslc
+	bool writesPerVertexPosition(const Module& module) {
+		return std::any_of(module.instructions.begin(), module.instructions.end(), [](const Instruction& instruction) {
+			return instruction.opcode == OpMemberDecorate && instruction.operands.size() == 4 &&
+				instruction.operands[2] == decorationBuiltIn && instruction.operands[3] == builtInPosition;
+		});
+	}
+
+	// as a variable or a member of the gl_PerVertex block
+	bool writesPosition(const Module& module) {
+		return std::any_of(module.instructions.begin(), module.instructions.end(), [](const Instruction& instruction) {
+			return (instruction.opcode == OpDecorate && instruction.operands.size() == 3 &&
+				instruction.operands[1] == decorationBuiltIn && instruction.operands[2] == builtInPosition) ||
+				(instruction.opcode == OpMemberDecorate && instruction.operands.size() == 4 &&
+					instruction.operands[2] == decorationBuiltIn && instruction.operands[3] == builtInPosition);
+		});
+	}
+
+}
+
+TEST(ShaderModules, VertexShadersAreWellFormed) {
+	for (const Module& module : { parseModule(gShaderVertex), parseModule(gShaderVertexIndirect), parseModule(gShaderVertexInstanced) }) {
+		expectEntryPoint(module, executionModelVertex);
+		EXPECT_TRUE(writesPosition(module));
+	}
+}
+
+TEST(ShaderModules, FragmentShaderIsWellFormed) {
+	expectEntryPoint(parseModule(gShaderFragment), executionModelFragment);
+}
+
+TEST(ShaderModules, CullShaderIsWellFormed) {
+	const Module module = parseModule(gShaderCull);
+	expectEntryPoint(module, executionModelGLCompute);
+	EXPECT_TRUE(std::any_of(module.instructions.begin(), module.instructions.end(), [](const Instruction& instruction) {
+		return instruction.opcode == OpExecutionMode && instruction.operands.size() == 5 && instruction.operands[1] == executionModeLocalSize;
+	}));
+}
+
+// a hand assembled header must not stand in for the generator output
+TEST(ShaderModules, GpuDrivenShadersAreGeneratedByGlslc) {
+	EXPECT_EQ(getGeneratorTool(gShaderCull), generatorGlslc);
+	EXPECT_EQ(getGeneratorTool(gShaderVertexIndirect), generatorGlslc);
+}
+
+TEST(ShaderModules, VertexShaderIsGeneratedByGlslc) {
+	EXPECT_EQ(getGeneratorTool(gShaderVertex), generatorGlslc);
+	EXPECT_TRUE(writesPerVertexPosition(parseModule(gShaderVertex)));
+}
+
+TEST(ShaderModules, InstancedVertexShaderIsGeneratedByGlslc) {
+	EXPECT_EQ(getGeneratorTool(gShaderVertexInstanced), generatorGlslc);
+	EXPECT_TRUE(writesPerVertexPosition(parseModule(gShaderVertexInstanced)));
+}
@@ -0,0 +1,166 @@
+#include "gtest/gtest.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "rendering/draw-collector.hpp"
+#include "rendering/static-batcher.hpp"
+
+using namespace poc;
+
+// unit cube centered on the origin, outward counter-clockwise faces
+static Mesh makeCube(const glm::vec3& color = glm::vec3(1.0f)) {
+	std::vector<Vertex> vertices;
+	for (uint32_t i = 0; i < 8; ++i) {
+		vertices.push_back(Vertex{ glm::vec3(i & 1 ? 0.5f : -0.5f, i & 2 ? 0.5f : -0.5f, i & 4 ? 0.5f : -0.5f), color });
+	}
+	std::vector<uint32_t> indices{
+		0, 2, 3, 0, 3, 1,	// -z
+		4, 5, 7, 4, 7, 6,	// +z
+		0, 4, 6, 0, 6, 2,	// -x
+		1, 3, 7, 1, 7, 5,	// +x
+		0, 1, 5, 0, 5, 4,	// -y
+		2, 6, 7, 2, 7, 3	// +y
+	};
+	return Mesh(std::move(vertices), std::move(indices));
+}
+
+// outward facing triangles: the normal points away from the center of the mesh
+static size_t countOutwardTriangles(span<const Vertex> vertices, span<const uint32_t> indices, const glm::vec3& center) {
+	size_t count = 0;
+	for (size_t i = 0; i < indices.size(); i += 3) {
+		const glm::vec3& a = vertices[indices[i]].position;
+		const glm::vec3& b = vertices[indices[i + 1]].position;
+		const glm::vec3& c = vertices[indices[i + 2]].position;
+		const glm::vec3 normal = glm::cross(b - a, c - a);
+		count += glm::dot(normal, (a + b + c) / 3.0f - center) > 0.0f ? 1 : 0;
+	}
+	return count;
+}
+
+TEST(StaticBatcher, NearbyPlacementsAreMerged) {
+	StaticBatchSettings settings;
+	settings.maxExtent = 20.0f;
+	settings.buildMeshlets = false;
+	StaticBatcher batcher(settings);
+	const uint32_t cube = batcher.addMesh(makeCube());
+	for (int x = 0; x < 40; ++x) {
+		for (int z = 0; z < 40; ++z) {
+			batcher.place(cube, glm::vec3(float(x) * 2.0f, 0.0f, float(z) * 2.0f));
+		}
+	}
+
+	Scene scene;
+	const StaticBatchReport report = batcher.build(scene);
+
+	EXPECT_EQ(report.placementCount, 1600u);
+	// the 80 x 80 area holds at least 4 x 4 batches of at most 20 units
+	EXPECT_GE(report.batches.size(), 16u);
+	EXPECT_LE(report.batches.size(), 64u);
+
+	uint32_t placementCount = 0;
+	for (const StaticBatch& batch : report.batches) {
+		placementCount += batch.placementCount;
+		const MeshRange& range = scene.getMeshes()[batch.mesh];
+		EXPECT_EQ(batch.vertexCount, batch.placementCount * 8);
+		EXPECT_EQ(batch.triangleCount, batch.placementCount * 12);
+		const glm::vec3 size = range.bounds.aabb.max - range.bounds.aabb.min;
+		EXPECT_LE(std::max(size.x, size.z), settings.maxExtent);
+		EXPECT_EQ(scene.getWorld().get<MeshComponent>(batch.entity).mesh, batch.mesh);
+	}
+	EXPECT_EQ(placementCount, 1600u);
+	EXPECT_EQ(scene.getVertexCount(), 1600u * 8);
+	EXPECT_EQ(scene.getMeshes().size(), report.batches.size());
+}
+
+TEST(StaticBatcher, BatchesAreSplitByFormatAndVertexCount) {
+	StaticBatchSettings settings;
+	settings.maxVertices = 80;
+	settings.maxExtent = 1000.0f;
+	settings.buildMeshlets = false;
+	StaticBatcher batcher(settings);
+	const uint32_t cube = batcher.addMesh(makeCube());
+	Mesh packed = makeCube();
+	packed.setVertexFormat(VertexFormat::SNORM16_POSITION);
+	const uint32_t packedCube = batcher.addMesh(std::move(packed));
+	for (int i = 0; i < 30; ++i) {
+		batcher.place(i % 2 == 0 ? cube : packedCube, glm::vec3(float(i) * 2.0f, 0.0f, 0.0f));
+	}
+
+	Scene scene;
+	const StaticBatchReport report = batcher.build(scene);
+
+	// 15 cubes of each format, 10 per batch
+	ASSERT_EQ(report.batches.size(), 4u);
+	for (const StaticBatch& batch : report.batches) {
+		EXPECT_LE(batch.vertexCount, settings.maxVertices);
+		EXPECT_EQ(scene.getMeshes()[batch.mesh].format, batch.format);
+	}
+	EXPECT_EQ(report.batches[0].format, VertexFormat::FLOAT32);
+	EXPECT_EQ(report.batches[3].format, VertexFormat::SNORM16_POSITION);
+}
+
+TEST(StaticBatcher, MirroredPlacementsKeepTheirWinding) {
+	StaticBatchSettings settings;
+	settings.buildMeshlets = false;
+	StaticBatcher batcher(settings);
+	const uint32_t cube = batcher.addMesh(makeCube());
+	batcher.place(cube, glm::vec3(5.0f, 0.0f, 0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(-1.0f, 2.0f, 1.0f));
+
+	Scene scene;
+	const StaticBatchReport report = batcher.build(scene);
+	ASSERT_EQ(report.batches.size(), 1u);
+
+	const MeshRange& range = scene.getMeshes()[report.batches[0].mesh];
+	EXPECT_EQ(countOutwardTriangles(scene.getMeshVertices(range), scene.getMeshIndices(range), glm::vec3(5.0f, 0.0f, 0.0f)), 12u);
+	EXPECT_FLOAT_EQ(range.bounds.aabb.max.y, 1.0f);
+}
+
+TEST(StaticBatcher, DisabledBatchingCreatesAnEntityPerPlacement) {
+	StaticBatchSettings settings;
+	settings.enabled = false;
+	StaticBatcher batcher(settings);
+	const uint32_t cube = batcher.addMesh(makeCube());
+	for (int i = 0; i < 10; ++i) {
+		batcher.place(cube, glm::vec3(float(i), 0.0f, 0.0f));
+	}
+
+	Scene scene;
+	const StaticBatchReport report = batcher.build(scene);
+
+	EXPECT_EQ(report.batches.size(), 10u);
+	EXPECT_EQ(scene.getMeshes().size(), 1u);
+	EXPECT_EQ(scene.getVertexCount(), 8u);
+	EXPECT_EQ(scene.getTransforms().getLocalPosition(scene.getWorld().get<TransformComponent>(report.batches[9].entity).node), glm::vec3(9.0f, 0.0f, 0.0f));
+}
+
+TEST(StaticBatcher, BatchingReducesTheDraws) {
+	Camera camera;
+	camera.setProjection(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f));
+	camera.setView(glm::lookAt(glm::vec3(40.0f, 30.0f, 120.0f), glm::vec3(40.0f, 0.0f, 40.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+
+	JobSystem jobs(2);
+	std::array<size_t, 2> drawCounts{};
+	for (const bool enabled : { false, true }) {
+		StaticBatchSettings settings;
+		settings.enabled = enabled;
+		StaticBatcher batcher(settings);
+		const uint32_t cube = batcher.addMesh(makeCube());
+		for (int x = 0; x < 40; ++x) {
+			for (int z = 0; z < 40; ++z) {
+				batcher.place(cube, glm::vec3(float(x) * 2.0f, 0.0f, float(z) * 2.0f));
+			}
+		}
+
+		Scene scene;
+		scene.getCamera() = camera;
+		batcher.build(scene);
+		scene.getTransforms().update(jobs);
+
+		DrawCollector collector;
+		collector.collect(scene, jobs, 720);
+		drawCounts[enabled] = collector.getDraws(VertexFormat::FLOAT32).size();
+	}
+
+	EXPECT_GT(drawCounts[0], 1000u);
+	EXPECT_LT(drawCounts[1] * 10, drawCounts[0]);
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cmath>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "core/camera.hpp"
+#include "rendering/mesh.hpp"
+
+namespace poc {
+
+	// closed unit sphere without duplicated vertices: rings x segments quads, one vertex per pole
+	inline Mesh makeSphere(uint32_t rings, uint32_t segments) {
+		std::vector<Vertex> vertices{ Vertex{ glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f) } };
+		for (uint32_t r = 1; r < rings; ++r) {
+			const float theta = glm::pi<float>() * float(r) / float(rings);
+			for (uint32_t s = 0; s < segments; ++s) {
+				const float phi = 2.0f * glm::pi<float>() * float(s) / float(segments);
+				vertices.push_back(Vertex{ glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)), glm::vec3(1.0f) });
+			}
+		}
+		vertices.push_back(Vertex{ glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(1.0f) });
+
+		const auto ring = [segments](uint32_t r, uint32_t s) {
+			return 1 + (r - 1) * segments + s % segments;
+		};
+		const uint32_t southPole = static_cast<uint32_t>(vertices.size() - 1);
+		std::vector<uint32_t> indices;
+		for (uint32_t s = 0; s < segments; ++s) {
+			indices.insert(indices.end(), { 0, ring(1, s + 1), ring(1, s) });
+			for (uint32_t r = 1; r + 1 < rings; ++r) {
+				indices.insert(indices.end(), { ring(r, s), ring(r, s + 1), ring(r + 1, s + 1) });
+				indices.insert(indices.end(), { ring(r, s), ring(r + 1, s + 1), ring(r + 1, s) });
+			}
+			indices.insert(indices.end(), { ring(rings - 1, s), ring(rings - 1, s + 1), southPole });
+		}
+		return Mesh(std::move(vertices), std::move(indices));
+	}
+
+	// square in the xy plane facing +z, centered on the origin
+	inline Mesh makeQuad(float halfSize) {
+		std::vector<Vertex> vertices{
+			Vertex{ glm::vec3(-halfSize, -halfSize, 0.0f), glm::vec3(1.0f) },
+			Vertex{ glm::vec3(halfSize, -halfSize, 0.0f), glm::vec3(1.0f) },
+			Vertex{ glm::vec3(halfSize, halfSize, 0.0f), glm::vec3(1.0f) },
+			Vertex{ glm::vec3(-halfSize, halfSize, 0.0f), glm::vec3(1.0f) }
+		};
+		return Mesh(std::move(vertices), std::vector<uint32_t>{ 0, 1, 2, 0, 2, 3 });
+	}
+
+	// 60 degrees vertical field of view, 16:9
+	inline Camera makePerspectiveCamera(const glm::vec3& eye, const glm::vec3& target, float farPlane = 100.0f) {
+		Camera camera;
+		camera.setProjection(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, farPlane));
+		camera.setView(glm::lookAt(eye, target, glm::vec3(0.0f, 1.0f, 0.0f)));
+		return camera;
+	}
+
+	inline std::string getTemporaryPath(const std::string& name) {
+		return (std::filesystem::temp_directory_path() / name).string();
+	}
+
+}
@@ -0,0 +1,112 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+
+#include "core/transform-hierarchy.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+using namespace poc;
+
+static void expectMatrixNear(const glm::mat4& actual, const glm::mat4& expected) {
+	for (glm::length_t column = 0; column < 4; ++column) {
+		for (glm::length_t row = 0; row < 4; ++row) {
+			EXPECT_NEAR(actual[column][row], expected[column][row], 1e-5f);
+		}
+	}
+}
+
+TEST(JobSystem, ParallelForVisitsEachIndexOnce) {
+	JobSystem jobs(4);
+	std::vector<std::atomic<uint32_t>> visits(10000);
+
+	for (uint32_t iteration = 0; iteration < 20; ++iteration) {
+		jobs.parallelFor(visits.size(), 64, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				++visits[i];
+			}
+		});
+	}
+
+	for (const std::atomic<uint32_t>& count : visits) {
+		ASSERT_EQ(count.load(), 20u);
+	}
+}
+
+TEST(TransformHierarchy, WorldMatricesComposeTheParents) {
+	JobSystem jobs(2);
+	TransformHierarchy hierarchy;
+	const TransformNode root = hierarchy.create();
+	const TransformNode child = hierarchy.create(root);
+	const TransformNode grandChild = hierarchy.create(child);
+
+	const glm::quat rotation = glm::angleAxis(glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+	hierarchy.setLocalPosition(root, glm::vec3(1.0f, 0.0f, 0.0f));
+	hierarchy.setLocalRotation(child, rotation);
+	hierarchy.setLocalScale(child, glm::vec3(2.0f));
+	hierarchy.setLocalPosition(grandChild, glm::vec3(0.0f, 1.0f, 0.0f));
+	hierarchy.update(jobs);
+
+	const glm::mat4 rootMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+	const glm::mat4 childMatrix = rootMatrix * glm::mat4_cast(rotation) * glm::scale(glm::mat4(1.0f), glm::vec3(2.0f));
+	const glm::mat4 grandChildMatrix = childMatrix * glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+	expectMatrixNear(hierarchy.getWorldMatrix(root), rootMatrix);
+	expectMatrixNear(hierarchy.getWorldMatrix(child), childMatrix);
+	expectMatrixNear(hierarchy.getWorldMatrix(grandChild), grandChildMatrix);
+	EXPECT_EQ(hierarchy.getLevelCount(), 3u);
+	EXPECT_EQ(hierarchy.getLastUpdateCount(), 3u);
+
+	// (1, 0, 0) + rotated & scaled (0, 1, 0)
+	const glm::vec4 origin = hierarchy.getWorldMatrix(grandChild) * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+	EXPECT_NEAR(origin.x, -1.0f, 1e-5f);
+	EXPECT_NEAR(origin.y, 0.0f, 1e-5f);
+}
+
+TEST(TransformHierarchy, OnlyDirtySubtreesAreUpdated) {
+	JobSystem jobs(4);
+	TransformHierarchy hierarchy;
+	const TransformNode root = hierarchy.create();
+	std::vector<TransformNode> branches;
+	for (uint32_t i = 0; i < 10; ++i) {
+		branches.push_back(hierarchy.create(root));
+		for (uint32_t j = 0; j < 100; ++j) {
+			hierarchy.create(branches.back());
+		}
+	}
+	hierarchy.update(jobs);
+	EXPECT_EQ(hierarchy.getLastUpdateCount(), 1011u);
+
+	hierarchy.update(jobs);
+	EXPECT_EQ(hierarchy.getLastUpdateCount(), 0u);
+
+	hierarchy.setLocalPosition(branches[3], glm::vec3(0.0f, 0.0f, 5.0f));
+	hierarchy.update(jobs);
+	EXPECT_EQ(hierarchy.getLastUpdateCount(), 101u);
+
+	hierarchy.setLocalPosition(root, glm::vec3(1.0f, 0.0f, 0.0f));
+	hierarchy.update(jobs);
+	EXPECT_EQ(hierarchy.getLastUpdateCount(), 1011u);
+}
+
+TEST(TransformHierarchy, NodesAddedOutOfOrderAreSortedByLevel) {
+	JobSystem jobs(2);
+	TransformHierarchy hierarchy;
+	const TransformNode root = hierarchy.create();
+	const TransformNode child = hierarchy.create(root);
+	const TransformNode grandChild = hierarchy.create(child);
+
+	// a second root after a level 2 node
+	const TransformNode otherRoot = hierarchy.create();
+	const TransformNode otherChild = hierarchy.create(otherRoot);
+
+	hierarchy.setLocalPosition(root, glm::vec3(1.0f, 0.0f, 0.0f));
+	hierarchy.setLocalPosition(otherRoot, glm::vec3(0.0f, 2.0f, 0.0f));
+	hierarchy.setLocalPosition(otherChild, glm::vec3(0.0f, 0.0f, 3.0f));
+	hierarchy.update(jobs);
+
+	EXPECT_EQ(hierarchy.getLevelCount(), 3u);
+	EXPECT_FLOAT_EQ(hierarchy.getWorldMatrix(grandChild)[3].x, 1.0f);
+	EXPECT_FLOAT_EQ(hierarchy.getWorldMatrix(otherChild)[3].y, 2.0f);
+	EXPECT_FLOAT_EQ(hierarchy.getWorldMatrix(otherChild)[3].z, 3.0f);
+	EXPECT_FLOAT_EQ(hierarchy.getLocalPosition(otherRoot).y, 2.0f);
+}
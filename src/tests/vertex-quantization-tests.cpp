@@ -0,0 +1,74 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "core/scene.hpp"
+#include "rendering/vertex-quantization.hpp"
+
+using namespace poc;
+
+static std::vector<Vertex> makeRandomVertices(size_t count, float range) {
+	std::mt19937 generator(7);
+	std::uniform_real_distribution<float> position(-range, range);
+	std::uniform_real_distribution<float> color(0.0f, 1.0f);
+
+	std::vector<Vertex> vertices(count);
+	for (Vertex& vertex : vertices) {
+		vertex.position = glm::vec3(position(generator), position(generator) * 0.5f + 10.0f, position(generator) * 0.1f);
+		vertex.color = glm::vec3(color(generator), color(generator), color(generator));
+	}
+	return vertices;
+}
+
+TEST(VertexQuantization, Snorm16PrecisionIsRelativeToTheBounds) {
+	const std::vector<Vertex> vertices = makeRandomVertices(1000, 100.0f);
+
+	std::vector<PackedVertex> packed;
+	const Dequantization dequantization = VertexQuantization::quantize(vertices, VertexFormat::SNORM16_POSITION, packed);
+	ASSERT_EQ(packed.size(), vertices.size());
+
+	// half a quantization step on each axis
+	const glm::vec3 tolerance = glm::vec3(dequantization.scale) / 32767.0f;
+	for (size_t i = 0; i < vertices.size(); ++i) {
+		const Vertex restored = VertexQuantization::dequantize(packed[i], VertexFormat::SNORM16_POSITION, dequantization);
+		for (glm::length_t axis = 0; axis < 3; ++axis) {
+			EXPECT_NEAR(restored.position[axis], vertices[i].position[axis], tolerance[axis]);
+			EXPECT_NEAR(restored.color[axis], vertices[i].color[axis], 0.5f / 255.0f);
+		}
+	}
+}
+
+TEST(VertexQuantization, HalfPositionKeepsElevenBitsOfMantissa) {
+	const std::vector<Vertex> vertices = makeRandomVertices(1000, 1.0f);
+
+	std::vector<PackedVertex> packed;
+	const Dequantization dequantization = VertexQuantization::quantize(vertices, VertexFormat::HALF_POSITION, packed);
+	EXPECT_EQ(dequantization.scale, glm::vec4(1.0f, 1.0f, 1.0f, 0.0f));
+
+	for (size_t i = 0; i < vertices.size(); ++i) {
+		const Vertex restored = VertexQuantization::dequantize(packed[i], VertexFormat::HALF_POSITION, dequantization);
+		for (glm::length_t axis = 0; axis < 3; ++axis) {
+			// relative precision, down to the smallest half subnormal
+			const float tolerance = std::max(std::abs(vertices[i].position[axis]) / 2048.0f, 6.0e-8f);
+			EXPECT_NEAR(restored.position[axis], vertices[i].position[axis], tolerance);
+		}
+	}
+}
+
+TEST(VertexQuantization, SceneStoresPackedMeshesInTheirOwnArena) {
+	Scene scene;
+	scene.addMesh(Mesh(makeRandomVertices(3, 1.0f)));
+	scene.addMesh(Mesh(makeRandomVertices(6, 1.0f), VertexFormat::SNORM16_POSITION));
+
+	EXPECT_EQ(scene.getVertices().size(), 3u);
+	EXPECT_EQ(scene.getPackedVertices().size(), 6u);
+	EXPECT_EQ(scene.getVertexCount(), 9u);
+
+	const MeshRange packedMesh = scene.getMeshes()[1];
+	EXPECT_EQ(packedMesh.format, VertexFormat::SNORM16_POSITION);
+	EXPECT_EQ(packedMesh.firstVertex, 0u);
+	EXPECT_EQ(packedMesh.firstIndex, 3u);
+	EXPECT_EQ(scene.getMeshPackedVertices(packedMesh).size(), 6u);
+}
@@ -0,0 +1,73 @@
+#include "gtest/gtest.h"
+
+#include "rendering/vulkan/vulkan-vertex-layout.hpp"
+
+using namespace poc;
+
+namespace {
+
+	struct TestInstance {
+		glm::vec4 offset;
+		uint32_t id;
+	};
+
+	constexpr auto testInstanceLayout = makeVertexLayout<TestInstance>(vk::VertexInputRate::eInstance, {
+		{ 2, vk::Format::eR32G32B32A32Sfloat, offsetof(TestInstance, offset) },
+		{ 3, vk::Format::eR32Uint, offsetof(TestInstance, id) }
+	});
+
+	constexpr const auto& float32Layout = VertexFormatLayout<VertexFormat::FLOAT32>::value;
+
+}
+
+TEST(VulkanVertexLayout, SingleLayoutGeneratesOneBinding) {
+	using State = VertexInputState<VertexFormatLayout<VertexFormat::SNORM16_POSITION>::value>;
+	static_assert(State::bindings.size() == 1);
+	static_assert(State::attributes.size() == 2);
+
+	EXPECT_EQ(State::bindings[0].binding, 0u);
+	EXPECT_EQ(State::bindings[0].stride, sizeof(PackedVertex));
+	EXPECT_EQ(State::bindings[0].inputRate, vk::VertexInputRate::eVertex);
+
+	EXPECT_EQ(State::attributes[0].location, 0u);
+	EXPECT_EQ(State::attributes[0].format, vk::Format::eR16G16B16A16Snorm);
+	EXPECT_EQ(State::attributes[1].location, 1u);
+	EXPECT_EQ(State::attributes[1].offset, offsetof(PackedVertex, color));
+
+	EXPECT_EQ(State::createInfo.vertexBindingDescriptionCount, 1u);
+	EXPECT_EQ(State::createInfo.pVertexBindingDescriptions, State::bindings.data());
+	EXPECT_EQ(State::createInfo.vertexAttributeDescriptionCount, 2u);
+	EXPECT_EQ(State::createInfo.pVertexAttributeDescriptions, State::attributes.data());
+}
+
+TEST(VulkanVertexLayout, LayoutsAreBoundInOrder) {
+	using State = VertexInputState<float32Layout, testInstanceLayout>;
+	static_assert(State::bindings.size() == 2);
+	static_assert(State::attributes.size() == 4);
+
+	EXPECT_EQ(State::bindings[1].binding, 1u);
+	EXPECT_EQ(State::bindings[1].stride, sizeof(TestInstance));
+	EXPECT_EQ(State::bindings[1].inputRate, vk::VertexInputRate::eInstance);
+
+	EXPECT_EQ(State::attributes[1].binding, 0u);
+	EXPECT_EQ(State::attributes[1].offset, offsetof(Vertex, color));
+	EXPECT_EQ(State::attributes[2].binding, 1u);
+	EXPECT_EQ(State::attributes[2].location, 2u);
+	EXPECT_EQ(State::attributes[3].binding, 1u);
+	EXPECT_EQ(State::attributes[3].format, vk::Format::eR32Uint);
+	EXPECT_EQ(State::attributes[3].offset, offsetof(TestInstance, id));
+}
+
+TEST(VulkanVertexLayout, InstancesFollowTheVertices) {
+	using State = VertexInputState<VertexFormatLayout<VertexFormat::HALF_POSITION>::value, InstanceLayout::value>;
+	static_assert(State::attributes.size() == 6);
+
+	EXPECT_EQ(State::bindings[1].stride, sizeof(Instance));
+	EXPECT_EQ(State::bindings[1].inputRate, vk::VertexInputRate::eInstance);
+	for (size_t i = 2; i < State::attributes.size(); ++i) {
+		EXPECT_EQ(State::attributes[i].binding, 1u);
+		EXPECT_EQ(State::attributes[i].location, i);
+	}
+	EXPECT_EQ(State::attributes[4].offset, 2 * sizeof(glm::vec4));
+	EXPECT_EQ(State::attributes[5].format, vk::Format::eR8G8B8A8Unorm);
+}
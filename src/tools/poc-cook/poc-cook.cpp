@@ -0,0 +1,85 @@
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+
+#include "assets/asset-cooker.hpp"
+
+using namespace poc;
+
+static void printUsage(const char* name) {
+	std::cerr << "Usage: " << name << " <source_directory> <output_directory> [options]\n"
+		<< "  --threads <n>               jobs cooking in parallel, 0 for one per hardware thread (default)\n"
+		<< "  --format <float32|half|snorm16>  vertex format of the cooked meshes (default float32)\n"
+		<< "  --no-optimize               skip the vertex cache, overdraw & vertex fetch optimizations\n"
+		<< "  --no-lods                   skip the levels of detail\n"
+		<< "  --no-meshlets               skip the meshlets\n"
+		<< "  --shader-compiler <command> GLSL to SPIR-V compiler, empty to skip the shaders (default glslc)" << std::endl;
+}
+
+int main(int argc, char** argv) {
+	if (argc < 3) {
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	CookSettings settings;
+	uint32_t threadCount = 0;
+	for (int i = 3; i < argc; ++i) {
+		const std::string option = argv[i];
+		const bool hasValue = i + 1 < argc;
+		if (option == "--threads" && hasValue) {
+			threadCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+		}
+		else if (option == "--format" && hasValue) {
+			const std::string format = argv[++i];
+			if (format == "float32") {
+				settings.vertexFormat = VertexFormat::FLOAT32;
+			}
+			else if (format == "half") {
+				settings.vertexFormat = VertexFormat::HALF_POSITION;
+			}
+			else if (format == "snorm16") {
+				settings.vertexFormat = VertexFormat::SNORM16_POSITION;
+			}
+			else {
+				printUsage(argv[0]);
+				return EXIT_FAILURE;
+			}
+		}
+		else if (option == "--no-optimize") {
+			settings.optimizeMeshes = false;
+		}
+		else if (option == "--no-lods") {
+			settings.generateLods = false;
+		}
+		else if (option == "--no-meshlets") {
+			settings.buildMeshlets = false;
+		}
+		else if (option == "--shader-compiler" && hasValue) {
+			settings.shaderCompiler = argv[++i];
+		}
+		else {
+			printUsage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	try {
+		const auto start = std::chrono::steady_clock::now();
+		JobSystem jobs(threadCount);
+		AssetCooker cooker(argv[1], argv[2], settings);
+		const CookReport report = cooker.cook(jobs);
+		const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+
+		std::cout << report.assetCount << " assets, " << report.cookedCount << " cooked, "
+			<< report.unchangedCount + report.sameContentCount << " up to date, " << report.failedCount << " failed in "
+			<< duration.count() << " ms" << std::endl;
+		return report.failedCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+}